@@ -29,8 +29,8 @@ void initialize_parser(void)
 {
    int i;
 
-   st.globalvars = table_create(TABLESIZE);
-   st.classvars = table_create(TABLESIZE);
+   st.globalvars = table_create(GLOBAL_TABLESIZE);
+   st.classvars = table_create(CLASS_TABLESIZE);
    st.localvars = table_create(TABLESIZE);
    st.missingvars = table_create(TABLESIZE);
 
@@ -182,6 +182,7 @@ id_type lookup_id(id_type id)
    record = (id_type) table_lookup(st.globalvars, (void *) id, id_hash, id_compare);
    if (record != NULL)
    {
+      note_external_id(record);
       id->type = record->type;
       id->idnum = record->idnum;
       id->ownernum = record->ownernum;
@@ -194,6 +195,7 @@ id_type lookup_id(id_type id)
    record = (id_type) table_lookup(st.missingvars, (void *) id, id_hash, id_compare);
    if (record != NULL)
    {
+      note_external_id(record);
       id->type = record->type;
       id->idnum = record->idnum;
       id->ownernum = record->ownernum;
@@ -275,6 +277,7 @@ int add_identifier(id_type id, int type)
       if (table_insert(st.missingvars, (void *) id, id_hash, id_compare) == 0)
 	 id->idnum = ++st.maxid;
       else return 1;
+      note_external_id(id);
       break;
 
    default:
@@ -460,13 +463,13 @@ expr_type make_expr_from_id(id_type id)
    case I_CONSTANT:
    {
       const_type c = (const_type) SafeMalloc(sizeof(const_struct));
-      id_type temp;
 
       /* Turn constant id reference into the constant itself */
       c->type = C_NUMBER;
 
-      temp = (id_type) list_find_item(st.constants, id, id_compare);
-      c->value.numval = temp->source; /* Value is stored in source field */
+      /* Value is stored in source field, which lookup_id copied from the
+       * class table; no need to search st.constants for it */
+      c->value.numval = id->source;
 
       e->type = E_CONSTANT;
       e->value.constval = c;
@@ -1082,6 +1085,7 @@ stmt_type make_call(id_type function_id, list_type args)
 		  id->type = I_MISSING;
 		  id->idnum = ++st.maxid;
 		  table_insert(st.missingvars, (void *) id, id_hash, id_compare);
+		  note_external_id(id);
 	       }
 	       else 
 	       {
@@ -1092,12 +1096,14 @@ stmt_type make_call(id_type function_id, list_type args)
 		  id->type = I_MISSING;
 		  id->source = I_PARAMETER;
 		  id->idnum = new_id->idnum;
+		  note_external_id(new_id);
 	       }
 	       
 	    }
 	    else 
 	    {
 	       id = new_id;
+	       note_external_id(id);
 	       if (id->type != I_PARAMETER)
 		  action_error("Can't find parameter %s", id->name);
 	    }
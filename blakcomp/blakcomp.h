@@ -12,6 +12,7 @@
 
 #ifdef BLAK_PLATFORM_WINDOWS
 #include <io.h>
+#include <direct.h>
 #endif
 
 #ifdef BLAK_PLATFORM_LINUX
@@ -44,6 +45,9 @@
 #define MAXARGS         30      /* Maximum # of arguments to a function */
 
 #define TABLESIZE       1023    /* Size of symbol tables */
+#define GLOBAL_TABLESIZE 16383  /* Size of global symbol table, which holds every
+                                 * class, message and resource in the database */
+#define CLASS_TABLESIZE 4095    /* Size of class symbol table; also holds constants */
 
 enum { C_NUMBER, C_STRING, C_NIL, C_FNAME, C_RESOURCE, C_CLASS, C_MESSAGE, C_OVERRIDE }; 
 
@@ -215,6 +219,22 @@ typedef struct {
    id_type superclass;
 } *recompile_type, recompile_struct;
 
+/* A source file that has been parsed, with everything code generation needs
+ * from it.  In batch mode with more than one job, code is generated only after
+ * every file has been parsed, on several threads at once; the unit keeps what
+ * the following files would otherwise change. */
+typedef struct {
+   char *dir;            /* Directory the file was compiled in, or NULL for the current one */
+   char *kod_fname;      /* Source filename, as recorded in the .bof */
+   char *bof_fname;      /* Object code filename, relative to dir */
+   list_type classes;    /* Classes defined in the file */
+   int num_strings;      /* Debugging strings in the file */
+   list_type strings;
+   list_type dep_files;  /* Source and include files read; see depend.c */
+   list_type dep_lines;  /* Manifest lines for its classes and externals */
+   bool ok;              /* Were the .bof, .rsc and manifest written? */
+} *compile_unit_type, compile_unit_struct;
+
 typedef struct {
    Table globalvars;     /* Identifiers with global scope */
    Table classvars;      /* Identifiers with class scope */
@@ -321,10 +341,15 @@ int class_compare(void *info1, void *info2);
 int add_identifier(id_type id, int type);
 int get_statement_line(stmt_type s, int curline);
 
-void codegen(char *current_fname, char *bof_fname);
+bool codegen(char *current_fname, char *bof_fname);
+compile_unit_type make_compile_unit(char *kod_fname, char *bof_fname, char *dir);
+bool codegen_unit(compile_unit_type u);
+bool codegen_units(list_type units, int num_jobs);
 void set_kodbase_filename(char *filename);
+const char *get_kodbase_filename(void);
 bool load_kodbase(void);
 bool save_kodbase(void);
+void checkpoint_kodbase(void);
 
 /*************************** Global variables *************************/
 extern bool generate_code;      /* true if we should generate code */
@@ -333,6 +358,7 @@ extern SymbolTable st;          /* Compiler's symbol table */
 /**************************** Include files ***************************/
 #include "sort.h"
 #include "optimize.h"
+#include "depend.h"
 
 #endif /* #ifdef _BLAKCOMP_H */
 
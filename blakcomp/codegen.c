@@ -11,10 +11,14 @@
 #include "bkod.h"
 #include "codegen.h"
 #include "resource.h"
+#include <atomic>
+#include <thread>
+#include <vector>
 
 static BYTE bof_magic[] = { 0x42, 0x4F, 0x46, 0xFF };
 
-bool codegen_ok;
+/* Code for several files may be generated at once, each on its own thread */
+thread_local bool codegen_ok;
 extern bool debug_bof;  /* Should we put debugging info into .bof? */
 
 typedef struct {
@@ -22,10 +26,10 @@ typedef struct {
    int offset;   // Offset in bof of beginning of statement
 } DebugLine;
 
-static list_type debug_lines;   // list of DebugLine structures
-FILE *outfile; /* File handle of output file */
-static list_type loop_stack;    /* Info for all current (possibly nested) loops */
-static loop_type current_loop;  /* Info for current loop */
+static thread_local list_type debug_lines;   // list of DebugLine structures
+thread_local FILE *outfile; /* File handle of output file */
+static thread_local list_type loop_stack;    /* Info for all current (possibly nested) loops */
+static thread_local loop_type current_loop;  /* Info for current loop */
 
 /************************************************************************/
 /*
@@ -41,18 +45,12 @@ void codegen_header(void)
 }
 /************************************************************************/
 /*
- * codegen_classes: Generate code for all classes.
+ * codegen_classes: Generate code for the given list of classes.
  */
-void codegen_classes(void)
+void codegen_classes(list_type c)
 {
-   list_type templist, c = NULL;
    int numclasses, classpos, endpos, i;
 
-   /* Make list of only classes which appeared in current source file */
-   for (templist = st.classes; templist != NULL; templist = templist->next)
-      if ( ((class_type) (templist->data))->is_new)
-        c = list_add_item(c, templist->data);
-   
    /* Write out # of classes */
    numclasses = list_length(c);
    OutputInt(outfile, numclasses);
@@ -90,32 +88,32 @@ void codegen_classes(void)
 }
 /************************************************************************/
 /*
- * codegen_string_table:  Write out string table.
+ * codegen_string_table:  Write out string table of compile unit u.
  */
-void codegen_string_table(void)
+void codegen_string_table(compile_unit_type u)
 {
    int i, curpos, total_len;
    char *str;
    list_type l;
 
-   OutputInt(outfile, st.num_strings);
+   OutputInt(outfile, u->num_strings);
 
    curpos = FileCurPos(outfile);
 
    /* Write out offsets of strings (need to know string lengths) */
    total_len = 0;
-   l = st.strings;
-   for (i=0; i < st.num_strings; i++)
+   l = u->strings;
+   for (i=0; i < u->num_strings; i++)
    {
-      OutputInt(outfile, curpos + total_len + st.num_strings * 4);
+      OutputInt(outfile, curpos + total_len + u->num_strings * 4);
       str = (char *) (l->data);
       total_len += (int) strlen(str) + 1;
       l = l->next;
    }
 
    /* Now write out the strings themselves */
-   l = st.strings;
-   for (i=0; i < st.num_strings; i++)
+   l = u->strings;
+   for (i=0; i < u->num_strings; i++)
    {
       str = (char *) (l->data);
       fwrite(str, (int) strlen(str), 1, outfile);
@@ -851,23 +849,62 @@ void codegen_class(class_type c)
    }
 }
 /************************************************************************/
+/*
+ * make_compile_unit: Collect what code generation needs of the file just
+ *   parsed: the classes it defined, its strings and its dependencies.
+ *   dir is the directory its filenames are relative to, or NULL for the
+ *   current one.  Marks its classes as done.
+ */
+compile_unit_type make_compile_unit(char *kod_fname, char *bof_fname, char *dir)
+{
+   compile_unit_type u = (compile_unit_type) SafeMalloc(sizeof(compile_unit_struct));
+   list_type c;
+
+   u->dir = dir;
+   u->kod_fname = kod_fname;
+   u->bof_fname = bof_fname;
+   u->num_strings = st.num_strings;
+   u->strings = st.strings;
+   u->ok = false;
+
+   /* Make list of only classes which appeared in current source file */
+   u->classes = NULL;
+   for (c = st.classes; c != NULL; c = c->next)
+      if (((class_type) (c->data))->is_new)
+         u->classes = list_add_item(u->classes, c->data);
+
+   finish_dependencies(u);
+
+   /* Mark all classes as done */
+   for (c = st.classes; c != NULL; c = c->next)
+      ((class_type) (c->data))->is_new = false;
+
+   return u;
+}
+/************************************************************************/
 /* 
- * codegen: Generate code for all the classes in the symbol table.
+ * codegen_unit: Write the .bof, .rsc and dependency files of compile unit
+ *   u.  Reads only u and what its classes refer to, so may be called on
+ *   several threads at once for different units.  Returns true iff the
+ *   files were written, which is also left in u->ok.
  */
-void codegen(char *kod_fname, char *bof_fname)
+bool codegen_unit(compile_unit_type u)
 {
-   list_type c = NULL;
+   char path[512];
    long endpos, stringpos, debugpos, namepos;
 
    codegen_ok = true;
    debug_lines = NULL;
+   loop_stack = NULL;
+   current_loop = NULL;
 
-   outfile = fopen(bof_fname, "w+b");
+   make_path(path, sizeof(path), u->dir, u->bof_fname);
+   outfile = fopen(path, "w+b");
 
    if (outfile == nullptr)
    {
-      simple_error("Unable to open bof file %s!", bof_fname);
-      return;
+      simple_error("Unable to open bof file %s!", path);
+      return false;
    }
 
    /* Write out header info */
@@ -885,7 +922,7 @@ void codegen(char *kod_fname, char *bof_fname)
    debugpos = FileCurPos(outfile);
    OutputInt(outfile, 0);
    
-   codegen_classes();
+   codegen_classes(u->classes);
    
    if (codegen_ok)
    {
@@ -895,7 +932,7 @@ void codegen(char *kod_fname, char *bof_fname)
       OutputInt(outfile, endpos);
 
       FileGotoEnd(outfile);
-      codegen_string_table();
+      codegen_string_table(u);
 
       /* Backpatch location of debug info */
       endpos = FileCurPos(outfile);
@@ -914,7 +951,7 @@ void codegen(char *kod_fname, char *bof_fname)
       OutputInt(outfile, endpos);
 
       FileGotoEnd(outfile);
-      codegen_filename(kod_fname);
+      codegen_filename(u->kod_fname);
    }
 
    fclose(outfile);
@@ -922,21 +959,64 @@ void codegen(char *kod_fname, char *bof_fname)
    /* If code generation failed, delete partial bof file */
    if (!codegen_ok)
    {
-      if (unlink(bof_fname))
-	 codegen_error("Couldn't delete file %s", bof_fname);
-      else simple_warning("Deleted file %s", bof_fname);
+      if (unlink(path))
+	 codegen_error("Couldn't delete file %s", path);
+      else simple_warning("Deleted file %s", path);
    }
 
-   /* Write out resources & new database if we compiled ok */
+   /* Write out resources and dependencies if we compiled ok */
    if (codegen_ok)
    {
       char temp[256];
-      set_extension(temp, sizeof(temp), bof_fname, ".rsc");
-      write_resources(temp);
-      save_kodbase();
+      set_extension(temp, sizeof(temp), u->bof_fname, ".rsc");
+      make_path(path, sizeof(path), u->dir, temp);
+      if (!write_dependencies(u, write_resources(path, u->classes) ? temp : NULL))
+         codegen_ok = false;
    }
 
-   /* Mark all classes as done */
-   for (c = st.classes; c != NULL; c = c->next)
-      ((class_type) (c->data))->is_new = false;
+   u->ok = codegen_ok;
+   return codegen_ok;
+}
+/************************************************************************/
+/*
+ * codegen_units: Generate code for each compile unit in the given list,
+ *   using up to num_jobs threads.  Returns true iff all of them succeeded;
+ *   each unit's ok field says which did.
+ */
+bool codegen_units(list_type units, int num_jobs)
+{
+   std::vector<compile_unit_type> work;
+   std::vector<std::thread> threads;
+   std::atomic<size_t> next(0);
+   list_type l;
+   int i;
+
+   for (l = units; l != NULL; l = l->next)
+      work.push_back((compile_unit_type) l->data);
+
+   for (i=0; i < num_jobs && i < (int) work.size(); i++)
+      threads.emplace_back([&work, &next]()
+      {
+         size_t n;
+         while ((n = next++) < work.size())
+            codegen_unit(work[n]);
+      });
+
+   for (std::thread &t : threads)
+      t.join();
+
+   for (compile_unit_type u : work)
+      if (!u->ok)
+         return false;
+   return true;
+}
+/************************************************************************/
+/* 
+ * codegen: Generate code for the classes of the file just parsed.
+ *   Returns true iff the .bof and .rsc files were written; the caller
+ *   is responsible for saving the database.
+ */
+bool codegen(char *kod_fname, char *bof_fname)
+{
+   return codegen_unit(make_compile_unit(kod_fname, bof_fname, NULL));
 }
@@ -34,7 +34,7 @@ typedef struct {
 				 */
 } *loop_type, loop_struct;
 
-extern bool codegen_ok;          /* Did codegen complete successfully? */
+extern thread_local bool codegen_ok; /* Did codegen complete successfully? */
 
 void OutputOpcode(FILE *outfile, opcode_type opcode);
 void OutputByte(FILE *outfile, BYTE datum);
@@ -57,7 +57,7 @@ void codegen_enter_loop(void);
 void codegen_exit_loop(void);
 
 void codegen_header(void);
-void codegen_string_table(void);
+void codegen_string_table(compile_unit_type u);
 int codegen_return(expr_type expr, int maxlocal);
 int codegen_statement(stmt_type s, int numlocals);
 void codegen_parameter(param_type p);
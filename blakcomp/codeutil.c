@@ -13,7 +13,7 @@
 
 // file opened in codegen.c -- ugly that it has the same name as a parameter
 // to many functions in this file.
-extern FILE *outfile;
+extern thread_local FILE *outfile;
 
 /************************************************************************/
 /* 
@@ -21,14 +21,14 @@ extern FILE *outfile;
  */
 void codegen_error(const char *fmt, ...)
 {
+   char message[1024];
    va_list marker;
 
-   fprintf(stderr, "error: ");
-
+   /* Print in one piece, so that other threads' messages don't break in */
    va_start(marker, fmt);
-   vfprintf(stderr, fmt, marker);
+   vsnprintf(message, sizeof(message), fmt, marker);
    va_end(marker);
-   fprintf(stderr, "\nAborting.\n");
+   fprintf(stderr, "error: %s\nAborting.\n", message);
 
    codegen_ok = false;
 }
@@ -0,0 +1,2260 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
+
+/* Bison implementation for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* C LALR(1) parser skeleton written by Richard Stallman, by
+   simplifying the original so-called "semantic" parser.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+/* All symbols defined below should begin with yy or YY, to avoid
+   infringing on user name space.  This should be done even for local
+   variables, as they might otherwise be expanded by user macros.
+   There are some unavoidable exceptions within include files to
+   define necessary library symbols; they are noted "INFRINGES ON
+   USER NAME SPACE" below.  */
+
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
+
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
+
+/* Skeleton name.  */
+#define YYSKELETON_NAME "yacc.c"
+
+/* Pure parsers.  */
+#define YYPURE 0
+
+/* Push parsers.  */
+#define YYPUSH 0
+
+/* Pull parsers.  */
+#define YYPULL 1
+
+
+
+
+/* First part of user prologue.  */
+#line 1 "./blakcomp.y"
+
+#include "blakcomp.h"
+#include <stdio.h>
+#include <stdint.h>   // Needed for Bison to get PTRDIFF_MAX (Bison bug?)
+
+#line 77 "debug/blakcomp.tab.c"
+
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
+# ifndef YY_NULLPTR
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
+#  else
+#   define YY_NULLPTR ((void*)0)
+#  endif
+# endif
+
+#include "blakcomp.tab.h"
+/* Symbol kind.  */
+enum yysymbol_kind_t
+{
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_NUMBER = 3,                     /* NUMBER  */
+  YYSYMBOL_REL_OP = 4,                     /* REL_OP  */
+  YYSYMBOL_STRING_CONSTANT = 5,            /* STRING_CONSTANT  */
+  YYSYMBOL_FILENAME = 6,                   /* FILENAME  */
+  YYSYMBOL_IDENTIFIER = 7,                 /* IDENTIFIER  */
+  YYSYMBOL_AND = 8,                        /* AND  */
+  YYSYMBOL_BREAK = 9,                      /* BREAK  */
+  YYSYMBOL_CLASSVARS = 10,                 /* CLASSVARS  */
+  YYSYMBOL_CONSTANTS = 11,                 /* CONSTANTS  */
+  YYSYMBOL_CONTINUE = 12,                  /* CONTINUE  */
+  YYSYMBOL_ELSE = 13,                      /* ELSE  */
+  YYSYMBOL_FOR = 14,                       /* FOR  */
+  YYSYMBOL_IF = 15,                        /* IF  */
+  YYSYMBOL_IN = 16,                        /* IN  */
+  YYSYMBOL_IS = 17,                        /* IS  */
+  YYSYMBOL_LOCAL = 18,                     /* LOCAL  */
+  YYSYMBOL_MESSAGES = 19,                  /* MESSAGES  */
+  YYSYMBOL_MOD = 20,                       /* MOD  */
+  YYSYMBOL_NOT = 21,                       /* NOT  */
+  YYSYMBOL_OR = 22,                        /* OR  */
+  YYSYMBOL_PROPAGATE = 23,                 /* PROPAGATE  */
+  YYSYMBOL_PROPERTIES = 24,                /* PROPERTIES  */
+  YYSYMBOL_RESOURCES = 25,                 /* RESOURCES  */
+  YYSYMBOL_RETURN = 26,                    /* RETURN  */
+  YYSYMBOL_WHILE = 27,                     /* WHILE  */
+  YYSYMBOL_END = 28,                       /* END  */
+  YYSYMBOL_EOL = 29,                       /* EOL  */
+  YYSYMBOL_SEP = 30,                       /* SEP  */
+  YYSYMBOL_INCLUDE = 31,                   /* INCLUDE  */
+  YYSYMBOL_32_ = 32,                       /* '|'  */
+  YYSYMBOL_33_ = 33,                       /* '&'  */
+  YYSYMBOL_34_ = 34,                       /* '='  */
+  YYSYMBOL_35_ = 35,                       /* '+'  */
+  YYSYMBOL_36_ = 36,                       /* '-'  */
+  YYSYMBOL_37_ = 37,                       /* '*'  */
+  YYSYMBOL_38_ = 38,                       /* '/'  */
+  YYSYMBOL_UMINUS = 39,                    /* UMINUS  */
+  YYSYMBOL_40_ = 40,                       /* '~'  */
+  YYSYMBOL_41_ = 41,                       /* ':'  */
+  YYSYMBOL_42_ = 42,                       /* '{'  */
+  YYSYMBOL_43_ = 43,                       /* '}'  */
+  YYSYMBOL_44_ = 44,                       /* ','  */
+  YYSYMBOL_45_ = 45,                       /* '('  */
+  YYSYMBOL_46_ = 46,                       /* ')'  */
+  YYSYMBOL_47_ = 47,                       /* '['  */
+  YYSYMBOL_48_ = 48,                       /* ']'  */
+  YYSYMBOL_49_ = 49,                       /* '#'  */
+  YYSYMBOL_50_ = 50,                       /* '$'  */
+  YYSYMBOL_51_ = 51,                       /* '@'  */
+  YYSYMBOL_YYACCEPT = 52,                  /* $accept  */
+  YYSYMBOL_Start = 53,                     /* Start  */
+  YYSYMBOL_Classes = 54,                   /* Classes  */
+  YYSYMBOL_Class = 55,                     /* Class  */
+  YYSYMBOL_end_junk = 56,                  /* end_junk  */
+  YYSYMBOL_Class_Signature = 57,           /* Class_Signature  */
+  YYSYMBOL_Constants_Block = 58,           /* Constants_Block  */
+  YYSYMBOL_Resources_Block = 59,           /* Resources_Block  */
+  YYSYMBOL_Classvars_Block = 60,           /* Classvars_Block  */
+  YYSYMBOL_Properties_Block = 61,          /* Properties_Block  */
+  YYSYMBOL_Messages_Block = 62,            /* Messages_Block  */
+  YYSYMBOL_constants_list = 63,            /* constants_list  */
+  YYSYMBOL_constant_assign = 64,           /* constant_assign  */
+  YYSYMBOL_resource_list = 65,             /* resource_list  */
+  YYSYMBOL_resource = 66,                  /* resource  */
+  YYSYMBOL_resource_const = 67,            /* resource_const  */
+  YYSYMBOL_classvar_list = 68,             /* classvar_list  */
+  YYSYMBOL_property_list = 69,             /* property_list  */
+  YYSYMBOL_classvar = 70,                  /* classvar  */
+  YYSYMBOL_property = 71,                  /* property  */
+  YYSYMBOL_message_handler_list = 72,      /* message_handler_list  */
+  YYSYMBOL_message_handler = 73,           /* message_handler  */
+  YYSYMBOL_message_header = 74,            /* message_header  */
+  YYSYMBOL_locals = 75,                    /* locals  */
+  YYSYMBOL_vars = 76,                      /* vars  */
+  YYSYMBOL_var = 77,                       /* var  */
+  YYSYMBOL_parameter_list = 78,            /* parameter_list  */
+  YYSYMBOL_param_list2 = 79,               /* param_list2  */
+  YYSYMBOL_parameter = 80,                 /* parameter  */
+  YYSYMBOL_statement_list = 81,            /* statement_list  */
+  YYSYMBOL_statement = 82,                 /* statement  */
+  YYSYMBOL_if_stmt = 83,                   /* if_stmt  */
+  YYSYMBOL_assign_stmt = 84,               /* assign_stmt  */
+  YYSYMBOL_for_stmt = 85,                  /* for_stmt  */
+  YYSYMBOL_loop_variable = 86,             /* loop_variable  */
+  YYSYMBOL_while_stmt = 87,                /* while_stmt  */
+  YYSYMBOL_start_loop = 88,                /* start_loop  */
+  YYSYMBOL_end_loop = 89,                  /* end_loop  */
+  YYSYMBOL_call = 90,                      /* call  */
+  YYSYMBOL_expression_list = 91,           /* expression_list  */
+  YYSYMBOL_argument_list = 92,             /* argument_list  */
+  YYSYMBOL_arg_list2 = 93,                 /* arg_list2  */
+  YYSYMBOL_argument = 94,                  /* argument  */
+  YYSYMBOL_expression = 95,                /* expression  */
+  YYSYMBOL_constant = 96,                  /* constant  */
+  YYSYMBOL_fname = 97,                     /* fname  */
+  YYSYMBOL_literal = 98,                   /* literal  */
+  YYSYMBOL_id = 99                         /* id  */
+};
+typedef enum yysymbol_kind_t yysymbol_kind_t;
+
+
+
+
+#ifdef short
+# undef short
+#endif
+
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
+
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
+#endif
+
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
+
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
+#else
+typedef signed char yytype_int8;
+#endif
+
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
+#else
+typedef short yytype_int16;
+#endif
+
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
+#endif
+
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
+#else
+typedef short yytype_uint8;
+#endif
+
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
+#else
+typedef int yytype_uint16;
+#endif
+
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
+#endif
+
+#ifndef YYSIZE_T
+# ifdef __SIZE_TYPE__
+#  define YYSIZE_T __SIZE_TYPE__
+# elif defined size_t
+#  define YYSIZE_T size_t
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYSIZE_T size_t
+# else
+#  define YYSIZE_T unsigned
+# endif
+#endif
+
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_uint8 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
+
+#ifndef YY_
+# if defined YYENABLE_NLS && YYENABLE_NLS
+#  if ENABLE_NLS
+#   include <libintl.h> /* INFRINGES ON USER NAME SPACE */
+#   define YY_(Msgid) dgettext ("bison-runtime", Msgid)
+#  endif
+# endif
+# ifndef YY_
+#  define YY_(Msgid) Msgid
+# endif
+#endif
+
+
+#ifndef YY_ATTRIBUTE_PURE
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
+#endif
+
+#ifndef YY_ATTRIBUTE_UNUSED
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
+# else
+#  define YY_ATTRIBUTE_UNUSED
+# endif
+#endif
+
+/* Suppress unused-variable warnings by "using" E.  */
+#if ! defined lint || defined __GNUC__
+# define YY_USE(E) ((void) (E))
+#else
+# define YY_USE(E) /* empty */
+#endif
+
+/* Suppress an incorrect diagnostic about yylval being uninitialized.  */
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
+    _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
+    _Pragma ("GCC diagnostic pop")
+#else
+# define YY_INITIAL_VALUE(Value) Value
+#endif
+#ifndef YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END
+#endif
+#ifndef YY_INITIAL_VALUE
+# define YY_INITIAL_VALUE(Value) /* Nothing. */
+#endif
+
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
+#endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
+#endif
+
+
+#define YY_ASSERT(E) ((void) (0 && (E)))
+
+#if !defined yyoverflow
+
+/* The parser invokes alloca or malloc; define the necessary symbols.  */
+
+# ifdef YYSTACK_USE_ALLOCA
+#  if YYSTACK_USE_ALLOCA
+#   ifdef __GNUC__
+#    define YYSTACK_ALLOC __builtin_alloca
+#   elif defined __BUILTIN_VA_ARG_INCR
+#    include <alloca.h> /* INFRINGES ON USER NAME SPACE */
+#   elif defined _AIX
+#    define YYSTACK_ALLOC __alloca
+#   elif defined _MSC_VER
+#    include <malloc.h> /* INFRINGES ON USER NAME SPACE */
+#    define alloca _alloca
+#   else
+#    define YYSTACK_ALLOC alloca
+#    if ! defined _ALLOCA_H && ! defined EXIT_SUCCESS
+#     include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+      /* Use EXIT_SUCCESS as a witness for stdlib.h.  */
+#     ifndef EXIT_SUCCESS
+#      define EXIT_SUCCESS 0
+#     endif
+#    endif
+#   endif
+#  endif
+# endif
+
+# ifdef YYSTACK_ALLOC
+   /* Pacify GCC's 'empty if-body' warning.  */
+#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (0)
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+    /* The OS might guarantee only one guard page at the bottom of the stack,
+       and a page size can be as small as 4096 bytes.  So we cannot safely
+       invoke alloca (N) if N exceeds 4096.  Use a slightly smaller number
+       to allow for a few compiler-allocated temporary stack slots.  */
+#   define YYSTACK_ALLOC_MAXIMUM 4032 /* reasonable circa 2006 */
+#  endif
+# else
+#  define YYSTACK_ALLOC YYMALLOC
+#  define YYSTACK_FREE YYFREE
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+#   define YYSTACK_ALLOC_MAXIMUM YYSIZE_MAXIMUM
+#  endif
+#  if (defined __cplusplus && ! defined EXIT_SUCCESS \
+       && ! ((defined YYMALLOC || defined malloc) \
+             && (defined YYFREE || defined free)))
+#   include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+#   ifndef EXIT_SUCCESS
+#    define EXIT_SUCCESS 0
+#   endif
+#  endif
+#  ifndef YYMALLOC
+#   define YYMALLOC malloc
+#   if ! defined malloc && ! defined EXIT_SUCCESS
+void *malloc (YYSIZE_T); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+#  ifndef YYFREE
+#   define YYFREE free
+#   if ! defined free && ! defined EXIT_SUCCESS
+void free (void *); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+# endif
+#endif /* !defined yyoverflow */
+
+#if (! defined yyoverflow \
+     && (! defined __cplusplus \
+         || (defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
+
+/* A type that is properly aligned for any stack member.  */
+union yyalloc
+{
+  yy_state_t yyss_alloc;
+  YYSTYPE yyvs_alloc;
+};
+
+/* The size of the maximum gap between one aligned stack and the next.  */
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
+
+/* The size of an array large to enough to hold all stacks, each with
+   N elements.  */
+# define YYSTACK_BYTES(N) \
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE)) \
+      + YYSTACK_GAP_MAXIMUM)
+
+# define YYCOPY_NEEDED 1
+
+/* Relocate STACK from its old location to the new one.  The
+   local variables YYSIZE and YYSTACKSIZE give the old and new number of
+   elements in the stack, and YYPTR gives the new location of the
+   stack.  Advance YYPTR to a properly aligned location for the next
+   stack.  */
+# define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
+    do                                                                  \
+      {                                                                 \
+        YYPTRDIFF_T yynewbytes;                                         \
+        YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
+        Stack = &yyptr->Stack_alloc;                                    \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
+      }                                                                 \
+    while (0)
+
+#endif
+
+#if defined YYCOPY_NEEDED && YYCOPY_NEEDED
+/* Copy COUNT objects from SRC to DST.  The source and destination do
+   not overlap.  */
+# ifndef YYCOPY
+#  if defined __GNUC__ && 1 < __GNUC__
+#   define YYCOPY(Dst, Src, Count) \
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
+#  else
+#   define YYCOPY(Dst, Src, Count)              \
+      do                                        \
+        {                                       \
+          YYPTRDIFF_T yyi;                      \
+          for (yyi = 0; yyi < (Count); yyi++)   \
+            (Dst)[yyi] = (Src)[yyi];            \
+        }                                       \
+      while (0)
+#  endif
+# endif
+#endif /* !YYCOPY_NEEDED */
+
+/* YYFINAL -- State number of the termination state.  */
+#define YYFINAL  3
+/* YYLAST -- Last index in YYTABLE.  */
+#define YYLAST   589
+
+/* YYNTOKENS -- Number of terminals.  */
+#define YYNTOKENS  52
+/* YYNNTS -- Number of nonterminals.  */
+#define YYNNTS  48
+/* YYNRULES -- Number of rules.  */
+#define YYNRULES  115
+/* YYNSTATES -- Number of states.  */
+#define YYNSTATES  220
+
+/* YYMAXUTOK -- Last valid token kind.  */
+#define YYMAXUTOK   287
+
+
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
+
+/* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex.  */
+static const yytype_int8 yytranslate[] =
+{
+       0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,    49,    50,     2,    33,     2,
+      45,    46,    37,    35,    44,    36,     2,    38,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,    41,     2,
+       2,    34,     2,     2,    51,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,    47,     2,    48,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,    42,    32,    43,    40,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     1,     2,     3,     4,
+       5,     6,     7,     8,     9,    10,    11,    12,    13,    14,
+      15,    16,    17,    18,    19,    20,    21,    22,    23,    24,
+      25,    26,    27,    28,    29,    30,    31,    39
+};
+
+#if YYDEBUG
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+static const yytype_int16 yyrline[] =
+{
+       0,    78,    78,    81,    82,    86,    90,    91,    95,    96,
+     100,   101,   105,   106,   110,   111,   115,   116,   120,   121,
+     125,   126,   130,   131,   132,   136,   137,   141,   142,   146,
+     147,   151,   152,   156,   157,   161,   162,   163,   167,   168,
+     169,   173,   174,   178,   181,   186,   191,   192,   196,   197,
+     200,   204,   205,   208,   209,   213,   217,   218,   222,   223,
+     224,   225,   226,   227,   228,   232,   237,   240,   243,   244,
+     248,   250,   256,   261,   266,   270,   274,   277,   281,   282,
+     283,   287,   288,   292,   293,   297,   298,   302,   303,   307,
+     308,   309,   310,   311,   312,   313,   314,   315,   316,   317,
+     318,   319,   320,   321,   322,   323,   324,   325,   329,   330,
+     332,   336,   337,   341,   342,   346
+};
+#endif
+
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if YYDEBUG || 0
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
+/* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
+   First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
+static const char *const yytname[] =
+{
+  "\"end of file\"", "error", "\"invalid token\"", "NUMBER", "REL_OP",
+  "STRING_CONSTANT", "FILENAME", "IDENTIFIER", "AND", "BREAK", "CLASSVARS",
+  "CONSTANTS", "CONTINUE", "ELSE", "FOR", "IF", "IN", "IS", "LOCAL",
+  "MESSAGES", "MOD", "NOT", "OR", "PROPAGATE", "PROPERTIES", "RESOURCES",
+  "RETURN", "WHILE", "END", "EOL", "SEP", "INCLUDE", "'|'", "'&'", "'='",
+  "'+'", "'-'", "'*'", "'/'", "UMINUS", "'~'", "':'", "'{'", "'}'", "','",
+  "'('", "')'", "'['", "']'", "'#'", "'$'", "'@'", "$accept", "Start",
+  "Classes", "Class", "end_junk", "Class_Signature", "Constants_Block",
+  "Resources_Block", "Classvars_Block", "Properties_Block",
+  "Messages_Block", "constants_list", "constant_assign", "resource_list",
+  "resource", "resource_const", "classvar_list", "property_list",
+  "classvar", "property", "message_handler_list", "message_handler",
+  "message_header", "locals", "vars", "var", "parameter_list",
+  "param_list2", "parameter", "statement_list", "statement", "if_stmt",
+  "assign_stmt", "for_stmt", "loop_variable", "while_stmt", "start_loop",
+  "end_loop", "call", "expression_list", "argument_list", "arg_list2",
+  "argument", "expression", "constant", "fname", "literal", "id", YY_NULLPTR
+};
+
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
+{
+  return yytname[yysymbol];
+}
+#endif
+
+#define YYPACT_NINF (-145)
+
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
+
+#define YYTABLE_NINF (-18)
+
+#define yytable_value_is_error(Yyn) \
+  0
+
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
+static const yytype_int16 yypact[] =
+{
+    -145,    17,    33,  -145,  -145,  -145,    13,   -11,     5,    27,
+      33,  -145,    36,    21,    65,    49,  -145,    60,    58,    79,
+    -145,   558,  -145,    80,    67,    92,    86,    99,  -145,    82,
+       3,  -145,    90,    84,    93,  -145,  -145,  -145,   100,   232,
+     107,  -145,   104,    25,  -145,  -145,   112,  -145,  -145,  -145,
+    -145,   232,    33,   232,   232,   232,   130,  -145,    33,  -145,
+     110,  -145,  -145,   105,  -145,   150,   120,  -145,    42,    44,
+      33,  -145,  -145,  -145,  -145,  -145,     1,  -145,    53,   493,
+    -145,   232,   232,   232,   232,  -145,   232,   232,   232,   232,
+     232,   232,   232,    77,  -145,  -145,   132,  -145,  -145,  -145,
+     232,   136,  -145,    45,  -145,     6,   114,  -145,   232,  -145,
+     147,   501,  -145,   512,   520,   225,   147,    -8,    -8,  -145,
+    -145,  -145,    33,    37,  -145,   493,  -145,   417,  -145,  -145,
+     232,   126,   151,    -4,  -145,   493,   138,   183,  -145,  -145,
+     436,   151,    33,  -145,  -145,    56,  -145,   142,   232,  -145,
+    -145,  -145,   -28,  -145,  -145,   243,    33,  -145,   232,   493,
+     266,  -145,    33,   149,   157,   159,    33,   232,   161,   191,
+     232,    99,  -145,  -145,  -145,  -145,  -145,  -145,   162,   -20,
+    -145,   493,  -145,  -145,  -145,  -145,  -145,   177,  -145,   356,
+    -145,  -145,   455,   377,   165,  -145,   232,   232,  -145,  -145,
+    -145,  -145,   474,   396,   293,  -145,  -145,  -145,   184,   303,
+    -145,   163,  -145,   330,  -145,  -145,  -145,   340,  -145,  -145
+};
+
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
+static const yytype_int8 yydefact[] =
+{
+       3,     0,     2,     1,   115,     4,    10,     0,     0,    12,
+       0,     8,     0,     0,    14,     0,    20,     0,     0,    16,
+       9,     0,    25,     0,     0,    18,     0,     0,    21,     0,
+       0,    31,     0,     0,     0,    24,   111,   112,     0,     0,
+       0,    26,     0,     0,    33,    41,     6,     5,    23,   108,
+     110,     0,     0,     0,     0,     0,     0,   109,     0,   105,
+       0,   103,   104,   106,    28,     0,     0,    32,     0,     0,
+      19,     7,   101,   113,   100,   102,     0,    79,     0,    81,
+     114,     0,     0,     0,     0,    22,     0,     0,     0,     0,
+       0,     0,     0,     0,    78,    29,     0,    30,    37,    36,
+       0,     0,    34,     0,    42,     0,     0,   107,     0,    80,
+      91,    89,    97,    90,    99,    98,    92,    93,    94,    95,
+      96,    83,     0,     0,    85,    87,    27,     0,    40,    39,
+       0,     0,    46,     0,    45,    82,     0,     0,    84,    35,
+       0,    46,     0,    56,    51,     0,    53,     0,     0,    86,
+      38,    56,     0,    48,    50,     0,     0,    52,     0,    88,
+       0,    47,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,    43,    57,    59,    60,    61,    62,     0,     0,
+      54,    55,    44,    49,    69,    66,    67,     0,    74,     0,
+      63,    65,     0,     0,     0,    58,     0,     0,    56,    64,
+      76,    68,     0,     0,     0,    56,    72,    76,    70,     0,
+      56,     0,    77,     0,    56,    75,    77,     0,    73,    71
+};
+
+/* YYPGOTO[NTERM-NUM].  */
+static const yytype_int16 yypgoto[] =
+{
+    -145,  -145,  -145,  -145,  -145,  -145,  -145,  -145,  -145,  -145,
+    -145,  -145,  -145,  -145,  -145,  -145,  -145,  -145,  -145,  -145,
+    -145,  -145,  -145,    62,  -145,    46,  -145,  -145,    43,  -144,
+    -145,  -145,  -145,  -145,  -145,  -145,    -1,    -7,  -140,  -145,
+    -145,  -145,    73,     4,  -145,   -64,  -145,    -2
+};
+
+/* YYDEFGOTO[NTERM-NUM].  */
+static const yytype_uint8 yydefgoto[] =
+{
+       0,     1,     2,     5,    47,     6,     9,    14,    19,    25,
+      34,    21,    28,    30,    41,    96,    43,    69,    67,   102,
+      70,   104,   105,   143,   152,   153,   134,   145,   146,   155,
+     173,   174,   175,   176,   187,   177,   205,   215,    59,    78,
+      94,   123,   124,   125,    61,    38,    62,    63
+};
+
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
+static const yytype_int16 yytable[] =
+{
+       7,    97,   161,     4,    40,    81,    10,   160,    15,    82,
+       4,   131,    83,   -13,   196,   178,   162,     3,    11,    29,
+     178,    83,   -13,    84,     8,    93,    66,   -13,    42,    91,
+      92,   -13,     4,    86,    87,    88,    89,    90,    91,    92,
+       4,    68,   144,    60,   -15,   101,    12,   107,   132,   -15,
+      73,     4,    13,   -15,   204,    72,    80,    74,    75,    76,
+      79,   209,    17,   -17,   178,    16,   213,   103,   106,   178,
+     217,    99,   -17,   178,   129,    18,   100,   178,    20,   130,
+      49,   137,    50,   138,     4,   110,   111,   112,   113,    22,
+     114,   115,   116,   117,   118,   119,   120,   108,    51,    23,
+     156,   109,   157,    24,   127,    36,    37,   194,    32,    31,
+      52,    33,   135,    53,    81,    35,    39,    54,    82,    44,
+     136,    46,    55,   121,    56,    45,   122,    57,    58,    48,
+      83,   147,    84,    49,   140,    50,    64,     4,    65,    85,
+     154,    71,    86,    87,    88,    89,    90,    91,    92,    98,
+      93,    51,   159,   179,   147,    95,    36,    37,   179,   133,
+     154,   126,   181,    52,   188,   128,    53,    83,   141,   142,
+      54,   189,   148,   192,   193,    55,   158,    56,    77,   184,
+      57,    58,    89,    90,    91,    92,    49,   185,    50,   186,
+       4,   190,   195,   197,    49,   201,    50,   211,     4,   180,
+     202,   203,   179,   151,    51,   214,   210,   179,   183,   218,
+     149,   179,    51,     0,     0,   179,    52,     0,     0,    53,
+       0,   191,     0,    54,    52,     0,     0,    53,    55,    81,
+      56,    54,   122,    57,    58,    49,    55,    50,    56,     4,
+       0,    57,    58,     0,   163,    83,     0,     0,     0,     0,
+       4,     0,   164,    51,     0,   165,     0,   166,   167,    88,
+      89,    90,    91,    92,     0,    52,   168,   163,    53,   169,
+     170,     0,    54,     4,   171,   164,     0,    55,   165,    56,
+     166,   167,    57,    58,     0,     0,   172,     0,     0,   168,
+      56,     0,   169,   170,   163,     0,     0,   171,     0,     0,
+       4,     0,   164,     0,   163,   165,     0,   166,   167,   182,
+       4,     0,   164,    56,     0,   165,   168,   166,   167,   169,
+     170,     0,     0,     0,   171,     0,   168,     0,     0,   169,
+     170,   163,     0,     0,   171,     0,   208,     4,     0,   164,
+      56,   163,   165,     0,   166,   167,   212,     4,     0,   164,
+      56,     0,   165,   168,   166,   167,   169,   170,     0,     0,
+      81,   171,     0,   168,    82,     0,   169,   170,     0,     0,
+       0,   171,     0,   216,     0,     0,    83,    56,    84,     0,
+       0,    81,     0,   219,     0,    82,     0,    56,    86,    87,
+      88,    89,    90,    91,    92,     0,     0,    83,   198,    84,
+      81,     0,     0,     0,    82,     0,     0,     0,     0,    86,
+      87,    88,    89,    90,    91,    92,    83,     0,    84,   200,
+       0,    81,     0,     0,     0,    82,     0,     0,    86,    87,
+      88,    89,    90,    91,    92,     0,     0,    83,   207,    84,
+      81,     0,     0,     0,    82,     0,   139,     0,     0,    86,
+      87,    88,    89,    90,    91,    92,    83,     0,    84,    81,
+       0,     0,     0,    82,     0,   150,     0,     0,    86,    87,
+      88,    89,    90,    91,    92,    83,     0,    84,    81,     0,
+       0,     0,    82,     0,     0,   199,     0,    86,    87,    88,
+      89,    90,    91,    92,    83,     0,    84,    81,     0,     0,
+       0,    82,     0,     0,   206,    81,    86,    87,    88,    89,
+      90,    91,    92,    83,     0,    84,    81,     0,     0,     0,
+      82,    83,     0,     0,    81,    86,    87,    88,    89,    90,
+      91,    92,    83,    86,    87,    88,    89,    90,    91,    92,
+      83,     0,     0,     0,    86,    87,    88,    89,    90,    91,
+      92,     0,     0,    87,    88,    89,    90,    91,    92,    26,
+       0,     0,     0,     0,     0,     4,     0,     0,   -11,     0,
+       0,     0,     0,     0,     0,     0,     0,   -11,     0,     0,
+       0,     0,   -11,   -11,     0,     0,   -11,     0,     0,    27
+};
+
+static const yytype_int16 yycheck[] =
+{
+       2,    65,    30,     7,     1,     4,    17,   151,    10,     8,
+       7,     5,    20,    10,    34,   155,    44,     0,    29,    21,
+     160,    20,    19,    22,    11,    45,     1,    24,    30,    37,
+      38,    28,     7,    32,    33,    34,    35,    36,    37,    38,
+       7,    43,    46,    39,    19,     1,    41,    46,    42,    24,
+      52,     7,    25,    28,   198,    51,    58,    53,    54,    55,
+      56,   205,    41,    19,   204,    29,   210,    69,    70,   209,
+     214,    29,    28,   213,    29,    10,    34,   217,    29,    34,
+       3,    44,     5,    46,     7,    81,    82,    83,    84,    29,
+      86,    87,    88,    89,    90,    91,    92,    44,    21,    41,
+      44,    48,    46,    24,   100,     6,     7,   171,    41,    29,
+      33,    19,   108,    36,     4,    29,    34,    40,     8,    29,
+     122,    28,    45,    46,    47,    41,    49,    50,    51,    29,
+      20,   133,    22,     3,   130,     5,    29,     7,    34,    29,
+     142,    29,    32,    33,    34,    35,    36,    37,    38,    29,
+      45,    21,   148,   155,   156,     5,     6,     7,   160,    45,
+     162,    29,   158,    33,   166,    29,    36,    20,    42,    18,
+      40,   167,    34,   169,   170,    45,    34,    47,    48,    30,
+      50,    51,    35,    36,    37,    38,     3,    30,     5,    30,
+       7,    30,    30,    16,     3,    30,     5,    13,     7,   156,
+     196,   197,   204,   141,    21,    42,   207,   209,   162,   216,
+     137,   213,    21,    -1,    -1,   217,    33,    -1,    -1,    36,
+      -1,    30,    -1,    40,    33,    -1,    -1,    36,    45,     4,
+      47,    40,    49,    50,    51,     3,    45,     5,    47,     7,
+      -1,    50,    51,    -1,     1,    20,    -1,    -1,    -1,    -1,
+       7,    -1,     9,    21,    -1,    12,    -1,    14,    15,    34,
+      35,    36,    37,    38,    -1,    33,    23,     1,    36,    26,
+      27,    -1,    40,     7,    31,     9,    -1,    45,    12,    47,
+      14,    15,    50,    51,    -1,    -1,    43,    -1,    -1,    23,
+      47,    -1,    26,    27,     1,    -1,    -1,    31,    -1,    -1,
+       7,    -1,     9,    -1,     1,    12,    -1,    14,    15,    43,
+       7,    -1,     9,    47,    -1,    12,    23,    14,    15,    26,
+      27,    -1,    -1,    -1,    31,    -1,    23,    -1,    -1,    26,
+      27,     1,    -1,    -1,    31,    -1,    43,     7,    -1,     9,
+      47,     1,    12,    -1,    14,    15,    43,     7,    -1,     9,
+      47,    -1,    12,    23,    14,    15,    26,    27,    -1,    -1,
+       4,    31,    -1,    23,     8,    -1,    26,    27,    -1,    -1,
+      -1,    31,    -1,    43,    -1,    -1,    20,    47,    22,    -1,
+      -1,     4,    -1,    43,    -1,     8,    -1,    47,    32,    33,
+      34,    35,    36,    37,    38,    -1,    -1,    20,    42,    22,
+       4,    -1,    -1,    -1,     8,    -1,    -1,    -1,    -1,    32,
+      33,    34,    35,    36,    37,    38,    20,    -1,    22,    42,
+      -1,     4,    -1,    -1,    -1,     8,    -1,    -1,    32,    33,
+      34,    35,    36,    37,    38,    -1,    -1,    20,    42,    22,
+       4,    -1,    -1,    -1,     8,    -1,    29,    -1,    -1,    32,
+      33,    34,    35,    36,    37,    38,    20,    -1,    22,     4,
+      -1,    -1,    -1,     8,    -1,    29,    -1,    -1,    32,    33,
+      34,    35,    36,    37,    38,    20,    -1,    22,     4,    -1,
+      -1,    -1,     8,    -1,    -1,    30,    -1,    32,    33,    34,
+      35,    36,    37,    38,    20,    -1,    22,     4,    -1,    -1,
+      -1,     8,    -1,    -1,    30,     4,    32,    33,    34,    35,
+      36,    37,    38,    20,    -1,    22,     4,    -1,    -1,    -1,
+       8,    20,    -1,    -1,     4,    32,    33,    34,    35,    36,
+      37,    38,    20,    32,    33,    34,    35,    36,    37,    38,
+      20,    -1,    -1,    -1,    32,    33,    34,    35,    36,    37,
+      38,    -1,    -1,    33,    34,    35,    36,    37,    38,     1,
+      -1,    -1,    -1,    -1,    -1,     7,    -1,    -1,    10,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    19,    -1,    -1,
+      -1,    -1,    24,    25,    -1,    -1,    28,    -1,    -1,    31
+};
+
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_int8 yystos[] =
+{
+       0,    53,    54,     0,     7,    55,    57,    99,    11,    58,
+      17,    29,    41,    25,    59,    99,    29,    41,    10,    60,
+      29,    63,    29,    41,    24,    61,     1,    31,    64,    99,
+      65,    29,    41,    19,    62,    29,     6,     7,    97,    34,
+       1,    66,    99,    68,    29,    41,    28,    56,    29,     3,
+       5,    21,    33,    36,    40,    45,    47,    50,    51,    90,
+      95,    96,    98,    99,    29,    34,     1,    70,    99,    69,
+      72,    29,    95,    99,    95,    95,    95,    48,    91,    95,
+      99,     4,     8,    20,    22,    29,    32,    33,    34,    35,
+      36,    37,    38,    45,    92,     5,    67,    97,    29,    29,
+      34,     1,    71,    99,    73,    74,    99,    46,    44,    48,
+      95,    95,    95,    95,    95,    95,    95,    95,    95,    95,
+      95,    46,    49,    93,    94,    95,    29,    95,    29,    29,
+      34,     5,    42,    45,    78,    95,    99,    44,    46,    29,
+      95,    42,    18,    75,    46,    79,    80,    99,    34,    94,
+      29,    75,    76,    77,    99,    81,    44,    46,    34,    95,
+      81,    30,    44,     1,     9,    12,    14,    15,    23,    26,
+      27,    31,    43,    82,    83,    84,    85,    87,    90,    99,
+      80,    95,    43,    77,    30,    30,    30,    86,    99,    95,
+      30,    30,    95,    95,    97,    30,    34,    16,    42,    30,
+      42,    30,    95,    95,    81,    88,    30,    42,    43,    81,
+      88,    13,    43,    81,    42,    89,    43,    81,    89,    43
+};
+
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr1[] =
+{
+       0,    52,    53,    54,    54,    55,    56,    56,    57,    57,
+      58,    58,    59,    59,    60,    60,    61,    61,    62,    62,
+      63,    63,    64,    64,    64,    65,    65,    66,    66,    67,
+      67,    68,    68,    69,    69,    70,    70,    70,    71,    71,
+      71,    72,    72,    73,    73,    74,    75,    75,    76,    76,
+      77,    78,    78,    79,    79,    80,    81,    81,    82,    82,
+      82,    82,    82,    82,    82,    82,    82,    82,    82,    82,
+      83,    83,    84,    85,    86,    87,    88,    89,    90,    90,
+      90,    91,    91,    92,    92,    93,    93,    94,    94,    95,
+      95,    95,    95,    95,    95,    95,    95,    95,    95,    95,
+      95,    95,    95,    95,    95,    95,    95,    95,    96,    96,
+      96,    97,    97,    98,    98,    99
+};
+
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
+{
+       0,     2,     1,     0,     2,     7,     1,     2,     2,     4,
+       0,     4,     0,     4,     0,     4,     0,     4,     0,     3,
+       0,     2,     4,     3,     2,     0,     2,     4,     2,     1,
+       1,     0,     2,     0,     2,     4,     2,     2,     4,     2,
+       2,     0,     2,     5,     6,     2,     0,     3,     1,     3,
+       1,     2,     3,     1,     3,     3,     0,     2,     2,     1,
+       1,     1,     1,     2,     3,     2,     2,     2,     3,     2,
+       5,     9,     4,     9,     1,     7,     0,     0,     2,     2,
+       3,     1,     3,     2,     3,     1,     3,     1,     4,     3,
+       3,     3,     3,     3,     3,     3,     3,     3,     3,     3,
+       2,     2,     2,     1,     1,     1,     1,     3,     1,     1,
+       1,     1,     1,     2,     2,     1
+};
+
+
+enum { YYENOMEM = -2 };
+
+#define yyerrok         (yyerrstatus = 0)
+#define yyclearin       (yychar = YYEMPTY)
+
+#define YYACCEPT        goto yyacceptlab
+#define YYABORT         goto yyabortlab
+#define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
+
+
+#define YYRECOVERING()  (!!yyerrstatus)
+
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YYEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
+
+
+/* Enable debugging if requested.  */
+#if YYDEBUG
+
+# ifndef YYFPRINTF
+#  include <stdio.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYFPRINTF fprintf
+# endif
+
+# define YYDPRINTF(Args)                        \
+do {                                            \
+  if (yydebug)                                  \
+    YYFPRINTF Args;                             \
+} while (0)
+
+
+
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
+do {                                                                      \
+  if (yydebug)                                                            \
+    {                                                                     \
+      YYFPRINTF (stderr, "%s ", Title);                                   \
+      yy_symbol_print (stderr,                                            \
+                  Kind, Value); \
+      YYFPRINTF (stderr, "\n");                                           \
+    }                                                                     \
+} while (0)
+
+
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
+
+static void
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
+{
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
+  if (!yyvaluep)
+    return;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
+
+static void
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
+{
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
+
+  yy_symbol_value_print (yyo, yykind, yyvaluep);
+  YYFPRINTF (yyo, ")");
+}
+
+/*------------------------------------------------------------------.
+| yy_stack_print -- Print the state stack from its BOTTOM up to its |
+| TOP (included).                                                   |
+`------------------------------------------------------------------*/
+
+static void
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
+{
+  YYFPRINTF (stderr, "Stack now");
+  for (; yybottom <= yytop; yybottom++)
+    {
+      int yybot = *yybottom;
+      YYFPRINTF (stderr, " %d", yybot);
+    }
+  YYFPRINTF (stderr, "\n");
+}
+
+# define YY_STACK_PRINT(Bottom, Top)                            \
+do {                                                            \
+  if (yydebug)                                                  \
+    yy_stack_print ((Bottom), (Top));                           \
+} while (0)
+
+
+/*------------------------------------------------.
+| Report that the YYRULE is going to be reduced.  |
+`------------------------------------------------*/
+
+static void
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
+                 int yyrule)
+{
+  int yylno = yyrline[yyrule];
+  int yynrhs = yyr2[yyrule];
+  int yyi;
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
+             yyrule - 1, yylno);
+  /* The symbols being reduced.  */
+  for (yyi = 0; yyi < yynrhs; yyi++)
+    {
+      YYFPRINTF (stderr, "   $%d = ", yyi + 1);
+      yy_symbol_print (stderr,
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)]);
+      YYFPRINTF (stderr, "\n");
+    }
+}
+
+# define YY_REDUCE_PRINT(Rule)          \
+do {                                    \
+  if (yydebug)                          \
+    yy_reduce_print (yyssp, yyvsp, Rule); \
+} while (0)
+
+/* Nonzero means print parse trace.  It is left uninitialized so that
+   multiple parsers can coexist.  */
+int yydebug;
+#else /* !YYDEBUG */
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
+# define YY_STACK_PRINT(Bottom, Top)
+# define YY_REDUCE_PRINT(Rule)
+#endif /* !YYDEBUG */
+
+
+/* YYINITDEPTH -- initial size of the parser's stacks.  */
+#ifndef YYINITDEPTH
+# define YYINITDEPTH 200
+#endif
+
+/* YYMAXDEPTH -- maximum size the stacks can grow to (effective only
+   if the built-in stack extension method is used).
+
+   Do not make this value too large; the results are undefined if
+   YYSTACK_ALLOC_MAXIMUM < YYSTACK_BYTES (YYMAXDEPTH)
+   evaluated with infinite-precision integer arithmetic.  */
+
+#ifndef YYMAXDEPTH
+# define YYMAXDEPTH 10000
+#endif
+
+
+
+
+
+
+/*-----------------------------------------------.
+| Release the memory associated to this symbol.  |
+`-----------------------------------------------*/
+
+static void
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep)
+{
+  YY_USE (yyvaluep);
+  if (!yymsg)
+    yymsg = "Deleting";
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+/* Lookahead token kind.  */
+int yychar;
+
+/* The semantic value of the lookahead symbol.  */
+YYSTYPE yylval;
+/* Number of syntax errors so far.  */
+int yynerrs;
+
+
+
+
+/*----------.
+| yyparse.  |
+`----------*/
+
+int
+yyparse (void)
+{
+    yy_state_fast_t yystate = 0;
+    /* Number of tokens to shift before error messages enabled.  */
+    int yyerrstatus = 0;
+
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
+       to reallocate them elsewhere.  */
+
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
+
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
+
+    /* The semantic value stack: array, bottom, top.  */
+    YYSTYPE yyvsa[YYINITDEPTH];
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
+
+  int yyn;
+  /* The return value of yyparse.  */
+  int yyresult;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
+  /* The variables used to return semantic value and location from the
+     action routines.  */
+  YYSTYPE yyval;
+
+
+
+#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
+
+  /* The number of symbols on the RHS of the reduced rule.
+     Keep to zero when no symbol should be popped.  */
+  int yylen = 0;
+
+  YYDPRINTF ((stderr, "Starting parse\n"));
+
+  yychar = YYEMPTY; /* Cause a token to be read.  */
+
+  goto yysetstate;
+
+
+/*------------------------------------------------------------.
+| yynewstate -- push a new state, which is found in yystate.  |
+`------------------------------------------------------------*/
+yynewstate:
+  /* In all cases, when you get here, the value and location stacks
+     have just been pushed.  So pushing a state here evens the stacks.  */
+  yyssp++;
+
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
+yysetstate:
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
+
+  if (yyss + yystacksize - 1 <= yyssp)
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
+#else
+    {
+      /* Get the current used size of the three stacks, in elements.  */
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
+
+# if defined yyoverflow
+      {
+        /* Give user a chance to reallocate the stack.  Use copies of
+           these so that the &'s don't force the real ones into
+           memory.  */
+        yy_state_t *yyss1 = yyss;
+        YYSTYPE *yyvs1 = yyvs;
+
+        /* Each stack pointer address is followed by the size of the
+           data in use in that stack, in bytes.  This used to be a
+           conditional around just the two extra args, but that might
+           be undefined if yyoverflow is a macro.  */
+        yyoverflow (YY_("memory exhausted"),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
+                    &yystacksize);
+        yyss = yyss1;
+        yyvs = yyvs1;
+      }
+# else /* defined YYSTACK_RELOCATE */
+      /* Extend the stack our own way.  */
+      if (YYMAXDEPTH <= yystacksize)
+        YYNOMEM;
+      yystacksize *= 2;
+      if (YYMAXDEPTH < yystacksize)
+        yystacksize = YYMAXDEPTH;
+
+      {
+        yy_state_t *yyss1 = yyss;
+        union yyalloc *yyptr =
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
+        if (! yyptr)
+          YYNOMEM;
+        YYSTACK_RELOCATE (yyss_alloc, yyss);
+        YYSTACK_RELOCATE (yyvs_alloc, yyvs);
+#  undef YYSTACK_RELOCATE
+        if (yyss1 != yyssa)
+          YYSTACK_FREE (yyss1);
+      }
+# endif
+
+      yyssp = yyss + yysize - 1;
+      yyvsp = yyvs + yysize - 1;
+
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
+
+      if (yyss + yystacksize - 1 <= yyssp)
+        YYABORT;
+    }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
+
+
+  if (yystate == YYFINAL)
+    YYACCEPT;
+
+  goto yybackup;
+
+
+/*-----------.
+| yybackup.  |
+`-----------*/
+yybackup:
+  /* Do appropriate processing given the current state.  Read a
+     lookahead token if we need one and don't already have one.  */
+
+  /* First try to decide what to do without reference to lookahead token.  */
+  yyn = yypact[yystate];
+  if (yypact_value_is_default (yyn))
+    goto yydefault;
+
+  /* Not known => get a lookahead token if don't already have one.  */
+
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
+  if (yychar == YYEMPTY)
+    {
+      YYDPRINTF ((stderr, "Reading a token\n"));
+      yychar = yylex ();
+    }
+
+  if (yychar <= YYEOF)
+    {
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
+      YYDPRINTF ((stderr, "Now at end of input.\n"));
+    }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      goto yyerrlab1;
+    }
+  else
+    {
+      yytoken = YYTRANSLATE (yychar);
+      YY_SYMBOL_PRINT ("Next token is", yytoken, &yylval, &yylloc);
+    }
+
+  /* If the proper action on seeing token YYTOKEN is to reduce or to
+     detect an error, take that action.  */
+  yyn += yytoken;
+  if (yyn < 0 || YYLAST < yyn || yycheck[yyn] != yytoken)
+    goto yydefault;
+  yyn = yytable[yyn];
+  if (yyn <= 0)
+    {
+      if (yytable_value_is_error (yyn))
+        goto yyerrlab;
+      yyn = -yyn;
+      goto yyreduce;
+    }
+
+  /* Count tokens shifted since error; after three, turn off error
+     status.  */
+  if (yyerrstatus)
+    yyerrstatus--;
+
+  /* Shift the lookahead token.  */
+  YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
+  yystate = yyn;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+
+  /* Discard the shifted token.  */
+  yychar = YYEMPTY;
+  goto yynewstate;
+
+
+/*-----------------------------------------------------------.
+| yydefault -- do the default action for the current state.  |
+`-----------------------------------------------------------*/
+yydefault:
+  yyn = yydefact[yystate];
+  if (yyn == 0)
+    goto yyerrlab;
+  goto yyreduce;
+
+
+/*-----------------------------.
+| yyreduce -- do a reduction.  |
+`-----------------------------*/
+yyreduce:
+  /* yyn is the number of a rule to reduce with.  */
+  yylen = yyr2[yyn];
+
+  /* If YYLEN is nonzero, implement the default value of the action:
+     '$$ = $1'.
+
+     Otherwise, the following line sets YYVAL to garbage.
+     This behavior is undocumented and Bison
+     users should not rely upon it.  Assigning to YYVAL
+     unconditionally makes the parser a bit smaller, and it avoids a
+     GCC warning that YYVAL may be used uninitialized.  */
+  yyval = yyvsp[1-yylen];
+
+
+  YY_REDUCE_PRINT (yyn);
+  switch (yyn)
+    {
+  case 2: /* Start: Classes  */
+#line 78 "./blakcomp.y"
+                                {}
+#line 1387 "debug/blakcomp.tab.c"
+    break;
+
+  case 3: /* Classes: %empty  */
+#line 81 "./blakcomp.y"
+                                { (yyval.int_val) = 0; }
+#line 1393 "debug/blakcomp.tab.c"
+    break;
+
+  case 4: /* Classes: Classes Class  */
+#line 82 "./blakcomp.y"
+                                { (yyval.int_val) = 0; }
+#line 1399 "debug/blakcomp.tab.c"
+    break;
+
+  case 5: /* Class: Class_Signature Constants_Block Resources_Block Classvars_Block Properties_Block Messages_Block end_junk  */
+#line 87 "./blakcomp.y"
+                { (yyval.class_val) = make_class((yyvsp[-6].class_val), (yyvsp[-4].list_val), (yyvsp[-3].list_val), (yyvsp[-2].list_val), (yyvsp[-1].list_val)); }
+#line 1405 "debug/blakcomp.tab.c"
+    break;
+
+  case 8: /* Class_Signature: id EOL  */
+#line 95 "./blakcomp.y"
+                                { (yyval.class_val) = make_class_signature((yyvsp[-1].id_val), NULL); }
+#line 1411 "debug/blakcomp.tab.c"
+    break;
+
+  case 9: /* Class_Signature: id IS id EOL  */
+#line 96 "./blakcomp.y"
+                                { (yyval.class_val) = make_class_signature((yyvsp[-3].id_val), (yyvsp[-1].id_val)); }
+#line 1417 "debug/blakcomp.tab.c"
+    break;
+
+  case 10: /* Constants_Block: %empty  */
+#line 100 "./blakcomp.y"
+                                                        { (yyval.int_val) = 0; }
+#line 1423 "debug/blakcomp.tab.c"
+    break;
+
+  case 11: /* Constants_Block: CONSTANTS ':' EOL constants_list  */
+#line 101 "./blakcomp.y"
+                                                        { (yyval.int_val) = 0; }
+#line 1429 "debug/blakcomp.tab.c"
+    break;
+
+  case 12: /* Resources_Block: %empty  */
+#line 105 "./blakcomp.y"
+                                                        { (yyval.list_val) = NULL; }
+#line 1435 "debug/blakcomp.tab.c"
+    break;
+
+  case 13: /* Resources_Block: RESOURCES ':' EOL resource_list  */
+#line 106 "./blakcomp.y"
+                                                        { (yyval.list_val) = (yyvsp[0].list_val); }
+#line 1441 "debug/blakcomp.tab.c"
+    break;
+
+  case 14: /* Classvars_Block: %empty  */
+#line 110 "./blakcomp.y"
+                                                        { (yyval.list_val) = NULL; }
+#line 1447 "debug/blakcomp.tab.c"
+    break;
+
+  case 15: /* Classvars_Block: CLASSVARS ':' EOL classvar_list  */
+#line 111 "./blakcomp.y"
+                                                       { (yyval.list_val) = (yyvsp[0].list_val); }
+#line 1453 "debug/blakcomp.tab.c"
+    break;
+
+  case 16: /* Properties_Block: %empty  */
+#line 115 "./blakcomp.y"
+                                                        { (yyval.list_val) = NULL; }
+#line 1459 "debug/blakcomp.tab.c"
+    break;
+
+  case 17: /* Properties_Block: PROPERTIES ':' EOL property_list  */
+#line 116 "./blakcomp.y"
+                                                        { (yyval.list_val) = (yyvsp[0].list_val); }
+#line 1465 "debug/blakcomp.tab.c"
+    break;
+
+  case 18: /* Messages_Block: %empty  */
+#line 120 "./blakcomp.y"
+                                                        { (yyval.list_val) = NULL; }
+#line 1471 "debug/blakcomp.tab.c"
+    break;
+
+  case 19: /* Messages_Block: MESSAGES ':' message_handler_list  */
+#line 121 "./blakcomp.y"
+                                                        { (yyval.list_val) = (yyvsp[0].list_val); }
+#line 1477 "debug/blakcomp.tab.c"
+    break;
+
+  case 20: /* constants_list: %empty  */
+#line 125 "./blakcomp.y"
+                                                { (yyval.int_val) = 0; }
+#line 1483 "debug/blakcomp.tab.c"
+    break;
+
+  case 21: /* constants_list: constants_list constant_assign  */
+#line 126 "./blakcomp.y"
+                                                { (yyval.int_val) = 0; }
+#line 1489 "debug/blakcomp.tab.c"
+    break;
+
+  case 22: /* constant_assign: id '=' expression EOL  */
+#line 130 "./blakcomp.y"
+                                        { (yyval.int_val) = 0; make_constant_id((yyvsp[-3].id_val), (yyvsp[-1].expr_val)); }
+#line 1495 "debug/blakcomp.tab.c"
+    break;
+
+  case 23: /* constant_assign: INCLUDE fname EOL  */
+#line 131 "./blakcomp.y"
+                                        { include_file((yyvsp[-1].string_val)); }
+#line 1501 "debug/blakcomp.tab.c"
+    break;
+
+  case 24: /* constant_assign: error EOL  */
+#line 132 "./blakcomp.y"
+                                        { (yyval.int_val) = 0; }
+#line 1507 "debug/blakcomp.tab.c"
+    break;
+
+  case 25: /* resource_list: %empty  */
+#line 136 "./blakcomp.y"
+                                        { (yyval.list_val) = NULL; }
+#line 1513 "debug/blakcomp.tab.c"
+    break;
+
+  case 26: /* resource_list: resource_list resource  */
+#line 137 "./blakcomp.y"
+                                        { (yyval.list_val) = list_add_item((yyvsp[-1].list_val), (yyvsp[0].resource_val)); }
+#line 1519 "debug/blakcomp.tab.c"
+    break;
+
+  case 27: /* resource: id '=' resource_const EOL  */
+#line 141 "./blakcomp.y"
+                                                { (yyval.resource_val) = make_resource((yyvsp[-3].id_val), (yyvsp[-1].const_val)); }
+#line 1525 "debug/blakcomp.tab.c"
+    break;
+
+  case 28: /* resource: error EOL  */
+#line 142 "./blakcomp.y"
+                                                { (yyval.resource_val) = NULL; }
+#line 1531 "debug/blakcomp.tab.c"
+    break;
+
+  case 29: /* resource_const: STRING_CONSTANT  */
+#line 146 "./blakcomp.y"
+                                { (yyval.const_val) = make_string_resource((yyvsp[0].string_val)); }
+#line 1537 "debug/blakcomp.tab.c"
+    break;
+
+  case 30: /* resource_const: fname  */
+#line 147 "./blakcomp.y"
+                                { (yyval.const_val) = make_fname_resource((yyvsp[0].string_val)); }
+#line 1543 "debug/blakcomp.tab.c"
+    break;
+
+  case 31: /* classvar_list: %empty  */
+#line 151 "./blakcomp.y"
+                                        { (yyval.list_val) = NULL; }
+#line 1549 "debug/blakcomp.tab.c"
+    break;
+
+  case 32: /* classvar_list: classvar_list classvar  */
+#line 152 "./blakcomp.y"
+                                        { (yyval.list_val) = list_add_item((yyvsp[-1].list_val), (yyvsp[0].classvar_val)); }
+#line 1555 "debug/blakcomp.tab.c"
+    break;
+
+  case 33: /* property_list: %empty  */
+#line 156 "./blakcomp.y"
+                                        { (yyval.list_val) = NULL; }
+#line 1561 "debug/blakcomp.tab.c"
+    break;
+
+  case 34: /* property_list: property_list property  */
+#line 157 "./blakcomp.y"
+                                        { (yyval.list_val) = list_add_item((yyvsp[-1].list_val), (yyvsp[0].prop_val)); }
+#line 1567 "debug/blakcomp.tab.c"
+    break;
+
+  case 35: /* classvar: id '=' expression EOL  */
+#line 161 "./blakcomp.y"
+                                        { (yyval.classvar_val) = make_classvar((yyvsp[-3].id_val), (yyvsp[-1].expr_val)); }
+#line 1573 "debug/blakcomp.tab.c"
+    break;
+
+  case 36: /* classvar: id EOL  */
+#line 162 "./blakcomp.y"
+                                        { (yyval.classvar_val) = make_classvar((yyvsp[-1].id_val), make_expr_from_constant(make_nil_constant())); }
+#line 1579 "debug/blakcomp.tab.c"
+    break;
+
+  case 37: /* classvar: error EOL  */
+#line 163 "./blakcomp.y"
+                                        { (yyval.classvar_val) = NULL; }
+#line 1585 "debug/blakcomp.tab.c"
+    break;
+
+  case 38: /* property: id '=' expression EOL  */
+#line 167 "./blakcomp.y"
+                                        { (yyval.prop_val) = make_property((yyvsp[-3].id_val), (yyvsp[-1].expr_val)); }
+#line 1591 "debug/blakcomp.tab.c"
+    break;
+
+  case 39: /* property: id EOL  */
+#line 168 "./blakcomp.y"
+                                        { (yyval.prop_val) = make_property((yyvsp[-1].id_val), make_expr_from_constant(make_nil_constant())); }
+#line 1597 "debug/blakcomp.tab.c"
+    break;
+
+  case 40: /* property: error EOL  */
+#line 169 "./blakcomp.y"
+                                        { (yyval.prop_val) = NULL; }
+#line 1603 "debug/blakcomp.tab.c"
+    break;
+
+  case 41: /* message_handler_list: %empty  */
+#line 173 "./blakcomp.y"
+                                                { (yyval.list_val) = NULL; }
+#line 1609 "debug/blakcomp.tab.c"
+    break;
+
+  case 42: /* message_handler_list: message_handler_list message_handler  */
+#line 174 "./blakcomp.y"
+                                                        { (yyval.list_val) = list_add_item((yyvsp[-1].list_val), (yyvsp[0].handler_val)); }
+#line 1615 "debug/blakcomp.tab.c"
+    break;
+
+  case 43: /* message_handler: message_header '{' locals statement_list '}'  */
+#line 179 "./blakcomp.y"
+                { (yyval.handler_val) = make_message_handler((yyvsp[-4].header_val), NULL, (yyvsp[-2].list_val), (yyvsp[-1].list_val)); }
+#line 1621 "debug/blakcomp.tab.c"
+    break;
+
+  case 44: /* message_handler: message_header STRING_CONSTANT '{' locals statement_list '}'  */
+#line 182 "./blakcomp.y"
+                { (yyval.handler_val) = make_message_handler((yyvsp[-5].header_val), (yyvsp[-4].string_val), (yyvsp[-2].list_val), (yyvsp[-1].list_val)); }
+#line 1627 "debug/blakcomp.tab.c"
+    break;
+
+  case 45: /* message_header: id parameter_list  */
+#line 187 "./blakcomp.y"
+                { (yyval.header_val) = make_message_header((yyvsp[-1].id_val), (yyvsp[0].list_val)); }
+#line 1633 "debug/blakcomp.tab.c"
+    break;
+
+  case 46: /* locals: %empty  */
+#line 191 "./blakcomp.y"
+                                { (yyval.list_val) = NULL; }
+#line 1639 "debug/blakcomp.tab.c"
+    break;
+
+  case 47: /* locals: LOCAL vars SEP  */
+#line 192 "./blakcomp.y"
+                                { (yyval.list_val) = (yyvsp[-1].list_val); }
+#line 1645 "debug/blakcomp.tab.c"
+    break;
+
+  case 48: /* vars: var  */
+#line 196 "./blakcomp.y"
+                                { (yyval.list_val) = list_add_item(NULL, (yyvsp[0].id_val)); }
+#line 1651 "debug/blakcomp.tab.c"
+    break;
+
+  case 49: /* vars: vars ',' var  */
+#line 197 "./blakcomp.y"
+                                { (yyval.list_val) = list_add_item((yyvsp[-2].list_val), (yyvsp[0].id_val)); }
+#line 1657 "debug/blakcomp.tab.c"
+    break;
+
+  case 50: /* var: id  */
+#line 200 "./blakcomp.y"
+                                { (yyval.id_val) = make_var((yyvsp[0].id_val)); }
+#line 1663 "debug/blakcomp.tab.c"
+    break;
+
+  case 51: /* parameter_list: '(' ')'  */
+#line 204 "./blakcomp.y"
+                                        { (yyval.list_val) = NULL; }
+#line 1669 "debug/blakcomp.tab.c"
+    break;
+
+  case 52: /* parameter_list: '(' param_list2 ')'  */
+#line 205 "./blakcomp.y"
+                                        { (yyval.list_val) = (yyvsp[-1].list_val); }
+#line 1675 "debug/blakcomp.tab.c"
+    break;
+
+  case 53: /* param_list2: parameter  */
+#line 208 "./blakcomp.y"
+                                                { (yyval.list_val) = list_add_item(NULL, (yyvsp[0].param_val)); }
+#line 1681 "debug/blakcomp.tab.c"
+    break;
+
+  case 54: /* param_list2: param_list2 ',' parameter  */
+#line 209 "./blakcomp.y"
+                                                { (yyval.list_val) = list_add_item((yyvsp[-2].list_val), (yyvsp[0].param_val)); }
+#line 1687 "debug/blakcomp.tab.c"
+    break;
+
+  case 55: /* parameter: id '=' expression  */
+#line 213 "./blakcomp.y"
+                                        { (yyval.param_val) = make_parameter((yyvsp[-2].id_val), (yyvsp[0].expr_val)); }
+#line 1693 "debug/blakcomp.tab.c"
+    break;
+
+  case 56: /* statement_list: %empty  */
+#line 217 "./blakcomp.y"
+                                { (yyval.list_val) = NULL; }
+#line 1699 "debug/blakcomp.tab.c"
+    break;
+
+  case 57: /* statement_list: statement_list statement  */
+#line 218 "./blakcomp.y"
+                                         { if ((yyvsp[0].stmt_val) != NULL) (yyval.list_val) = add_statement((yyvsp[-1].list_val), (yyvsp[0].stmt_val)); }
+#line 1705 "debug/blakcomp.tab.c"
+    break;
+
+  case 58: /* statement: call SEP  */
+#line 222 "./blakcomp.y"
+                                { (yyval.stmt_val) = (yyvsp[-1].stmt_val); }
+#line 1711 "debug/blakcomp.tab.c"
+    break;
+
+  case 59: /* statement: if_stmt  */
+#line 223 "./blakcomp.y"
+                                { (yyval.stmt_val) = (yyvsp[0].stmt_val); }
+#line 1717 "debug/blakcomp.tab.c"
+    break;
+
+  case 60: /* statement: assign_stmt  */
+#line 224 "./blakcomp.y"
+                                { (yyval.stmt_val) = (yyvsp[0].stmt_val); }
+#line 1723 "debug/blakcomp.tab.c"
+    break;
+
+  case 61: /* statement: for_stmt  */
+#line 225 "./blakcomp.y"
+                                { (yyval.stmt_val) = (yyvsp[0].stmt_val); }
+#line 1729 "debug/blakcomp.tab.c"
+    break;
+
+  case 62: /* statement: while_stmt  */
+#line 226 "./blakcomp.y"
+                                { (yyval.stmt_val) = (yyvsp[0].stmt_val); }
+#line 1735 "debug/blakcomp.tab.c"
+    break;
+
+  case 63: /* statement: PROPAGATE SEP  */
+#line 227 "./blakcomp.y"
+                                { (yyval.stmt_val) = make_prop_stmt(); }
+#line 1741 "debug/blakcomp.tab.c"
+    break;
+
+  case 64: /* statement: RETURN expression SEP  */
+#line 229 "./blakcomp.y"
+                                { (yyval.stmt_val) = allocate_statement();
+				  (yyval.stmt_val)->type = S_RETURN;
+				  (yyval.stmt_val)->value.return_stmt_val = (yyvsp[-1].expr_val); }
+#line 1749 "debug/blakcomp.tab.c"
+    break;
+
+  case 65: /* statement: RETURN SEP  */
+#line 233 "./blakcomp.y"
+                                { (yyval.stmt_val) = allocate_statement();
+				  (yyval.stmt_val)->type = S_RETURN;
+				  (yyval.stmt_val)->value.return_stmt_val = 
+				     make_expr_from_constant(make_nil_constant()); }
+#line 1758 "debug/blakcomp.tab.c"
+    break;
+
+  case 66: /* statement: BREAK SEP  */
+#line 237 "./blakcomp.y"
+                                { check_break();
+				  (yyval.stmt_val) = allocate_statement();
+				  (yyval.stmt_val)->type = S_BREAK; }
+#line 1766 "debug/blakcomp.tab.c"
+    break;
+
+  case 67: /* statement: CONTINUE SEP  */
+#line 240 "./blakcomp.y"
+                                { check_continue();
+				  (yyval.stmt_val) = allocate_statement();
+				  (yyval.stmt_val)->type = S_CONTINUE; }
+#line 1774 "debug/blakcomp.tab.c"
+    break;
+
+  case 68: /* statement: INCLUDE fname SEP  */
+#line 243 "./blakcomp.y"
+                                  { include_file((yyvsp[-1].string_val)); (yyval.stmt_val) = NULL; }
+#line 1780 "debug/blakcomp.tab.c"
+    break;
+
+  case 69: /* statement: error SEP  */
+#line 244 "./blakcomp.y"
+                                { (yyval.stmt_val) = NULL; }
+#line 1786 "debug/blakcomp.tab.c"
+    break;
+
+  case 70: /* if_stmt: IF expression '{' statement_list '}'  */
+#line 249 "./blakcomp.y"
+                { (yyval.stmt_val) = make_if_stmt((yyvsp[-3].expr_val), (yyvsp[-1].list_val), NULL); }
+#line 1792 "debug/blakcomp.tab.c"
+    break;
+
+  case 71: /* if_stmt: IF expression '{' statement_list '}' ELSE '{' statement_list '}'  */
+#line 252 "./blakcomp.y"
+                { (yyval.stmt_val) = make_if_stmt((yyvsp[-7].expr_val), (yyvsp[-5].list_val), (yyvsp[-1].list_val)); }
+#line 1798 "debug/blakcomp.tab.c"
+    break;
+
+  case 72: /* assign_stmt: id '=' expression SEP  */
+#line 257 "./blakcomp.y"
+                { (yyval.stmt_val) = make_assign_stmt((yyvsp[-3].id_val), (yyvsp[-1].expr_val)); }
+#line 1804 "debug/blakcomp.tab.c"
+    break;
+
+  case 73: /* for_stmt: FOR loop_variable IN expression '{' start_loop statement_list '}' end_loop  */
+#line 262 "./blakcomp.y"
+                { (yyval.stmt_val) = make_for_stmt((yyvsp[-7].id_val), (yyvsp[-5].expr_val), (yyvsp[-2].list_val)); }
+#line 1810 "debug/blakcomp.tab.c"
+    break;
+
+  case 74: /* loop_variable: id  */
+#line 266 "./blakcomp.y"
+       { make_loop_variable((yyvsp[0].id_val)); }
+#line 1816 "debug/blakcomp.tab.c"
+    break;
+
+  case 75: /* while_stmt: WHILE expression '{' start_loop statement_list '}' end_loop  */
+#line 271 "./blakcomp.y"
+                { (yyval.stmt_val) = make_while_stmt((yyvsp[-5].expr_val), (yyvsp[-2].list_val)); }
+#line 1822 "debug/blakcomp.tab.c"
+    break;
+
+  case 76: /* start_loop: %empty  */
+#line 274 "./blakcomp.y"
+                                { enter_loop(); }
+#line 1828 "debug/blakcomp.tab.c"
+    break;
+
+  case 77: /* end_loop: %empty  */
+#line 277 "./blakcomp.y"
+                                { leave_loop(); }
+#line 1834 "debug/blakcomp.tab.c"
+    break;
+
+  case 78: /* call: id argument_list  */
+#line 281 "./blakcomp.y"
+                                        { (yyval.stmt_val) = make_call((yyvsp[-1].id_val), (yyvsp[0].list_val)); }
+#line 1840 "debug/blakcomp.tab.c"
+    break;
+
+  case 79: /* call: '[' ']'  */
+#line 282 "./blakcomp.y"
+                                        { (yyval.stmt_val) = make_list_call(NULL); }
+#line 1846 "debug/blakcomp.tab.c"
+    break;
+
+  case 80: /* call: '[' expression_list ']'  */
+#line 283 "./blakcomp.y"
+                                        { (yyval.stmt_val) = make_list_call((yyvsp[-1].list_val)); }
+#line 1852 "debug/blakcomp.tab.c"
+    break;
+
+  case 81: /* expression_list: expression  */
+#line 287 "./blakcomp.y"
+                                                { (yyval.list_val) = list_add_item(NULL, (yyvsp[0].expr_val)); }
+#line 1858 "debug/blakcomp.tab.c"
+    break;
+
+  case 82: /* expression_list: expression_list ',' expression  */
+#line 288 "./blakcomp.y"
+                                                { (yyval.list_val) = list_add_item((yyvsp[-2].list_val), (yyvsp[0].expr_val)); }
+#line 1864 "debug/blakcomp.tab.c"
+    break;
+
+  case 83: /* argument_list: '(' ')'  */
+#line 292 "./blakcomp.y"
+                                        { (yyval.list_val) = NULL; }
+#line 1870 "debug/blakcomp.tab.c"
+    break;
+
+  case 84: /* argument_list: '(' arg_list2 ')'  */
+#line 293 "./blakcomp.y"
+                                        { (yyval.list_val) = (yyvsp[-1].list_val); }
+#line 1876 "debug/blakcomp.tab.c"
+    break;
+
+  case 85: /* arg_list2: argument  */
+#line 297 "./blakcomp.y"
+                                        { (yyval.list_val) = list_add_item(NULL, (yyvsp[0].arg_val)); }
+#line 1882 "debug/blakcomp.tab.c"
+    break;
+
+  case 86: /* arg_list2: arg_list2 ',' argument  */
+#line 298 "./blakcomp.y"
+                                        { (yyval.list_val) = list_add_item((yyvsp[-2].list_val), (yyvsp[0].arg_val)); }
+#line 1888 "debug/blakcomp.tab.c"
+    break;
+
+  case 87: /* argument: expression  */
+#line 302 "./blakcomp.y"
+                                        { (yyval.arg_val) = make_arg_from_expr((yyvsp[0].expr_val)); }
+#line 1894 "debug/blakcomp.tab.c"
+    break;
+
+  case 88: /* argument: '#' id '=' expression  */
+#line 303 "./blakcomp.y"
+                                       { (yyval.arg_val) = make_arg_from_setting((yyvsp[-2].id_val), (yyvsp[0].expr_val)); }
+#line 1900 "debug/blakcomp.tab.c"
+    break;
+
+  case 89: /* expression: expression AND expression  */
+#line 307 "./blakcomp.y"
+                                                { (yyval.expr_val) = make_bin_op((yyvsp[-2].expr_val), AND_OP, (yyvsp[0].expr_val)); }
+#line 1906 "debug/blakcomp.tab.c"
+    break;
+
+  case 90: /* expression: expression OR expression  */
+#line 308 "./blakcomp.y"
+                                                { (yyval.expr_val) = make_bin_op((yyvsp[-2].expr_val), OR_OP, (yyvsp[0].expr_val)); }
+#line 1912 "debug/blakcomp.tab.c"
+    break;
+
+  case 91: /* expression: expression REL_OP expression  */
+#line 309 "./blakcomp.y"
+                                                { (yyval.expr_val) = make_bin_op((yyvsp[-2].expr_val), (yyvsp[-1].int_val), (yyvsp[0].expr_val)); }
+#line 1918 "debug/blakcomp.tab.c"
+    break;
+
+  case 92: /* expression: expression '=' expression  */
+#line 310 "./blakcomp.y"
+                                                { (yyval.expr_val) = make_bin_op((yyvsp[-2].expr_val), EQ_OP, (yyvsp[0].expr_val)); }
+#line 1924 "debug/blakcomp.tab.c"
+    break;
+
+  case 93: /* expression: expression '+' expression  */
+#line 311 "./blakcomp.y"
+                                                { (yyval.expr_val) = make_bin_op((yyvsp[-2].expr_val), PLUS_OP, (yyvsp[0].expr_val)); }
+#line 1930 "debug/blakcomp.tab.c"
+    break;
+
+  case 94: /* expression: expression '-' expression  */
+#line 312 "./blakcomp.y"
+                                                { (yyval.expr_val) = make_bin_op((yyvsp[-2].expr_val), MINUS_OP, (yyvsp[0].expr_val)); }
+#line 1936 "debug/blakcomp.tab.c"
+    break;
+
+  case 95: /* expression: expression '*' expression  */
+#line 313 "./blakcomp.y"
+                                                { (yyval.expr_val) = make_bin_op((yyvsp[-2].expr_val), MULT_OP, (yyvsp[0].expr_val)); }
+#line 1942 "debug/blakcomp.tab.c"
+    break;
+
+  case 96: /* expression: expression '/' expression  */
+#line 314 "./blakcomp.y"
+                                                { (yyval.expr_val) = make_bin_op((yyvsp[-2].expr_val), DIV_OP, (yyvsp[0].expr_val)); }
+#line 1948 "debug/blakcomp.tab.c"
+    break;
+
+  case 97: /* expression: expression MOD expression  */
+#line 315 "./blakcomp.y"
+                                                { (yyval.expr_val) = make_bin_op((yyvsp[-2].expr_val), MOD_OP, (yyvsp[0].expr_val)); }
+#line 1954 "debug/blakcomp.tab.c"
+    break;
+
+  case 98: /* expression: expression '&' expression  */
+#line 316 "./blakcomp.y"
+                                                { (yyval.expr_val) = make_bin_op((yyvsp[-2].expr_val), BITAND_OP, (yyvsp[0].expr_val)); }
+#line 1960 "debug/blakcomp.tab.c"
+    break;
+
+  case 99: /* expression: expression '|' expression  */
+#line 317 "./blakcomp.y"
+                                                { (yyval.expr_val) = make_bin_op((yyvsp[-2].expr_val), BITOR_OP, (yyvsp[0].expr_val)); }
+#line 1966 "debug/blakcomp.tab.c"
+    break;
+
+  case 100: /* expression: '-' expression  */
+#line 318 "./blakcomp.y"
+                                                { (yyval.expr_val) = make_un_op(NEG_OP, (yyvsp[0].expr_val)); }
+#line 1972 "debug/blakcomp.tab.c"
+    break;
+
+  case 101: /* expression: NOT expression  */
+#line 319 "./blakcomp.y"
+                                                { (yyval.expr_val) = make_un_op(NOT_OP, (yyvsp[0].expr_val)); }
+#line 1978 "debug/blakcomp.tab.c"
+    break;
+
+  case 102: /* expression: '~' expression  */
+#line 320 "./blakcomp.y"
+                                                { (yyval.expr_val) = make_un_op(BITNOT_OP, (yyvsp[0].expr_val)); }
+#line 1984 "debug/blakcomp.tab.c"
+    break;
+
+  case 103: /* expression: constant  */
+#line 321 "./blakcomp.y"
+                                                { (yyval.expr_val) = make_expr_from_constant((yyvsp[0].const_val)); }
+#line 1990 "debug/blakcomp.tab.c"
+    break;
+
+  case 104: /* expression: literal  */
+#line 322 "./blakcomp.y"
+                                                { (yyval.expr_val) = make_expr_from_constant((yyvsp[0].const_val)); }
+#line 1996 "debug/blakcomp.tab.c"
+    break;
+
+  case 105: /* expression: call  */
+#line 323 "./blakcomp.y"
+                                                { (yyval.expr_val) = make_expr_from_call((yyvsp[0].stmt_val)); }
+#line 2002 "debug/blakcomp.tab.c"
+    break;
+
+  case 106: /* expression: id  */
+#line 324 "./blakcomp.y"
+                                                { (yyval.expr_val) = make_expr_from_id((yyvsp[0].id_val)); }
+#line 2008 "debug/blakcomp.tab.c"
+    break;
+
+  case 107: /* expression: '(' expression ')'  */
+#line 325 "./blakcomp.y"
+                                                { (yyval.expr_val) = (yyvsp[-1].expr_val); }
+#line 2014 "debug/blakcomp.tab.c"
+    break;
+
+  case 108: /* constant: NUMBER  */
+#line 329 "./blakcomp.y"
+                                { (yyval.const_val) = make_numeric_constant((yyvsp[0].int_val)); }
+#line 2020 "debug/blakcomp.tab.c"
+    break;
+
+  case 109: /* constant: '$'  */
+#line 330 "./blakcomp.y"
+                                { (yyval.const_val) = make_nil_constant(); }
+#line 2026 "debug/blakcomp.tab.c"
+    break;
+
+  case 110: /* constant: STRING_CONSTANT  */
+#line 332 "./blakcomp.y"
+                                { (yyval.const_val) = make_string_constant((yyvsp[0].string_val)); }
+#line 2032 "debug/blakcomp.tab.c"
+    break;
+
+  case 111: /* fname: FILENAME  */
+#line 336 "./blakcomp.y"
+                                { (yyval.string_val) = (yyvsp[0].string_val); }
+#line 2038 "debug/blakcomp.tab.c"
+    break;
+
+  case 112: /* fname: IDENTIFIER  */
+#line 337 "./blakcomp.y"
+                                { (yyval.string_val) = (yyvsp[0].idname); }
+#line 2044 "debug/blakcomp.tab.c"
+    break;
+
+  case 113: /* literal: '&' id  */
+#line 341 "./blakcomp.y"
+                                { (yyval.const_val) = make_literal_class((yyvsp[0].id_val)); }
+#line 2050 "debug/blakcomp.tab.c"
+    break;
+
+  case 114: /* literal: '@' id  */
+#line 342 "./blakcomp.y"
+                                { (yyval.const_val) = make_literal_message((yyvsp[0].id_val)); }
+#line 2056 "debug/blakcomp.tab.c"
+    break;
+
+  case 115: /* id: IDENTIFIER  */
+#line 346 "./blakcomp.y"
+                                { (yyval.id_val) = make_identifier((yyvsp[0].idname)); }
+#line 2062 "debug/blakcomp.tab.c"
+    break;
+
+
+#line 2066 "debug/blakcomp.tab.c"
+
+      default: break;
+    }
+  /* User semantic actions sometimes alter yychar, and that requires
+     that yytoken be updated with the new translation.  We take the
+     approach of translating immediately before every use of yytoken.
+     One alternative is translating here after every semantic action,
+     but that translation would be missed if the semantic action invokes
+     YYABORT, YYACCEPT, or YYERROR immediately after altering yychar or
+     if it invokes YYBACKUP.  In the case of YYABORT or YYACCEPT, an
+     incorrect destructor might then be invoked immediately.  In the
+     case of YYERROR or YYBACKUP, subsequent parser actions might lead
+     to an incorrect destructor call or verbose syntax error message
+     before the lookahead is translated.  */
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
+
+  YYPOPSTACK (yylen);
+  yylen = 0;
+
+  *++yyvsp = yyval;
+
+  /* Now 'shift' the result of the reduction.  Determine what state
+     that goes to, based on the state we popped back to and the rule
+     number reduced by.  */
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
+
+  goto yynewstate;
+
+
+/*--------------------------------------.
+| yyerrlab -- here on detecting error.  |
+`--------------------------------------*/
+yyerrlab:
+  /* Make sure we have latest lookahead translation.  See comments at
+     user semantic actions for why this is necessary.  */
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
+  /* If not already recovering from an error, report this error.  */
+  if (!yyerrstatus)
+    {
+      ++yynerrs;
+      yyerror (YY_("syntax error"));
+    }
+
+  if (yyerrstatus == 3)
+    {
+      /* If just tried and failed to reuse lookahead token after an
+         error, discard it.  */
+
+      if (yychar <= YYEOF)
+        {
+          /* Return failure if at end of input.  */
+          if (yychar == YYEOF)
+            YYABORT;
+        }
+      else
+        {
+          yydestruct ("Error: discarding",
+                      yytoken, &yylval);
+          yychar = YYEMPTY;
+        }
+    }
+
+  /* Else will try to reuse lookahead token after shifting the error
+     token.  */
+  goto yyerrlab1;
+
+
+/*---------------------------------------------------.
+| yyerrorlab -- error raised explicitly by YYERROR.  |
+`---------------------------------------------------*/
+yyerrorlab:
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
+
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYERROR.  */
+  YYPOPSTACK (yylen);
+  yylen = 0;
+  YY_STACK_PRINT (yyss, yyssp);
+  yystate = *yyssp;
+  goto yyerrlab1;
+
+
+/*-------------------------------------------------------------.
+| yyerrlab1 -- common code for both syntax error and YYERROR.  |
+`-------------------------------------------------------------*/
+yyerrlab1:
+  yyerrstatus = 3;      /* Each real token shifted decrements this.  */
+
+  /* Pop stack until we find a state that shifts the error token.  */
+  for (;;)
+    {
+      yyn = yypact[yystate];
+      if (!yypact_value_is_default (yyn))
+        {
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
+            {
+              yyn = yytable[yyn];
+              if (0 < yyn)
+                break;
+            }
+        }
+
+      /* Pop the current state because it cannot handle the error token.  */
+      if (yyssp == yyss)
+        YYABORT;
+
+
+      yydestruct ("Error: popping",
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp);
+      YYPOPSTACK (1);
+      yystate = *yyssp;
+      YY_STACK_PRINT (yyss, yyssp);
+    }
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+
+
+  /* Shift the error token.  */
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
+
+  yystate = yyn;
+  goto yynewstate;
+
+
+/*-------------------------------------.
+| yyacceptlab -- YYACCEPT comes here.  |
+`-------------------------------------*/
+yyacceptlab:
+  yyresult = 0;
+  goto yyreturnlab;
+
+
+/*-----------------------------------.
+| yyabortlab -- YYABORT comes here.  |
+`-----------------------------------*/
+yyabortlab:
+  yyresult = 1;
+  goto yyreturnlab;
+
+
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
+yyexhaustedlab:
+  yyerror (YY_("memory exhausted"));
+  yyresult = 2;
+  goto yyreturnlab;
+
+
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
+  if (yychar != YYEMPTY)
+    {
+      /* Make sure we have latest lookahead translation.  See comments at
+         user semantic actions for why this is necessary.  */
+      yytoken = YYTRANSLATE (yychar);
+      yydestruct ("Cleanup: discarding lookahead",
+                  yytoken, &yylval);
+    }
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYABORT or YYACCEPT.  */
+  YYPOPSTACK (yylen);
+  YY_STACK_PRINT (yyss, yyssp);
+  while (yyssp != yyss)
+    {
+      yydestruct ("Cleanup: popping",
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp);
+      YYPOPSTACK (1);
+    }
+#ifndef yyoverflow
+  if (yyss != yyssa)
+    YYSTACK_FREE (yyss);
+#endif
+
+  return yyresult;
+}
+
+#line 350 "./blakcomp.y"
+
+
@@ -0,0 +1,137 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
+
+/* Bison interface for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+#ifndef YY_YY_DEBUG_BLAKCOMP_TAB_H_INCLUDED
+# define YY_YY_DEBUG_BLAKCOMP_TAB_H_INCLUDED
+/* Debug traces.  */
+#ifndef YYDEBUG
+# define YYDEBUG 1
+#endif
+#if YYDEBUG
+extern int yydebug;
+#endif
+
+/* Token kinds.  */
+#ifndef YYTOKENTYPE
+# define YYTOKENTYPE
+  enum yytokentype
+  {
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    NUMBER = 258,                  /* NUMBER  */
+    REL_OP = 259,                  /* REL_OP  */
+    STRING_CONSTANT = 260,         /* STRING_CONSTANT  */
+    FILENAME = 261,                /* FILENAME  */
+    IDENTIFIER = 262,              /* IDENTIFIER  */
+    AND = 263,                     /* AND  */
+    BREAK = 264,                   /* BREAK  */
+    CLASSVARS = 265,               /* CLASSVARS  */
+    CONSTANTS = 266,               /* CONSTANTS  */
+    CONTINUE = 267,                /* CONTINUE  */
+    ELSE = 268,                    /* ELSE  */
+    FOR = 269,                     /* FOR  */
+    IF = 270,                      /* IF  */
+    IN = 271,                      /* IN  */
+    IS = 272,                      /* IS  */
+    LOCAL = 273,                   /* LOCAL  */
+    MESSAGES = 274,                /* MESSAGES  */
+    MOD = 275,                     /* MOD  */
+    NOT = 276,                     /* NOT  */
+    OR = 277,                      /* OR  */
+    PROPAGATE = 278,               /* PROPAGATE  */
+    PROPERTIES = 279,              /* PROPERTIES  */
+    RESOURCES = 280,               /* RESOURCES  */
+    RETURN = 281,                  /* RETURN  */
+    WHILE = 282,                   /* WHILE  */
+    END = 283,                     /* END  */
+    EOL = 284,                     /* EOL  */
+    SEP = 285,                     /* SEP  */
+    INCLUDE = 286,                 /* INCLUDE  */
+    UMINUS = 287                   /* UMINUS  */
+  };
+  typedef enum yytokentype yytoken_kind_t;
+#endif
+
+/* Value type.  */
+#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
+union YYSTYPE
+{
+#line 7 "./blakcomp.y"
+
+	int  int_val;		/* A numerical value */
+	char *string_val;	/* A string value */
+	char *idname;		/* The name of an identifier */
+	id_type   id_val;       /* An identifier, with type info */
+	stmt_type stmt_val;	/* A statement */
+	list_type list_val;	/* A generic linked list */
+	const_type const_val;  	/* A constant */
+	expr_type  expr_val;    /* An expression */
+
+	arg_type   arg_val;     /* An argument to a procedure call */
+	param_type param_val;	/* A parameter declaration */
+	classvar_type classvar_val;	/* A class variable */
+	property_type prop_val;	/* A property */
+	resource_type resource_val;	/* A resource */
+
+	message_handler_type handler_val;	/* A message handler */
+	message_header_type header_val;		/* A message header */
+	class_type class_val;
+
+	call_stmt_type 		call_stmt_val;	/* A function call */
+	if_stmt_type 		if_stmt_val;		/* etc. */
+	assign_stmt_type 	assign_stmt_val;	
+	for_stmt_type 		for_stmt_val;	
+	while_stmt_type 	while_stmt_val;	
+
+#line 123 "debug/blakcomp.tab.h"
+
+};
+typedef union YYSTYPE YYSTYPE;
+# define YYSTYPE_IS_TRIVIAL 1
+# define YYSTYPE_IS_DECLARED 1
+#endif
+
+
+extern YYSTYPE yylval;
+
+
+int yyparse (void);
+
+
+#endif /* !YY_YY_DEBUG_BLAKCOMP_TAB_H_INCLUDED  */
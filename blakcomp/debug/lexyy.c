@@ -0,0 +1,964 @@
+
+#include "blakcomp.h"
+#include "blakcomp.tab.h"
+/* Hand-written stand-in for the flex scanner, for local testing only. */
+#include <string>
+struct yy_buffer_state { std::string text; size_t pos; };
+typedef struct yy_buffer_state *YY_BUFFER_STATE;
+#define YY_BUF_SIZE 16384
+static YY_BUFFER_STATE yy_cur = NULL;
+#define YY_CURRENT_BUFFER yy_cur
+static std::string yy_tok;
+char *yytext = (char *) "";
+enum { S_INITIAL, S_STRING, S_CODE };
+static int yy_start = S_INITIAL;
+YY_BUFFER_STATE yy_create_buffer(FILE *f, int)
+{
+   YY_BUFFER_STATE b = new yy_buffer_state;
+   char buf[65536]; size_t n;
+   b->pos = 0;
+   while ((n = fread(buf, 1, sizeof(buf), f)) > 0) b->text.append(buf, n);
+   return b;
+}
+void yy_delete_buffer(YY_BUFFER_STATE) {}
+void yy_switch_to_buffer(YY_BUFFER_STATE b) { yy_cur = b; }
+#include <mutex>
+
+/* Parser states */
+enum {
+   STATE_CODE, STATE_INITIAL,
+};
+
+int cur_state = STATE_INITIAL;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+int yywrap(void);
+#ifdef __cplusplus
+}
+#endif
+
+extern int yyparse(void);
+static FILE *open_file(char *fname);
+static void usage(void);
+static list_type read_file_list(list_type l, const char *list_fname);
+static char *absolute_path(const char *path);
+static char *enter_source_dir(char *path);
+static char *current_dir(void);
+static void delete_batch_output(list_type files);
+
+int lineno;
+bool generate_code = true;  /* true if we should generate code */
+extern int yydebug;        /* Set to nonzero to get yacc debug info */
+list_type file_list;       /* List of files to compile */
+char *current_fname;
+char *bof_fname;       /* Object code filename */
+bool debug_bof;         /* Should we put debugging info in .bof file? */
+bool batch_mode;        /* Compiling a file list with the database kept in memory? */
+static char *start_dir; /* Directory we were started in, for batch mode */
+
+struct file_state {
+   YY_BUFFER_STATE buffer;
+   char *filename;
+   int lineno;
+   FILE *file_ptr;
+};
+
+#define MAX_INCLUDE_DEPTH 10
+#define MAX_INCLUDE_DIRS  20
+
+struct file_state include_stack[MAX_INCLUDE_DEPTH + 1];  /* stack of nested included files */
+int include_depth;                                       /* nesting depth of include files */
+
+static char *include_dirs[MAX_INCLUDE_DIRS];/* include directory names */             
+static int num_include_dirs;               /* # of include directories specified on command line */
+int yywrap(void);
+
+static int hl_strline(const char *s, size_t n)
+{
+   size_t i = 0;
+   while (i < n && s[i] != '"' && s[i] != '\n')
+   {
+      if (s[i] == '\\') { if (i + 1 >= n || s[i+1] == '\n') return -1; i += 2; }
+      else i++;
+   }
+   if (i >= n || s[i] != '"') return -1;
+   i++;
+   while (i < n && (s[i] == ' ' || s[i] == '\t' || s[i] == '\r')) i++;
+   return (int) i;
+}
+static int hl_unterminated(const char *s, size_t n)
+{
+   size_t i = 0;
+   while (i < n && s[i] != '"' && s[i] != '\n')
+   {
+      if (s[i] == '\\') { if (i + 1 >= n || s[i+1] == '\n') return -1; i += 2; }
+      else i++;
+   }
+   if (i < n && s[i] == '\n') return (int) i;
+   return -1;
+}
+static bool hl_fnchar(char c) { return isalnum((unsigned char) c) || c == '_' || c == '-'; }
+int yylex(void)
+{
+   static const struct { const char *w; int tok; } kw[] = {
+      {"and",AND},{"break",BREAK},{"classvars",CLASSVARS},{"continue",CONTINUE},
+      {"constants",CONSTANTS},{"else",ELSE},{"end",END},{"for",FOR},{"if",IF},{"in",IN},
+      {"is",IS},{"local",LOCAL},{"messages",MESSAGES},{"mod",MOD},{"not",NOT},{"or",OR},
+      {"propagate",PROPAGATE},{"properties",PROPERTIES},{"resources",RESOURCES},
+      {"return",RETURN},{"while",WHILE},{"include",INCLUDE}};
+   for (;;)
+   {
+      if (yy_cur->pos >= yy_cur->text.size())
+      {
+         if (yywrap()) return 0;
+         continue;
+      }
+      const char *s = yy_cur->text.data() + yy_cur->pos;
+      size_t n = yy_cur->text.size() - yy_cur->pos;
+      bool bol = yy_cur->pos == 0 || s[-1] == '\n';
+      int best = -1, rule = -1, kwi = -1;
+      auto cand = [&](int len, int r) { if (len > best) { best = len; rule = r; } };
+      if (yy_start == S_STRING)
+      {
+         cand(hl_unterminated(s, n), 1);
+         int l = hl_strline(s, n);
+         if (l >= 0)
+         {
+            for (;;)
+            {
+               size_t j = l;
+               if (j >= n || s[j] != '\n') break;
+               j++;
+               while (j < n && (s[j] == ' ' || s[j] == '\t' || s[j] == '\r')) j++;
+               if (j >= n || s[j] != '"') break;
+               j++;
+               int l2 = hl_strline(s + j, n - j);
+               if (l2 < 0) break;
+               l = (int) (j + l2);
+            }
+            cand(l, 2);
+         }
+      }
+      if (s[0] == '"') cand(1, 3);
+      for (size_t k = 0; k < sizeof(kw)/sizeof(kw[0]); k++)
+      {
+         size_t L = strlen(kw[k].w);
+         if (L <= n && strncasecmp(s, kw[k].w, L) == 0 && (int) L > best) { best = (int) L; rule = 4; kwi = (int) k; }
+      }
+      if (n >= 2 && (!strncmp(s, "<>", 2) || !strncmp(s, "<=", 2) || !strncmp(s, ">=", 2))) cand(2, 5);
+      if (s[0] == '<' || s[0] == '>') cand(1, 5);
+      if (strchr("-+*/,:#&@()={}$[]|~", s[0]) && s[0]) cand(1, 6);
+      if (s[0] == ';') cand(1, 7);
+      if (isalpha((unsigned char) s[0]))
+      {
+         size_t i = 1; while (i < n && (isalnum((unsigned char) s[i]) || s[i] == '_')) i++;
+         cand((int) i, 8);
+      }
+      {
+         size_t i = 0; while (i < n && hl_fnchar(s[i])) i++;
+         if (i < n && s[i] == '.')
+         {
+            i++; while (i < n && hl_fnchar(s[i])) i++;
+            cand((int) i, 9);
+         }
+      }
+      if (isdigit((unsigned char) s[0]))
+      {
+         size_t i = 0; while (i < n && isdigit((unsigned char) s[i])) i++;
+         cand((int) i, 10);
+      }
+      if (n > 2 && s[0] == '0' && (s[1] == 'x' || s[1] == 'X') && isxdigit((unsigned char) s[2]))
+      {
+         size_t i = 2; while (i < n && isxdigit((unsigned char) s[i])) i++;
+         cand((int) i, 11);
+      }
+      if (bol)
+      {
+         size_t i = 0; while (i < n && (s[i] == ' ' || s[i] == '\t' || s[i] == '\r')) i++;
+         if (i < n && s[i] == '%')
+         {
+            while (i < n && s[i] != '\n') i++;
+            if (i < n) cand((int) i + 1, 12);
+         }
+      }
+      if (s[0] == '%')
+      {
+         size_t i = 0; while (i < n && s[i] != '\n') i++;
+         cand((int) i, 13);
+      }
+      if (s[0] == '\\')
+      {
+         size_t i = 1; while (i < n && (s[i] == ' ' || s[i] == '\t' || s[i] == '\r')) i++;
+         if (i < n && s[i] == '\n') cand((int) i + 1, 14);
+      }
+      if (bol)
+      {
+         size_t i = 0; while (i < n && (s[i] == ' ' || s[i] == '\t' || s[i] == '\r')) i++;
+         if (i < n && s[i] == '\n') cand((int) i + 1, 15);
+      }
+      {
+         size_t i = 0; while (i < n && (s[i] == ' ' || s[i] == '\t' || s[i] == '\r')) i++;
+         if (i > 0) cand((int) i, 16);
+      }
+      if (s[0] == '\n' && yy_start == S_CODE) cand(1, 17);
+      if (s[0] == '\n' && yy_start == S_INITIAL) cand(1, 18);
+      if (s[0] != '\n') cand(1, 19);
+      if (best <= 0) { yy_cur->pos++; continue; }
+
+      yy_tok.assign(s, best); if (getenv("HLDEBUG")) fprintf(stderr, "[r%d:%s]\n", rule, yy_tok.c_str());
+      yytext = &yy_tok[0];
+      yy_cur->pos += best;
+      switch (rule)
+      {
+      case 1: yyerror("Unterminated string"); /* fall through */
+      case 2:
+         yylval.string_val = assemble_string(yytext);
+         yy_start = (cur_state == STATE_INITIAL) ? S_INITIAL : S_CODE;
+         return STRING_CONSTANT;
+      case 3: yy_start = S_STRING; break;
+      case 4:
+         if (kw[kwi].tok == END) { yy_start = S_INITIAL; cur_state = STATE_INITIAL; }
+         if (kw[kwi].tok == MESSAGES) { yy_start = S_CODE; cur_state = STATE_CODE; }
+         return kw[kwi].tok;
+      case 5:
+         if (!strcmp(yytext, "<>")) yylval.int_val = NEQ_OP;
+         else if (!strcmp(yytext, "<=")) yylval.int_val = LEQ_OP;
+         else if (!strcmp(yytext, ">=")) yylval.int_val = GEQ_OP;
+         else if (!strcmp(yytext, "<")) yylval.int_val = LT_OP;
+         else yylval.int_val = GT_OP;
+         return REL_OP;
+      case 6: return yytext[0];
+      case 7: return SEP;
+      case 8: yylval.idname = strdup(yytext); return IDENTIFIER;
+      case 9: yylval.idname = strdup(yytext); return FILENAME;
+      case 10: yylval.int_val = atoi(yytext); return NUMBER;
+      case 11: sscanf(yytext, "%x", &yylval.int_val); return NUMBER;
+      case 12: lineno++; break;
+      case 13: break;
+      case 14: lineno++; break;
+      case 15: lineno++; break;
+      case 16: break;
+      case 17: lineno++; break;
+      case 18: lineno++; return EOL;
+      case 19: yyerror("Invalid character"); break;
+      }
+   }
+}
+
+
+/************************************************************************/
+void handle_error(void)
+{
+   static int numerrors = 0;
+   static std::mutex error_mutex;  /* Code generation may report errors from several threads */
+   std::lock_guard<std::mutex> lock(error_mutex);
+
+   generate_code = false; /* Errors; don't generate code */
+   if (++numerrors > MAXERRORS)
+   {
+      fprintf(stderr, "Too many errors. Aborting.\n");
+      exit(1);
+   }
+}
+/************************************************************************/
+/* yyerror should be used for lexing & parsing errors. */
+void yyerror(const char *s)
+{
+   /* If token is EOL, give useful error message */
+   if (!strcmp(yytext, "\n"))
+      fprintf(stderr, "%s(%d): error: Premature end of line\n", 
+							 current_fname, lineno-1);
+   else
+      fprintf(stderr, "%s(%d): error: %s on token %s\n", 
+							 current_fname, lineno, s, yytext);
+   handle_error();
+}
+/************************************************************************/
+/* action_error should be used for semantic errors. */
+void action_error(const char *fmt, ...)
+{
+   int errline = lineno;
+   va_list marker;
+
+   /* If last token was EOL, report error on previous line */
+   if (!strcmp(yytext, "\n"))
+      errline--;
+
+   fprintf(stderr, "%s(%d): error: ", current_fname, errline);  
+
+   va_start(marker, fmt);
+   vfprintf(stderr, fmt, marker);
+   va_end(marker);
+   fprintf(stderr, "\n");
+
+   handle_error();
+}
+/************************************************************************/
+/* action_warning should be used for semantic warnings. */
+void action_warning(const char *fmt, ...)
+{
+   int errline = lineno;
+   va_list marker;
+
+   /* If last token was EOL, report error on previous line */
+   if (!strcmp(yytext, "\n"))
+      errline--;
+
+   fprintf(stderr, "%s(%d): warning: ", current_fname, errline);  
+
+   va_start(marker, fmt);
+   vfprintf(stderr, fmt, marker);
+   va_end(marker);
+   fprintf(stderr, "\n");
+}
+/************************************************************************/
+/* simple_error should be used for other errors. */
+void simple_error(const char *fmt, ...)
+{
+   char message[1024];
+   va_list marker;
+
+   /* Print in one piece, so that other threads' messages don't break in */
+   va_start(marker, fmt);
+   vsnprintf(message, sizeof(message), fmt, marker);
+   va_end(marker);
+   fprintf(stderr, "  error: %s\n", message);
+
+   handle_error();   
+}
+/************************************************************************/
+/* simple_warning should be used for all warnings. */
+void simple_warning(const char *fmt, ...)
+{
+   char message[1024];
+   va_list marker;
+
+   va_start(marker, fmt);
+   vsnprintf(message, sizeof(message), fmt, marker);
+   va_end(marker);
+   printf("  warning: %s\n", message);
+}
+/************************************************************************/
+// Return value of hex digit, or -1 if none.
+int read_escape_char(unsigned char c)
+{
+  if (c >= '0' && c <= '9')
+  {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f')
+  {
+    return c - 'a' + 10;
+  }
+  if (c >= 'A' && c <= 'F')
+  {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+/************************************************************************/
+/*
+ * assemble_string:  Convert a Blakod multiple-line string into a
+ *   plain string, without starting and ending quotes, and with escape
+ *   sequences replaced.
+ */
+char *assemble_string(char *str)
+{
+   unsigned char *new_str = reinterpret_cast<unsigned char *>(strdup(str));
+   bool inside_quotes = true;
+
+   unsigned char *rd = new_str;
+   unsigned char *wt = new_str;
+
+   while (*rd != '\0')
+   {
+     // Disallow high-bit ASCII to make files UTF-8 clean
+     if (*rd > 127)
+     {
+       yyerror("Illegal character in string");
+     }
+     
+     /* Throw out junk outside quotes */
+     if (!inside_quotes && *rd != '"')
+     {
+       if (*rd == '\n')
+         lineno++;
+       rd++;
+       continue;
+     }
+     
+     switch (*rd)
+     {
+     case '\\':
+       rd++;
+       
+       /* Look for special characters */
+       switch (*rd)
+       {
+       case 'n':
+         *wt = '\r';    /* Ugh.. CR-LF pair for Windows ugliness */
+         wt++;
+         *wt = '\n';
+         wt++;
+         break;
+
+       case 'x': {
+         // Look for \xnn escape sequence
+         rd++;
+         int escape_val_1 = read_escape_char(*rd);
+         if (escape_val_1 < 0)
+         {
+           yyerror("Illegal escape sequence");
+           break;
+         }
+         rd++;
+         int escape_val_2 = read_escape_char(*rd);
+         if (escape_val_2 < 0)
+         {
+           yyerror("Illegal escape sequence");
+           break;
+         }
+         *wt = (16 * escape_val_1) + escape_val_2;
+         wt++;
+         break;
+       }
+         
+       default:
+         *wt = *rd;
+         wt++;
+         break;
+         
+       }
+       break;
+       
+     case '"':  /* Ignore quotes */
+       inside_quotes = !inside_quotes;
+       break;
+       
+     case '\n': /* Ignore newlines */
+       lineno++;
+       break;
+       
+     default:
+       *wt = *rd;
+       wt++;
+       break;
+     }
+     
+     rd++;
+   }
+   *wt = '\0';
+
+   return (char *) new_str;
+}
+/************************************************************************/
+/* 
+ * recompile_warnings:  Give warning messages for each class that should
+ *    be recompiled because one of its ancestors was recompiled.
+ */
+void recompile_warnings(list_type l)
+{
+   int column = 0;
+
+   if (l == NULL)
+      return;
+
+   simple_warning("Need to recompile these subclasses:");
+
+   for (; l != NULL; l = l->next)
+   {
+      const char *name = ((recompile_type) (l->data))->class_id->name;
+      
+      if (column + strlen(name) >= 75)
+      {
+         printf("\n");
+         column = 0;
+      }
+      printf("%s  ", name);
+      column += (int) strlen(name) + 2;
+      
+      /* ((recompile_type) (l->data))->superclass->name); */
+   }
+   printf("\n");
+}
+/************************************************************************/
+int yywrap(void)
+{
+   fclose(include_stack[include_depth].file_ptr);
+
+   yy_delete_buffer(YY_CURRENT_BUFFER);
+   /* XXX Should close file; but this causes access violation, because
+      FILE pointer is out of scope.  
+    */
+
+   /* If in an included file, move back to including file */
+   if (include_depth > 0)
+   {
+      include_depth--;
+      lineno = include_stack[include_depth].lineno;
+      current_fname = include_stack[include_depth].filename;
+      yy_switch_to_buffer(include_stack[include_depth].buffer);
+      return 0;
+   }
+
+   return 1; /* Otherwise stop reading the current file */
+}
+/************************************************************************/
+/*
+ * open_file:  Open the given filename and return a FILE pointer to it.
+ *    If the file has no extension, we add a ".kod" extension.
+ *    Also set bof_fname to the corresponding ".bof" filename.
+ */
+FILE *open_file(char *fname)
+{
+   char temp[256];
+   FILE *fin;
+
+   /* Add .kod extension if necessary */
+   set_extension(temp, sizeof(temp), fname, ".kod");
+   
+   if ((fin = fopen(temp, "r")) == NULL)
+   {
+      perror(fname);
+      exit(1);
+   }
+
+   current_fname = strdup(temp);
+   note_source_file(temp);
+
+   /* Construct object code filename */
+   bof_fname = strdup(fname);
+   set_extension(bof_fname, sizeof(bof_fname), bof_fname, ".bof");
+
+   return fin;
+}
+/************************************************************************/
+/*
+ * open_include_file:  Attempt to open given filename in all include
+ *   directories.  Return file pointer, or NULL on failure.
+ */
+FILE *open_include_file(char *filename)
+{
+   FILE *fin;
+   int i;
+   char tempbuf[512];
+
+   /* Loop through include directories and try to open file */
+   for (i=0; i < num_include_dirs; i++)
+   {
+      snprintf(tempbuf, sizeof(tempbuf), "%s/%s", include_dirs[i], filename);
+      if ((fin = fopen(tempbuf, "r")) != NULL)
+      {
+	 note_source_file(tempbuf);
+	 return fin;
+      }
+   }
+
+   /* Finally, just try current directory */
+   fin = fopen(filename, "r");
+   if (fin != NULL)
+      note_source_file(filename);
+
+   return fin;
+}
+/************************************************************************/
+/*
+ * include_file:  Switch flex over to the given file, parse it, and then
+ *   return to the original file.  Include files may be nested.
+ */
+void include_file(char *filename)
+{
+   FILE *fin;
+
+   if (include_depth >= MAX_INCLUDE_DEPTH)
+   {
+      action_error("Maximum nesting depth of include files is %d", MAX_INCLUDE_DEPTH);
+      return;
+   }
+
+   if ((fin = open_include_file(filename)) == NULL)
+   {
+      action_error("Can't find include file %s", filename);
+      return;
+   }
+
+   /* Save away current state, and move on to included file */
+
+   include_stack[include_depth].buffer   = YY_CURRENT_BUFFER;
+   include_stack[include_depth].filename = current_fname;
+   include_stack[include_depth].lineno   = lineno;
+   include_depth++;
+
+   yy_switch_to_buffer(yy_create_buffer(fin, YY_BUF_SIZE));
+   include_stack[include_depth].file_ptr = fin;
+   current_fname = strdup(filename);
+   lineno = 1;
+}
+/************************************************************************/
+/*
+ * add_include_directory:  Add given directory to list of directories
+ *   that are searched for include files.  These directories can be
+ *   specified on the command line.
+ */
+void add_include_directory(char *dirname)
+{
+   if (num_include_dirs == MAX_INCLUDE_DIRS)
+      simple_error("Too many include directories!");
+   else
+   {
+      include_dirs[num_include_dirs] = dirname;
+      num_include_dirs++;
+   }
+}
+/************************************************************************/
+void usage(void)
+{
+   fprintf(stderr, "usage: bc <options> filename ...\n");
+   fprintf(stderr, "     possible options are:\n");
+   fprintf(stderr, "     -d            Put debugging info in .bof file\n");
+   fprintf(stderr, "     -K file       Specify kodbase file\n");
+   fprintf(stderr, "     -I dir        Add dir to include path\n");
+   fprintf(stderr, "     -L file       Batch compile the files listed in file, in order\n");
+   fprintf(stderr, "     -j jobs       With -L, generate code on this many threads\n");
+}
+/************************************************************************/
+/*
+ * read_file_list:  Add the filenames in the given file, one per line, to
+ *   the list l.  Blank lines and lines starting with # are skipped.
+ */
+list_type read_file_list(list_type l, const char *list_fname)
+{
+   FILE *fin;
+   char line[512];
+   char *start, *end;
+
+   if ((fin = fopen(list_fname, "r")) == NULL)
+   {
+      perror(list_fname);
+      exit(1);
+   }
+
+   while (fgets(line, sizeof(line), fin) != NULL)
+   {
+      start = line;
+      while (isspace((unsigned char) *start))
+         start++;
+      end = start + strlen(start);
+      while (end > start && isspace((unsigned char) end[-1]))
+         *--end = '\0';
+
+      if (*start == '\0' || *start == '#')
+         continue;
+      l = list_add_item(l, strdup(start));
+   }
+
+   fclose(fin);
+   return l;
+}
+/************************************************************************/
+/*
+ * absolute_path:  Return a copy of path that still names the same file
+ *   after we change directories.
+ */
+char *absolute_path(const char *path)
+{
+   char *full;
+
+   if (path[0] == '/' || path[0] == '\\' || (isalpha((unsigned char) path[0]) && path[1] == ':'))
+      return strdup(path);
+
+   full = (char *) SafeMalloc((long) (strlen(start_dir) + strlen(path) + 2));
+   sprintf(full, "%s/%s", start_dir, path);
+   return full;
+}
+/************************************************************************/
+/*
+ * enter_source_dir:  Change to the directory holding the given source
+ *   file, and return the file's name within that directory.  In batch mode
+ *   each file is compiled from its own directory, as make would do, so
+ *   that local includes resolve and the .bof records the same filename.
+ */
+char *enter_source_dir(char *path)
+{
+   char *dir, *sep;
+
+   sep = strrchr(path, '/');
+   if (strrchr(path, '\\') > sep)
+      sep = strrchr(path, '\\');
+   if (sep == NULL)
+      return path;
+
+   dir = strdup(path);
+   dir[sep - path] = '\0';
+   if (chdir(*dir == '\0' ? "/" : dir) != 0)
+   {
+      perror(dir);
+      exit(1);
+   }
+   free(dir);
+
+   return sep + 1;
+}
+/************************************************************************/
+/*
+ * current_dir:  Return a copy of the name of the current directory.
+ */
+char *current_dir(void)
+{
+   char cwd[1024];
+
+   if (getcwd(cwd, sizeof(cwd)) == NULL)
+   {
+      perror("getcwd");
+      exit(1);
+   }
+   return strdup(cwd);
+}
+/************************************************************************/
+/*
+ * delete_batch_output:  After a failed batch, delete the .bof, .rsc and
+ *   dependency files written for the given files.  Their ids were never
+ *   saved to the database, so they must be compiled again.
+ */
+void delete_batch_output(list_type files)
+{
+   char temp[256];
+   char *fname;
+
+   for (; files != NULL; files = files->next)
+   {
+      fname = enter_source_dir((char *) files->data);
+      set_extension(temp, sizeof(temp), fname, ".bof");
+      unlink(temp);
+      set_extension(temp, sizeof(temp), fname, ".rsc");
+      unlink(temp);
+      set_extension(temp, sizeof(temp), fname, DEPEND_EXTENSION);
+      unlink(temp);
+      chdir(start_dir);
+   }
+}
+/************************************************************************/
+int main(int argc, char **argv)
+{
+   int i, num_skipped = 0, num_jobs = 1;
+   list_type current_file_ptr, compiled_files = NULL, units = NULL, l;
+   compile_unit_type unit;
+   char *arg;
+
+   if (argc == 1)
+   {
+      usage();
+      exit(1);
+   }
+
+   file_list = NULL;
+   debug_bof = false;
+   batch_mode = false;
+
+   num_include_dirs = 0;
+
+   /* Parse command line */
+   for (i = 1; i < argc; i++)
+   {
+      arg = argv[i];
+      if (*arg == '-' || *arg == '/')
+	 /* Switch on command-line options */
+	 switch(toupper(*(arg + 1)))
+	 {
+	 case 'D':               /* Debugging on */
+	    debug_bof = true;
+	    break;
+	    
+	 case 'K' :              /* Specify kodbase filename */
+	    if (i == argc - 1)
+	       fprintf(stderr, "Switch -%c needs a filename (ignoring)\n",*(arg+1));
+	    else
+	    {
+	       i++;
+	       arg = argv[i];
+	       set_kodbase_filename(arg);
+	    }
+	    break;
+	    
+	 case 'I':               /* Specify include file directory */
+	    if (i == argc - 1)
+		    fprintf(stderr, "Switch -%c needs a directory (ignoring)\n",*(arg+1));
+	    else
+	    {
+	       i++;
+	       arg = argv[i];
+	       if (access(arg,4) == 0) /* 4 means read access */
+		  add_include_directory(arg);
+	       else
+	       {
+			 fprintf(stderr, "Unable to read include file directory %s\n",arg);
+			 exit(1);
+	       }
+	    }
+	    break;
+
+	 case 'L':               /* Batch compile files from list */
+	    if (i == argc - 1)
+		    fprintf(stderr, "Switch -%c needs a filename (ignoring)\n",*(arg+1));
+	    else
+	    {
+	       i++;
+	       file_list = read_file_list(file_list, argv[i]);
+	       batch_mode = true;
+	    }
+	    break;
+
+	 case 'J':               /* Generate code on several threads */
+	    if (i == argc - 1)
+		    fprintf(stderr, "Switch -%c needs a number (ignoring)\n",*(arg+1));
+	    else
+	    {
+	       i++;
+	       num_jobs = atoi(argv[i]);
+	       if (num_jobs < 1)
+	       {
+		  fprintf(stderr, "Switch -%c needs a positive number\n",*(arg+1));
+		  exit(1);
+	       }
+	    }
+	    break;
+
+	 default:
+	    fprintf(stderr, "Ignoring unknown switch -%c.\n", *(arg + 1));
+	    
+	 }
+      else file_list = list_add_item(file_list, argv[i]);
+   }
+
+   if (file_list == NULL)
+   {
+      fprintf(stderr, "No files specified!\n");
+      exit(1);
+   }
+
+   current_file_ptr = file_list;
+
+   /* Uncomment the next line to get parser trace */
+   /* yydebug = 1; */
+
+   initialize_parser();
+
+   /* In batch mode we change to each file's directory, so make the paths
+    * given on the command line independent of the current directory. */
+   if (batch_mode)
+   {
+      start_dir = current_dir();
+
+      for (i=0; i < num_include_dirs; i++)
+         include_dirs[i] = absolute_path(include_dirs[i]);
+      set_kodbase_filename(absolute_path(get_kodbase_filename()));
+   }
+
+   /* Read in database file */
+   if (!load_kodbase())
+      simple_error("Error loading database; continuing with compilation");
+      
+
+	bool all_success = true;
+   for (current_file_ptr = file_list; current_file_ptr != NULL; 
+        current_file_ptr = current_file_ptr->next)
+   {
+      char *fname = (char *) current_file_ptr->data;
+
+      // Reset per-file counts
+      include_depth = 0;
+      st.num_strings = 0;
+      st.strings = NULL;
+
+      if (batch_mode)
+      {
+         fname = enter_source_dir(fname);
+
+         /* Skip files that would compile to what they already have */
+         if (dependencies_current(fname))
+         {
+            num_skipped++;
+            chdir(start_dir);
+            continue;
+         }
+      }
+
+      start_dependencies(fname);
+      include_stack[0].file_ptr = open_file(fname);
+      include_stack[0].buffer = yy_create_buffer(include_stack[0].file_ptr, 
+                                                 YY_BUF_SIZE);
+      include_stack[0].filename = current_fname;
+      yy_switch_to_buffer(include_stack[0].buffer);
+
+      lineno = 1;
+      
+      yyparse();
+
+      /* In batch mode the database is written once, after the last file.
+       * With more than one job, code is generated after every file has
+       * been parsed, so all ids are given out in the same order as when
+       * each file's code is generated in turn. */
+      if (!generate_code)
+         all_success = false;
+      else if (!batch_mode)
+      {
+         if (codegen(current_fname, bof_fname))
+            save_kodbase();
+         else
+            all_success = false;
+      }
+      else
+      {
+         unit = make_compile_unit(current_fname, bof_fname, current_dir());
+         checkpoint_kodbase();
+         compiled_files = list_add_item(compiled_files, current_file_ptr->data);
+         if (num_jobs > 1)
+            units = list_add_item(units, unit);
+         else if (!codegen_unit(unit))
+            all_success = false;
+      }
+      generate_code = true;
+
+      if (batch_mode)
+      {
+         chdir(start_dir);
+
+         /* Later files may depend on this one, so stop at the first failure */
+         if (!all_success)
+         {
+            fprintf(stderr, "Batch stopped at %s; no database written\n",
+                    (char *) current_file_ptr->data);
+            delete_batch_output(compiled_files);
+            break;
+         }
+      }
+   }
+
+   /* Units are in the same order as compiled_files; stop at the first
+    * failure, as if each had been generated in turn */
+   if (batch_mode && all_success && units != NULL && !codegen_units(units, num_jobs))
+   {
+      all_success = false;
+      for (l = units, current_file_ptr = compiled_files; l != NULL;
+           l = l->next, current_file_ptr = current_file_ptr->next)
+         if (!((compile_unit_type) l->data)->ok)
+            break;
+      fprintf(stderr, "Batch stopped at %s; no database written\n",
+              (char *) current_file_ptr->data);
+      delete_batch_output(compiled_files);
+   }
+
+   if (batch_mode && all_success)
+   {
+      if (num_skipped > 0)
+         printf("%d of %d files were up to date\n", num_skipped, list_length(file_list));
+      save_kodbase();
+   }
+
+   /* Give warnings for classes that should be recompiled */
+   recompile_warnings(st.recompile_list);
+
+   return !all_success;
+}
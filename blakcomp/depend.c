@@ -0,0 +1,453 @@
+// Meridian 59, Copyright 1994-2012 Andrew Kirmse and Chris Kirmse.
+// All rights reserved.
+//
+// This software is distributed under a license that is described in
+// the LICENSE file that accompanies it.
+//
+// Meridian is a registered trademark.
+/* depend.c  Dependency manifests for compiled kod files.
+ *
+ * Along with each .bof, the compiler writes a .dep file listing everything
+ * that went into it:
+ *
+ *   B version debug     .bof format version, and whether -d was given
+ *   F file hash         contents of the source file and each included file
+ *   O file              .bof and .rsc files that were written
+ *   D class hash        interface of each class defined in the file
+ *   C class hash        interface of each of their superclasses
+ *   E name type idnum   global identifier referred to, with the id # it had
+ *   END
+ *
+ * A class's interface is what save_class_list writes to the database for
+ * it: its id #, superclass, and the names and id #s of its resources,
+ * classvars, properties, messages and parameters.  That is all a subclass
+ * sees of it.  In batch mode, a file whose manifest still matches the
+ * symbol table and the files on disk would compile to the same output,
+ * so it is not compiled again.
+ */
+
+#include "blakcomp.h"
+#include <stdint.h>
+
+#define FNV_OFFSET 14695981039346656037ull
+#define FNV_PRIME  1099511628211ull
+
+extern bool debug_bof;
+
+static list_type dep_files;     /* Names of source and include files read */
+static Table dep_ids;           /* Global identifiers referred to */
+static bool dep_ids_created = false;
+
+/************************************************************************/
+static uint64_t hash_bytes(uint64_t h, const void *data, size_t len)
+{
+   const unsigned char *p = (const unsigned char *) data;
+
+   while (len-- > 0)
+   {
+      h ^= *p++;
+      h *= FNV_PRIME;
+   }
+   return h;
+}
+/************************************************************************/
+static uint64_t hash_string(uint64_t h, const char *s)
+{
+   /* Include the terminator, so that adjacent strings can't run together */
+   return hash_bytes(h, s, strlen(s) + 1);
+}
+/************************************************************************/
+static uint64_t hash_int(uint64_t h, int num)
+{
+   return hash_bytes(h, &num, sizeof(num));
+}
+/************************************************************************/
+/*
+ * hash_file:  Set hash to a hash of the contents of the given file.
+ *   Returns false if the file can't be read.
+ */
+static bool hash_file(const char *fname, uint64_t *hash)
+{
+   FILE *f;
+   char buf[4096];
+   size_t len;
+   uint64_t h = FNV_OFFSET;
+
+   if ((f = fopen(fname, "rb")) == NULL)
+      return false;
+
+   while ((len = fread(buf, 1, sizeof(buf), f)) > 0)
+      h = hash_bytes(h, buf, len);
+
+   fclose(f);
+   *hash = h;
+   return true;
+}
+/************************************************************************/
+/*
+ * find_class:  Return the class with the given name from the class list,
+ *   or NULL if there is none.
+ */
+static class_type find_class(const char *name)
+{
+   id_struct key;
+   id_type id;
+   list_type l;
+
+   key.name = (char *) name;
+   id = (id_type) table_lookup(st.globalvars, (void *) &key, id_hash, id_compare);
+   if (id == NULL || id->type != I_CLASS)
+      return NULL;
+
+   for (l = st.classes; l != NULL; l = l->next)
+      if (((class_type) l->data)->class_id->idnum == id->idnum)
+	 return (class_type) l->data;
+   return NULL;
+}
+/************************************************************************/
+/*
+ * find_superclass:  Return the current class structure of c's superclass.
+ *   A class read from the database may still point at the old structure
+ *   of a superclass that has since been recompiled, so look it up by name.
+ */
+static class_type find_superclass(class_type c)
+{
+   if (c->superclass == NULL)
+      return NULL;
+   return find_class(c->superclass->class_id->name);
+}
+/************************************************************************/
+/*
+ * class_interface_hash:  Return a hash of the parts of class c that are
+ *   written to the database, which are all that other classes can see.
+ *   Walks the same lists, in the same order, as save_class_list.
+ */
+static uint64_t class_interface_hash(class_type c)
+{
+   list_type l, p;
+   uint64_t h = FNV_OFFSET;
+
+   h = hash_string(h, c->class_id->name);
+   h = hash_int(h, c->class_id->idnum);
+   if (c->superclass == NULL)
+      h = hash_int(h, NO_SUPERCLASS);
+   else
+   {
+      h = hash_int(h, c->superclass->class_id->idnum);
+      h = hash_string(h, c->superclass->class_id->name);
+   }
+
+   for (l = c->resources; l != NULL; l = l->next)
+   {
+      resource_type r = (resource_type) l->data;
+      h = hash_int(h, 'R');
+      h = hash_string(h, r->lhs->name);
+      h = hash_int(h, r->lhs->idnum);
+   }
+
+   for (l = c->classvars; l != NULL; l = l->next)
+   {
+      classvar_type cv = (classvar_type) l->data;
+      h = hash_int(h, 'V');
+      h = hash_string(h, cv->id->name);
+      h = hash_int(h, cv->id->idnum);
+   }
+
+   for (l = c->properties; l != NULL; l = l->next)
+   {
+      property_type prop = (property_type) l->data;
+      h = hash_int(h, 'Y');
+      h = hash_string(h, prop->id->name);
+      h = hash_int(h, prop->id->idnum);
+   }
+
+   for (l = c->messages; l != NULL; l = l->next)
+   {
+      message_handler_type m = (message_handler_type) l->data;
+      h = hash_int(h, 'M');
+      h = hash_string(h, m->header->message_id->name);
+      h = hash_int(h, m->header->message_id->idnum);
+
+      for (p = m->header->params; p != NULL; p = p->next)
+      {
+	 param_type param = (param_type) p->data;
+	 h = hash_int(h, 'P');
+	 h = hash_string(h, param->lhs->name);
+	 h = hash_int(h, param->lhs->idnum);
+      }
+   }
+   return h;
+}
+/************************************************************************/
+/*
+ * external_type:  Return the kind of identifier id is, treating an
+ *   unresolved reference as the kind it will become once defined.
+ */
+static int external_type(id_type id)
+{
+   return id->type == I_MISSING ? id->source : id->type;
+}
+/************************************************************************/
+/*
+ * start_dependencies:  Forget the dependencies of the last file compiled,
+ *   and delete the manifest of the given file, which is about to be
+ *   compiled.  If compilation fails the file then has no manifest.
+ */
+void start_dependencies(char *kod_fname)
+{
+   char temp[256];
+   list_type l;
+
+   for (l = dep_files; l != NULL; l = l->next)
+      free(l->data);
+   dep_files = list_delete(dep_files);
+
+   if (!dep_ids_created)
+   {
+      dep_ids = table_create(TABLESIZE);
+      dep_ids_created = true;
+   }
+   else table_delete(dep_ids);
+
+   set_extension(temp, sizeof(temp), kod_fname, DEPEND_EXTENSION);
+   unlink(temp);
+}
+/************************************************************************/
+/*
+ * note_source_file:  Record that the given source or include file was read.
+ */
+void note_source_file(const char *fname)
+{
+   dep_files = list_add_item(dep_files, strdup(fname));
+}
+/************************************************************************/
+/*
+ * note_external_id:  Record that the code refers to the given global
+ *   identifier, whose id # it will contain.
+ */
+void note_external_id(id_type id)
+{
+   /* Built-in identifiers never change */
+   if (!dep_ids_created || id->type == I_FUNCTION || id->idnum < IDBASE)
+      return;
+
+   table_insert(dep_ids, (void *) id, id_hash, id_compare);
+}
+/************************************************************************/
+/*
+ * add_line:  Add a line, formatted as by printf, to the end of list l.
+ */
+static list_type add_line(list_type l, const char *fmt, ...)
+{
+   char line[512];
+   va_list marker;
+
+   va_start(marker, fmt);
+   vsnprintf(line, sizeof(line), fmt, marker);
+   va_end(marker);
+   return list_add_item(l, strdup(line));
+}
+/************************************************************************/
+/*
+ * finish_dependencies:  Give u the dependencies of the file just parsed:
+ *   the files it read, and the manifest lines for its classes and the
+ *   externals it refers to.  These are taken now, since later files in a
+ *   batch change the symbol table they come from.
+ */
+void finish_dependencies(compile_unit_type u)
+{
+   list_type l, lines = NULL;
+   class_type c, super;
+   id_type id;
+   int i;
+
+   u->dep_files = dep_files;
+   dep_files = NULL;
+
+   for (l = u->classes; l != NULL; l = l->next)
+   {
+      c = (class_type) l->data;
+
+      lines = add_line(lines, "D %s %016llx", c->class_id->name,
+		       (unsigned long long) class_interface_hash(c));
+      for (super = find_superclass(c); super != NULL; super = find_superclass(super))
+	 lines = add_line(lines, "C %s %016llx", super->class_id->name,
+			  (unsigned long long) class_interface_hash(super));
+   }
+
+   for (i=0; i < dep_ids.size; i++)
+      for (l = dep_ids.entries[i]; l != NULL; l = l->next)
+      {
+	 id = (id_type) l->data;
+	 lines = add_line(lines, "E %s %d %d", id->name, external_type(id), id->idnum);
+      }
+
+   u->dep_lines = lines;
+}
+/************************************************************************/
+/*
+ * write_dependencies:  Write the manifest for compile unit u, whose .bof
+ *   (and .rsc, if rsc_fname is not NULL) has just been written.  Reads
+ *   only u, so may be called for different units at once.  Returns true
+ *   on success.
+ */
+bool write_dependencies(compile_unit_type u, char *rsc_fname)
+{
+   char temp[256], path[512], source[512];
+   FILE *f;
+   list_type l;
+   uint64_t hash;
+
+   set_extension(temp, sizeof(temp), u->bof_fname, DEPEND_EXTENSION);
+   make_path(path, sizeof(path), u->dir, temp);
+   if ((f = fopen(path, "wt")) == NULL)
+   {
+      simple_error("Unable to open dependency file %s", path);
+      return false;
+   }
+
+   fprintf(f, "B %d %d\n", BOF_VERSION, debug_bof ? 1 : 0);
+
+   for (l = u->dep_files; l != NULL; l = l->next)
+   {
+      make_path(source, sizeof(source), u->dir, (char *) l->data);
+      if (!hash_file(source, &hash))
+      {
+	 simple_error("Unable to read %s", source);
+	 fclose(f);
+	 unlink(path);
+	 return false;
+      }
+      fprintf(f, "F %s %016llx\n", (char *) l->data, (unsigned long long) hash);
+   }
+
+   fprintf(f, "O %s\n", u->bof_fname);
+   if (rsc_fname != NULL)
+      fprintf(f, "O %s\n", rsc_fname);
+
+   for (l = u->dep_lines; l != NULL; l = l->next)
+      fprintf(f, "%s\n", (char *) l->data);
+
+   fprintf(f, "END\n");
+   fclose(f);
+   return true;
+}
+/************************************************************************/
+/*
+ * external_current:  Return true iff the global identifier with the given
+ *   name is still of the given kind and has the given id #.
+ */
+static bool external_current(const char *name, int type, int idnum)
+{
+   id_struct key;
+   id_type id;
+
+   key.name = (char *) name;
+   id = (id_type) table_lookup(st.globalvars, (void *) &key, id_hash, id_compare);
+   if (id == NULL)
+      id = (id_type) table_lookup(st.missingvars, (void *) &key, id_hash, id_compare);
+
+   return id != NULL && external_type(id) == type && id->idnum == idnum;
+}
+/************************************************************************/
+/*
+ * class_current:  Return true iff the class with the given name exists
+ *   and has the interface with the given hash.
+ */
+static bool class_current(const char *name, const char *hash)
+{
+   class_type c = find_class(name);
+
+   return c != NULL && class_interface_hash(c) == strtoull(hash, NULL, 16);
+}
+/************************************************************************/
+/*
+ * dependencies_current:  Return true iff the given file has a manifest,
+ *   and nothing listed in it has changed, so that compiling the file again
+ *   would give the output it already has.  The classes in a file that is
+ *   up to date are taken off the list of classes to recompile.
+ */
+bool dependencies_current(char *kod_fname)
+{
+   char temp[256], line[512];
+   char *tag, *t1, *t2, *t3;
+   FILE *f;
+   uint64_t hash;
+   list_type l, classes = NULL;
+   int version, debug;
+   bool current = true, ended = false;
+
+   set_extension(temp, sizeof(temp), kod_fname, DEPEND_EXTENSION);
+   if ((f = fopen(temp, "rt")) == NULL)
+      return false;
+
+   /* Output depends on the compiler version and flags too */
+   if (fgets(line, sizeof(line), f) == NULL ||
+       sscanf(line, "B %d %d", &version, &debug) != 2 ||
+       version != BOF_VERSION || debug != (debug_bof ? 1 : 0))
+      current = false;
+
+   while (current && fgets(line, sizeof(line), f) != NULL)
+   {
+      tag = strtok(line, " \t\n");
+      t1 = strtok(NULL, " \t\n");
+      t2 = strtok(NULL, " \t\n");
+      t3 = strtok(NULL, " \t\n");
+
+      if (tag == NULL)
+      {
+	 current = false;
+	 break;
+      }
+
+      if (!strcmp(tag, "END"))
+      {
+	 ended = true;
+	 break;
+      }
+
+      switch (tag[0])
+      {
+      case 'F':
+	 current = t2 != NULL && hash_file(t1, &hash) &&
+	    hash == strtoull(t2, NULL, 16);
+	 break;
+
+      case 'O':
+	 current = t1 != NULL && access(t1, 0) == 0;
+	 break;
+
+      case 'D':
+	 if (t1 != NULL)
+	    classes = list_add_item(classes, strdup(t1));
+	 /* fall through */
+      case 'C':
+	 current = t2 != NULL && class_current(t1, t2);
+	 break;
+
+      case 'E':
+	 current = t3 != NULL && external_current(t1, atoi(t2), atoi(t3));
+	 break;
+
+      default:
+	 current = false;
+	 break;
+      }
+   }
+   fclose(f);
+
+   /* A manifest cut short by a crash proves nothing */
+   current = current && ended;
+
+   for (l = classes; l != NULL; l = l->next)
+   {
+      if (current)
+	 st.recompile_list = list_delete_item(st.recompile_list,
+					      (void *) find_class((char *) l->data)->class_id,
+					      recompile_compare);
+      free(l->data);
+   }
+   list_delete(classes);
+
+   return current;
+}
@@ -0,0 +1,24 @@
+// Meridian 59, Copyright 1994-2012 Andrew Kirmse and Chris Kirmse.
+// All rights reserved.
+//
+// This software is distributed under a license that is described in
+// the LICENSE file that accompanies it.
+//
+// Meridian is a registered trademark.
+/* depend.h
+ * Header file for depend.c
+ */
+
+#ifndef _DEPEND_H
+#define _DEPEND_H
+
+#define DEPEND_EXTENSION ".dep"
+
+void start_dependencies(char *kod_fname);
+void note_source_file(const char *fname);
+void note_external_id(id_type id);
+void finish_dependencies(compile_unit_type u);
+bool write_dependencies(compile_unit_type u, char *rsc_fname);
+bool dependencies_current(char *kod_fname);
+
+#endif /* #ifndef _DEPEND_H */
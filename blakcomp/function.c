@@ -39,6 +39,11 @@ function_type Functions[] = {
 {"DelListElem",         DELLISTELEM,     AEXPRESSION,   AEXPRESSION,    ANONE},
 {"FindListElem",         FINDLISTELEM,     AEXPRESSION,   AEXPRESSION,    ANONE},
 {"MoveListElem",       MOVELISTELEM,     AEXPRESSION,   AEXPRESSION, AEXPRESSION, ANONE},
+{"CreateArray",         CREATEARRAY,     AEXPRESSION,   ANONE},
+{"GetArrayElem",        GETARRAYELEM,    AEXPRESSION,   AEXPRESSION,    ANONE},
+{"SetArrayElem",        SETARRAYELEM,    AEXPRESSION,   AEXPRESSION,    AEXPRESSION, ANONE},
+{"ArrayLength",         ARRAYLENGTH,     AEXPRESSION,   ANONE},
+{"IsArray",             ISARRAY,         AEXPRESSION,   ANONE},
 {"Random",		RANDOM,		 AEXPRESSION,	AEXPRESSION,	ANONE},
 {"AddPacket",           ADDPACKET,       AEXPRESSIONS,  ANONE},
 {"SendPacket",          SENDPACKET,      AEXPRESSION,   ANONE},
@@ -66,6 +71,10 @@ function_type Functions[] = {
 {"CanMoveInRoomFine",CANMOVEINROOMFINE,AEXPRESSION,AEXPRESSION,AEXPRESSION,
     AEXPRESSION,AEXPRESSION,ANONE},
 {"IsPointInSector", POINTINSECTOR, AEXPRESSION, AEXPRESSION, AEXPRESSION, AEXPRESSION, AEXPRESSION, AEXPRESSION, ANONE},
+{"RoomObjectMoved",     ROOMOBJECTMOVED, AEXPRESSION,   AEXPRESSION,AEXPRESSION,AEXPRESSION,ANONE},
+{"RoomObjectRemoved",   ROOMOBJECTREMOVED,AEXPRESSION,  AEXPRESSION,    ANONE},
+{"RoomObjectsInRange",  ROOMOBJECTSINRANGE,AEXPRESSION, AEXPRESSION,AEXPRESSION,AEXPRESSION,ANONE},
+{"RoomObjectsOfClass",  ROOMOBJECTSOFCLASS,AEXPRESSION, AEXPRESSION,    ANONE},
 {"SetResource",         SETRESOURCE,     AEXPRESSION,   AEXPRESSION,  ANONE},
 {"Post",		POSTMESSAGE,   	 AEXPRESSION,	AEXPRESSION, 	ASETTINGS, ANONE},
 {"Abs",                 ABS,             AEXPRESSION,   ANONE},
@@ -49,6 +49,11 @@ void set_kodbase_filename(char *filename)
    basefile = filename;
 }
 
+const char *get_kodbase_filename(void)
+{
+   return basefile;
+}
+
 /*
  * load_kodbase - reads the kodbase.txt file into memory, returns success/failure
  */
@@ -543,8 +548,9 @@ bool save_kodbase()
    /* Loop over all classes, and write them out */
    save_class_list(kodbase, st.classes);
 
-   /* Write out unresolved externals */
-   external_list = table_get_all(st.missingvars);
+   /* Write out unresolved externals, in order so that the file doesn't
+    * depend on how the table was built */
+   external_list = SortExternalList(table_get_all(st.missingvars));
    numexternals = save_externals(kodbase, external_list);
    
    if (numexternals != 0)
@@ -553,3 +559,26 @@ bool save_kodbase()
    fclose(kodbase);
    return true;
 }
+/**********************************************************************/
+/*
+ * checkpoint_kodbase: Leave the symbol table as if it had just been
+ *   saved with save_kodbase and read back in with load_kodbase.  Used
+ *   between files in batch mode, where the database stays in memory.
+ *   Identifiers from files compiled so far are marked as coming from the
+ *   database, so that a later file may redefine them just as it could in
+ *   a separate compiler run.
+ */
+void checkpoint_kodbase(void)
+{
+   list_type l;
+   id_type id;
+   int i;
+
+   for (i=0; i < st.globalvars.size; i++)
+      for (l = st.globalvars.entries[i]; l != NULL; l = l->next)
+      {
+	 id = (id_type) l->data;
+	 if (id->source == COMPILE)
+	    id->source = DBASE;
+      }
+}
@@ -18,9 +18,10 @@ char *GetStringFromResource(resource_type r);
 /*
  * write_resources: Write out resources to a .rsc file.  fname should be the 
  *    name of the .rsc file to receive the resources.  Resources are found by
- *    looping through all the classes in the symbol table.
+ *    looping through the given list of classes.  Returns true iff
+ *    a file was written; there is none if the classes have no resources.
  */
-void write_resources(char *fname)
+bool write_resources(char *fname, list_type classes)
 {
    list_type c, l;
    resource_type r;
@@ -31,26 +32,25 @@ void write_resources(char *fname)
 
    /* Count resources and compute length */
    num_resources = 0;
-   for (c = st.classes; c != NULL; c = c->next)
+   for (c = classes; c != NULL; c = c->next)
    {
       cl = (class_type) c->data;
-      if (cl->is_new)
-         for (l = cl->resources; l != NULL; l = l->next)
-         {
-            r = (resource_type) (l->data);
-            
-            num_resources++;
-         }
+      for (l = cl->resources; l != NULL; l = l->next)
+      {
+         r = (resource_type) (l->data);
+         
+         num_resources++;
+      }
    }
    /* If no resources, do nothing */
    if (num_resources == 0)
-      return;
+      return false;
    
    f = fopen(fname, "wb");
    if (f == NULL)
    {
       simple_error("Unable to open resource file %s!", fname);
-      return;
+      return false;
    }
    
    /* Write out header information */
@@ -62,24 +62,24 @@ void write_resources(char *fname)
    fwrite(&num_resources, 4, 1, f);
 
    /* Loop through classes in this source file, and then their resources */
-   for (c = st.classes; c != NULL; c = c->next)
+   for (c = classes; c != NULL; c = c->next)
    {
       cl = (class_type) c->data;
-      if (cl->is_new)
-         for (l = cl->resources; l != NULL; l = l->next)
-         {
-            r = (resource_type) (l->data);
-            
-            // Write out id #
-            fwrite(&r->lhs->idnum, 4, 1, f);
-            
-            // Write string
-            str = GetStringFromResource(r);
-            fwrite(str, strlen(str) + 1, 1, f);
-         }
+      for (l = cl->resources; l != NULL; l = l->next)
+      {
+         r = (resource_type) (l->data);
+         
+         // Write out id #
+         fwrite(&r->lhs->idnum, 4, 1, f);
+         
+         // Write string
+         str = GetStringFromResource(r);
+         fwrite(str, strlen(str) + 1, 1, f);
+      }
    }
 
    fclose(f);
+   return true;
 }
 /***************************************************************************/
 char *GetStringFromResource(resource_type r)
@@ -12,6 +12,6 @@
 #ifndef _RESOURCE_H
 #define _RESOURCE_H
 
-void write_resources(char *fname);
+bool write_resources(char *fname, list_type classes);
 
 #endif /* #ifndef _RESOURCE_H */
@@ -45,6 +45,11 @@ int CompareMessageHandlers(void *hand1, void *hand2)
    return (h1->header->message_id->idnum < h2->header->message_id->idnum);
 }
 /************************************************************************/
+int CompareExternals(void *id1, void *id2)
+{
+   return (((id_type) id1)->idnum < ((id_type) id2)->idnum);
+}
+/************************************************************************/
 /* 
  * SortParameterList: Sort the given list in place, and return it.
  *   params must be a list of param_type; that is, a list of message
@@ -101,6 +106,16 @@ list_type SortMessageHandlerList(list_type handlers)
    return InsertionSort(handlers, CompareMessageHandlers);
 }
 /************************************************************************/
+/*
+ * SortExternalList: Sort the given list in place by id #, and return it.
+ *   externals must be a list of id_type, such as the unresolved externals,
+ *   which are kept in a hash table in no particular order.
+ */
+list_type SortExternalList(list_type externals)
+{
+   return InsertionSort(externals, CompareExternals);
+}
+/************************************************************************/
 /*
  * InsertionSort:  Perform an in-place insertion sort on the given list,
  *   and return it.
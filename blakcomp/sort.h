@@ -15,6 +15,7 @@
 list_type SortParameterList(list_type params);
 list_type SortArgumentList(list_type args);
 list_type SortMessageHandlerList(list_type handlers);
+list_type SortExternalList(list_type externals);
 
 
 #endif /* #ifndef _SORT_H */
@@ -65,23 +65,35 @@ void set_extension(char *newfile, int newfile_len, const char *filename, const c
    strcat(newfile, extension);
 }
 /************************************************************************/
+/*
+ * make_path: Set path to the name of file fname in directory dir.  fname
+ *    is used as it is if dir is NULL or fname is already absolute.
+ */
+void make_path(char *path, int path_len, const char *dir, const char *fname)
+{
+   if (dir == NULL || fname[0] == '/' || fname[0] == '\\' ||
+       (isalpha((unsigned char) fname[0]) && fname[1] == ':'))
+      snprintf(path, path_len, "%s", fname);
+   else snprintf(path, path_len, "%s/%s", dir, fname);
+}
+/************************************************************************/
 /*
  * string_hash: return a number i s.t. 0 <= i < max based on given
- *      string.  This function was stolen from Bison.
- *      Max should be odd for best results.
+ *      string.  FNV-1a over every character, so that names sharing a
+ *      long suffix (..._name_rsc, ..._desc_rsc) still spread out.
  *  NOTE: It's case insensitive!!!
  */
 int string_hash(const char *name, int max)
 {
-   const char *cp = name;
-   int k = 0;
-   while (*cp++)
+   const unsigned char *cp = (const unsigned char *) name;
+   unsigned int k = 2166136261u;
+   while (*cp)
    {
-      char ch = tolower(*cp);
-      k = ((k << 1) ^ (ch)) & 0x3fff;
+      k ^= (unsigned int) tolower(*cp++);
+      k *= 16777619u;
    }
    
-   return k % max;
+   return (int) (k % (unsigned int) max);
 }
 /* List abstraction: use void pointers to point to data field. */
 /************************************************************************/
@@ -558,6 +558,12 @@ const char * name_function(int fnum)
    case FINDLISTELEM : return "FindListElem";
    case MOVELISTELEM : return "MoveListElem";
 
+   case CREATEARRAY : return "CreateArray";
+   case GETARRAYELEM : return "GetArrayElem";
+   case SETARRAYELEM : return "SetArrayElem";
+   case ARRAYLENGTH : return "ArrayLength";
+   case ISARRAY : return "IsArray";
+
    case GETTIME : return "GetTime";
 
    case ABS: return "Abs";
@@ -32,6 +32,7 @@
 */
 
 #include "blakserv.h"
+#include "json_utils.h"
 
 enum { N,S,I,R }; /* no more params, string param, int param, rest of line param */
 
@@ -97,6 +98,15 @@ void AdminShowMemory(int session_id,admin_parm_type parms[],
                      int num_blak_parm,parm_node blak_parm[]);
 void AdminShowCalled(int session_id,admin_parm_type parms[],
                      int num_blak_parm,parm_node blak_parm[]);
+void AdminShowWebhooks(int session_id,admin_parm_type parms[],
+                       int num_blak_parm,parm_node blak_parm[]);
+void AdminShowLatency(int session_id,admin_parm_type parms[],
+                      int num_blak_parm,parm_node blak_parm[]);
+void AdminShowLatencyJson(int session_id,admin_parm_type parms[],
+                          int num_blak_parm,parm_node blak_parm[]);
+void AdminShowLatencyEachSession(session_node *s);
+void AdminShowMetrics(int session_id,admin_parm_type parms[],
+                      int num_blak_parm,parm_node blak_parm[]);
 void AdminShowCalledClass(class_node *c);
 
 void AdminShowObject(int session_id,admin_parm_type parms[],
@@ -267,6 +277,8 @@ void AdminBlockIP(int session_id,admin_parm_type parms[],
 
 void AdminReloadSystem(int session_id,admin_parm_type parms[],
                        int num_blak_parm,parm_node blak_parm[]);
+void AdminReloadKod(int session_id,admin_parm_type parms[],
+                    int num_blak_parm,parm_node blak_parm[]);
 void AdminReloadGame(int session_id,admin_parm_type parms[],
                      int num_blak_parm,parm_node blak_parm[]);
 void AdminReloadGameEachSession(session_node *s);
@@ -296,6 +308,17 @@ void AdminRead(int session_id,admin_parm_type parms[],
 void AdminMark(int session_id,admin_parm_type parms[],
                int num_blak_parm,parm_node blak_parm[]);
 
+void AdminProfileFlamegraph(int session_id,admin_parm_type parms[],
+                            int num_blak_parm,parm_node blak_parm[]);
+void AdminProfileFlamegraphStack(const char *stack,int count);
+void AdminProfileShow(int session_id,admin_parm_type parms[],
+                      int num_blak_parm,parm_node blak_parm[]);
+void AdminProfileShowNode(profile_node *p);
+void AdminProfileStart(int session_id,admin_parm_type parms[],
+                       int num_blak_parm,parm_node blak_parm[]);
+void AdminProfileStop(int session_id,admin_parm_type parms[],
+                      int num_blak_parm,parm_node blak_parm[]);
+
 admin_table_type admin_show_table[] =
 {
 	{ AdminShowAccount,       {R,N}, false, A|M, NULL, 0, "account",
@@ -312,12 +335,16 @@ admin_table_type admin_show_table[] =
 	{ AdminShowDynamicResources,{N}, false, A, NULL, 0, "dynamic",       "Show all dynamic resources" },
 	{ AdminShowExactInstances,{S,N}, false, A, NULL, 0, "exactinstances", "Show all instances of class, excluding subclasses" },
 	{ AdminShowInstances,     {S,N}, false, A, NULL, 0, "instances",     "Show all instances of class" },
+	{ AdminShowLatency,       {N},   false, A|M, NULL, 0, "latency",       "Show main loop latency percentiles" },
+	{ AdminShowLatencyJson,   {N},   false, A|M, NULL, 0, "latencyjson",
+	"Show main loop latency histograms as JSON" },
 	{ AdminShowList,          {I,N}, false, A|M, NULL, 0, "list",          "Traverse & show a list" },
 	{ AdminShowListNode,      {I,N}, false, A|M, NULL, 0, "listnode",      "Show one list node by id" },
 	{ AdminShowMatches,       {S,S,S,S,S,N}, false, A, NULL, 0, "matches",     "Show all instances of class which match criteria" },
 	{ AdminShowMemory,        {N},   false, A|M, NULL, 0, "memory",        "Show system memory use" },
 	{ AdminShowMessage,       {S,S,N},false,A|M, NULL, 0, "message",
 	"Show info about class & message" },
+	{ AdminShowMetrics,       {N},   false, A|M, NULL, 0, "metrics",       "Show server metrics for Prometheus" },
 	{ AdminShowName,          {R,N}, false, A|M, NULL, 0, "name",          "Show object of user name" },
 	{ AdminShowObject,        {I,N}, false, A|M, NULL, 0, "object",        "Show one object by id" },
 	{ AdminShowPackages,      {N},   false,A, NULL, 0, "packages",       "Show all packages loaded" },
@@ -337,6 +364,7 @@ admin_table_type admin_show_table[] =
 	{ AdminShowUsage,         {N},   false,A|M,NULL, 0, "usage",         "Show current usage" },
 	{ AdminShowUser,          {R,N}, false, A|M, NULL, 0, "user",          "Show one user by name or object id" },
 	{ AdminShowUsers,         {N},   false, A, NULL, 0, "users",         "Show all users" },
+	{ AdminShowWebhooks,      {N},   false, A|M, NULL, 0, "webhooks",      "Show webhook queue and pipe status" },
 };
 #define LEN_ADMIN_SHOW_TABLE (sizeof(admin_show_table)/sizeof(admin_table_type))
 
@@ -455,15 +483,27 @@ admin_table_type admin_hangup_table[] =
 {
 	{ AdminHangupAccount,  {R,N},  false, A|M, NULL, 0, "account", "Hangup one account" },
 	{ AdminHangupAll,      {N},    false, A|M, NULL, 0, "all", "Hangup all users" },
-	{ AdminBlockIP,        {R,N},  false, A|M, NULL, 0, "ip", "Block an IP address (temporarily)" },
+	{ AdminBlockIP,        {R,N},  false, A|M, NULL, 0, "ip", "Block an IP address or address/bits (temporarily)" },
 	{ AdminHangupSession,  {I,N},  false, A, NULL, 0, "session", "Hangup one session" },
 	{ AdminHangupUser,     {R,N},  false, A|M, NULL, 0, "user", "Hangup one user" },
 };
 #define LEN_ADMIN_HANGUP_TABLE (sizeof(admin_hangup_table)/sizeof(admin_table_type))
 
+admin_table_type admin_profile_table[] =
+{
+	{ AdminProfileFlamegraph, {N},   false, A|M, NULL, 0, "flamegraph",
+	"Show sampled Blakod stacks in collapsed format for flamegraph tools" },
+	{ AdminProfileShow,       {I,N}, false, A|M, NULL, 0, "show",
+	"Show top (int) message handlers by exclusive time" },
+	{ AdminProfileStart,      {N},   false, A|M, NULL, 0, "start",  "Clear and start profiling Blakod" },
+	{ AdminProfileStop,       {N},   false, A|M, NULL, 0, "stop",   "Stop profiling Blakod" },
+};
+#define LEN_ADMIN_PROFILE_TABLE (sizeof(admin_profile_table)/sizeof(admin_table_type))
+
 admin_table_type admin_reload_table[] =
 {
 	{ AdminReloadGame,     {I,N}, false, A|M, NULL, 0, "game",   "Reload game from any save time (0 for last)" },
+	{ AdminReloadKod,      {N},   false, A|M, NULL, 0, "kod",    "Load newly compiled kod without saving or reloading the game" },
 	{ AdminReloadMotd,     {N},   false, A|M, NULL, 0, "motd",   "Reload message of the day from file" },
 	{ AdminReloadPackages, {N},   false, A|M, NULL, 0, "packages","Rescan upload directory for packages" },
 	{ AdminReloadSystem,   {N},   false, A|M, NULL, 0, "system", "Save game and reload all kod, motd" },
@@ -517,6 +557,7 @@ admin_table_type admin_main_table[] =
 	{ AdminMail,          {N},   false, A, NULL, 0, "mail",      "Read administrator mail" },
 	{ AdminMark,          {N},   false, A|M, NULL, 0, "mark",      "Mark all channel logs with a dashed line" },
 	{ AdminPage,          {N},   false, A, NULL, 0, "page",      "Page the console" },
+	{ NULL, {N}, false, A, admin_profile_table, LEN_ADMIN_PROFILE_TABLE, "profile", "Profile subcommand" },
 	{ AdminRead,          {S,N}, false, A|M, NULL, 0, "read",      "Read admin commands from a file, echoes everything" },
 	{ NULL, {N}, false, A, admin_recreate_table,LEN_ADMIN_RECREATE_TABLE, "recreate", "Recreate subcommand" },
 	{ NULL, {N}, false, A, admin_reload_table, LEN_ADMIN_RELOAD_TABLE, "reload", "Reload subcommand" },
@@ -1333,6 +1374,7 @@ void AdminShowStatus(int session_id,admin_parm_type parms[],
 	aprintf("Handled %i top level messages, total %i messages\n",
 		kstat->num_top_level_messages, kstat->num_messages);
 	aprintf("Deepest message call stack is %i calls from top level\n",kstat->message_depth_highest);
+	aprintf("Most posted messages waiting at once is %i\n",kstat->post_queue_highest);
 	aprintf("Most instructions on one top level message is %i instructions\n",kstat->num_interpreted_highest);
 	aprintf("Number of top level messages over 1000 milliseconds is %i\n",kstat->interpreting_time_over_second);
 	aprintf("Longest time on one top level message is %i milliseconds\n",kstat->interpreting_time_highest);
@@ -1357,9 +1399,19 @@ void AdminShowStatus(int session_id,admin_parm_type parms[],
 		ConfigInt(SOCKET_PORT),
 		ConfigInt(SOCKET_MAINTENANCE_PORT));
 	aprintf("There are %i sessions logged on\n", GetUsedSessions());
+	aprintf("There are %i blocked addresses and prefixes\n", GetNumBlocks());
+	aprintf("Closed %" PRIu64 " connections over the connection rate limits, tracking %i addresses\n",
+		metric_counters[METRIC_CONNECTIONS_LIMITED].load(std::memory_order_relaxed),
+		GetNumConnectRateAddresses());
+
+	channel_stats cstat;
+	GetChannelStats(&cstat);
+	aprintf("Logged %i channel messages, folded %i repeats, dropped %i\n",
+		cstat.written,cstat.repeated,cstat.dropped);
 
 	aprintf("----\n");
 	aprintf("Used %i list nodes\n",GetListNodesUsed());
+	aprintf("Used %i arrays\n",GetArraysUsed());
 	aprintf("Used %i object nodes\n",GetObjectsUsed());
 	aprintf("Used %i string nodes\n",GetStringsUsed());
 	aprintf("Watching %i active timers\n",GetNumActiveTimers());
@@ -1379,19 +1431,193 @@ void AdminShowMemory(int session_id,admin_parm_type parms[],
 
 	mstat = GetMemoryStats();
 
-	size_t total = 0;
+	size_t total = 0,pool_reserved = 0,pool_used = 0;
 
 	aprintf("%s\n",TimeStr(GetTime()).c_str());
+	/* Pooled is what the pools of small blocks have taken from the system,
+	   and Free how much of that is on their free lists or not cut up yet */
+	aprintf("%-20s %10s %10s %9s %10s %5s\n","","Bytes","Peak","Blocks","Pooled","Free");
 	for (int i=0;i<GetNumMemoryStats();i++)
 	{
-		aprintf("%-20s %8lu\n",GetMemoryStatName(i),mstat->allocated[i]);
+		aprintf("%-20s %10lu %10lu %9lu",GetMemoryStatName(i),mstat->allocated[i],
+			mstat->peak[i],mstat->live[i]);
+		if (mstat->pool_reserved[i] > 0)
+			aprintf(" %10lu %4lu%%\n",mstat->pool_reserved[i],
+				(mstat->pool_reserved[i] - mstat->pool_used[i])*100/mstat->pool_reserved[i]);
+		else
+			aprintf("\n");
 		total += mstat->allocated[i];
+		pool_reserved += mstat->pool_reserved[i];
+		pool_used += mstat->pool_used[i];
 	}
 	aprintf("%-20s %4lu MB\n","-- Total",total/1024/1024);
+	if (pool_reserved > 0)
+		aprintf("%-20s %4lu KB, %lu%% free\n","-- Pooled",pool_reserved/1024,
+			(pool_reserved - pool_used)*100/pool_reserved);
+
+	const string_intern_stats *istat = GetStringInternStats();
+	aprintf("%-20s %8i nodes share %i strings (%.2f:1)\n","Interned strings",
+		istat->references,istat->unique,
+		istat->unique ? (double) istat->references / istat->unique : 0.0);
+	aprintf("%-20s %8lu\n","Intern bytes saved",
+		(unsigned long) (istat->bytes_referenced - istat->bytes));
 
 	aprintf("-------------------------------------------\n");
 }
 
+void AdminShowWebhooks(int session_id,admin_parm_type parms[],
+                       int num_blak_parm,parm_node blak_parm[])
+{
+	webhook_stats wstat;
+	int i;
+
+	aprintf("Webhooks ----------------------------------\n");
+
+	if (!IsWebhookEnabled())
+	{
+		aprintf("Webhooks are disabled\n");
+		aprintf("-------------------------------------------\n");
+		return;
+	}
+
+	GetWebhookStats(&wstat);
+
+	aprintf("Queued %i (highest %i), posted %i, dropped %i, undelivered %i\n",
+		wstat.queued,wstat.queued_max,wstat.posted,wstat.dropped,wstat.undelivered);
+	aprintf("%4s %-9s %8s %8s %10s %6s %8s %8s\n","Pipe","State","Messages","Writes",
+		"Bytes","Full","Connects","Disconn");
+	for (i=0;i<MAX_WEBHOOK_PIPES;i++)
+	{
+		webhook_pipe_stats *p = &wstat.pipes[i];
+		if (p->connects == 0)
+			continue;
+		aprintf("%4i %-9s %8i %8i %10" PRId64 " %6i %8i %8i\n",i+1,
+			p->connected ? "connected" : "closed",p->messages,p->writes,
+			p->bytes,p->full,p->connects,p->disconnects);
+	}
+
+	aprintf("-------------------------------------------\n");
+}
+
+/* the sessions whose input has waited longest, for show latency */
+#define LATENCY_SHOW_SESSIONS 10
+static std::vector<session_node *> latency_sessions;
+
+void AdminShowLatencyEachSession(session_node *s)
+{
+	if (s->conn.type != CONN_CONSOLE && s->input_delay_max > 0)
+		latency_sessions.push_back(s);
+}
+
+static bool AdminShowLatencyCompare(session_node *s1,session_node *s2)
+{
+	return s1->input_delay_max > s2->input_delay_max;
+}
+
+static void AdminGetLatencySessions(void)
+{
+	latency_sessions.clear();
+	ForEachSession(AdminShowLatencyEachSession);
+	std::sort(latency_sessions.begin(),latency_sessions.end(),AdminShowLatencyCompare);
+	if (latency_sessions.size() > LATENCY_SHOW_SESSIONS)
+		latency_sessions.resize(LATENCY_SHOW_SESSIONS);
+}
+
+void AdminShowLatency(int session_id,admin_parm_type parms[],
+                      int num_blak_parm,parm_node blak_parm[])
+{
+	const histogram_type *h;
+	session_node *s;
+	int i;
+
+	aprintf("Latency since %s, in ms ---------------------------\n",
+		TimeStr(GetLatencyStartTime()).c_str());
+	aprintf("%-10s %10s %9s %9s %9s %9s %9s %9s\n","Phase","Count","Mean",
+		"p50","p90","p99","p99.9","Max");
+
+	for (i=0;i<NUM_LATENCY;i++)
+	{
+		h = GetLatencyHistogram(i);
+		aprintf("%-10s %10" PRIu64 " %9.3f %9.3f %9.3f %9.3f %9.3f %9.3f\n",
+			GetLatencyName(i),h->count,HistogramMean(h)/1000.0,
+			HistogramPercentile(h,50.0)/1000.0,HistogramPercentile(h,90.0)/1000.0,
+			HistogramPercentile(h,99.0)/1000.0,HistogramPercentile(h,99.9)/1000.0,
+			h->max/1000.0);
+	}
+
+	aprintf("Stalls over %i ms: %i\n",ConfigInt(DEBUG_STALL),GetLatencyNumStalls());
+
+	AdminGetLatencySessions();
+	if (!latency_sessions.empty())
+	{
+		aprintf("Longest input delays:\n");
+		for (i=0;i<(int)latency_sessions.size();i++)
+		{
+			s = latency_sessions[i];
+			aprintf("  session %4i %-20s %9.3f\n",s->session_id,
+				s->account == NULL ? "?" : s->account->name.c_str(),s->input_delay_max/1000.0);
+		}
+	}
+	latency_sessions.clear();
+
+	aprintf("-----------------------------------------------------------------------------\n");
+}
+
+/* One JSON object, in microseconds.  Each histogram lists its nonempty
+   buckets as [largest value in bucket, count] pairs, so that a collector
+   can subtract two dumps and merge dumps from several servers. */
+void AdminShowLatencyJson(int session_id,admin_parm_type parms[],
+                          int num_blak_parm,parm_node blak_parm[])
+{
+	const histogram_type *h;
+	session_node *s;
+	int i,j;
+	bool first;
+
+	aprintf("{\"since\":%" PRId64 ",\"stall_ms\":%i,\"stalls\":%i,\"phases\":{",
+		(INT64) GetLatencyStartTime(),ConfigInt(DEBUG_STALL),GetLatencyNumStalls());
+
+	for (i=0;i<NUM_LATENCY;i++)
+	{
+		h = GetLatencyHistogram(i);
+		aprintf("%s\"%s\":{\"count\":%" PRIu64 ",\"sum\":%" PRIu64 ",\"max\":%" PRIu64
+			",\"p50\":%" PRIu64 ",\"p90\":%" PRIu64 ",\"p99\":%" PRIu64 ",\"p999\":%" PRIu64
+			",\"buckets\":[",
+			i == 0 ? "" : ",",GetLatencyName(i),h->count,h->sum,h->max,
+			HistogramPercentile(h,50.0),HistogramPercentile(h,90.0),
+			HistogramPercentile(h,99.0),HistogramPercentile(h,99.9));
+
+		first = true;
+		for (j=0;j<HISTOGRAM_BUCKETS;j++)
+		{
+			if (h->buckets[j] == 0)
+				continue;
+			aprintf("%s[%" PRIu64 ",%" PRIu64 "]",first ? "" : ",",
+				HistogramBucketTop(j),h->buckets[j]);
+			first = false;
+		}
+		aprintf("]}");
+	}
+
+	aprintf("},\"sessions\":[");
+	AdminGetLatencySessions();
+	for (i=0;i<(int)latency_sessions.size();i++)
+	{
+		s = latency_sessions[i];
+		aprintf("%s{\"session\":%i,\"account\":\"%s\",\"input_delay_max\":%i}",
+			i == 0 ? "" : ",",s->session_id,
+			JsonEscape(s->account == NULL ? "" : s->account->name).c_str(),s->input_delay_max);
+	}
+	latency_sessions.clear();
+	aprintf("]}\n");
+}
+
+void AdminShowMetrics(int session_id,admin_parm_type parms[],
+                      int num_blak_parm,parm_node blak_parm[])
+{
+	WriteMetrics(aprintf);
+}
+
 static int show_messages_ignore_count;
 static int show_messages_ignore_id;
 static int show_messages_count;
@@ -1534,9 +1760,9 @@ void AdminShowObject(int session_id,admin_parm_type parms[],
 		if (i == 0)
 			prop_name = "self";
 		else
-			prop_name = GetPropertyNameByID(c,o->p[i].id);
+			prop_name = GetPropertyNameByID(c,i);
 		if (prop_name == NULL)
-			snprintf(buf, sizeof(buf), ": #%-19i",o->p[i].id);
+			snprintf(buf, sizeof(buf), ": #%-19i",i);
 		else
 			snprintf(buf, sizeof(buf), ": %-20s",prop_name);
 		aprintf("%s = %s %s\n",buf,GetTagName(o->p[i].val),
@@ -2067,6 +2293,10 @@ void AdminShowCalls(int session_id,admin_parm_type parms[],
 		case ROOMDATA : strncpy(c_name, "RoomData", sizeof(c_name)); break;
 		case CANMOVEINROOM : strncpy(c_name, "CanMoveInRoom", sizeof(c_name)); break;
 		case CANMOVEINROOMFINE : strncpy(c_name, "CanMoveInRoomFine", sizeof(c_name)); break;
+		case ROOMOBJECTMOVED : strncpy(c_name, "RoomObjectMoved", sizeof(c_name)); break;
+		case ROOMOBJECTREMOVED : strncpy(c_name, "RoomObjectRemoved", sizeof(c_name)); break;
+		case ROOMOBJECTSINRANGE : strncpy(c_name, "RoomObjectsInRange", sizeof(c_name)); break;
+		case ROOMOBJECTSOFCLASS : strncpy(c_name, "RoomObjectsOfClass", sizeof(c_name)); break;
 		case MINIGAMENUMBERTOSTRING : strncpy(c_name, "MinigameNumberToString", sizeof(c_name)); break;
 		case MINIGAMESTRINGTONUMBER : strncpy(c_name, "MinigameStringToNumber", sizeof(c_name)); break;
 		case CONS : strncpy(c_name, "Cons", sizeof(c_name)); break;
@@ -2081,6 +2311,11 @@ void AdminShowCalls(int session_id,admin_parm_type parms[],
 		case DELLISTELEM : strncpy(c_name, "DelListElem", sizeof(c_name)); break;
 		case FINDLISTELEM : strncpy(c_name, "FindListElem", sizeof(c_name)); break;
 		case MOVELISTELEM : strncpy(c_name, "MoveListElem", sizeof(c_name)); break;
+		case CREATEARRAY : strncpy(c_name, "CreateArray", sizeof(c_name)); break;
+		case GETARRAYELEM : strncpy(c_name, "GetArrayElem", sizeof(c_name)); break;
+		case SETARRAYELEM : strncpy(c_name, "SetArrayElem", sizeof(c_name)); break;
+		case ARRAYLENGTH : strncpy(c_name, "ArrayLength", sizeof(c_name)); break;
+		case ISARRAY : strncpy(c_name, "IsArray", sizeof(c_name)); break;
 		case GETTIME : strncpy(c_name, "GetTime", sizeof(c_name)); break;
 		case ABS : strncpy(c_name, "Abs", sizeof(c_name)); break;
 		case BOUND : strncpy(c_name, "Bound", sizeof(c_name)); break;
@@ -2221,13 +2456,18 @@ void AdminShowClass(int session_id,admin_parm_type parms[],
 
 }
 
+static int admin_num_instances;
+
+static void AdminShowInstance(object_node *o)
+{
+	aprintf(" OBJECT %i", o->object_id);
+	admin_num_instances++;
+}
+
 void AdminShowExactInstances(int session_id, admin_parm_type parms[],
 	int num_blak_parm, parm_node blak_parm[])
 {
-	int i, m;
 	class_node* c;
-	extern object_node* objects;
-	extern int num_objects;
 
 	char* class_str;
 	class_str = (char*)parms[0];
@@ -2240,27 +2480,16 @@ void AdminShowExactInstances(int session_id, admin_parm_type parms[],
 	}
 
 	aprintf(":< instances (excluding subclasses) of CLASS %s (%i)\n:", c->class_name, c->class_id);
-	m = 0;
-	for (i = 0; i < num_objects; i++)
-	{
-		class_node* wc = GetClassByID(objects[i].class_id);
-		if (wc == c)
-		{
-			aprintf(" OBJECT %i", i);
-			m++;
-		}
-	}
-	aprintf("\n: %i total", m);
+	admin_num_instances = 0;
+	ForEachObjectOfClass(c, false, AdminShowInstance);
+	aprintf("\n: %i total", admin_num_instances);
 	aprintf("\n:>\n");
 }
 
 void AdminShowInstances(int session_id,admin_parm_type parms[],
                         int num_blak_parm,parm_node blak_parm[])
 {
-	int i, m;
 	class_node *c;
-	extern object_node* objects;
-	extern int num_objects;
 
 	char *class_str;
 	class_str = (char *)parms[0];
@@ -2273,22 +2502,9 @@ void AdminShowInstances(int session_id,admin_parm_type parms[],
 	}
 
 	aprintf(":< instances of CLASS %s (%i)\n:",c->class_name,c->class_id);
-	m = 0;
-	for (i = 0; i < num_objects; i++)
-	{
-		class_node* wc = GetClassByID(objects[i].class_id);
-		while (wc)
-		{
-			if (wc == c)
-			{
-				aprintf(" OBJECT %i", i);
-				m++;
-				break;
-			}
-			wc = wc->super_ptr;
-		}
-	}
-	aprintf("\n: %i total", m);
+	admin_num_instances = 0;
+	ForEachObjectOfClass(c, true, AdminShowInstance);
+	aprintf("\n: %i total", admin_num_instances);
 	aprintf("\n:>\n");
 }
 
@@ -2612,7 +2828,7 @@ void AdminShowReferencesEachObject(object_node *o)
 			admin_show_references_current_prop = "self";
 		else
 			admin_show_references_current_prop =
-			GetPropertyNameByID(admin_show_references_current_class,o->p[i].id);
+			GetPropertyNameByID(admin_show_references_current_class,i);
 
 		if (o->p[i].val.int_val == admin_show_references_value.int_val)
 		{
@@ -4195,27 +4411,27 @@ void AdminHangupUser(int session_id,admin_parm_type parms[],
 	HangupSession(hangup_session);
 }
 
-extern block_node* FindBlock(struct in_addr* piaPeer);
-
 /*
- * AdminBlockIP - Block an IP address from accessing this server
+ * AdminBlockIP - Block an IP address, or address/bits prefix, from accessing
+ *   this server, or unblock it if it's already blocked
  */
 
 void AdminBlockIP(int session_id,admin_parm_type parms[],
                   int num_blak_parm,parm_node blak_parm[])
 {
-	struct in_addr blocktoAdd;
+	ip_key blocktoAdd;
+	int prefix_len;
 	char *arg_str = (char *)parms[0];
 
 	aprintf("This command will only affect specified IPs until the server reboots\n");
 
-	if( ( blocktoAdd.s_addr = inet_addr( arg_str ) ) != -1 ) {
-		if(FindBlock( &blocktoAdd ) == NULL )  {
-			AddBlock(-1, &blocktoAdd);
-			aprintf("IP %s blocked\n",inet_ntoa( blocktoAdd ) );
+	if( ParseIPPrefix( arg_str, &blocktoAdd, &prefix_len ) ) {
+		if( !FindBlock( &blocktoAdd, prefix_len ) )  {
+			AddBlockPrefix(-1, &blocktoAdd, prefix_len);
+			aprintf("IP %s blocked\n",IPPrefixStr( &blocktoAdd, prefix_len ).c_str() );
 		} else {
-			DeleteBlock( &blocktoAdd );
-			aprintf("IP %s has been unblocked\n" ,inet_ntoa( blocktoAdd ) );
+			DeleteBlock( &blocktoAdd, prefix_len );
+			aprintf("IP %s has been unblocked\n" ,IPPrefixStr( &blocktoAdd, prefix_len ).c_str() );
 		}
 	}  else {
 		aprintf("Couldn`t build IP address bad format %s\n",arg_str );
@@ -4342,6 +4558,7 @@ void AdminReloadSystem(int session_id,admin_parm_type parms[],
 	ResetResource();
 	ResetTimer();
 	ResetList();
+	ResetArray();
 	ResetObject();
 	ResetMessage();
 	ResetClass();
@@ -4373,6 +4590,32 @@ void AdminReloadSystem(int session_id,admin_parm_type parms[],
 	UnpauseTimers();
 }
 
+void AdminReloadKod(int session_id,admin_parm_type parms[],
+                    int num_blak_parm,parm_node blak_parm[])
+{
+	int num_files;
+	UINT64 start_time;
+
+	lprintf("AdminReloadKod reloading changed kod\n");
+
+	aprintf("Loading new .bof files... ");
+	AdminSendBufferList();
+
+	start_time = GetMilliCount();
+	num_files = ReloadBof();
+	if (num_files < 0)
+	{
+		aprintf("failed; see the error log.\n");
+		return;
+	}
+
+	if (num_files > 0)
+		UpdateSecurityRedbook();
+
+	aprintf("%i file%s in %u ms.\n",num_files,num_files == 1 ? "" : "s",
+			  (unsigned int) (GetMilliCount() - start_time));
+}
+
 /* stuff for foreachsession */
 int accounts_in_game;
 void AdminReloadGame(int session_id,admin_parm_type parms[],
@@ -4401,6 +4644,7 @@ void AdminReloadGame(int session_id,admin_parm_type parms[],
 	ResetString();
 	ResetTimer();
 	ResetList();
+	ResetArray();
 	ResetObject();
 	aprintf("done.\n");
 	AdminSendBufferList();
@@ -4589,3 +4833,79 @@ void AdminMark(int session_id,admin_parm_type parms[],
 	dprintf("-------------------------------------------------------------------------------------\n");
 	eprintf("-------------------------------------------------------------------------------------\n");
 }
+
+void AdminProfileStart(int session_id,admin_parm_type parms[],
+                       int num_blak_parm,parm_node blak_parm[])
+{
+	StartProfiling(ConfigInt(BLAKOD_PROFILE_INTERVAL));
+	aprintf("Profiling Blakod, sampling every %i instructions.\n",GetProfileInterval());
+}
+
+void AdminProfileStop(int session_id,admin_parm_type parms[],
+                      int num_blak_parm,parm_node blak_parm[])
+{
+	if (!GetKodStats()->profiling)
+	{
+		aprintf("Blakod is not being profiled.\n");
+		return;
+	}
+
+	StopProfiling();
+	aprintf("Stopped profiling after %.1f seconds, with %i samples.\n",
+		GetProfileElapsedMilli()/1000.0,GetProfileNumSamples());
+}
+
+static std::vector<profile_node *> profile_show_nodes;
+
+void AdminProfileShowNode(profile_node *p)
+{
+	profile_show_nodes.push_back(p);
+}
+
+static bool AdminProfileCompare(profile_node *p1,profile_node *p2)
+{
+	return p1->exclusive_ns > p2->exclusive_ns;
+}
+
+void AdminProfileShow(int session_id,admin_parm_type parms[],
+                      int num_blak_parm,parm_node blak_parm[])
+{
+	profile_node *p;
+	class_node *c;
+	int i,num_show;
+
+	num_show = (int)parms[0];
+	num_show = std::max(1,num_show);
+	num_show = std::min(500,num_show);
+
+	profile_show_nodes.clear();
+	ForEachProfileNode(AdminProfileShowNode);
+	std::sort(profile_show_nodes.begin(),profile_show_nodes.end(),AdminProfileCompare);
+
+	aprintf("Profiled for %.1f seconds%s, %i samples.\n",GetProfileElapsedMilli()/1000.0,
+		GetKodStats()->profiling ? " so far" : "",GetProfileNumSamples());
+	aprintf("%4s %-22s %-22s %9s %10s %10s %12s %12s\n","Rank","Class","Message",
+		"Calls","Incl ms","Excl ms","Incl insts","Excl insts");
+
+	for (i=0;i<num_show && i<(int)profile_show_nodes.size();i++)
+	{
+		p = profile_show_nodes[i];
+		c = GetClassByID(p->class_id);
+		aprintf("%3i. %-22s %-22s %9i %10.1f %10.1f %12" PRId64 " %12" PRId64 "\n",i+1,
+			(c == NULL) ? "Unknown" : c->class_name,GetNameByID(p->message_id),p->calls,
+			p->inclusive_ns/1000000.0,p->exclusive_ns/1000000.0,
+			p->inclusive_insts,p->exclusive_insts);
+	}
+	profile_show_nodes.clear();
+}
+
+void AdminProfileFlamegraph(int session_id,admin_parm_type parms[],
+                            int num_blak_parm,parm_node blak_parm[])
+{
+	ForEachProfileStack(AdminProfileFlamegraphStack);
+}
+
+void AdminProfileFlamegraphStack(const char *stack,int count)
+{
+	aprintf("%s %i\n",stack,count);
+}
@@ -0,0 +1,240 @@
+// Meridian 59, Copyright 1994-2012 Andrew Kirmse and Chris Kirmse.
+// All rights reserved.
+//
+// This software is distributed under a license that is described in
+// the LICENSE file that accompanies it.
+//
+// Meridian is a registered trademark.
+/*
+* array.c
+*
+
+  This module maintains a dynamically sized array with the array nodes
+  used by the Blakod.  An array is a fixed number of values, set when it
+  is created, kept together so that any of them can be read or set
+  without walking a list.  Elements are numbered from 1, like Nth.
+
+  Arrays are garbage collected, saved and loaded like the list nodes.
+
+*/
+
+#include "blakserv.h"
+
+static array_node *arrays;
+static int num_arrays,max_arrays;
+
+/* local function prototypes */
+static int AllocateArray(int length);
+
+void InitArray(void)
+{
+	num_arrays = 0;
+	max_arrays = INIT_ARRAY_NODES;
+	arrays = (array_node *)AllocateMemory(MALLOC_ID_ARRAY,max_arrays*sizeof(array_node));
+}
+
+void ResetArray(void)
+{
+	ClearArray();
+}
+
+/* ClearArray
+*
+* Need this because when loading game, if there is an error, reset anything
+* that was already set.
+*
+*/
+void ClearArray(void)
+{
+	int i,old_arrays;
+
+	for (i=0;i<num_arrays;i++)
+		FreeArray(i);
+
+	old_arrays = max_arrays;
+
+	num_arrays = 0;
+	max_arrays = INIT_ARRAY_NODES;
+	arrays = (array_node *)
+		ResizeMemory(MALLOC_ID_ARRAY,arrays,old_arrays*sizeof(array_node),
+		max_arrays*sizeof(array_node));
+}
+
+int GetArraysUsed(void)
+{
+	return num_arrays;
+}
+
+static int AllocateArray(int length)
+{
+	int old_arrays,i;
+	array_node *a;
+
+	if (num_arrays == max_arrays)
+	{
+		old_arrays = max_arrays;
+		max_arrays = max_arrays * 2;
+		arrays = (array_node *)
+			ResizeMemory(MALLOC_ID_ARRAY,arrays,old_arrays*sizeof(array_node),
+			max_arrays*sizeof(array_node));
+		lprintf("AllocateArray resized to %i arrays\n",max_arrays);
+	}
+
+	a = &arrays[num_arrays];
+	a->length = length;
+	a->elems = (val_type *)AllocateMemory(MALLOC_ID_ARRAY,length*sizeof(val_type));
+	for (i=0;i<length;i++)
+		a->elems[i].int_val = NIL;
+
+	return num_arrays++;
+}
+
+/* returns the id of a new array of length elements, all $, or INVALID_ID if
+   length is out of range */
+int CreateArray(int length)
+{
+	if (length < 1 || length > MAX_ARRAY_ELEMS)
+	{
+		bprintf("CreateArray can't make an array of %i elements\n",length);
+		return INVALID_ID;
+	}
+
+	return AllocateArray(length);
+}
+
+bool LoadArray(int array_id,int length)
+{
+	if (length < 1 || length > MAX_ARRAY_ELEMS)
+	{
+		eprintf("LoadArray found array %i with %i elements\n",array_id,length);
+		return false;
+	}
+
+	if (AllocateArray(length) != array_id)
+	{
+		eprintf("LoadArray didn't make array id %i\n",array_id);
+		return false;
+	}
+
+	return true;
+}
+
+array_node *GetArrayByID(int array_id)
+{
+	if (array_id < 0 || array_id >= num_arrays)
+	{
+		eprintf("GetArrayByID can't retrieve invalid array %i\n",array_id);
+		return NULL;
+	}
+	return &arrays[array_id];
+}
+
+bool IsArrayByID(int array_id)
+{
+	if (array_id < 0 || array_id >= num_arrays)
+		return false;
+
+	return true;
+}
+
+blak_int GetArrayElem(int array_id,int n)
+{
+	array_node *a;
+
+	a = GetArrayByID(array_id);
+	if (a == NULL)
+		return NIL;
+
+	if (n < 1 || n > a->length)
+	{
+		bprintf("GetArrayElem can't get element %i of %i element array %i\n",
+			n,a->length,array_id);
+		return NIL;
+	}
+
+	return a->elems[n-1].int_val;
+}
+
+blak_int SetArrayElem(int array_id,int n,val_type new_val)
+{
+	array_node *a;
+
+	a = GetArrayByID(array_id);
+	if (a == NULL)
+		return NIL;
+
+	if (n < 1 || n > a->length)
+	{
+		bprintf("SetArrayElem can't set element %i of %i element array %i\n",
+			n,a->length,array_id);
+		return NIL;
+	}
+
+	a->elems[n-1] = new_val;
+	return NIL;
+}
+
+void ForEachArray(void (*callback_func)(array_node *a,int array_id))
+{
+	int i;
+
+	for (i=0;i<num_arrays;i++)
+		callback_func(&arrays[i],i);
+}
+
+/* these functions are for garbage collecting */
+
+void FreeArray(int array_id)
+{
+	array_node *a;
+
+	a = GetArrayByID(array_id);
+	if (a == NULL)
+	{
+		eprintf("FreeArray can't find %i\n",array_id);
+		return;
+	}
+
+	/* NULL once it has been moved to a lower id */
+	if (a->elems != NULL)
+		FreeMemory(MALLOC_ID_ARRAY,a->elems,a->length*sizeof(val_type));
+	a->elems = NULL;
+	a->length = 0;
+}
+
+void MoveArrayNode(int dest_id,int source_id)
+{
+	array_node *source,*dest;
+
+	source = GetArrayByID(source_id);
+	if (source == NULL)
+	{
+		eprintf("MoveArrayNode can't find source %i, total death end game\n",
+			source_id);
+		return;
+	}
+
+	dest = GetArrayByID(dest_id);
+	if (dest == NULL)
+	{
+		eprintf("MoveArrayNode can't find dest %i, total death end game\n",
+			dest_id);
+		return;
+	}
+
+	/* we're guaranteed dest_id <= source_id, and that dest has been freed
+	 * or moved already if they're different.
+	 */
+
+	if (dest_id == source_id)
+		return;
+
+	*dest = *source;
+	source->elems = NULL;
+	source->length = 0;
+}
+
+void SetNumArrays(int new_num_arrays)
+{
+	num_arrays = new_num_arrays;
+}
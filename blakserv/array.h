@@ -0,0 +1,44 @@
+// Meridian 59, Copyright 1994-2012 Andrew Kirmse and Chris Kirmse.
+// All rights reserved.
+//
+// This software is distributed under a license that is described in
+// the LICENSE file that accompanies it.
+//
+// Meridian is a registered trademark.
+/*
+ * array.h
+ *
+ */
+
+#ifndef _ARRAY_H
+#define _ARRAY_H
+
+#define INIT_ARRAY_NODES (10000)
+
+/* most elements CreateArray will make an array with */
+#define MAX_ARRAY_ELEMS (65536)
+
+typedef struct
+{
+   val_type *elems;
+   int length;
+   int garbage_ref;
+} array_node;
+
+void InitArray(void);
+void ResetArray(void);
+void ClearArray(void);
+int GetArraysUsed(void);
+int CreateArray(int length);
+bool LoadArray(int array_id,int length);
+array_node * GetArrayByID(int array_id);
+bool IsArrayByID(int array_id);
+blak_int GetArrayElem(int array_id,int n);
+blak_int SetArrayElem(int array_id,int n,val_type new_val);
+
+void ForEachArray(void (*callback_func)(array_node *a,int array_id));
+void FreeArray(int array_id);
+void MoveArrayNode(int dest_id,int source_id);
+void SetNumArrays(int new_num_arrays);
+
+#endif
@@ -18,8 +18,13 @@
 
 #include "blakserv.h"
 
+/* most connections AsyncSocketAccept takes from the listen queue at once;
+   the rest wait for the next time around the main loop */
+#define ACCEPT_BATCH 64
+
 /* local function prototypes */
 void AcceptSocketConnections(int socket_port,int connection_type);
+static bool AcceptOneConnection(SOCKET sock,int connection_type);
 void AsyncEachSessionNameLookup(session_node *s);
 
 bool CheckMaintenanceMask(SOCKADDR_IN *addr,int len_addr);
@@ -28,10 +33,12 @@ void AsyncSocketClose(SOCKET sock);
 void AsyncSocketWrite(SOCKET sock);
 void AsyncSocketRead(SOCKET sock);
 
-#define MAX_MAINTENANCE_MASKS 15
-char *maintenance_masks[MAX_MAINTENANCE_MASKS];
-int num_maintenance_masks = 0;
-char *maintenance_buffer = NULL;
+/* prefixes of the addresses allowed on the maintenance port, from the
+   MaintenanceMask setting */
+static ip_tree maintenance_masks;
+
+static void BuildMaintenanceMasks(const char *config_masks);
+static bool ParseMaintenanceMask(const char *mask,ip_key *key,int *prefix_len);
 
 void InitAsyncConnections(void)
 {
@@ -45,28 +52,7 @@ void InitAsyncConnections(void)
 	}
 #endif
 
-	maintenance_buffer = (char *)malloc(strlen(ConfigStr(SOCKET_MAINTENANCE_MASK)) + 1);
-	strcpy(maintenance_buffer,ConfigStr(SOCKET_MAINTENANCE_MASK));
-
-	// now parse out each maintenance ip
-	maintenance_masks[num_maintenance_masks] = strtok(maintenance_buffer,";");
-	while (maintenance_masks[num_maintenance_masks] != NULL)
-	{
-		num_maintenance_masks++;
-		if (num_maintenance_masks == MAX_MAINTENANCE_MASKS)
-			break;
-		maintenance_masks[num_maintenance_masks] = strtok(NULL,";");
-	}
-
-	/*
-	{
-		int i;
-		for (i=0;i<num_maintenance_masks;i++)
-		{
-			dprintf("mask %i is [%s]\n",i,maintenance_masks[i]);
-		}
-	}
-	*/
+	BuildMaintenanceMasks(ConfigStr(SOCKET_MAINTENANCE_MASK));
 }
 
 void ExitAsyncConnections(void)
@@ -140,7 +126,20 @@ void AcceptSocketConnections(int socket_port,int connection_type)
 		return;
 	}
 
-	if (listen(sock,5) < 0) /* backlog of 5 connects by OS */
+#ifdef BLAK_PLATFORM_LINUX
+	/* so AcceptOneConnection finds out when the queue is empty */
+	opt = fcntl(sock,F_GETFL,0);
+	if (fcntl(sock,F_SETFL,opt | O_NONBLOCK) < 0)
+	{
+		eprintf("AcceptSocketConnections error setting non-blocking\n");
+		closesocket(sock);
+		return;
+	}
+#endif
+
+	/* a deep queue, so the connects of everyone coming back after a
+	   restart wait for us rather than being refused by the OS */
+	if (listen(sock,SOMAXCONN) < 0)
 	{
 		eprintf("AcceptSocketConnections listen failed, WinSock error %i\n",
 			GetLastError());
@@ -154,14 +153,7 @@ void AcceptSocketConnections(int socket_port,int connection_type)
 
 void AsyncSocketAccept(SOCKET sock,int event,int error,int connection_type)
 {
-	SOCKET new_sock;
-	SOCKADDR_IN acc_sin;    /* Accept socket address - internet style */
-	socklen_t acc_sin_len;        /* Accept socket address length */
-	SOCKADDR_IN peer_info;
-	socklen_t peer_len;
-	struct in_addr peer_addr;
-	connection_node conn;
-	session_node *s;
+	int i;
 
 	if (event != FD_ACCEPT)
 	{
@@ -175,31 +167,38 @@ void AsyncSocketAccept(SOCKET sock,int event,int error,int connection_type)
 		return;
 	}
 
-	acc_sin_len = sizeof acc_sin;
+	if (connection_type == SOCKET_PORT)
+		SetConnectRateLimits(ConfigInt(SOCKET_CONNECT_BURST),ConfigInt(SOCKET_CONNECT_PER_MINUTE),
+			ConfigInt(SOCKET_GLOBAL_CONNECT_PER_SECOND));
 
-	new_sock = accept(sock,(struct sockaddr *) &acc_sin,&acc_sin_len);
-	if (new_sock == SOCKET_ERROR)
-	{
-		eprintf("AcceptSocketConnections accept failed, error %i\n",
-			GetLastError());
-		return;
-	}
+	for (i=0;i<ACCEPT_BATCH;i++)
+		if (!AcceptOneConnection(sock,connection_type))
+			break;
+}
 
-#ifdef BLAK_PLATFORM_LINUX
-    int flags = fcntl(new_sock,F_GETFL,0);
-    flags |= O_NONBLOCK;
-    if (fcntl(new_sock,F_SETFL,flags) < 0) {
-        eprintf("AcceptSocketConnections error setting non-blocking\n");
-        return;
-    }
-#endif
+/* returns false once there are no more connections waiting */
+static bool AcceptOneConnection(SOCKET sock,int connection_type)
+{
+	SOCKET new_sock;
+	SOCKADDR_IN peer_info;
+	socklen_t peer_len;
+	struct in_addr peer_addr;
+	connection_node conn;
+	session_node *s;
 
 	peer_len = sizeof peer_info;
-	if (getpeername(new_sock,(SOCKADDR *)&peer_info,&peer_len) < 0)
+
+#ifdef BLAK_PLATFORM_LINUX
+	new_sock = accept4(sock,(struct sockaddr *) &peer_info,&peer_len,SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
+	new_sock = accept(sock,(struct sockaddr *) &peer_info,&peer_len);
+#endif
+	if (new_sock == INVALID_SOCKET)
 	{
-		eprintf("AcceptSocketConnections getpeername failed error %i\n",
-			GetLastError());
-		return;
+		if (GetLastError() != WSAEWOULDBLOCK)
+			eprintf("AcceptSocketConnections accept failed, error %i\n",
+				GetLastError());
+		return false;
 	}
 
 	memcpy(&peer_addr,(long *)&(peer_info.sin_addr),sizeof(struct in_addr));
@@ -212,7 +211,7 @@ void AsyncSocketAccept(SOCKET sock,int event,int error,int connection_type)
 		{
 			lprintf("Blocked maintenance connection from %s.\n", conn.name);
 			closesocket(new_sock);
-			return;
+			return true;
 		}
 	}
 	else
@@ -221,7 +220,15 @@ void AsyncSocketAccept(SOCKET sock,int event,int error,int connection_type)
 		{
 			lprintf("Blocked connection from %s.\n", conn.name);
 			closesocket(new_sock);
-			return;
+			return true;
+		}
+
+		/* not logged, since a flood of these would flood the log too */
+		if (!CheckConnectRate(&peer_addr,GetMilliCount()))
+		{
+			MetricsAdd(METRIC_CONNECTIONS_LIMITED,1);
+			closesocket(new_sock);
+			return true;
 		}
 	}
 
@@ -261,68 +268,66 @@ void AsyncSocketAccept(SOCKET sock,int event,int error,int connection_type)
 	}
 
 	LeaveServerLock();
-}
 
-#ifdef BLAK_PLATFORM_WINDOWS
-#define IN_ADDR_HELPER(x) x.S_un.S_addr
-#elif BLAK_PLATFORM_LINUX
-#define IN_ADDR_HELPER(x) x.s_addr
-#endif
+	return true;
+}
 
-bool CheckMaintenanceMask(SOCKADDR_IN *addr,int len_addr)
+/* the masks are separated by semicolons */
+static void BuildMaintenanceMasks(const char *config_masks)
 {
-	IN_ADDR mask;
-	int i;
+	std::string masks = config_masks;
+	std::string mask;
+	size_t start,end;
+	ip_key key;
+	int prefix_len;
 
-	for (i=0;i<num_maintenance_masks;i++)
-	{
-		IN_ADDR_HELPER(mask) = inet_addr(maintenance_masks[i]);
-		if (IN_ADDR_HELPER(mask) == INADDR_NONE)
-		{
-			eprintf("CheckMaintenanceMask has invalid configured mask %s\n",
-					  maintenance_masks[i]);
-			continue;
-		}
-
-		unsigned char b1 = (unsigned char)((IN_ADDR_HELPER(mask) & 0xff000000) >> 24);
-		unsigned char b2 = (unsigned char)((IN_ADDR_HELPER(mask) & 0x00ff0000) >> 16);
-		unsigned char b3 = (unsigned char)((IN_ADDR_HELPER(mask) & 0x0000ff00) >> 8);
-		unsigned char b4 = (unsigned char)(IN_ADDR_HELPER(mask) & 0xff);
-		/* for each byte of the mask, if it's non-zero, the client must match it */
+	IPTreeClear(&maintenance_masks);
 
-		unsigned char addr_b1 = (unsigned char)((IN_ADDR_HELPER(addr->sin_addr) & 0xff000000) >> 24);
-		unsigned char addr_b2 = (unsigned char)((IN_ADDR_HELPER(addr->sin_addr) & 0x00ff0000) >> 16);
-		unsigned char addr_b3 = (unsigned char)((IN_ADDR_HELPER(addr->sin_addr) & 0x0000ff00) >> 8);
-		unsigned char addr_b4 = (unsigned char)((IN_ADDR_HELPER(addr->sin_addr) & 0xff));
-
-		if ((b1 != 0) && (addr_b1 != b1))
+	for (start = 0;start <= masks.size();start = end + 1)
+	{
+		end = masks.find(';',start);
+		if (end == std::string::npos)
+			end = masks.size();
+		mask = masks.substr(start,end - start);
+		if (mask.find_first_not_of(" \t") == std::string::npos)
 			continue;
 
-		if ((b2 != 0) && (addr_b2 != b2))
+		if (!ParseMaintenanceMask(mask.c_str(),&key,&prefix_len))
+		{
+			eprintf("BuildMaintenanceMasks has invalid configured mask %s\n",mask.c_str());
 			continue;
+		}
+		IPTreeAdd(&maintenance_masks,&key,prefix_len);
+	}
+}
 
-		if ((b3 != 0) && (addr_b3 != b3))
-			continue;
+/* A mask is an address or address/bits prefix, as in the block list.  An
+   IPv4 address without /bits, like 208.192.72.0, is a prefix of its bytes
+   up to the last one that isn't 0. */
+static bool ParseMaintenanceMask(const char *mask,ip_key *key,int *prefix_len)
+{
+	int i;
 
-		if ((b4 != 0) && (addr_b4 != b4))
-			continue;
+	if (!ParseIPPrefix(mask,key,prefix_len))
+		return false;
 
-		/*
-		dprintf("%u\n",addr_b1);
-		dprintf("%u\n",addr_b2);
-		dprintf("%u\n",addr_b3);
-		dprintf("%u\n",addr_b4);
+	if (strchr(mask,'/') == NULL && *prefix_len == IP_KEY_BITS &&
+		strchr(mask,':') == NULL)
+	{
+		for (i=IP_KEY_BYTES-1;i>=IP_KEY_IPV4_BITS/8;i--)
+			if (key->bytes[i] != 0)
+				break;
+		*prefix_len = 8*(i + 1);
+	}
+	return true;
+}
 
-		  dprintf("----\n");
+bool CheckMaintenanceMask(SOCKADDR_IN *addr,int len_addr)
+{
+	ip_key key;
 
-			dprintf("%u\n",b1);
-			dprintf("%u\n",b2);
-			dprintf("%u\n",b3);
-			dprintf("%u\n",b4);
-	*/
-		return true;
-	}
-	return false;
+	IPKeyFromInAddr(&addr->sin_addr,&key);
+	return IPTreeMatch(&maintenance_masks,&key,0) != NULL;
 }
 
 static HANDLE name_lookup_handle;
@@ -460,6 +465,7 @@ void AsyncSocketWrite(SOCKET sock)
 				dprintf("async write wrote %i/%i bytes\n",bytes,bn->len_buf);
 
 			transmitted_bytes += bn->len_buf;
+			MetricsAdd(METRIC_BYTES_SENT,bn->len_buf);
 
 			s->send_list = bn->next;
 			DeleteBuffer(bn);
@@ -541,6 +547,9 @@ void AsyncSocketRead(SOCKET sock)
 	}
 
 	bn->len_buf += bytes;
+	MetricsAdd(METRIC_BYTES_RECEIVED,bytes);
+	if (bytes > 0 && s->receive_time == 0)
+		s->receive_time = GetMicroCount();
 
 	/*
 	dprintf("read %i bytes sess %i from %i\n",bytes,s->session_id,s->num_receiving,
@@ -147,12 +147,12 @@ int AddDynamicResource(const char *str_value)
 	return new_rsc_id;
 }
 
-void ChangeDynamicResourceStr(resource_node *r,char *str_value)
+void ChangeDynamicResourceStr(resource_node *r,const char *str_value)
 {
 	ChangeDynamicResource(r,str_value,(int) strlen(str_value));
 }
 
-void ChangeDynamicResource(resource_node *r,char *data,int len_data)
+void ChangeDynamicResource(resource_node *r,const char *data,int len_data)
 {
 	if (r == NULL)
 	{
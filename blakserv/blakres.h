@@ -26,8 +26,8 @@ void ResetResource(void);
 void AddResource(int id,const char *str_value);
 void SetResourceName(int id,char *name);
 int AddDynamicResource(const char *str_value);
-void ChangeDynamicResourceStr(resource_node *r,char *str_value);
-void ChangeDynamicResource(resource_node *r,char *data,int len_data);
+void ChangeDynamicResourceStr(resource_node *r,const char *str_value);
+void ChangeDynamicResource(resource_node *r,const char *data,int len_data);
 int GetNumDynamicRscFiles(void);
 int SetNumDynamicRscFiles(int num_files);
 resource_node * GetResourceByID(int id);
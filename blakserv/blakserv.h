@@ -118,7 +118,9 @@ enum
 #define SPROCKET_FILE "sprocket.dll"
 
 #include <string>
+#include <string_view>
 #include <vector>
+#include <unordered_map>
 typedef std::vector<std::string> StringVector;
 
 #ifdef BLAK_PLATFORM_WINDOWS
@@ -130,6 +132,7 @@ typedef std::vector<std::string> StringVector;
 #endif  // BLAK_PLATFORM_LINUX
 
 #include <algorithm>
+#include <functional>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -211,8 +214,13 @@ extern DWORD main_thread_id;
 #include "class.h"
 #include "object.h"
 #include "list.h"
+#include "array.h"
 #include "loadkod.h"
 #include "sendmsg.h"
+#include "profile.h"
+#include "histogram.h"
+#include "latency.h"
+#include "metrics.h"
 #include "ccode.h"
 #include "timer.h"
 #include "account.h"
@@ -238,6 +246,7 @@ extern DWORD main_thread_id;
 #include "parsecli.h"
 #include "sprocket.h"
 #include "bstring.h"
+#include "fuzzy.h"
 #include "admin.h"
 #include "garbage.h"
 #include "savegame.h"
@@ -7,113 +7,532 @@
 // Meridian is a registered trademark.
 // block.c : Implements the block list for BLAKSERV.
 //
+// Blocks are address prefixes (a single address being a prefix of all its
+// bits) in a compressed radix tree, so checking an address looks at no
+// more nodes than there are bits in it, however many blocks there are.
+// The same trees hold the maintenance masks (see async.c).
+//
+// Blocks that run out are left in the tree, where checks ignore them,
+// until ExpireBlocks takes them off the top of a heap ordered by when they
+// run out.
+//
+// New connections to the game port are also held to a rate, before they
+// get a session: each address has a bucket of ConnectBurst connections
+// that fills at ConnectPerMinute, and all of them share one that fills at
+// GlobalConnectPerSecond.  Buckets are kept in whole milliseconds' worth
+// of refill, so the sums are all integers.
+//
 //////////
 //
 
 #include "blakserv.h"
 
+// What a connection costs, in refill units: a bucket filling at n units a
+// millisecond has n connections' credit a minute, or a second.
+#define ADDRESS_CONNECT_COST (60*1000)
+#define GLOBAL_CONNECT_COST (1000)
+
 //////////
 
-static block_node* block_head = NULL;
+typedef struct
+{
+	INT64 iExpires;
+	ip_key key;
+	int prefix_len;
+} block_expiry;
+
+typedef struct
+{
+	INT64 credit;      // in refill units, see ADDRESS_CONNECT_COST
+	UINT64 last_ms;    // when credit was last topped up
+} connect_bucket;
+
+static ip_tree blocks;
+static std::vector<block_expiry> block_expiries;   // a min-heap on iExpires
+
+static std::unordered_map<uint32_t,connect_bucket> address_buckets;
+static connect_bucket global_bucket;
+static int connect_burst,connect_per_minute,global_per_second;
+static UINT64 last_bucket_sweep;
+
+/* local function prototypes */
+static int GetIPKeyBit(const ip_key *key, int bit);
+static int CommonPrefixLen(const ip_key *a, const ip_key *b, int start, int max_len);
+static void MaskIPKey(ip_key *key, int prefix_len);
+static ip_tree_node * NewIPTreeNode(const ip_key *key, int prefix_len);
+static bool RemoveIPTreeNode(ip_tree *tree, ip_tree_node **link, const ip_key *key, int prefix_len);
+static void FreeIPTreeNodes(ip_tree_node *node);
+static bool LaterExpiry(const block_expiry &a, const block_expiry &b);
+static void ExpireBlocks(INT64 now);
+static void RefillBucket(connect_bucket *bucket, UINT64 now_ms, INT64 capacity, INT64 per_ms);
+static void SweepAddressBuckets(UINT64 now_ms);
 
 //////////
 
-block_node* FindBlock(struct in_addr* piaPeer)
+void IPKeyFromInAddr(const struct in_addr *addr, ip_key *key)
 {
-	block_node* pBlock = block_head;
+	memset(key->bytes, 0, 10);
+	key->bytes[10] = 0xff;
+	key->bytes[11] = 0xff;
+	memcpy(&key->bytes[12], addr, 4);
+}
+
+/* reads an IPv4 or IPv6 address, with /bits after it for a prefix of it */
+bool ParseIPPrefix(const char *str, ip_key *key, int *prefix_len)
+{
+	char buf[64];
+	char *slash,*end;
+	struct in_addr addr4;
+	struct in6_addr addr6;
+	size_t len;
+	long bits;
+	int max_bits;
+
+	while (*str == ' ' || *str == '\t')
+		str++;
+	len = strlen(str);
+	while (len > 0 && isspace((unsigned char) str[len-1]))
+		len--;
+	if (len == 0 || len >= sizeof(buf))
+		return false;
+	memcpy(buf, str, len);
+	buf[len] = 0;
 
-	while (pBlock)
+	slash = strchr(buf, '/');
+	if (slash != NULL)
+		*slash = 0;
+
+	if (inet_pton(AF_INET, buf, &addr4) == 1)
+	{
+		IPKeyFromInAddr(&addr4, key);
+		max_bits = IP_KEY_BITS - IP_KEY_IPV4_BITS;
+	}
+	else if (inet_pton(AF_INET6, buf, &addr6) == 1)
 	{
-		if (0 == memcmp(&pBlock->iaPeer, piaPeer, sizeof(struct in_addr)))
-			return pBlock;
+		memcpy(key->bytes, &addr6, IP_KEY_BYTES);
+		max_bits = IP_KEY_BITS;
+	}
+	else
+		return false;
 
-		pBlock = pBlock->next;
+	bits = max_bits;
+	if (slash != NULL)
+	{
+		bits = strtol(slash + 1, &end, 10);
+		if (end == slash + 1 || *end != 0 || bits < 0 || bits > max_bits)
+			return false;
 	}
 
-	return NULL;
+	*prefix_len = (int) bits + IP_KEY_BITS - max_bits;
+	MaskIPKey(key, *prefix_len);
+	return true;
 }
 
-void AddBlock(int iSeconds, struct in_addr* piaPeer)
+std::string IPPrefixStr(const ip_key *key, int prefix_len)
 {
-	block_node* pBlock = FindBlock(piaPeer);
-	INT64 iExpires = (iSeconds < 0)? -1 : GetTime() + iSeconds;
-
-    // A block set to expire at -1 will stay in effect until all blocks are deleted.
-	// (Usually when server is shut down and later restarted.)
+	static const unsigned char ipv4_mapped[12] =
+		{ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xff, 0xff };
+	char buf[64];
 
-	if (pBlock)
+	if (prefix_len >= IP_KEY_IPV4_BITS && memcmp(key->bytes, ipv4_mapped, 12) == 0)
 	{
-		if (pBlock->iExpires >= 0)
-			pBlock->iExpires = iExpires;
-		return;
+		inet_ntop(AF_INET, &key->bytes[12], buf, sizeof(buf));
+		prefix_len -= IP_KEY_IPV4_BITS;
+		if (prefix_len == IP_KEY_BITS - IP_KEY_IPV4_BITS)
+			return buf;
+	}
+	else
+	{
+		inet_ntop(AF_INET6, key->bytes, buf, sizeof(buf));
+		if (prefix_len == IP_KEY_BITS)
+			return buf;
 	}
+	return std::string(buf) + "/" + std::to_string(prefix_len);
+}
 
-	pBlock = (block_node *) AllocateMemory(MALLOC_ID_BLOCK,sizeof(block_node));
-	if (pBlock)
+static int GetIPKeyBit(const ip_key *key, int bit)
+{
+	return (key->bytes[bit >> 3] >> (7 - (bit & 7))) & 1;
+}
+
+/* how many leading bits, up to max_len, a and b have the same, given that
+   they're known to have the first start bits the same */
+static int CommonPrefixLen(const ip_key *a, const ip_key *b, int start, int max_len)
+{
+	int i,len;
+	unsigned char diff;
+
+	for (i=start & ~7;i<max_len;i+=8)
 	{
-		pBlock->iExpires = iExpires;
-		pBlock->iaPeer = *piaPeer;
-		pBlock->next = block_head;
-		block_head = pBlock;
+		diff = a->bytes[i >> 3] ^ b->bytes[i >> 3];
+		if (diff != 0)
+		{
+			len = i;
+			while ((diff & 0x80) == 0)
+			{
+				diff <<= 1;
+				len++;
+			}
+			return std::min(len, max_len);
+		}
 	}
+	return max_len;
 }
 
-void DeleteBlock(struct in_addr* piaPeer)
+static void MaskIPKey(ip_key *key, int prefix_len)
 {
-	block_node** pHook = &block_head;
-	block_node* pBlock = block_head;
+	int i;
 
-	while (pBlock)
+	for (i=prefix_len;i<IP_KEY_BITS;i++)
+		key->bytes[i >> 3] &= ~(0x80 >> (i & 7));
+}
+
+static ip_tree_node * NewIPTreeNode(const ip_key *key, int prefix_len)
+{
+	ip_tree_node *node;
+
+	node = (ip_tree_node *) AllocateMemory(MALLOC_ID_BLOCK,sizeof(ip_tree_node));
+	node->key = *key;
+	MaskIPKey(&node->key, prefix_len);
+	node->prefix_len = prefix_len;
+	node->in_set = false;
+	node->iExpires = -1;
+	node->child[0] = NULL;
+	node->child[1] = NULL;
+	return node;
+}
+
+/* returns the node for the prefix, which is added, never expiring, if it
+   wasn't in the tree */
+ip_tree_node * IPTreeAdd(ip_tree *tree, const ip_key *key, int prefix_len)
+{
+	ip_tree_node **link,*node,*join,*added;
+	int common;
+
+	link = &tree->root;
+	added = NULL;
+	while (*link != NULL)
 	{
-		if (0 == memcmp(&pBlock->iaPeer, piaPeer, sizeof(struct in_addr)))
+		node = *link;
+		common = CommonPrefixLen(&node->key, key, 0, std::min(node->prefix_len, prefix_len));
+		if (common < node->prefix_len)
 		{
-			*pHook = pBlock->next;
-			FreeMemory(MALLOC_ID_BLOCK,pBlock,sizeof(block_node));
-			return;
+			/* the prefix parts from node before node's own ends, so it goes
+			   above node, joined to it by a new node if it isn't node's
+			   prefix itself */
+			added = NewIPTreeNode(key, prefix_len);
+			if (common == prefix_len)
+			{
+				added->child[GetIPKeyBit(&node->key, prefix_len)] = node;
+				*link = added;
+			}
+			else
+			{
+				join = NewIPTreeNode(key, common);
+				join->child[GetIPKeyBit(&node->key, common)] = node;
+				join->child[GetIPKeyBit(key, common)] = added;
+				*link = join;
+			}
+			break;
+		}
+
+		if (node->prefix_len == prefix_len)
+		{
+			added = node;
+			break;
 		}
+		link = &node->child[GetIPKeyBit(key, node->prefix_len)];
+	}
+
+	if (added == NULL)
+	{
+		added = NewIPTreeNode(key, prefix_len);
+		*link = added;
+	}
+
+	if (!added->in_set)
+	{
+		added->in_set = true;
+		added->iExpires = -1;
+		tree->num_prefixes++;
+	}
+	return added;
+}
 
-		pHook = &pBlock->next;
-		pBlock = pBlock->next;
+ip_tree_node * IPTreeFind(ip_tree *tree, const ip_key *key, int prefix_len)
+{
+	ip_tree_node *node;
+
+	node = tree->root;
+	while (node != NULL && node->prefix_len <= prefix_len)
+	{
+		if (CommonPrefixLen(&node->key, key, 0, node->prefix_len) < node->prefix_len)
+			return NULL;
+		if (node->prefix_len == prefix_len)
+			return node->in_set? node : NULL;
+		node = node->child[GetIPKeyBit(key, node->prefix_len)];
+	}
+	return NULL;
+}
+
+bool IPTreeRemove(ip_tree *tree, const ip_key *key, int prefix_len)
+{
+	return RemoveIPTreeNode(tree, &tree->root, key, prefix_len);
+}
+
+/* takes the prefix out of the set, then, on the way back up, frees each
+   node that no longer has a reason to be there */
+static bool RemoveIPTreeNode(ip_tree *tree, ip_tree_node **link, const ip_key *key, int prefix_len)
+{
+	ip_tree_node *node;
+
+	node = *link;
+	if (node == NULL || node->prefix_len > prefix_len ||
+		CommonPrefixLen(&node->key, key, 0, node->prefix_len) < node->prefix_len)
+		return false;
+
+	if (node->prefix_len == prefix_len)
+	{
+		if (!node->in_set)
+			return false;
+		node->in_set = false;
+		tree->num_prefixes--;
+	}
+	else if (!RemoveIPTreeNode(tree, &node->child[GetIPKeyBit(key, node->prefix_len)], key, prefix_len))
+		return false;
+
+	if (!node->in_set && (node->child[0] == NULL || node->child[1] == NULL))
+	{
+		*link = node->child[0] != NULL? node->child[0] : node->child[1];
+		FreeMemory(MALLOC_ID_BLOCK,node,sizeof(ip_tree_node));
 	}
+	return true;
+}
+
+/* returns a prefix of the full address addr that's in the tree and hasn't
+   run out by now, or NULL if none is */
+ip_tree_node * IPTreeMatch(ip_tree *tree, const ip_key *addr, INT64 now)
+{
+	ip_tree_node *node;
+	int matched;
+
+	/* each node's prefix starts with its parent's, which matched already */
+	matched = 0;
+	node = tree->root;
+	while (node != NULL)
+	{
+		if (CommonPrefixLen(&node->key, addr, matched, node->prefix_len) < node->prefix_len)
+			return NULL;
+		if (node->in_set && (node->iExpires < 0 || node->iExpires > now))
+			return node;
+		if (node->prefix_len == IP_KEY_BITS)
+			return NULL;
+		matched = node->prefix_len;
+		node = node->child[GetIPKeyBit(addr, node->prefix_len)];
+	}
+	return NULL;
+}
+
+void IPTreeClear(ip_tree *tree)
+{
+	FreeIPTreeNodes(tree->root);
+	tree->root = NULL;
+	tree->num_prefixes = 0;
+}
+
+static void FreeIPTreeNodes(ip_tree_node *node)
+{
+	if (node == NULL)
+		return;
+	FreeIPTreeNodes(node->child[0]);
+	FreeIPTreeNodes(node->child[1]);
+	FreeMemory(MALLOC_ID_BLOCK,node,sizeof(ip_tree_node));
+}
+
+//////////
+
+void AddBlock(int iSeconds, struct in_addr* piaPeer)
+{
+	ip_key key;
+
+	IPKeyFromInAddr(piaPeer, &key);
+	AddBlockPrefix(iSeconds, &key, IP_KEY_BITS);
+}
+
+void AddBlockPrefix(int iSeconds, const ip_key *key, int prefix_len)
+{
+	ip_tree_node* pBlock = IPTreeFind(&blocks, key, prefix_len);
+	INT64 iExpires = (iSeconds < 0)? -1 : GetTime() + iSeconds;
+	block_expiry expiry;
+
+    // A block set to expire at -1 will stay in effect until all blocks are deleted.
+	// (Usually when server is shut down and later restarted.)
+
+	if (pBlock)
+	{
+		if (pBlock->iExpires < 0)
+			return;
+	}
+	else
+		pBlock = IPTreeAdd(&blocks, key, prefix_len);
+
+	pBlock->iExpires = iExpires;
+	if (iExpires < 0)
+		return;
+
+	// an entry for an earlier time is left in the heap, and ignored there
+	expiry.iExpires = iExpires;
+	expiry.key = pBlock->key;
+	expiry.prefix_len = prefix_len;
+	block_expiries.push_back(expiry);
+	std::push_heap(block_expiries.begin(), block_expiries.end(), LaterExpiry);
+}
+
+bool FindBlock(const ip_key *key, int prefix_len)
+{
+	return IPTreeFind(&blocks, key, prefix_len) != NULL;
+}
+
+void DeleteBlock(const ip_key *key, int prefix_len)
+{
+	IPTreeRemove(&blocks, key, prefix_len);
 }
 
 void DeleteAllBlocks()
 {
-	while (block_head)
+	IPTreeClear(&blocks);
+	block_expiries.clear();
+}
+
+int GetNumBlocks(void)
+{
+	return blocks.num_prefixes;
+}
+
+static bool LaterExpiry(const block_expiry &a, const block_expiry &b)
+{
+	return a.iExpires > b.iExpires;
+}
+
+static void ExpireBlocks(INT64 now)
+{
+	block_expiry expiry;
+	ip_tree_node *pBlock;
+
+	while (!block_expiries.empty() && block_expiries.front().iExpires <= now)
 	{
-		block_node* pBlock = block_head;
-		block_head = pBlock->next;
+		expiry = block_expiries.front();
+		std::pop_heap(block_expiries.begin(), block_expiries.end(), LaterExpiry);
+		block_expiries.pop_back();
 
-		FreeMemory(MALLOC_ID_BLOCK,pBlock,sizeof(block_node));
+		// a block made longer or permanent since has moved on from this time
+		pBlock = IPTreeFind(&blocks, &expiry.key, expiry.prefix_len);
+		if (pBlock != NULL && pBlock->iExpires == expiry.iExpires)
+			IPTreeRemove(&blocks, &expiry.key, expiry.prefix_len);
 	}
 }
 
 bool CheckBlockList(struct in_addr* piaPeer)
 {
-	block_node* pBlock = FindBlock(piaPeer);
+	INT64 now = GetTime();
+	ip_key key;
 
 	// true means not blocked and can connect
 	// false means block still in effect
 
-	if (!pBlock)
+	ExpireBlocks(now);
+	if (blocks.root == NULL)
 		return true;
 
-	if (pBlock->iExpires < 0)
-		return false;
+	IPKeyFromInAddr(piaPeer, &key);
+	return IPTreeMatch(&blocks, &key, now) == NULL;
+}
 
-	if (pBlock->iExpires <= GetTime())
+/* 0 for any of these means no limit of that kind */
+void SetConnectRateLimits(int burst, int per_minute, int global_second)
+{
+	if (burst != connect_burst || per_minute != connect_per_minute)
+		address_buckets.clear();
+	if (global_second != global_per_second)
+		global_bucket.last_ms = 0;
+
+	connect_burst = burst;
+	connect_per_minute = per_minute;
+	global_per_second = global_second;
+}
+
+/* last_ms of 0 is a new bucket, which starts full */
+static void RefillBucket(connect_bucket *bucket, UINT64 now_ms, INT64 capacity, INT64 per_ms)
+{
+	if (bucket->last_ms == 0)
+		bucket->credit = capacity;
+	else if (now_ms > bucket->last_ms)
+		bucket->credit = std::min(capacity, bucket->credit + (INT64)(now_ms - bucket->last_ms)*per_ms);
+	bucket->last_ms = now_ms;
+}
+
+bool CheckConnectRate(struct in_addr* piaPeer, UINT64 now_ms)
+{
+	connect_bucket *bucket;
+	uint32_t addr;
+
+	// true means the connection is within the rates and can go ahead;
+	// only then is it taken from the buckets
+
+	bucket = NULL;
+	if (connect_burst > 0 && connect_per_minute > 0)
 	{
-		DeleteBlock(piaPeer);
-		return true;
+		if (now_ms - last_bucket_sweep >= 60*1000)
+			SweepAddressBuckets(now_ms);
+
+		memcpy(&addr, piaPeer, sizeof(addr));
+		bucket = &address_buckets[addr];
+		RefillBucket(bucket, now_ms, (INT64)connect_burst*ADDRESS_CONNECT_COST, connect_per_minute);
+		if (bucket->credit < ADDRESS_CONNECT_COST)
+			return false;
+	}
+
+	if (global_per_second > 0)
+	{
+		RefillBucket(&global_bucket, now_ms, (INT64)global_per_second*GLOBAL_CONNECT_COST,
+			global_per_second);
+		if (global_bucket.credit < GLOBAL_CONNECT_COST)
+			return false;
+		global_bucket.credit -= GLOBAL_CONNECT_COST;
 	}
 
-	return false;
+	if (bucket != NULL)
+		bucket->credit -= ADDRESS_CONNECT_COST;
+	return true;
+}
+
+/* drops the buckets that have filled back up, which are the same as new ones */
+static void SweepAddressBuckets(UINT64 now_ms)
+{
+	std::unordered_map<uint32_t,connect_bucket>::iterator it;
+	INT64 capacity;
+
+	capacity = (INT64)connect_burst*ADDRESS_CONNECT_COST;
+	for (it = address_buckets.begin(); it != address_buckets.end(); )
+	{
+		if (it->second.credit + (INT64)(now_ms - it->second.last_ms)*connect_per_minute >= capacity)
+			it = address_buckets.erase(it);
+		else
+			++it;
+	}
+	last_bucket_sweep = now_ms;
+}
+
+int GetNumConnectRateAddresses(void)
+{
+	return (int)address_buckets.size();
 }
 
 /*
  * BuildBannedIPBlocks - Ban IPs from meridian
  *
- * Input : asciz string of filename of banned ips
+ * Input : asciz string of filename of banned ips, one address or
+ *         address/bits prefix a line; blank lines and # comments are skipped
  * Output :
  *
  * Author : Charlie
@@ -125,7 +544,9 @@ void BuildBannedIPBlocks( const char *filename )
   
   FILE*fp;
   char buffer[1024];
-  struct in_addr blocktoAdd ;
+  char *ptr;
+  ip_key blocktoAdd;
+  int prefix_len;
   
   fp = fopen(filename,"rt");
   if( fp == NULL ) {
@@ -137,10 +558,13 @@ void BuildBannedIPBlocks( const char *filename )
   do {
     if(fgets(buffer,1023,fp) != NULL ) {
       /* lets be cautious */
-      if(strlen(buffer)>0) {
-	if( ( blocktoAdd.s_addr = inet_addr( buffer ) ) != -1 ) {
-	  AddBlock( -1, &blocktoAdd );
-	  dprintf("Banned IP address %s\n", inet_ntoa( blocktoAdd ) );
+      ptr = buffer;
+      while (isspace((unsigned char) *ptr))
+	ptr++;
+      if(*ptr != 0 && *ptr != '#') {
+	if( ParseIPPrefix( ptr, &blocktoAdd, &prefix_len ) ) {
+	  AddBlockPrefix( -1, &blocktoAdd, prefix_len );
+	  dprintf("Banned IP address %s\n", IPPrefixStr( &blocktoAdd, prefix_len ).c_str() );
 	} else {
 	  eprintf("Warning invalid entry in %s is [%s]\n",filename,buffer);
 	}
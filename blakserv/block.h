@@ -13,19 +13,57 @@
 #ifndef BLOCK_H
 #define BLOCK_H
 
-typedef struct block_node_struct
+// Addresses are kept as IPv6 ones, with IPv4 addresses mapped into
+// ::ffff:0:0/96, so an IPv4 prefix of n bits is IP_KEY_IPV4_BITS + n bits.
+#define IP_KEY_BYTES 16
+#define IP_KEY_BITS (8*IP_KEY_BYTES)
+#define IP_KEY_IPV4_BITS 96
+
+typedef struct
+{
+   unsigned char bytes[IP_KEY_BYTES];
+} ip_key;
+
+// A node of a compressed radix tree of address prefixes.  Nodes that were
+// only made to join two others aren't in_set.
+typedef struct ip_tree_node_struct
+{
+   ip_key key;        // bits past prefix_len are zero
+   int prefix_len;
+   bool in_set;
+   INT64 iExpires;    // -1 for never
+   struct ip_tree_node_struct *child[2];
+} ip_tree_node;
+
+typedef struct
 {
-   INT64 iExpires;  // Expiration time
-   struct in_addr iaPeer;
-   struct block_node_struct *next;
-} block_node;
+   ip_tree_node *root;
+   int num_prefixes;
+} ip_tree;
+
+void IPKeyFromInAddr(const struct in_addr *addr, ip_key *key);
+bool ParseIPPrefix(const char *str, ip_key *key, int *prefix_len);
+std::string IPPrefixStr(const ip_key *key, int prefix_len);
+
+ip_tree_node * IPTreeAdd(ip_tree *tree, const ip_key *key, int prefix_len);
+ip_tree_node * IPTreeFind(ip_tree *tree, const ip_key *key, int prefix_len);
+bool IPTreeRemove(ip_tree *tree, const ip_key *key, int prefix_len);
+ip_tree_node * IPTreeMatch(ip_tree *tree, const ip_key *addr, INT64 now);
+void IPTreeClear(ip_tree *tree);
 
 void AddBlock(int iSeconds, struct in_addr* piaPeer);
-void DeleteBlock(struct in_addr* piaPeer);
+void AddBlockPrefix(int iSeconds, const ip_key *key, int prefix_len);
+bool FindBlock(const ip_key *key, int prefix_len);
+void DeleteBlock(const ip_key *key, int prefix_len);
 void DeleteAllBlocks(void);
+int GetNumBlocks(void);
 
 bool CheckBlockList(struct in_addr* piaPeer);
 
+void SetConnectRateLimits(int burst, int per_minute, int global_per_second);
+bool CheckConnectRate(struct in_addr* piaPeer, UINT64 now_ms);
+int GetNumConnectRateAddresses(void);
+
 void BuildBannedIPBlocks( const char *filename );
 
 
@@ -21,8 +21,19 @@ typedef struct
    char *data;
    int len_data;
    int garbage_ref;
+   bool interned;             /* data is shared; see string.c */
+   bool fuzzy_valid;          /* fuzzy_hash is current for data */
+   unsigned int fuzzy_hash;   /* GetTableHash value, computed on demand */
 } string_node;
 
+typedef struct
+{
+   int unique;                /* distinct interned strings */
+   int references;            /* string nodes pointing at them */
+   size_t bytes;              /* bytes of interned data stored */
+   size_t bytes_referenced;   /* bytes those nodes would hold unshared */
+} string_intern_stats;
+
 void InitString(void);
 void ResetString(void);
 int GetStringsUsed(void);
@@ -38,6 +49,10 @@ void SetNumStrings(int new_num_strings);
 int GetNumStrings(void);
 
 void SetString(string_node *snod,char *buf,int len);
+void AdoptString(string_node *snod,char *buf,int len);
+const string_intern_stats * GetStringInternStats(void);
+void InvalidateStringCache(string_node *snod);
+unsigned int GetStringFuzzyHash(string_node *snod);
 
 void SetTempString(char *buf,int len);
 void ClearTempString(void);
@@ -20,6 +20,7 @@ std::string ShortTimeStr(time_t time);
 std::string FileTimeStr(time_t time);
 std::string RelativeTimeStr(time_t time);
 UINT64 GetMilliCount();
+UINT64 GetMicroCount();
 
 #endif
 
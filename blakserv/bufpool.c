@@ -54,7 +54,8 @@ void ResetBufferPool(void)
 	 bn->size_prebuf = BUFFER_SIZE + HEADERBYTES;
       }
       FreeMemory(MALLOC_ID_BUFFER,bn->prebuf,bn->size_prebuf);
-      FreeMemory(MALLOC_ID_BUFFER,bn,sizeof(buffer_node));
+      FreePoolMemory(MALLOC_ID_BUFFER,bn,sizeof(buffer_node));
+      MetricsAdd(METRIC_BUFFERS_FREED,1);
       bn = temp;
    }
    buffers = NULL;
@@ -69,7 +70,7 @@ buffer_node * GetBuffer(void)
    MutexAcquire(mutex_buffers);
    if (buffers == NULL)
    {
-      bn = (buffer_node *) AllocateMemory(MALLOC_ID_BUFFER,sizeof(buffer_node));
+      bn = (buffer_node *) AllocatePoolMemory(MALLOC_ID_BUFFER,sizeof(buffer_node));
       bn->len_buf = 0;
       bn->size_buf = BUFFER_SIZE; /* used for buffers in reading */
       bn->size_prebuf = BUFFER_SIZE + HEADERBYTES;
@@ -77,6 +78,7 @@ buffer_node * GetBuffer(void)
       bn->buf = bn->prebuf + HEADERBYTES;
       bn->buffer_id = next_buffer_id++;
       bn->next = NULL;
+      MetricsAdd(METRIC_BUFFERS_CREATED,1);
    }
    else
    {
@@ -95,6 +97,7 @@ buffer_node * GetBuffer(void)
    }
    MutexRelease(mutex_buffers);
 
+   MetricsAdd(METRIC_BUFFERS_TAKEN,1);
    return bn;
 }
 
@@ -111,6 +114,8 @@ void DeleteBuffer(buffer_node *bn)
    bn->next = buffers;
    buffers = bn;
    MutexRelease(mutex_buffers);
+
+   MetricsAdd(METRIC_BUFFERS_RETURNED,1);
 }
 
 /* adds a block of bytes to a buffer list, potentially adding more buffers to
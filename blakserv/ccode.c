@@ -19,13 +19,7 @@
 #include "blakserv.h"
 #define FMT_HEADER_ONLY
 #include "fmt/format.h"
-#include "json_utils.h"
-
-#define iswhite(c) ((c)==' ' || (c)=='\t' || (c)=='\n' || (c)=='\r')
-
-// global buffers for zero-terminated string manipulation
-static char buf0[LEN_MAX_CLIENT_MSG+1];
-static char buf1[LEN_MAX_CLIENT_MSG+1];
+#include "json_utils.h"
 
 // Fineness units consistent with Blakod
 static const int FINENESS = 64;
@@ -33,27 +27,6 @@ static const int FINENESS = 64;
 // Scaling factor to convert server coordinates to polygon vertex coordinates
 static const int POLYGON_COORD_SCALE = 16;
 
-/* just like strstr, except any case-insensitive match will be returned */
-const char* stristr(const char* pSource, const char* pSearch)
-{
-   if (!pSource || !pSearch || !*pSearch)
-      return NULL;
-	
-   size_t nSearch = strlen(pSearch);
-   // Don't search past the end of pSource
-   const char *pEnd = pSource + strlen(pSource) - nSearch;
-   while (pSource <= pEnd)
-   {
-      if (0 == strnicmp(pSource, pSearch, nSearch))
-         return pSource;
-
-      pSource++;
-   }
-	
-   return NULL;
-}
-
-
 blak_int C_Invalid(int object_id,local_var_type *local_vars,
 			  int num_normal_parms,parm_node normal_parm_array[],
 			  int num_name_parms,parm_node name_parm_array[])
@@ -459,7 +432,7 @@ blak_int C_IsClass(int object_id,local_var_type *local_vars,
 		return NIL;
 	}
 	
-	c = GetClassByID(o->class_id);
+	c = o->class_ptr;
 	if (c == NULL)
 	{
 		bprintf("C_IsClass can't find class %i, DIE totally\n",o->class_id);
@@ -467,19 +440,8 @@ blak_int C_IsClass(int object_id,local_var_type *local_vars,
 		return NIL;
 	}
 	
-	do
-	{
-		if (c->class_id == class_val.v.data)
-		{
-			ret_val.v.tag = TAG_INT;
-			ret_val.v.data = true;
-			return ret_val.int_val;
-		}
-		c = c->super_ptr;
-	} while (c != NULL);
-	
 	ret_val.v.tag = TAG_INT;
-	ret_val.v.data = false;
+	ret_val.v.data = IsClassOrSubclass(c,(int) class_val.v.data);
 	return ret_val.int_val;
 }
 
@@ -624,58 +586,6 @@ blak_int C_StringEqual(int object_id,local_var_type *local_vars,
 	return ret_val.int_val;
 }
 
-void FuzzyCollapseString(char* pTarget, const char* pSource, int len)
-{
-	if (!pTarget || !pSource || len <= 0)
-	{
-		*pTarget = '\0';
-		return;
-	}
-	
-	// skip over leading and trailing whitespace
-	while (len && iswhite(*pSource)) { pSource++; len--; }
-	while (len && iswhite(pSource[len-1])) { len--; }
-	
-	// copy the core string in uppercase
-	while (len)
-	{
-		*pTarget++ = toupper(*pSource++);
-		len--;
-	}
-	
-	*pTarget = '\0';
-}
-
-bool FuzzyBufferEqual(const char *s1,int len1,const char *s2,int len2)
-{
-	if (!s1 || !s2 || len1 <= 0 || len2 <= 0)
-		return false;
-	
-	// skip over leading whitespace
-	while (len1 && iswhite(*s1)) { s1++; len1--; }
-	while (len2 && iswhite(*s2)) { s2++; len2--; }
-	
-	// cut off trailing whitespace
-	while (len1 && iswhite(s1[len1-1])) { len1--; }
-	while (len2 && iswhite(s2[len2-1])) { len2--; }
-	
-	// empty strings can't match anything
-	if (!len1 || !len2)
-		return false;
-	
-	// walk the strings until we find a mismatch or an end
-	while (len1 && len2 && toupper(*s1) == toupper(*s2))
-	{
-		s1++;
-		s2++;
-		len1--;
-		len2--;
-	}
-	
-	// we matched only if we finished both strings at the same time
-	return (len1 == 0 && len2 == 0);
-}
-
 //	Blakod parameters; string0, string1, string2
 //	Substitute first occurrence of string1 in string0 with string2
 //	Returns 1 if substituted, 0 if not found, NIL if error
@@ -685,15 +595,12 @@ blak_int C_StringSubstitute(int object_id,local_var_type *local_vars,
 {
 	val_type s0_val, s1_val, s2_val, r_val;
 	string_node *snod0, *snod1;
-	char buf0[LEN_MAX_CLIENT_MSG+1], buf1[LEN_MAX_CLIENT_MSG+1];
-	char *s0, *copyspot;
+	char *s0, *new_data;
    const char *s1, *s2, *subspot;
-	int len1, len2, new_len;
+	int len0, len1, len2, new_len, offset;
 	resource_node *r;
 	
-	s0 = buf0;
-	s1 = buf1;
-	s2 = subspot = copyspot = NULL;
+	s1 = s2 = subspot = NULL;
 	
 	s0_val = RetrieveValue( object_id, local_vars, normal_parm_array[0].type,
 		normal_parm_array[0].value);
@@ -722,19 +629,15 @@ blak_int C_StringSubstitute(int object_id,local_var_type *local_vars,
 			return NIL;
 		}
 		
-		// make a zero-terminated scratch copy of string1
+		s1 = snod1->data;
 		len1 = snod1->len_data;
-		memcpy( buf1, snod1->data, len1 );
-		buf1[len1] = 0x0;
 		break;
 		
 	case TAG_TEMP_STRING :
 		snod1 = GetTempString();
 		
-		// make a zero-terminated scratch copy of string1
+		s1 = snod1->data;
 		len1 = snod1->len_data;
-		memcpy( buf1, snod1->data, len1 );
-		buf1[len1] = 0x0;
 		break;
 		
 	case TAG_RESOURCE :
@@ -797,38 +700,51 @@ blak_int C_StringSubstitute(int object_id,local_var_type *local_vars,
 		return NIL;
 	}
 	
-	// now make a zero-terminated scratch copy of string0
-	memcpy( s0, snod0->data, snod0->len_data );
-	s0[snod0->len_data] = 0x0;
-	
-	// so we can use stristr to do the work
-	subspot = stristr( s0, s1 );
+	// match in place, stopping at any embedded zero as the old C string
+	// search did; string1 is still spliced out by its full length below
+	s0 = snod0->data;
+	len0 = s0 ? (int) strnlen( s0, snod0->len_data ) : 0;
+	subspot = FuzzyFindBuffer( s0, len0, s1, (int) strnlen( s1, len1 ) );
 	
     r_val.v.tag = TAG_INT;
     r_val.v.data = 0;
 	
 	if( subspot != NULL )	// only substitute if string1 is found in string0
 	{
+		offset = (int) (subspot - s0);
+		
 		if (snod0 != GetTempString())
 		{
-			// free the old string0 and allocate a new (possibly longer) string0
-			FreeMemory(MALLOC_ID_STRING,snod0->data,snod0->len_data);
-			snod0->data = (char *) AllocateMemory( MALLOC_ID_STRING, new_len+1);
+			// build the new (possibly longer) string0 beside the old one,
+			// since the old data may be interned and shared
+			new_data = (char *) AllocatePoolMemory( MALLOC_ID_STRING, new_len+1);
+			memcpy( new_data, s0, offset );
+			memcpy( new_data + offset, s2, len2 );
+			memcpy( new_data + offset + len2, s0 + offset + len1,
+				new_len - offset - len2 );
+			new_data[new_len] = '\0';
+			AdoptString( snod0, new_data, new_len );
+		}
+		else
+		{
+			// string2 may be the temp string itself, which the shift
+			// below would overwrite before it's copied in
+			char scratch[LEN_TEMP_STRING + 1];
+			if (s2 >= s0 && s2 <= s0 + LEN_TEMP_STRING)
+			{
+				memcpy( scratch, s2, len2 );
+				s2 = scratch;
+			}
+
+			// the temp string buffer holds LEN_TEMP_STRING, so shift in place
+			memmove( s0 + offset + len2, s0 + offset + len1,
+				new_len - offset - len2 );
+			memcpy( s0 + offset, s2, len2 );
+			snod0->len_data = new_len;
+			snod0->data[snod0->len_data] = '\0';
 		}
 		
-		// copy the piece before string1
-		copyspot = snod0->data;
-		memcpy( copyspot, s0, subspot - s0 );
-		
-		// copy string2
-		copyspot += ( subspot - s0 );
-		memcpy( copyspot, s2, len2 );
-		
-		// copy the piece after string1
-		copyspot += len2;
-		memcpy( copyspot, subspot + len1, new_len - (subspot - s0) - len2 );
-		snod0->len_data = new_len;
-		snod0->data[snod0->len_data] = '\0';
+		InvalidateStringCache(snod0);
 		
 		r_val.v.data = 1;
 	}
@@ -876,25 +792,6 @@ blak_int C_StringContain(int object_id,local_var_type *local_vars,
 	return ret_val.int_val;
 }
 
-/*
-"   orc teeth" == "orc teeth"
-" orc  teeth" == "orc teeth"
-"orcteeth" == "orc teeth"
-*/
-
-// return true if s1 contains s2,
-//	first converting to uppercase and squashing tabs and spaces to a single space
-bool FuzzyBufferContain(const char *s1,int len_s1,const char *s2,int len_s2)
-{
-	if (!s1 || !s2 || len_s1 <= 0 || len_s2 <= 0)
-		return false;
-	
-	FuzzyCollapseString(buf0, s1, len_s1);
-	FuzzyCollapseString(buf1, s2, len_s2);
-	
-	return (NULL != strstr(buf0, buf1));
-}
-
 blak_int C_SetResource(int object_id,local_var_type *local_vars,
 				  int num_normal_parms,parm_node normal_parm_array[],
 				  int num_name_parms,parm_node name_parm_array[])
@@ -1908,6 +1805,127 @@ blak_int C_MoveListElem(int object_id,local_var_type *local_vars,
   return NIL;
 }
 
+blak_int C_CreateArray(int object_id,local_var_type *local_vars,
+				  int num_normal_parms,parm_node normal_parm_array[],
+				  int num_name_parms,parm_node name_parm_array[])
+{
+	val_type length_val,ret_val;
+	int array_id;
+	
+	length_val = RetrieveValue(object_id,local_vars,normal_parm_array[0].type,
+		normal_parm_array[0].value);
+	if (length_val.v.tag != TAG_INT)
+	{
+		bprintf("C_CreateArray object %i can't make array of non-int length %s\n",
+            object_id,fmt(length_val));
+		return NIL;
+	}
+	
+	array_id = CreateArray((int) length_val.v.data);
+	if (array_id == INVALID_ID)
+		return NIL;
+	
+	ret_val.v.tag = TAG_ARRAY;
+	ret_val.v.data = array_id;
+	return ret_val.int_val;
+}
+
+blak_int C_GetArrayElem(int object_id,local_var_type *local_vars,
+				   int num_normal_parms,parm_node normal_parm_array[],
+				   int num_name_parms,parm_node name_parm_array[])
+{
+	val_type array_val,n_val;
+	
+	array_val = RetrieveValue(object_id,local_vars,normal_parm_array[0].type,
+		normal_parm_array[0].value);
+	if (array_val.v.tag != TAG_ARRAY)
+	{
+		bprintf("C_GetArrayElem object %i can't get elem of non-array %s\n",
+            object_id,fmt(array_val));
+		return NIL;
+	}
+	
+	n_val = RetrieveValue(object_id,local_vars,normal_parm_array[1].type,
+		normal_parm_array[1].value);
+	if (n_val.v.tag != TAG_INT)
+	{
+		bprintf("C_GetArrayElem object %i can't get elem with n = non-int %s\n",
+            object_id,fmt(n_val));
+		return NIL;
+	}
+	
+	return GetArrayElem((int) array_val.v.data,(int) n_val.v.data);
+}
+
+blak_int C_SetArrayElem(int object_id,local_var_type *local_vars,
+				   int num_normal_parms,parm_node normal_parm_array[],
+				   int num_name_parms,parm_node name_parm_array[])
+{
+	val_type array_val,n_val,set_val;
+	
+	array_val = RetrieveValue(object_id,local_vars,normal_parm_array[0].type,
+		normal_parm_array[0].value);
+	if (array_val.v.tag != TAG_ARRAY)
+	{
+		bprintf("C_SetArrayElem object %i can't set elem of non-array %s\n",
+            object_id,fmt(array_val));
+		return NIL;
+	}
+	
+	n_val = RetrieveValue(object_id,local_vars,normal_parm_array[1].type,
+		normal_parm_array[1].value);
+	if (n_val.v.tag != TAG_INT)
+	{
+		bprintf("C_SetArrayElem object %i can't set elem with n = non-int %s\n",
+            object_id,fmt(n_val));
+		return NIL;
+	}
+	
+	set_val = RetrieveValue(object_id,local_vars,normal_parm_array[2].type,
+		normal_parm_array[2].value);
+	
+	return SetArrayElem((int) array_val.v.data,(int) n_val.v.data,set_val);
+}
+
+blak_int C_ArrayLength(int object_id,local_var_type *local_vars,
+				  int num_normal_parms,parm_node normal_parm_array[],
+				  int num_name_parms,parm_node name_parm_array[])
+{
+	val_type array_val,ret_val;
+	array_node *a;
+	
+	array_val = RetrieveValue(object_id,local_vars,normal_parm_array[0].type,
+		normal_parm_array[0].value);
+	if (array_val.v.tag != TAG_ARRAY)
+	{
+		bprintf("C_ArrayLength object %i can't take ArrayLength of non-array %s\n",
+            object_id,fmt(array_val));
+		return NIL;
+	}
+	
+	a = GetArrayByID((int) array_val.v.data);
+	if (a == NULL)
+		return NIL;
+	
+	ret_val.v.tag = TAG_INT;
+	ret_val.v.data = a->length;
+	return ret_val.int_val;
+}
+
+blak_int C_IsArray(int object_id,local_var_type *local_vars,
+			  int num_normal_parms,parm_node normal_parm_array[],
+			  int num_name_parms,parm_node name_parm_array[])
+{
+	val_type var_check,ret_val;
+	
+	var_check = RetrieveValue(object_id,local_vars,normal_parm_array[0].type,
+			     normal_parm_array[0].value);
+	
+	ret_val.v.tag = TAG_INT;
+	ret_val.v.data = var_check.v.tag == TAG_ARRAY;
+	return ret_val.int_val;
+}
+
 blak_int C_GetTime(int object_id,local_var_type *local_vars,
 			  int num_normal_parms,parm_node normal_parm_array[],
 			  int num_name_parms,parm_node name_parm_array[])
@@ -2589,6 +2607,181 @@ blak_int C_IsPointInSector(int object_id, local_var_type *local_vars, int num_no
    return ret.int_val;
 }
 
+/* GetRoomDataParm
+ *
+ * Looks up the room data passed as a Blakod parameter; function_name is
+ * used for error messages.
+ */
+static roomdata_node * GetRoomDataParm(val_type room_val,const char *function_name)
+{
+	roomdata_node *r;
+
+	if (room_val.v.tag != TAG_ROOM_DATA)
+	{
+		bprintf("%s can't use non room %s\n",function_name,fmt(room_val));
+		return NULL;
+	}
+
+	r = GetRoomDataByID(room_val.v.data);
+	if (r == NULL)
+		bprintf("%s can't find room %" PRId64 "\n",function_name,room_val.v.data);
+	return r;
+}
+
+/* BuildObjectList
+ *
+ * Returns a Blakod list of the given object ids, in the given order.
+ */
+static blak_int BuildObjectList(const std::vector<int> &object_ids)
+{
+	val_type ret_val,temp;
+
+	ret_val.int_val = NIL;
+	for (size_t i=object_ids.size();i>0;i--)
+	{
+		temp.v.tag = TAG_OBJECT;
+		temp.v.data = object_ids[i-1];
+		ret_val.v.data = Cons(temp,ret_val);
+		ret_val.v.tag = TAG_LIST; /* do this AFTER the cons call or DIE */
+	}
+	return ret_val.int_val;
+}
+
+/*
+ * C_RoomObjectMoved: tell a room's spatial hash that an object is now at
+ * row, col (1-based).  Adds the object if the room didn't have it yet.
+ */
+blak_int C_RoomObjectMoved(int object_id,local_var_type *local_vars,
+			int num_normal_parms,parm_node normal_parm_array[],
+			int num_name_parms,parm_node name_parm_array[])
+{
+	val_type room_val,what_val,row_val,col_val;
+	roomdata_node *r;
+
+	room_val = RetrieveValue(object_id,local_vars,normal_parm_array[0].type,
+		normal_parm_array[0].value);
+	what_val = RetrieveValue(object_id,local_vars,normal_parm_array[1].type,
+		normal_parm_array[1].value);
+	row_val = RetrieveValue(object_id,local_vars,normal_parm_array[2].type,
+		normal_parm_array[2].value);
+	col_val = RetrieveValue(object_id,local_vars,normal_parm_array[3].type,
+		normal_parm_array[3].value);
+
+	r = GetRoomDataParm(room_val,"C_RoomObjectMoved");
+	if (r == NULL)
+		return NIL;
+
+	if (what_val.v.tag != TAG_OBJECT)
+	{
+		bprintf("C_RoomObjectMoved can't use non object %s\n", fmt(what_val));
+		return NIL;
+	}
+
+	if (row_val.v.tag != TAG_INT || col_val.v.tag != TAG_INT)
+	{
+		bprintf("C_RoomObjectMoved can't use non int position %s, %s\n",
+			fmt(row_val), fmt(col_val));
+		return NIL;
+	}
+
+	RoomObjectMoved(r,(int) what_val.v.data,(int) row_val.v.data,(int) col_val.v.data);
+	return NIL;
+}
+
+blak_int C_RoomObjectRemoved(int object_id,local_var_type *local_vars,
+			int num_normal_parms,parm_node normal_parm_array[],
+			int num_name_parms,parm_node name_parm_array[])
+{
+	val_type room_val,what_val;
+	roomdata_node *r;
+
+	room_val = RetrieveValue(object_id,local_vars,normal_parm_array[0].type,
+		normal_parm_array[0].value);
+	what_val = RetrieveValue(object_id,local_vars,normal_parm_array[1].type,
+		normal_parm_array[1].value);
+
+	r = GetRoomDataParm(room_val,"C_RoomObjectRemoved");
+	if (r == NULL)
+		return NIL;
+
+	if (what_val.v.tag != TAG_OBJECT)
+	{
+		bprintf("C_RoomObjectRemoved can't use non object %s\n", fmt(what_val));
+		return NIL;
+	}
+
+	RoomObjectRemoved(r,(int) what_val.v.data);
+	return NIL;
+}
+
+/*
+ * C_RoomObjectsInRange: returns a list of the objects in the room within
+ * distance squares of row, col (inclusive).
+ */
+blak_int C_RoomObjectsInRange(int object_id,local_var_type *local_vars,
+			int num_normal_parms,parm_node normal_parm_array[],
+			int num_name_parms,parm_node name_parm_array[])
+{
+	val_type room_val,row_val,col_val,distance_val;
+	roomdata_node *r;
+	std::vector<int> found;
+
+	room_val = RetrieveValue(object_id,local_vars,normal_parm_array[0].type,
+		normal_parm_array[0].value);
+	row_val = RetrieveValue(object_id,local_vars,normal_parm_array[1].type,
+		normal_parm_array[1].value);
+	col_val = RetrieveValue(object_id,local_vars,normal_parm_array[2].type,
+		normal_parm_array[2].value);
+	distance_val = RetrieveValue(object_id,local_vars,normal_parm_array[3].type,
+		normal_parm_array[3].value);
+
+	r = GetRoomDataParm(room_val,"C_RoomObjectsInRange");
+	if (r == NULL)
+		return NIL;
+
+	if (row_val.v.tag != TAG_INT || col_val.v.tag != TAG_INT || distance_val.v.tag != TAG_INT)
+	{
+		bprintf("C_RoomObjectsInRange can't use non int position %s, %s, distance %s\n",
+			fmt(row_val), fmt(col_val), fmt(distance_val));
+		return NIL;
+	}
+
+	GetRoomObjectsInRange(r,(int) row_val.v.data,(int) col_val.v.data,
+		(int) distance_val.v.data,found);
+	return BuildObjectList(found);
+}
+
+/*
+ * C_RoomObjectsOfClass: returns a list of the objects in the room that are
+ * of the given class or a subclass, e.g. RoomObjectsOfClass(prmRoom,&User).
+ */
+blak_int C_RoomObjectsOfClass(int object_id,local_var_type *local_vars,
+			int num_normal_parms,parm_node normal_parm_array[],
+			int num_name_parms,parm_node name_parm_array[])
+{
+	val_type room_val,class_val;
+	roomdata_node *r;
+	std::vector<int> found;
+
+	room_val = RetrieveValue(object_id,local_vars,normal_parm_array[0].type,
+		normal_parm_array[0].value);
+	class_val = RetrieveValue(object_id,local_vars,normal_parm_array[1].type,
+		normal_parm_array[1].value);
+
+	r = GetRoomDataParm(room_val,"C_RoomObjectsOfClass");
+	if (r == NULL)
+		return NIL;
+
+	if (class_val.v.tag != TAG_CLASS)
+	{
+		bprintf("C_RoomObjectsOfClass can't look for non-class %s\n", fmt(class_val));
+		return NIL;
+	}
+
+	GetRoomObjectsOfClass(r,(int) class_val.v.data,found);
+	return BuildObjectList(found);
+}
+
 blak_int C_SendWebhook(int object_id, local_var_type *local_vars,
     int num_normal_parms, parm_node normal_parm_array[],
     int num_name_parms, parm_node name_parm_array[])
@@ -2632,7 +2825,7 @@ blak_int C_SendWebhook(int object_id, local_var_type *local_vars,
     
     // Start building JSON: {"event": "EventName", "params": {
     std::string json = "{\"event\":\"";
-    json += JsonEscape(std::string(event_name, event_len));
+    json += JsonEscape(std::string(event_name, event_len));
     json += "\",\"params\":{";
     
     // Process remaining parameters as key-value pairs
@@ -2660,7 +2853,7 @@ blak_int C_SendWebhook(int object_id, local_var_type *local_vars,
         
         // Add key
         json += "\"";
-        json += JsonEscape(std::string(key_str, key_len));
+        json += JsonEscape(std::string(key_str, key_len));
         json += "\":";
         
         // Handle different value types
@@ -2668,7 +2861,7 @@ blak_int C_SendWebhook(int object_id, local_var_type *local_vars,
             value_val.v.tag == TAG_RESOURCE) {
             if (LookupString(value_val, "C_SendWebhook", &value_str, &value_len)) {
                 json += "\"";
-                json += JsonEscape(std::string(value_str, value_len));
+                json += JsonEscape(std::string(value_str, value_len));
                 json += "\"";
             } else {
                 json += "null";
@@ -2686,7 +2879,7 @@ blak_int C_SendWebhook(int object_id, local_var_type *local_vars,
     // Close JSON: }}
     json += "}}";
     
-    // Send structured webhook message via trusted structured path.
-    SendWebhookStructuredMessage(json.c_str(), (int)json.length());
-    return NIL;
-}
+    // Send structured webhook message via trusted structured path.
+    SendWebhookStructuredMessage(json.c_str(), (int)json.length());
+    return NIL;
+}
@@ -189,6 +189,26 @@ blak_int C_MoveListElem(int object_id,local_var_type *local_vars,
 		   int num_normal_parms,parm_node normal_parm_array[],
 		   int num_name_parms,parm_node name_parm_array[]);
 
+blak_int C_CreateArray(int object_id,local_var_type *local_vars,
+		  int num_normal_parms,parm_node normal_parm_array[],
+		  int num_name_parms,parm_node name_parm_array[]);
+
+blak_int C_GetArrayElem(int object_id,local_var_type *local_vars,
+		   int num_normal_parms,parm_node normal_parm_array[],
+		   int num_name_parms,parm_node name_parm_array[]);
+
+blak_int C_SetArrayElem(int object_id,local_var_type *local_vars,
+		   int num_normal_parms,parm_node normal_parm_array[],
+		   int num_name_parms,parm_node name_parm_array[]);
+
+blak_int C_ArrayLength(int object_id,local_var_type *local_vars,
+		  int num_normal_parms,parm_node normal_parm_array[],
+		  int num_name_parms,parm_node name_parm_array[]);
+
+blak_int C_IsArray(int object_id,local_var_type *local_vars,
+	      int num_normal_parms,parm_node normal_parm_array[],
+	      int num_name_parms,parm_node name_parm_array[]);
+
 blak_int C_GetTime(int object_id,local_var_type *local_vars,
 	      int num_normal_parms,parm_node normal_parm_array[],
 	      int num_name_parms,parm_node name_parm_array[]);
@@ -253,13 +273,25 @@ blak_int C_IsPointInSector(int object_id,local_var_type *local_vars,
 			int num_normal_parms,parm_node normal_parm_array[],
 			int num_name_parms,parm_node name_parm_array[]);
 
+blak_int C_RoomObjectMoved(int object_id,local_var_type *local_vars,
+			int num_normal_parms,parm_node normal_parm_array[],
+			int num_name_parms,parm_node name_parm_array[]);
+
+blak_int C_RoomObjectRemoved(int object_id,local_var_type *local_vars,
+			int num_normal_parms,parm_node normal_parm_array[],
+			int num_name_parms,parm_node name_parm_array[]);
+
+blak_int C_RoomObjectsInRange(int object_id,local_var_type *local_vars,
+			int num_normal_parms,parm_node normal_parm_array[],
+			int num_name_parms,parm_node name_parm_array[]);
+
+blak_int C_RoomObjectsOfClass(int object_id,local_var_type *local_vars,
+			int num_normal_parms,parm_node normal_parm_array[],
+			int num_name_parms,parm_node name_parm_array[]);
+
 blak_int C_SendWebhook(int object_id, local_var_type *local_vars,
 			int num_normal_parms, parm_node normal_parm_array[],
 			int num_name_parms, parm_node name_parm_array[]);
 
 
-void FuzzyCollapseString(char* pTarget, const char* pSource, int len);
-bool FuzzyBufferEqual(const char *s1,int len1,const char *s2,int len2);
-bool FuzzyBufferContain(const char *s1,int len1,const char *s2,int len2);
-
 #endif
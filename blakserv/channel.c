@@ -13,10 +13,23 @@
  Based on the configuration, the channels may or not be written to
  files, but they are always shown on the interface (chanbuf.c).
 
+ Once OpenDefaultChannels has run, the printf functions only format
+ their message into a slot of a lock-free ring and return.  A writer
+ thread empties the ring: it adds the timestamp, converts newlines,
+ writes the files and the interface buffer, flushes once per batch,
+ and starts a new file when the date changes.  A message identical to
+ the previous one on its channel within CHANNEL_REPEAT_SECONDS is
+ counted instead of written.  If the ring is full the message is
+ dropped and counted.  Before the writer starts and after it stops,
+ messages are written directly by the calling thread.
+
  */
 
 #include "blakserv.h"
 
+#include <atomic>
+#include <thread>
+
 typedef struct
 {
    int channel_id;
@@ -33,9 +46,55 @@ channel_table_type channel_table[] =
 
 channel_node channel[NUM_CHANNELS];
 
+/* must be a power of 2 so the ring positions can wrap */
+#define CHANNEL_RING_SIZE 1024
+#define CHANNEL_RECORD_SIZE 2000
+#define CHANNEL_REPEAT_SECONDS 10
+#define CHANNEL_IDLE_MS 10
+#define CHANNEL_FLUSH_WAIT_MS 2000
+
+/* one message, formatted by the caller and finished by the writer */
+typedef struct
+{
+   std::atomic<unsigned int> sequence;
+   int channel_id;
+   bool add_newline;
+   const char *separator;
+   time_t time;
+   char text[CHANNEL_RECORD_SIZE];
+} channel_record;
+
+/* the last message written on a channel, for folding repeats */
+typedef struct
+{
+   std::string text;
+   time_t first_time;
+   time_t last_time;
+   int count;
+} channel_repeat;
+
+static channel_record channel_ring[CHANNEL_RING_SIZE];
+static std::atomic<unsigned int> ring_head;   /* next slot for a caller */
+static std::atomic<unsigned int> ring_tail;   /* next slot for the writer */
+
+static std::thread writer_thread;
+static std::atomic<bool> writer_running;
+static std::atomic<bool> reopen_requested;
+static std::atomic<bool> flush_requested;
+static bool exit_hook_registered;
+
+static channel_repeat channel_repeats[NUM_CHANNELS];
+
+static std::atomic<int> records_written;
+static std::atomic<int> records_repeated;
+static std::atomic<int> records_dropped;
+static int records_dropped_reported;
+
 /* local function prototypes */
 void WriteStrChannel(int channel_id,char *s);
 FILE *CreateFileChannel(int channel_id);
+static void ChannelWriterThread(void);
+static void StopChannelWriterAtExit(void);
 
 static void AppendNewlineSafe(char *s, size_t max_len)
 {
@@ -56,7 +115,40 @@ std::string obj_to_string(int tag, INT64 data)
   return std::to_string(tag) + "," + std::to_string(data);
 }
 
-void OpenDefaultChannels()
+/* localtime() shares its result between threads, and the writer thread
+ * formats times while the game thread may be doing the same */
+static bool ChannelLocalTime(time_t t,struct tm *tm_time)
+{
+#ifdef BLAK_PLATFORM_WINDOWS
+   return localtime_s(tm_time,&t) == 0;
+#else
+   return localtime_r(&t,tm_time) != NULL;
+#endif
+}
+
+static void ChannelDateStr(time_t t,char *date_str,size_t len)
+{
+   struct tm tm_time;
+
+   if (!ChannelLocalTime(t,&tm_time) ||
+       strftime(date_str,len,"%Y-%m-%d",&tm_time) == 0)
+      snprintf(date_str,len,"unknown");
+}
+
+/* same format as TimeStr() */
+static void ChannelTimeStr(time_t t,char *time_str,size_t len)
+{
+   struct tm tm_time;
+
+   if (t == 0)
+      snprintf(time_str,len,"Never");
+   else if (!ChannelLocalTime(t,&tm_time))
+      snprintf(time_str,len,"Invalid Time");
+   else if (strftime(time_str,len,"%b %d %Y %H:%M:%S",&tm_time) == 0)
+      snprintf(time_str,len,"Time string too long");
+}
+
+static void OpenChannelFiles()
 {
    int i;
    for (i=0;i<NUM_CHANNELS;i++)
@@ -73,7 +165,7 @@ void OpenDefaultChannels()
    }
 }
 
-void CloseDefaultChannels()
+static void CloseChannelFiles()
 {
    int i;
 
@@ -87,7 +179,7 @@ void CloseDefaultChannels()
    }
 }
 
-void FlushDefaultChannels()
+static void FlushChannelFiles()
 {
    int i;
 
@@ -96,102 +188,205 @@ void FlushDefaultChannels()
          fflush(channel[i].file);
 }
 
-// Max length of a time string
-static const int MAX_TIME_SIZE = 100;
-
-void dprintf(const char *fmt,...)
+void OpenDefaultChannels()
 {
-   char s[2000];
-   va_list marker;
-   size_t current_len;
-   size_t remaining;
+   unsigned int i;
 
-   snprintf(s, sizeof(s), "%s|",TimeStr(GetTime()).c_str());
-   current_len = strlen(s);
-   remaining = sizeof(s) - current_len;
+   OpenChannelFiles();
 
-   if (remaining > 0)
+   for (i=0;i<CHANNEL_RING_SIZE;i++)
+      channel_ring[i].sequence.store(i,std::memory_order_relaxed);
+   ring_head.store(0);
+   ring_tail.store(0);
+
+   writer_running.store(true,std::memory_order_release);
+   writer_thread = std::thread(ChannelWriterThread);
+
+   if (!exit_hook_registered)
    {
-      va_start(marker,fmt);
-      vsnprintf(s+current_len, remaining, fmt,marker);
-      va_end(marker);
+      atexit(StopChannelWriterAtExit);
+      exit_hook_registered = true;
    }
+}
 
-   TermConvertBuffer(s,sizeof(s)); /* makes \n's into CR/LF pairs */
-   AppendNewlineSafe(s, sizeof(s));
+void CloseDefaultChannels()
+{
+   if (writer_running.exchange(false))
+      writer_thread.join();
 
-   WriteStrChannel(CHANNEL_D,s);
+   CloseChannelFiles();
 }
 
-void eprintf(const char *fmt,...)
+/* exit() with the writer still running, as FatalErrorShow does, would
+ * destroy a joinable std::thread, which aborts and loses what's still in
+ * the ring; write it out and stop the writer instead */
+static void StopChannelWriterAtExit()
 {
-   char s[2000];
-   va_list marker;
-   size_t current_len;
-   size_t remaining;
+   if (writer_thread.joinable() &&
+       std::this_thread::get_id() == writer_thread.get_id())
+   {
+      writer_running.store(false);
+      writer_thread.detach();
+      return;
+   }
 
-   snprintf(s, sizeof(s), "%s | ",TimeStr(GetTime()).c_str());
-   current_len = strlen(s);
-   remaining = sizeof(s) - current_len;
+   CloseDefaultChannels();
+}
 
-   if (remaining > 0)
+/* start new channel files; done by the writer thread if it's running */
+void ReopenDefaultChannels()
+{
+   if (writer_running.load(std::memory_order_acquire))
    {
-      va_start(marker,fmt);
-      vsnprintf(s+current_len, remaining, fmt,marker);
-      va_end(marker);
+      reopen_requested.store(true);
+      return;
    }
 
-   TermConvertBuffer(s,sizeof(s)); /* makes \n's into CR/LF pairs */
+   CloseChannelFiles();
+   OpenChannelFiles();
+}
+
+/* get everything logged so far onto disk.  This is called on the way to
+ * crashing, so if the writer is stuck we give up after a while */
+void FlushDefaultChannels()
+{
+   int waited;
+
+   if (writer_running.load(std::memory_order_acquire) &&
+       std::this_thread::get_id() != writer_thread.get_id())
+   {
+      flush_requested.store(true);
+      for (waited=0;waited<CHANNEL_FLUSH_WAIT_MS && flush_requested.load();waited++)
+         std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      return;
+   }
 
-   WriteStrChannel(CHANNEL_E,s);
+   FlushChannelFiles();
 }
 
-void bprintf(const char *fmt,...)
+void GetChannelStats(channel_stats *cs)
 {
-   char s[1000];
-   va_list marker;
-   size_t current_len;
-   size_t remaining;
+   cs->written = records_written.load();
+   cs->repeated = records_repeated.load();
+   cs->dropped = records_dropped.load();
+}
 
-   snprintf(s, sizeof(s), "%s | [%s] ",TimeStr(GetTime()).c_str(),BlakodDebugInfo().c_str());
-   current_len = strlen(s);
-   remaining = sizeof(s) - current_len;
+static channel_record * ClaimChannelRecord(unsigned int *ring_pos)
+{
+   channel_record *rec;
+   unsigned int pos,seq;
+   int diff;
 
-   if (remaining > 0)
+   pos = ring_head.load(std::memory_order_relaxed);
+   for (;;)
    {
-      va_start(marker,fmt);
-      vsnprintf(s+current_len, remaining, fmt,marker);
-      va_end(marker);
+      rec = &channel_ring[pos % CHANNEL_RING_SIZE];
+      seq = rec->sequence.load(std::memory_order_acquire);
+      diff = (int) (seq - pos);
+      if (diff == 0)
+      {
+         if (ring_head.compare_exchange_weak(pos,pos+1,std::memory_order_relaxed))
+         {
+            *ring_pos = pos;
+            return rec;
+         }
+      }
+      else if (diff < 0)
+         return NULL;   /* writer hasn't freed this slot yet: ring is full */
+      else
+         pos = ring_head.load(std::memory_order_relaxed);
    }
+}
+
+static void EmitChannelRecord(channel_record *rec)
+{
+   char s[CHANNEL_RECORD_SIZE];
+   char time_str[80];
+
+   /* a record as long as s loses its end, the same as an overlong message
+      did when it was formatted */
+   ChannelTimeStr(rec->time,time_str,sizeof(time_str));
+   if (snprintf(s,sizeof(s),"%s%s%s",time_str,rec->separator,rec->text) >= (int) sizeof(s))
+      s[sizeof(s)-1] = '\0';
 
    TermConvertBuffer(s,sizeof(s)); /* makes \n's into CR/LF pairs */
-   AppendNewlineSafe(s, sizeof(s));
+   if (rec->add_newline)
+      AppendNewlineSafe(s,sizeof(s));
 
-   WriteStrChannel(CHANNEL_E,s);
+   WriteStrChannel(rec->channel_id,s);
 }
 
-void lprintf(const char *fmt,...)
+static void WriteChannel(int channel_id,bool add_newline,const char *separator,
+                         const char *prefix,const char *fmt,va_list marker)
 {
-   char s[1000];
-   va_list marker;
+   channel_record direct,*rec;
+   unsigned int pos;
    size_t current_len;
-   size_t remaining;
-
-   snprintf(s, sizeof(s), "%s | ",TimeStr(GetTime()).c_str());
-   current_len = strlen(s);
-   remaining = sizeof(s) - current_len;
 
-   if (remaining > 0)
+   rec = &direct;
+   if (writer_running.load(std::memory_order_acquire))
    {
-      va_start(marker,fmt);
-      vsnprintf(s+current_len, remaining, fmt,marker);
-      va_end(marker);
+      rec = ClaimChannelRecord(&pos);
+      if (rec == NULL)
+      {
+         records_dropped++;
+         return;
+      }
    }
 
-   TermConvertBuffer(s,sizeof(s)); /* makes \n's into CR/LF pairs */
-   AppendNewlineSafe(s, sizeof(s));
+   rec->channel_id = channel_id;
+   rec->add_newline = add_newline;
+   rec->separator = separator;
+   rec->time = GetTime();
+
+   snprintf(rec->text,sizeof(rec->text),"%s",prefix);
+   current_len = strlen(rec->text);
+   if (current_len < sizeof(rec->text))
+      vsnprintf(rec->text+current_len,sizeof(rec->text)-current_len,fmt,marker);
+
+   if (rec == &direct)
+      EmitChannelRecord(rec);
+   else
+      rec->sequence.store(pos+1,std::memory_order_release);
+}
+
+void dprintf(const char *fmt,...)
+{
+   va_list marker;
+
+   va_start(marker,fmt);
+   WriteChannel(CHANNEL_D,true,"|","",fmt,marker);
+   va_end(marker);
+}
+
+void eprintf(const char *fmt,...)
+{
+   va_list marker;
 
-   WriteStrChannel(CHANNEL_L,s);
+   va_start(marker,fmt);
+   WriteChannel(CHANNEL_E,false," | ","",fmt,marker);
+   va_end(marker);
+}
+
+void bprintf(const char *fmt,...)
+{
+   va_list marker;
+   std::string prefix;
+
+   prefix = "[" + BlakodDebugInfo() + "] ";
+
+   va_start(marker,fmt);
+   WriteChannel(CHANNEL_E,true," | ",prefix.c_str(),fmt,marker);
+   va_end(marker);
+}
+
+void lprintf(const char *fmt,...)
+{
+   va_list marker;
+
+   va_start(marker,fmt);
+   WriteChannel(CHANNEL_L,true," | ","",fmt,marker);
+   va_end(marker);
 }
 
 void WriteStrChannel(int channel_id,char *s)
@@ -199,7 +394,7 @@ void WriteStrChannel(int channel_id,char *s)
    if (channel[channel_id].file != NULL)
    {
       fwrite(s, 1, strlen(s), channel[channel_id].file);
-      if (ConfigBool(CHANNEL_FLUSH))
+      if (ConfigBool(CHANNEL_FLUSH) && !writer_running.load(std::memory_order_relaxed))
          fflush(channel[channel_id].file);
    }
 
@@ -211,21 +406,168 @@ FILE *CreateFileChannel(int channel_id)
    char channel_file[MAX_PATH+FILENAME_MAX];
    FILE *pFile;
 
-   char date_str[500];
-
-   time_t t;
-   struct tm *time_struct;
-
-   t = time(NULL);
-   time_struct = localtime(&t);
-   if (time_struct == NULL) {
-       strncpy(date_str, "unknown", sizeof(date_str));
-   } else {
-       strftime(date_str, sizeof(date_str), "%Y-%m-%d", time_struct);
-   }
+   ChannelDateStr(time(NULL),channel[channel_id].file_date,
+                  sizeof(channel[channel_id].file_date));
    snprintf(channel_file, sizeof(channel_file),
-            "%s%s-%s.txt",ConfigStr(PATH_CHANNEL),channel_table[channel_id].file_name, date_str);
+            "%s%s-%s.txt",ConfigStr(PATH_CHANNEL),channel_table[channel_id].file_name,
+            channel[channel_id].file_date);
    pFile = fopen(channel_file, "ab");
 
    return pFile;
 }
+
+/* the rest of this file runs only in the writer thread */
+
+static void WriteChannelNote(int channel_id,time_t t,const char *fmt,...)
+{
+   channel_record note;
+   va_list marker;
+
+   note.channel_id = channel_id;
+   note.add_newline = true;
+   note.separator = " | ";
+   note.time = t;
+
+   va_start(marker,fmt);
+   vsnprintf(note.text,sizeof(note.text),fmt,marker);
+   va_end(marker);
+
+   EmitChannelRecord(&note);
+}
+
+/* write out how many times the last message on channel_id was repeated,
+ * if it was, and forget it */
+static void EndChannelRepeat(int channel_id)
+{
+   channel_repeat *r = &channel_repeats[channel_id];
+
+   if (r->count > 0)
+      WriteChannelNote(channel_id,r->last_time,"Previous message repeated %i more time%s",
+                       r->count,r->count == 1 ? "" : "s");
+   r->text.clear();
+   r->count = 0;
+}
+
+static void WriteChannelRecord(channel_record *rec)
+{
+   channel_repeat *r = &channel_repeats[rec->channel_id];
+
+   if (!r->text.empty() && rec->time - r->first_time < CHANNEL_REPEAT_SECONDS &&
+       r->text == rec->text)
+   {
+      r->count++;
+      r->last_time = rec->time;
+      records_repeated++;
+      return;
+   }
+
+   EndChannelRepeat(rec->channel_id);
+   EmitChannelRecord(rec);
+   records_written++;
+
+   r->text = rec->text;
+   r->first_time = r->last_time = rec->time;
+}
+
+/* returns the number of records written */
+static int DrainChannelRing()
+{
+   channel_record *rec;
+   unsigned int pos;
+   int count;
+
+   count = 0;
+   pos = ring_tail.load(std::memory_order_relaxed);
+   for (;;)
+   {
+      rec = &channel_ring[pos % CHANNEL_RING_SIZE];
+      if (rec->sequence.load(std::memory_order_acquire) != pos+1)
+         break;
+
+      WriteChannelRecord(rec);
+
+      rec->sequence.store(pos+CHANNEL_RING_SIZE,std::memory_order_release);
+      pos++;
+      ring_tail.store(pos,std::memory_order_release);
+      count++;
+   }
+   return count;
+}
+
+static void RotateChannelFiles(time_t now)
+{
+   char date_str[sizeof(channel[0].file_date)];
+   int i;
+
+   ChannelDateStr(now,date_str,sizeof(date_str));
+   for (i=0;i<NUM_CHANNELS;i++)
+   {
+      if (channel[i].file != NULL && strcmp(date_str,channel[i].file_date) != 0)
+      {
+         fclose(channel[i].file);
+         channel[i].file = CreateFileChannel(i);
+      }
+   }
+}
+
+static void ChannelWriterThread()
+{
+   time_t now,last_rotate_check;
+   bool running;
+   int dropped,i;
+
+   last_rotate_check = 0;
+   for (;;)
+   {
+      running = writer_running.load(std::memory_order_acquire);
+      now = GetTime();
+
+      if (reopen_requested.exchange(false))
+      {
+         CloseChannelFiles();
+         OpenChannelFiles();
+      }
+
+      if (now != last_rotate_check)
+      {
+         RotateChannelFiles(now);
+         last_rotate_check = now;
+      }
+
+      dropped = records_dropped.load();
+      if (dropped != records_dropped_reported)
+      {
+         WriteChannelNote(CHANNEL_E,now,"Channel writer dropped %i messages, log ring was full",
+                          dropped - records_dropped_reported);
+         records_dropped_reported = dropped;
+      }
+
+      if (DrainChannelRing() > 0)
+      {
+         if (ConfigBool(CHANNEL_FLUSH))
+            FlushChannelFiles();
+         continue;
+      }
+
+      for (i=0;i<NUM_CHANNELS;i++)
+         if (channel_repeats[i].count > 0 &&
+             now - channel_repeats[i].first_time >= CHANNEL_REPEAT_SECONDS)
+            EndChannelRepeat(i);
+
+      if (flush_requested.load())
+      {
+         FlushChannelFiles();
+         flush_requested.store(false);
+      }
+
+      if (!running)
+         break;
+
+      std::this_thread::sleep_for(std::chrono::milliseconds(CHANNEL_IDLE_MS));
+   }
+
+   for (i=0;i<NUM_CHANNELS;i++)
+      EndChannelRepeat(i);
+   FlushChannelFiles();
+   flush_requested.store(false);
+}
@@ -16,8 +16,16 @@
 typedef struct
 {
    FILE *file;
+   char file_date[16];     /* date in the file's name, for rotation */
 } channel_node;
 
+typedef struct
+{
+   int written;            /* messages written by the channel writer */
+   int repeated;           /* identical messages folded into a count */
+   int dropped;            /* messages lost because the ring was full */
+} channel_stats;
+
 enum
 {
    CHANNEL_D,		/* debug info */
@@ -29,6 +37,8 @@ enum
 void OpenDefaultChannels(void);
 void CloseDefaultChannels(void);
 void FlushDefaultChannels(void);
+void ReopenDefaultChannels(void);
+void GetChannelStats(channel_stats *cs);
 
 // Give warnings on these functions if arguments don't match format (gcc only)
 #if defined(__GNUC__)
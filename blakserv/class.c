@@ -20,6 +20,11 @@
 	messages and number of messages, possibly its name from the kodbase,
 	the filename the class is defined in (the .kod file), and possibly a
 	list of names of its properties.
+
+	Once the classes are loaded, the class tree is numbered in preorder,
+	so that a class and its subclasses have consecutive numbers, and
+	classes_in_order has them by number.  This lets object.c find the
+	objects of a class and its subclasses from a run of classes.
 	
 */
 
@@ -30,10 +35,20 @@ static int classes_table_size;
 
 static sihash_type class_name_map;
 
+static std::vector<class_node *> classes_in_order;
+
+/* each class by id, filled in by NumberClasses, so that GetClassByID and
+   IsClassOrSubclass don't walk a hash bucket */
+std::vector<class_node *> classes_by_id;
+
 
 /* local function prototypes */
+void FreeClassData(class_node *c);
 void SetOneClassVariables(class_node *c,class_node *setvar_class);
 void SetOneClassPropertyNames(class_node *c);
+static void NumberClasses(void);
+static void NumberClass(class_node *c,
+						std::unordered_map<class_node *,std::vector<class_node *>> &subclasses);
 
 void InitClass(void)
 {
@@ -51,8 +66,6 @@ void InitClass(void)
 void ResetClass(void)
 {
 	class_node *c,*temp;
-	classvar_name_node *cv,*temp_cv;
-	property_name_node *prop,*temp_prop;
 	int i;
 	
 	for (i=0;i<classes_table_size;i++)
@@ -61,51 +74,80 @@ void ResetClass(void)
 		while (c != NULL)
 		{
 			temp = c->next;
-			if (c->num_prop_defaults != 0)
-				FreeMemory(MALLOC_ID_CLASS,c->prop_default,
-							  sizeof(prop_default_type)*c->num_prop_defaults);
-			if (c->num_var_defaults != 0)
-				FreeMemory(MALLOC_ID_CLASS,c->var_default,
-							  sizeof(var_default_type)*c->num_var_defaults);
-			if (c->num_vars != 0)
-				FreeMemory(MALLOC_ID_CLASS,c->vars,sizeof(var_default_type)*c->num_vars);
+			FreeClassData(c);
 			
 			if (c->class_name != NULL)
 				FreeMemory(MALLOC_ID_KODBASE,c->class_name,strlen(c->class_name)+1);
 
-			prop = c->property_names_this;
-			while (prop != NULL)
-			{
-				temp_prop = prop->next;
-				FreeMemory(MALLOC_ID_KODBASE,prop->name,strlen(prop->name)+1);
-				FreeMemory(MALLOC_ID_KODBASE,prop,sizeof(property_name_node));
-				prop = temp_prop;
-			}
-
-			FreeSIHash(c->property_names);
-			
-			cv = c->classvar_names;
-			while (cv != NULL)
-			{
-				temp_cv = cv->next;
-				FreeMemory(MALLOC_ID_KODBASE,cv->name,strlen(cv->name)+1);
-				FreeMemory(MALLOC_ID_KODBASE,cv,sizeof(classvar_name_node));
-				cv = temp_cv;
-			}
-			
 			FreeMemory(MALLOC_ID_CLASS,c,sizeof(class_node));
 			c = temp;
 		}
 		classes[i] = NULL;
 	}
+	classes_in_order.clear();
+	classes_by_id.clear();
 
 	FreeSIHash(class_name_map);
 	class_name_map = CreateSIHash(ConfigInt(MEMORY_SIZE_CLASS_NAME_HASH));
 }
 
+/* FreeClassData
+*
+* Free what a class got from its .bof and the kodbase, other than its
+* messages and its name.
+*/
+void FreeClassData(class_node *c)
+{
+	classvar_name_node *cv,*temp_cv;
+	property_name_node *prop,*temp_prop;
+
+	if (c->num_prop_defaults != 0)
+		FreeMemory(MALLOC_ID_CLASS,c->prop_default,
+					  sizeof(prop_default_type)*c->num_prop_defaults);
+	c->prop_default = NULL;
+	c->num_prop_defaults = 0;
+
+	if (c->num_var_defaults != 0)
+		FreeMemory(MALLOC_ID_CLASS,c->var_default,
+					  sizeof(var_default_type)*c->num_var_defaults);
+	c->var_default = NULL;
+	c->num_var_defaults = 0;
+
+	if (c->vars != NULL)
+		FreeMemory(MALLOC_ID_CLASS,c->vars,sizeof(var_default_type)*c->num_vars);
+	c->vars = NULL;
+
+	prop = c->property_names_this;
+	while (prop != NULL)
+	{
+		temp_prop = prop->next;
+		FreeMemory(MALLOC_ID_KODBASE,prop->name,strlen(prop->name)+1);
+		FreeMemory(MALLOC_ID_KODBASE,prop,sizeof(property_name_node));
+		prop = temp_prop;
+	}
+	c->property_names_this = NULL;
+
+	if (c->property_names != NULL)
+		FreeSIHash(c->property_names);
+	c->property_names = NULL;
+	
+	cv = c->classvar_names;
+	while (cv != NULL)
+	{
+		temp_cv = cv->next;
+		FreeMemory(MALLOC_ID_KODBASE,cv->name,strlen(cv->name)+1);
+		FreeMemory(MALLOC_ID_KODBASE,cv,sizeof(classvar_name_node));
+		cv = temp_cv;
+	}
+	c->classvar_names = NULL;
+}
+
 /* AddClass
 *
-* This adds a new class to the class hash table.
+* This adds a new class to the class hash table.  If the class is already
+* there (its .bof is being reloaded), its class_node is reused, so that
+* objects and other classes pointing to it stay valid.  Its old defaults
+* and property names are dropped; the kodbase gives it new names.
 */
 void AddClass(int id,bof_class_header *class_data,char *fname,char *bof_base,
 			  bof_dstring *dstrs,bof_line_table *line_table,bof_class_props *props)
@@ -114,15 +156,31 @@ void AddClass(int id,bof_class_header *class_data,char *fname,char *bof_base,
 	class_node *new_node;
 	bof_list_elem *classvar_values, *prop_values;
 
-	new_node = (class_node *)AllocateMemory(MALLOC_ID_CLASS,sizeof(class_node));
-	memset(new_node, 0, sizeof(class_node));
+	new_node = GetClassByID(id);
+	if (new_node != NULL)
+		FreeClassData(new_node);
+	else
+	{
+		new_node = (class_node *)AllocateMemory(MALLOC_ID_CLASS,sizeof(class_node));
+		memset(new_node, 0, sizeof(class_node));
 	
-	new_node->class_id = id;
+		new_node->class_id = id;
+		new_node->messages = NULL;
+		new_node->num_messages = 0;
+		new_node->class_name = NULL;
+		new_node->first_instance = INVALID_OBJECT;
+		new_node->last_instance = INVALID_OBJECT;
+		new_node->prop_slab = NULL;
+
+		/* add to class table */
+		hash_num = GetClassHashNum(new_node->class_id);
+		new_node->next = classes[hash_num];
+		classes[hash_num] = new_node;
+	}
+
 	new_node->super_id = class_data->superclass;
 	new_node->num_properties = props->num_properties;
 	new_node->num_prop_defaults = props->num_default_prop_vals;
-	new_node->messages = NULL;
-	new_node->num_messages = 0;
 	if (new_node->num_prop_defaults != 0)
 	{
 		new_node->prop_default = (prop_default_type *)
@@ -138,7 +196,6 @@ void AddClass(int id,bof_class_header *class_data,char *fname,char *bof_base,
 		new_node->prop_default[i].val.int_val = val32to64(prop_values[i].offset);
 	}
 	new_node->fname = fname;
-	new_node->class_name = NULL;
 	new_node->property_names = NULL;
 	new_node->property_names_this = NULL;
 	new_node->classvar_names = NULL;
@@ -169,11 +226,6 @@ void AddClass(int id,bof_class_header *class_data,char *fname,char *bof_base,
 	}
 	
 	new_node->vars = NULL;
-	
-	/* add to class table */
-	hash_num = GetClassHashNum(new_node->class_id);
-	new_node->next = classes[hash_num];
-	classes[hash_num] = new_node;
 }
 
 void SetClassName(int id,char *name)
@@ -228,6 +280,67 @@ void SetClassesSuperPtr(void)
 			eprintf("Fatal: Class hash bin %3i has length %i; Increase SizeClassHash in [Memory] in blakserv.cfg\n",i,length);
 
 	}
+
+	NumberClasses();
+}
+
+/* NumberClasses
+*
+* Number the class tree in preorder, subclasses in order of id.  A class
+* whose superclass can't be found is numbered as a root.  Classes in a
+* loop of superclasses can't be numbered, and are left at -1, which is in
+* no class's range.  Also fills in classes_by_id.
+*/
+static void NumberClasses(void)
+{
+	std::vector<class_node *> all;
+	std::unordered_map<class_node *,std::vector<class_node *>> subclasses;
+	class_node *c;
+	size_t i;
+
+	for (i=0;i<(size_t) classes_table_size;i++)
+		for (c = classes[i]; c != NULL; c = c->next)
+		{
+			c->class_enter = -1;
+			c->class_exit = -1;
+			all.push_back(c);
+		}
+
+	std::sort(all.begin(),all.end(),
+		[](class_node *a,class_node *b) { return a->class_id < b->class_id; });
+
+	classes_by_id.assign(all.empty() || all.back()->class_id < 0 ? 0 :
+						 all.back()->class_id + 1,NULL);
+	for (i=0;i<all.size();i++)
+		if (all[i]->class_id >= 0)
+			classes_by_id[all[i]->class_id] = all[i];
+
+	for (i=0;i<all.size();i++)
+		if (all[i]->super_ptr != NULL)
+			subclasses[all[i]->super_ptr].push_back(all[i]);
+
+	classes_in_order.clear();
+	classes_in_order.reserve(all.size());
+	for (i=0;i<all.size();i++)
+		if (all[i]->super_ptr == NULL)
+			NumberClass(all[i],subclasses);
+}
+
+static void NumberClass(class_node *c,
+						std::unordered_map<class_node *,std::vector<class_node *>> &subclasses)
+{
+	std::unordered_map<class_node *,std::vector<class_node *>>::iterator it;
+	size_t i;
+
+	c->class_enter = (int) classes_in_order.size();
+	classes_in_order.push_back(c);
+
+	it = subclasses.find(c);
+	if (it != subclasses.end())
+		for (i=0;i<it->second.size();i++)
+			NumberClass(it->second[i],subclasses);
+
+	c->class_exit = (int) classes_in_order.size();
 }
 
 void SetClassVariables(void)
@@ -240,6 +353,11 @@ void SetClassVariables(void)
 		c = classes[i];
 		while (c != NULL)
 		{
+			/* classes not reloaded by ReloadBof still have theirs */
+			if (c->vars != NULL)
+				FreeMemory(MALLOC_ID_CLASS,c->vars,sizeof(var_default_type)*c->num_vars);
+			c->vars = NULL;
+
 			if (c->num_vars > 0)
 			{
 				/* dprintf("allocating %i, %i\n",sizeof(var_default_type),c->num_vars); */
@@ -307,6 +425,9 @@ void SetClassPropertyNames()
 		c = classes[i];
 		while (c != NULL)
 		{
+			/* names include those of superclasses, which may have been reloaded */
+			if (c->property_names != NULL)
+				FreeSIHash(c->property_names);
 			c->property_names = CreateSIHash(ConfigInt(MEMORY_SIZE_PROPERTIES_NAME_HASH));
 			SetOneClassPropertyNames(c);
 			c = c->next;
@@ -337,6 +458,11 @@ void SetOneClassPropertyNames(class_node *c)
 class_node * GetClassByID(int class_id)
 {
 	class_node *c;
+
+	/* classes added since NumberClasses last ran are only in the hash */
+	if (class_id >= 0 && class_id < (int) classes_by_id.size() &&
+		 classes_by_id[class_id] != NULL)
+		return classes_by_id[class_id];
 	
 	c = classes[GetClassHashNum(class_id)];
 	while (c != NULL)
@@ -349,6 +475,14 @@ class_node * GetClassByID(int class_id)
 	return NULL;
 }
 
+/* the class numbered order by SetClassesSuperPtr */
+class_node * GetClassByOrder(int order)
+{
+	if (order < 0 || order >= (int) classes_in_order.size())
+		return NULL;
+	return classes_in_order[order];
+}
+
 class_node * GetClassByName(const char *class_name)
 {
 	int class_id;
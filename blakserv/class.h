@@ -55,6 +55,21 @@ typedef struct class_struct
 
    struct class_struct *super_ptr;
 
+   /* SetClassesSuperPtr numbers the class tree in preorder, so that this
+      class and its subclasses are numbered class_enter up to but not
+      including class_exit */
+   int class_enter;
+   int class_exit;
+
+   /* the objects of just this class, in order of id, linked through their
+      next_instance (see object.c) */
+   int first_instance;
+   int last_instance;
+
+   /* where the property values of this class's objects come from (see
+      object.c) */
+   struct prop_slab_struct *prop_slab;
+
    struct class_struct *next; /* for open hash table linked list */
 } class_node;
 
@@ -79,12 +94,41 @@ void AddClassPropertyName(class_node *c,char *property_name,int property_id);
 void SetClassPropertyNames();
 class_node * GetClassByName(const char *class_name);
 class_node * GetClassByID(int class_id);
+class_node * GetClassByOrder(int order);
 const char * GetPropertyNameByID(class_node *c,int property_id);
 int GetPropertyIDByName(class_node *c,const char *property_name);
 char *GetClassVarNameByID(class_node *c,int classvar_id);
 int GetClassVarIDByName(class_node *c,const char *classvar_name);
 
 void ForEachClass(void (*callback_func)(class_node *c));
+
+/* whether class c is class ancestor or inherits from it, from the numbers
+   SetClassesSuperPtr gave them */
+static __inline bool IsClassInTree(class_node *c,class_node *ancestor)
+{
+   return c == ancestor ||
+      (c->class_enter > ancestor->class_enter && c->class_enter < ancestor->class_exit);
+}
+
+/* each class by id, filled in by SetClassesSuperPtr */
+extern std::vector<class_node *> classes_by_id;
+
+/* whether class c is class_id or inherits from it, without the hash walk
+   of GetClassByID */
+static __inline bool IsClassOrSubclass(class_node *c,int class_id)
+{
+   class_node *ancestor;
+
+   if (c == NULL)
+      return false;
+   if (c->class_id == class_id)
+      return true;
+   if (class_id < 0 || class_id >= (int) classes_by_id.size())
+      return false;
+
+   ancestor = classes_by_id[class_id];
+   return ancestor != NULL && IsClassInTree(c,ancestor);
+}
 const char * GetClassDebugStr(class_node *c,int dstr_id);
 int GetSourceLine(class_node *c,char *bkod_ptr);
 
@@ -69,6 +69,9 @@ config_table_type config_table[] =
 { SOCKET_DNS_LOOKUP,      true, "DNSLookup",     CONFIG_BOOL,  "No" },
 { SOCKET_NAGLE,           false, "Nagle",         CONFIG_BOOL,  "Yes" },
 { SOCKET_BLOCK_TIME,      true, "BlockTime",     CONFIG_INT,   "300" }, /* seconds */
+{ SOCKET_CONNECT_BURST,   true, "ConnectBurst",  CONFIG_INT,   "10" },
+{ SOCKET_CONNECT_PER_MINUTE,true, "ConnectPerMinute",CONFIG_INT,"20" },
+{ SOCKET_GLOBAL_CONNECT_PER_SECOND,true, "GlobalConnectPerSecond",CONFIG_INT,"100" },
 
 { CHANNEL_GROUP,          false, "[Channel]",     CONFIG_GROUP, "" },
 { CHANNEL_DEBUG_DISK,     false, "DebugDisk",     CONFIG_BOOL,  "No" },
@@ -127,6 +130,7 @@ config_table_type config_table[] =
 { MEMORY_SIZE_RESOURCE_HASH, false, "SizeResourceHash", CONFIG_INT,"99971" },
 { MEMORY_SIZE_RESOURCE_NAME_HASH, false, "SizeResourceNameHash", CONFIG_INT,"99971" },
 { MEMORY_SIZE_PROPERTIES_NAME_HASH, false, "SizePropertiesNameHash", CONFIG_INT,   "499" },
+{ MEMORY_INTERN_STRINGS,  true, "InternStrings", CONFIG_BOOL,  "Yes" },
 
 { AUTO_GROUP,             false, "[Auto]",        CONFIG_GROUP, "" },
 { AUTO_GARBAGE_TIME,      false, "GarbageTime",   CONFIG_INT,   "90", }, /* minutes */
@@ -189,6 +193,7 @@ config_table_type config_table[] =
 { DEBUG_INITPROPERTIES,   true, "InitProperties",CONFIG_BOOL,  "No" },
 { DEBUG_INITLOCALS,       true, "InitLocals",    CONFIG_BOOL,  "No" },
 { DEBUG_UNINITIALIZED,    true, "Uninitialized", CONFIG_BOOL,  "No" },
+{ DEBUG_STALL,            true, "StallMilliseconds",CONFIG_INT, "500" },
 
 { SECURITY_GROUP,         false, "[Security]",    CONFIG_GROUP, "" },
 { SECURITY_LOG_SPOOFS,    true, "LogSpoofs",     CONFIG_BOOL,  "Yes" },
@@ -206,6 +211,7 @@ config_table_type config_table[] =
 
 { BLAKOD_GROUP,           false, "[Blakod]",      CONFIG_GROUP, "" },
 { BLAKOD_MAX_STATEMENTS,  true, "MaxStatements", CONFIG_INT,   "20000000" },
+{ BLAKOD_PROFILE_INTERVAL, true, "ProfileSampleInterval", CONFIG_INT, "1000" },
 
 { WEBHOOK_GROUP,          false, "[Webhook]",     CONFIG_GROUP, "" },
 { WEBHOOK_ENABLED,        false, "Enabled",       CONFIG_BOOL,  "No" },
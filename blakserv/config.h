@@ -24,6 +24,7 @@ enum
    SOCKET_GROUP,
    SOCKET_PORT, SOCKET_MAINTENANCE_PORT, SOCKET_MAINTENANCE_MASK,
    SOCKET_DNS_LOOKUP, SOCKET_NAGLE, SOCKET_BLOCK_TIME,
+   SOCKET_CONNECT_BURST, SOCKET_CONNECT_PER_MINUTE, SOCKET_GLOBAL_CONNECT_PER_SECOND,
 
    CHANNEL_GROUP,
    CHANNEL_DEBUG_DISK, CHANNEL_ERROR_DISK, CHANNEL_LOG_DISK,
@@ -60,6 +61,7 @@ enum
    MEMORY_SIZE_RESOURCE_HASH,
    MEMORY_SIZE_RESOURCE_NAME_HASH,
    MEMORY_SIZE_PROPERTIES_NAME_HASH,
+   MEMORY_INTERN_STRINGS,
 
    AUTO_GROUP,
    AUTO_GARBAGE_TIME, AUTO_GARBAGE_PERIOD, AUTO_SAVE_TIME, AUTO_SAVE_PERIOD,
@@ -92,7 +94,7 @@ enum
    DEBUG_GROUP,
    DEBUG_SMTP, DEBUG_CANMOVEINROOM, DEBUG_HEAP, DEBUG_TRANSMITTED_BYTES,
    DEBUG_HASH, DEBUG_INITPROPERTIES, DEBUG_INITLOCALS,
-   DEBUG_UNINITIALIZED,
+   DEBUG_UNINITIALIZED, DEBUG_STALL,
 
    SECURITY_GROUP,
    SECURITY_LOG_SPOOFS, SECURITY_HANGUP_SPOOFS, SECURITY_REDBOOK_RSC,
@@ -102,7 +104,7 @@ enum
    SERVICE_MACHINE, SERVICE_DIRECTORY, SERVICE_USERNAME, SERVICE_PASSWORD,
 
    BLAKOD_GROUP,
-   BLAKOD_MAX_STATEMENTS,
+   BLAKOD_MAX_STATEMENTS, BLAKOD_PROFILE_INTERVAL,
 
    WEBHOOK_GROUP,
    WEBHOOK_ENABLED, WEBHOOK_PREFIX,
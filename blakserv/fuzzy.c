@@ -0,0 +1,179 @@
+// Meridian 59, Copyright 1994-2012 Andrew Kirmse and Chris Kirmse.
+// All rights reserved.
+//
+// This software is distributed under a license that is described in
+// the LICENSE file that accompanies it.
+//
+// Meridian is a registered trademark.
+/*
+ * fuzzy.c
+ *
+
+ This module does the "fuzzy" string comparisons used by the Blakod
+ string builtins and table hashing: leading and trailing whitespace is
+ ignored, and letters compare without regard to case.
+
+ All of the work is done in place on the caller's buffers; nothing is
+ copied or uppercased into scratch space first.  Case folding is plain
+ ASCII, which is what toupper() does in the "C" locale the server runs in.
+ Where SSE2 is available the search for candidate match positions is done
+ 16 bytes at a time.
+
+ */
+
+#include <string.h>
+
+#include "fuzzy.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define iswhite(c) ((c)==' ' || (c)=='\t' || (c)=='\n' || (c)=='\r')
+
+static inline char FuzzyFoldChar(char c)
+{
+   return (c >= 'a' && c <= 'z') ? (char) (c - ('a' - 'A')) : c;
+}
+
+static bool FuzzyMatchAt(const char *s,const char *needle,int len_needle)
+{
+   int i;
+
+   for (i=0;i<len_needle;i++)
+      if (FuzzyFoldChar(s[i]) != FuzzyFoldChar(needle[i]))
+         return false;
+
+   return true;
+}
+
+void FuzzyTrimBuffer(const char **s,int *len)
+{
+   const char *p;
+   const char *nul;
+   int n;
+
+   p = *s;
+   n = *len;
+   if (p == NULL || n <= 0)
+   {
+      *len = 0;
+      return;
+   }
+
+   // skip over leading and trailing whitespace
+   while (n && iswhite(*p)) { p++; n--; }
+   while (n && iswhite(p[n-1])) { n--; }
+
+   // anything after an embedded zero was never seen by the old C string code
+   nul = (const char *) memchr(p,'\0',n);
+   if (nul != NULL)
+      n = (int) (nul - p);
+
+   *s = p;
+   *len = n;
+}
+
+const char * FuzzyFindBuffer(const char *haystack,int len_haystack,
+                             const char *needle,int len_needle)
+{
+   const char *p,*last;
+   char first;
+
+   if (!haystack || !needle || len_needle <= 0 || len_haystack < len_needle)
+      return NULL;
+
+   first = FuzzyFoldChar(needle[0]);
+   p = haystack;
+   last = haystack + len_haystack - len_needle;
+
+#if defined(__SSE2__)
+   {
+      const __m128i first_vec = _mm_set1_epi8(first);
+      const __m128i before_a = _mm_set1_epi8('a' - 1);
+      const __m128i after_z = _mm_set1_epi8('z' + 1);
+      const __m128i case_bit = _mm_set1_epi8('a' - 'A');
+
+      // each pass checks 16 starting positions, all of which are <= last
+      while (last - p >= 15)
+      {
+         __m128i chunk = _mm_loadu_si128((const __m128i *) p);
+         __m128i lower = _mm_and_si128(_mm_cmpgt_epi8(chunk,before_a),
+                                       _mm_cmpgt_epi8(after_z,chunk));
+         chunk = _mm_sub_epi8(chunk,_mm_and_si128(lower,case_bit));
+         unsigned int mask = (unsigned int)
+            _mm_movemask_epi8(_mm_cmpeq_epi8(chunk,first_vec));
+
+         while (mask)
+         {
+            int i = __builtin_ctz(mask);
+            if (FuzzyMatchAt(p + i,needle,len_needle))
+               return p + i;
+            mask &= mask - 1;
+         }
+         p += 16;
+      }
+   }
+#endif
+
+   for (;p<=last;p++)
+      if (FuzzyFoldChar(*p) == first && FuzzyMatchAt(p,needle,len_needle))
+         return p;
+
+   return NULL;
+}
+
+bool FuzzyBufferEqual(const char *s1,int len1,const char *s2,int len2)
+{
+   if (!s1 || !s2 || len1 <= 0 || len2 <= 0)
+      return false;
+
+   // skip over leading whitespace
+   while (len1 && iswhite(*s1)) { s1++; len1--; }
+   while (len2 && iswhite(*s2)) { s2++; len2--; }
+
+   // cut off trailing whitespace
+   while (len1 && iswhite(s1[len1-1])) { len1--; }
+   while (len2 && iswhite(s2[len2-1])) { len2--; }
+
+   // empty strings can't match anything
+   if (!len1 || !len2)
+      return false;
+
+   // interned strings with the same contents share their data
+   if (s1 == s2 && len1 == len2)
+      return true;
+
+   // walk the strings until we find a mismatch or an end
+   while (len1 && len2 && FuzzyFoldChar(*s1) == FuzzyFoldChar(*s2))
+   {
+      s1++;
+      s2++;
+      len1--;
+      len2--;
+   }
+
+   // we matched only if we finished both strings at the same time
+   return (len1 == 0 && len2 == 0);
+}
+
+/*
+"   orc teeth" contains "ORC"
+"orc teeth  " contains " teeth "
+*/
+
+// return true if s1 contains s2, ignoring case and surrounding whitespace
+bool FuzzyBufferContain(const char *s1,int len_s1,const char *s2,int len_s2)
+{
+   if (!s1 || !s2 || len_s1 <= 0 || len_s2 <= 0)
+      return false;
+
+   FuzzyTrimBuffer(&s1,&len_s1);
+   FuzzyTrimBuffer(&s2,&len_s2);
+
+   // an all-whitespace s2 is contained in anything
+   if (len_s2 == 0)
+      return true;
+
+   return FuzzyFindBuffer(s1,len_s1,s2,len_s2) != NULL;
+}
@@ -0,0 +1,28 @@
+// Meridian 59, Copyright 1994-2012 Andrew Kirmse and Chris Kirmse.
+// All rights reserved.
+//
+// This software is distributed under a license that is described in
+// the LICENSE file that accompanies it.
+//
+// Meridian is a registered trademark.
+/*
+ * fuzzy.h
+ *
+ */
+
+#ifndef _FUZZY_H
+#define _FUZZY_H
+
+/* Narrow [*s, *s + *len) to its fuzzy core: leading and trailing whitespace
+ * trimmed, and cut at the first embedded '\0' the way a C string would be. */
+void FuzzyTrimBuffer(const char **s,int *len);
+
+/* Case-insensitive search for needle in haystack, both given by length.
+ * Returns a pointer into haystack, or NULL if not found or needle is empty. */
+const char * FuzzyFindBuffer(const char *haystack,int len_haystack,
+                             const char *needle,int len_needle);
+
+bool FuzzyBufferEqual(const char *s1,int len1,const char *s2,int len2);
+bool FuzzyBufferContain(const char *s1,int len1,const char *s2,int len2);
+
+#endif
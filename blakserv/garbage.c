@@ -9,41 +9,65 @@
  * garbage.c
  *
 
- This module performs garbage collection on the list, object, string,
- and timer nodes.  The most complicated part is the list nodes,
+ This module performs garbage collection on the list, array, object,
+ string, and timer nodes.  The most complicated part is the list nodes,
  everything else isn't too complicated.  See the GarbageCollect()
  function below for a full description of how things work.
 
+ The list nodes' marks are kept here, in bitmaps beside the nodes rather
+ than in them, so that marking and renumbering only touch the nodes they
+ need to read.
+
  */
 
 #include "blakserv.h"
 
-#define SERVER_MERGE_BASE		(0)
+#include <bit>
 
-#define VISITED_LIST (1<<31)
+#define SERVER_MERGE_BASE		(0)
 
 #define UNREFERENCED -1
 #define REFERENCED -2
 
+/* one bit per list node: whether it is referenced, and whether its
+   references have been renumbered.  list_forward has the new id of the
+   first referenced node of each 64, so a node's new id is that plus the
+   number of referenced nodes before it in its 64. */
+static std::vector<UINT64> list_marks;
+static std::vector<UINT64> list_visited;
+static std::vector<int> list_forward;
+
 /* local function prototypes */
 
 void GarbageKickoffGamePick(session_node *s);
 void GarbageWarnAdminSession(session_node *s);
 
 /* list node garbage collection */
-void ClearListNodeGarbageRef(list_node *l,int list_id);
+void ClearListNodeMarks(void);
 void MarkObjectListNodes(object_node *o);
 void MarkListNode(int list_id);
-void RenumberListNode(list_node *l,int list_id);
+void RenumberListNodes(void);
 void RenumberObjectListNodeReferences(object_node *o);
 void RenumberListNodeReferences(val_type *vlist_ptr);
-void CompactListNode(list_node *l,int list_id);
+void CompactListNodes(void);
+
+/* array garbage collection */
+void ClearArrayGarbageRef(array_node *a,int array_id);
+void MarkArray(int array_id);
+void RenumberArrayListNodeReferences(array_node *a,int array_id);
+void RenumberArray(array_node *a,int array_id);
+void RenumberObjectArrayReferences(object_node *o);
+void RenumberListNodeArrayReferences(list_node *l,int list_id);
+void RenumberArrayArrayReferences(array_node *a,int array_id);
+void ResetArrayReference(val_type *varray_ptr);
+void CompactArray(array_node *a,int array_id);
 
 /* object garbage collection */
 void ClearObjectGarbageRef(object_node *o);
 void MarkUserObjectNodes(user_node *u);
 void MarkObject(int object_id);
 void MarkListNodeObject(int list_id);
+void MarkArrayObject(int array_id);
 void DeleteUnreferencedObject(object_node *o);
 
 void RenumberObject(object_node *o);
@@ -51,7 +75,9 @@ void RenumberObjectReferences(object_node *o);
 void RenumberUserObjectReferences(user_node *u);
 void RenumberSessionObjectReferences(session_node *s);
 void RenumberTimerObjectReferences(timer_node *t);
+void RenumberRoomDataObjectReferences(roomdata_node *r);
 void RenumberListNodeObjectReferences(list_node *l,int list_id);
+void RenumberArrayObjectReferences(array_node *a,int array_id);
 bool ResetObjectReference(val_type *vobject_ptr);
 void CompactObject(object_node *o);
 
@@ -59,6 +85,7 @@ void CompactObject(object_node *o);
 void RenumberTimer(timer_node *t);
 void RenumberObjectTimerReferences(object_node *o);
 void RenumberListNodeTimerReferences(list_node *l,int list_id);
+void RenumberArrayTimerReferences(array_node *a,int array_id);
 void ResetTimerReference(val_type *vtimer_ptr);
 void CompactTimer(timer_node *t);
 
@@ -66,10 +93,12 @@ void CompactTimer(timer_node *t);
 void ClearStringGarbageRef(string_node *snod,int string_id);
 void MarkObjectStrings(object_node *o);
 void MarkListNodeStrings(list_node *l,int list_id);
+void MarkArrayStrings(array_node *a,int array_id);
 void MarkString(int string_id);
 void RenumberString(string_node *snod,int string_id);
 void RenumberObjectStringReferences(object_node *o);
 void RenumberListNodeStringReferences(list_node *l,int list_id);
+void RenumberArrayStringReferences(array_node *a,int array_id);
 void ResetStringReference(val_type *vlist_ptr);
 void CompactString(string_node *snod,int string_id);
 
@@ -78,6 +107,10 @@ int next_renumber;
 
 void GarbageCollect()
 {
+   UINT64 start_time;
+
+   start_time = GetMicroCount();
+
    /* anyone in game mode w/o a user can have stale data, so knock 'em out */
    ForEachSession(GarbageKickoffGamePick);
 
@@ -94,7 +127,7 @@ void GarbageCollect()
 
    ResetTable(); /* tables are not GC'ed yet, so we gotta clear 'em. */
 
-   /* first, garbage collect the list nodes */
+   /* first, garbage collect the list nodes and arrays */
 
    /* 
     * This is complicated, because there can be multiple references
@@ -104,24 +137,39 @@ void GarbageCollect()
     *
     * first, mark all list nodes unreferenced.
     *  then, mark used list nodes referenced.
-    *  then, go through each list node in increasing numerical order and
-    *        set the garbage_ref to what its new list node id will be.
+    *  then, go through the marks in increasing numerical order and
+    *        work out what the new list node ids will be.
     *  then, go through each object & list node and change its
     *        list id to that list node's new list id.
-    *  then, go through each list node in increasing numerical order and
-    *        move it to its new list id spot.
+    *  then, go through each referenced list node in increasing numerical
+    *        order and move it to its new list id spot.
+    *
+    * Lists and arrays can hold each other, so the arrays are marked along
+    * with the list nodes, and the list ids in referenced arrays are changed
+    * too.  Then the arrays are renumbered and compacted like strings.
     */
 
-   ForEachListNode(ClearListNodeGarbageRef);
+   ClearListNodeMarks();
+   ForEachArray(ClearArrayGarbageRef);
    ForEachObject(MarkObjectListNodes);
    
    next_renumber = SERVER_MERGE_BASE;
    
-   ForEachListNode(RenumberListNode);
+   RenumberListNodes();
    ForEachObject(RenumberObjectListNodeReferences);
-   ForEachListNode(CompactListNode);
+   ForEachArray(RenumberArrayListNodeReferences);
+   CompactListNodes();
 
    SetNumListNodes(next_renumber);
+
+   next_renumber = SERVER_MERGE_BASE;
+
+   ForEachArray(RenumberArray);
+   ForEachObject(RenumberObjectArrayReferences);
+   ForEachListNode(RenumberListNodeArrayReferences);
+   ForEachArray(RenumberArrayArrayReferences);
+   ForEachArray(CompactArray);
+   SetNumArrays(next_renumber);
    
    /* now garbage collect the object nodes */
 
@@ -135,13 +183,14 @@ void GarbageCollect()
     *  then, delete the unreferenced ones.
     *  then, go through each object in increasing numerical order and
     *        set the garbage_ref to what its new object id will be.
-    *  then, go through each object, list node, user, session, and timer,
-    *        and change its object id to that object's new object id.
+    *  then, go through each object, list node, array, user, session, timer
+    *        and room, and change its object id to that object's new object id.
     *  then, go through each object in increasing numerical order and
     *        move it to its new object id spot.
     */
 
    ForEachObject(ClearObjectGarbageRef);
+   ForEachArray(ClearArrayGarbageRef);
    ForEachUser(MarkUserObjectNodes);
    MarkObject(GetSystemObjectID());
    ForEachObject(DeleteUnreferencedObject);
@@ -151,9 +200,12 @@ void GarbageCollect()
    ForEachObject(RenumberObject);
    ForEachObject(RenumberObjectReferences);
    ForEachListNode(RenumberListNodeObjectReferences);
+   ForEachArray(RenumberArrayObjectReferences);
    ForEachUser(RenumberUserObjectReferences);
+   ReindexUserObjectIDs();
    ForEachSession(RenumberSessionObjectReferences);
    ForEachTimer(RenumberTimerObjectReferences);
+   ForEachRoomData(RenumberRoomDataObjectReferences);
    ForEachObject(CompactObject);
    SetNumObjects(next_renumber);
 
@@ -166,6 +218,7 @@ void GarbageCollect()
    ForEachTimer(RenumberTimer);
    ForEachObject(RenumberObjectTimerReferences);
    ForEachListNode(RenumberListNodeTimerReferences);
+   ForEachArray(RenumberArrayTimerReferences);
    ForEachTimer(CompactTimer);
    SetNumTimers(next_renumber);
 
@@ -174,14 +227,18 @@ void GarbageCollect()
    ForEachString(ClearStringGarbageRef);
    ForEachObject(MarkObjectStrings);
    ForEachListNode(MarkListNodeStrings);
+   ForEachArray(MarkArrayStrings);
 
    next_renumber = SERVER_MERGE_BASE;
 
    ForEachString(RenumberString);
    ForEachObject(RenumberObjectStringReferences);
    ForEachListNode(RenumberListNodeStringReferences);
+   ForEachArray(RenumberArrayStringReferences);
    ForEachString(CompactString);
    SetNumStrings(next_renumber);
+
+   MetricsGarbageCollectDone(GetMicroCount() - start_time);
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -208,9 +265,33 @@ void GarbageWarnAdminSession(session_node *s)
 
 /////////////////////////////////////////////////////////////////////////////
 
-void ClearListNodeGarbageRef(list_node *l,int list_id)
+void ClearListNodeMarks(void)
+{
+   size_t words;
+
+   words = (GetListNodesUsed() + 63)/64;
+   list_marks.assign(words,0);
+   list_visited.assign(words,0);
+   list_forward.resize(words);
+}
+
+static __inline bool IsListNodeMarked(const std::vector<UINT64> &bits,int list_id)
 {
-   l->garbage_ref = UNREFERENCED;
+   return (bits[list_id >> 6] >> (list_id & 63)) & 1;
+}
+
+static __inline void SetListNodeMark(std::vector<UINT64> &bits,int list_id)
+{
+   bits[list_id >> 6] |= (UINT64) 1 << (list_id & 63);
+}
+
+/* the new id of referenced list node list_id, once RenumberListNodes has run */
+static __inline int GetNewListNodeID(int list_id)
+{
+   UINT64 before;
+
+   before = list_marks[list_id >> 6] & (((UINT64) 1 << (list_id & 63)) - 1);
+   return list_forward[list_id >> 6] + std::popcount(before);
 }
 
 void MarkObjectListNodes(object_node *o)
@@ -223,6 +304,8 @@ void MarkObjectListNodes(object_node *o)
       {
 	 MarkListNode(o->p[i].val.v.data);
       }
+      if (o->p[i].val.v.tag == TAG_ARRAY)
+	 MarkArray(o->p[i].val.v.data);
    }
 }
 
@@ -239,10 +322,17 @@ void MarkListNode(int list_id)
 	 return;
       }
       
-      l->garbage_ref = REFERENCED;
+      /* everything after it is marked already, or is being */
+      if (IsListNodeMarked(list_marks,list_id))
+	 return;
+      SetListNodeMark(list_marks,list_id);
       
       if (l->first.v.tag == TAG_LIST)
 	 MarkListNode(l->first.v.data);
+      if (l->first.v.tag == TAG_ARRAY)
+	 MarkArray(l->first.v.data);
+      if (l->rest.v.tag == TAG_ARRAY)
+	 MarkArray(l->rest.v.data);
 
       if (l->rest.v.tag != TAG_LIST)
 	 break;
@@ -251,11 +341,14 @@ void MarkListNode(int list_id)
    }
 }
 
-void RenumberListNode(list_node *l,int list_id)
+void RenumberListNodes(void)
 {
-   if (l->garbage_ref == REFERENCED)
+   size_t i;
+
+   for (i=0;i<list_marks.size();i++)
    {
-      l->garbage_ref = next_renumber++;
+      list_forward[i] = next_renumber;
+      next_renumber += std::popcount(list_marks[i]);
    }
 }
 
@@ -275,32 +368,34 @@ void RenumberObjectListNodeReferences(object_node *o)
 void RenumberListNodeReferences(val_type *vlist_ptr)
 {
    list_node *l;
+   int list_id;
    
   begin:
-   l = GetListNodeByID(vlist_ptr->v.data);
+   list_id = (int) vlist_ptr->v.data;
+   l = GetListNodeByID(list_id);
    if (l == NULL)
    {
       eprintf("RenumberListNodeReferences death by garbage collection\n");
       return;
    }
    
-   if (l->garbage_ref == REFERENCED || l->garbage_ref == UNREFERENCED)
+   if (!IsListNodeMarked(list_marks,list_id))
    {
       eprintf("RenumberListNodeReferences unrenumbered list node %" PRId64 "\n",
 	      vlist_ptr->v.data);
       return;
    }
    
-   /* this VISITED_LIST bit is around because suppose there are two lists
+   /* this visited bit is around because suppose there are two lists
     * each containing a third list.  The first reference to list 3 will
     * move its first and rest things, but the second should not.
     */
    
-   vlist_ptr->v.data = l->garbage_ref & ~VISITED_LIST; /* has the new list node id */
+   vlist_ptr->v.data = GetNewListNodeID(list_id);
    
-   if (!(l->garbage_ref & VISITED_LIST))
+   if (!IsListNodeMarked(list_visited,list_id))
    {
-      l->garbage_ref = l->garbage_ref | VISITED_LIST;
+      SetListNodeMark(list_visited,list_id);
       
       if (l->first.v.tag == TAG_LIST)
 	 RenumberListNodeReferences(&(l->first));
@@ -313,10 +408,133 @@ void RenumberListNodeReferences(val_type *vlist_ptr)
 
 }
 
-void CompactListNode(list_node *l,int list_id)
+void CompactListNodes(void)
+{
+   size_t i;
+   UINT64 bits;
+   int list_id;
+
+   for (i=0;i<list_marks.size();i++)
+   {
+      for (bits = list_marks[i]; bits != 0; bits &= bits - 1)
+      {
+	 list_id = (int) (i*64) + std::countr_zero(bits);
+	 MoveListNode(GetNewListNodeID(list_id),list_id);
+      }
+   }
+}
+
+void ClearArrayGarbageRef(array_node *a,int array_id)
 {
-   if (l->garbage_ref != UNREFERENCED)
-      MoveListNode(l->garbage_ref & ~VISITED_LIST,list_id);
+   a->garbage_ref = UNREFERENCED;
+}
+
+void MarkArray(int array_id)
+{
+   array_node *a;
+   int i;
+
+   a = GetArrayByID(array_id);
+   if (a == NULL)
+   {
+      eprintf("MarkArray death by garbage collection\n");
+      return;
+   }
+
+   if (a->garbage_ref == REFERENCED)
+      return;
+   a->garbage_ref = REFERENCED;
+
+   for (i=0;i<a->length;i++)
+   {
+      if (a->elems[i].v.tag == TAG_LIST)
+	 MarkListNode(a->elems[i].v.data);
+      if (a->elems[i].v.tag == TAG_ARRAY)
+	 MarkArray(a->elems[i].v.data);
+   }
+}
+
+void RenumberArrayListNodeReferences(array_node *a,int array_id)
+{
+   int i;
+
+   if (a->garbage_ref != REFERENCED)
+      return;
+
+   for (i=0;i<a->length;i++)
+   {
+      if (a->elems[i].v.tag == TAG_LIST)
+	 RenumberListNodeReferences(&(a->elems[i]));
+   }
+}
+
+void RenumberArray(array_node *a,int array_id)
+{
+   if (a->garbage_ref == REFERENCED)
+      a->garbage_ref = next_renumber++;
+}
+
+void RenumberObjectArrayReferences(object_node *o)
+{
+   int i;
+
+   for (i=0;i<o->num_props;i++)
+   {
+      if (o->p[i].val.v.tag == TAG_ARRAY)
+	 ResetArrayReference(&(o->p[i].val));
+   }
+}
+
+void RenumberListNodeArrayReferences(list_node *l,int list_id)
+{
+   if (l->first.v.tag == TAG_ARRAY)
+      ResetArrayReference(&(l->first));
+   if (l->rest.v.tag == TAG_ARRAY)
+      ResetArrayReference(&(l->rest));
+}
+
+void RenumberArrayArrayReferences(array_node *a,int array_id)
+{
+   int i;
+
+   /* unreferenced arrays are about to be freed */
+   if (a->garbage_ref == UNREFERENCED)
+      return;
+
+   for (i=0;i<a->length;i++)
+   {
+      if (a->elems[i].v.tag == TAG_ARRAY)
+	 ResetArrayReference(&(a->elems[i]));
+   }
+}
+
+void ResetArrayReference(val_type *varray_ptr)
+{
+   array_node *a;
+
+   a = GetArrayByID(varray_ptr->v.data);
+   if (a == NULL)
+   {
+      eprintf("ResetArrayReference death by garbage collection\n");
+      return;
+   }
+
+   if (a->garbage_ref == REFERENCED || a->garbage_ref == UNREFERENCED)
+   {
+      eprintf("ResetArrayReference unrenumbered array %" PRId64 "\n",
+              varray_ptr->v.data);
+      return;
+   }
+
+   varray_ptr->v.data = a->garbage_ref; /* has the new array id */
+}
+
+void CompactArray(array_node *a,int array_id)
+{
+   if (a->garbage_ref == UNREFERENCED)
+      FreeArray(array_id);
+   else
+      MoveArrayNode(a->garbage_ref,array_id);
 }
 
 void ClearObjectGarbageRef(object_node *o)
@@ -353,6 +571,8 @@ void MarkObject(int object_id)
 	 MarkObject(o->p[i].val.v.data);
       if (o->p[i].val.v.tag == TAG_LIST)
 	 MarkListNodeObject(o->p[i].val.v.data);
+      if (o->p[i].val.v.tag == TAG_ARRAY)
+	 MarkArrayObject(o->p[i].val.v.data);
    }
 }
 
@@ -374,6 +594,11 @@ void MarkListNodeObject(int list_id)
       if (l->rest.v.tag == TAG_OBJECT)
 	 MarkObject(l->rest.v.data);
       
+      if (l->first.v.tag == TAG_ARRAY)
+	 MarkArrayObject(l->first.v.data);
+      if (l->rest.v.tag == TAG_ARRAY)
+	 MarkArrayObject(l->rest.v.data);
+      
       if (l->first.v.tag == TAG_LIST)
 	 MarkListNodeObject(l->first.v.data);
       if (l->rest.v.tag != TAG_LIST)
@@ -382,6 +607,35 @@ void MarkListNodeObject(int list_id)
    }
 }
 
+/* garbage_ref is free to mark arrays seen here, as they have all been
+   renumbered already, so that an array holding itself doesn't loop */
+void MarkArrayObject(int array_id)
+{
+   array_node *a;
+   int i;
+
+   a = GetArrayByID(array_id);
+   if (a == NULL)
+   {
+      eprintf("MarkArrayObject death by garbage collection\n");
+      return;
+   }
+
+   if (a->garbage_ref == REFERENCED)
+      return;
+   a->garbage_ref = REFERENCED;
+
+   for (i=0;i<a->length;i++)
+   {
+      if (a->elems[i].v.tag == TAG_OBJECT)
+	 MarkObject(a->elems[i].v.data);
+      if (a->elems[i].v.tag == TAG_LIST)
+	 MarkListNodeObject(a->elems[i].v.data);
+      if (a->elems[i].v.tag == TAG_ARRAY)
+	 MarkArrayObject(a->elems[i].v.data);
+   }
+}
+
 void DeleteUnreferencedObject(object_node *o)
 {
    if (o->garbage_ref == UNREFERENCED)
@@ -428,6 +682,21 @@ void RenumberListNodeObjectReferences(list_node *l,int list_id)
    }
 }
 
+void RenumberArrayObjectReferences(array_node *a,int array_id)
+{
+   int i;
+
+   for (i=0;i<a->length;i++)
+   {
+      if (a->elems[i].v.tag == TAG_OBJECT)
+      {
+	 if (ResetObjectReference(&(a->elems[i])) == false)
+	    eprintf("RenumberArrayObjectReferences got object death in array %i\n",
+		    array_id);
+      }
+   }
+}
+
 void RenumberUserObjectReferences(user_node *u)
 {
    object_node *o;
@@ -475,6 +744,25 @@ void RenumberTimerObjectReferences(timer_node *t)
    t->object_id = o->garbage_ref; /* has the new object id */
 }
 
+void RenumberRoomDataObjectReferences(roomdata_node *r)
+{
+   object_node *o;
+   std::vector<std::pair<int,room_object_pos>> held;
+
+   /* object ids are what the spatial hash is keyed on, so rebuild it.
+      Anything deleted is dropped; the room would have removed it anyway. */
+
+   held.assign(r->object_pos.begin(),r->object_pos.end());
+   ClearRoomObjects(r);
+
+   for (auto &entry : held)
+   {
+      o = GetObjectByIDQuietly(entry.first);
+      if (o == NULL)
+	 continue;
+      RoomObjectMoved(r,o->garbage_ref,entry.second.row,entry.second.col);
+   }
+}
 
 bool ResetObjectReference(val_type *vobject_ptr)
 {
@@ -520,6 +808,17 @@ void RenumberListNodeTimerReferences(list_node *l,int list_id)
       ResetTimerReference(&(l->rest));
 }
 
+void RenumberArrayTimerReferences(array_node *a,int array_id)
+{
+   int i;
+
+   for (i=0;i<a->length;i++)
+   {
+      if (a->elems[i].v.tag == TAG_TIMER)
+	 ResetTimerReference(&(a->elems[i]));
+   }
+}
+
 void ResetTimerReference(val_type *vtimer_ptr)
 {
    timer_node *t;
@@ -565,6 +864,17 @@ void MarkListNodeStrings(list_node *l,int list_id)
       MarkString(l->rest.v.data);
 }
 
+void MarkArrayStrings(array_node *a,int array_id)
+{
+   int i;
+
+   for (i=0;i<a->length;i++)
+   {
+      if (a->elems[i].v.tag == TAG_STRING)
+	 MarkString(a->elems[i].v.data);
+   }
+}
+
 void MarkString(int string_id)
 {
    string_node *snod;
@@ -605,6 +915,17 @@ void RenumberListNodeStringReferences(list_node *l,int list_id)
       ResetStringReference(&(l->rest));
 }
 
+void RenumberArrayStringReferences(array_node *a,int array_id)
+{
+   int i;
+
+   for (i=0;i<a->length;i++)
+   {
+      if (a->elems[i].v.tag == TAG_STRING)
+	 ResetStringReference(&(a->elems[i]));
+   }
+}
+
 void ResetStringReference(val_type *vlist_ptr)
 {
    string_node *snod;
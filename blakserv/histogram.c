@@ -0,0 +1,124 @@
+// Meridian 59, Copyright 1994-2012 Andrew Kirmse and Chris Kirmse.
+// All rights reserved.
+//
+// This software is distributed under a license that is described in
+// the LICENSE file that accompanies it.
+//
+// Meridian is a registered trademark.
+/*
+ * histogram.c
+ *
+
+ This module keeps histograms of latencies, or any other non-negative
+ counts, in the log-linear layout of HdrHistogram: values are bucketed by
+ their highest set bit, and each of those ranges is split into
+ HISTOGRAM_SUB_BUCKETS equal parts.  Recording a value is a couple of
+ shifts and an increment, the memory used is fixed no matter how large
+ the values get, and percentiles come back within a fixed relative error.
+
+ */
+
+#include <string.h>
+
+#ifdef BLAK_PLATFORM_WINDOWS
+#include <windows.h>
+#include <intrin.h>
+#else
+#include "osd_linux.h"
+#endif
+
+#include "histogram.h"
+
+static int HighestBit(UINT64 value)
+{
+#ifdef BLAK_PLATFORM_WINDOWS
+   unsigned long index;
+
+   _BitScanReverse64(&index,value);
+   return (int) index;
+#else
+   return 63 - __builtin_clzll(value);
+#endif
+}
+
+int HistogramBucketIndex(UINT64 value)
+{
+   int shift;
+
+   if (value < 2*HISTOGRAM_SUB_BUCKETS)
+      return (int) value;
+
+   /* value is in [HISTOGRAM_SUB_BUCKETS,2*HISTOGRAM_SUB_BUCKETS) << shift */
+   shift = HighestBit(value) - HISTOGRAM_SUB_BITS;
+   return (shift + 1)*HISTOGRAM_SUB_BUCKETS + (int) (value >> shift) - HISTOGRAM_SUB_BUCKETS;
+}
+
+/* the largest value that goes in the given bucket */
+UINT64 HistogramBucketTop(int index)
+{
+   int shift;
+   UINT64 sub;
+
+   if (index < 2*HISTOGRAM_SUB_BUCKETS)
+      return (UINT64) index;
+
+   shift = index/HISTOGRAM_SUB_BUCKETS - 1;
+   sub = (UINT64) (index % HISTOGRAM_SUB_BUCKETS + HISTOGRAM_SUB_BUCKETS);
+
+   /* wraps to the largest UINT64 for the very last bucket */
+   return ((sub + 1) << shift) - 1;
+}
+
+void HistogramClear(histogram_type *h)
+{
+   memset(h,0,sizeof(*h));
+}
+
+void HistogramRecord(histogram_type *h,UINT64 value)
+{
+   h->buckets[HistogramBucketIndex(value)]++;
+   h->count++;
+   h->sum += value;
+   if (value > h->max)
+      h->max = value;
+}
+
+UINT64 HistogramPercentile(const histogram_type *h,double percent)
+{
+   UINT64 rank,seen,top;
+   int i;
+
+   if (h->count == 0)
+      return 0;
+
+   if (percent < 0.0)
+      percent = 0.0;
+   if (percent > 100.0)
+      percent = 100.0;
+
+   /* the rank-th smallest value, counting from 1 */
+   rank = (UINT64) (percent/100.0*h->count + 0.5);
+   if (rank < 1)
+      rank = 1;
+   if (rank > h->count)
+      rank = h->count;
+
+   seen = 0;
+   for (i=0;i<HISTOGRAM_BUCKETS;i++)
+   {
+      seen += h->buckets[i];
+      if (seen >= rank)
+      {
+         top = HistogramBucketTop(i);
+         return top < h->max ? top : h->max;
+      }
+   }
+   return h->max;
+}
+
+UINT64 HistogramMean(const histogram_type *h)
+{
+   if (h->count == 0)
+      return 0;
+   return h->sum/h->count;
+}
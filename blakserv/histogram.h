@@ -0,0 +1,46 @@
+// Meridian 59, Copyright 1994-2012 Andrew Kirmse and Chris Kirmse.
+// All rights reserved.
+//
+// This software is distributed under a license that is described in
+// the LICENSE file that accompanies it.
+//
+// Meridian is a registered trademark.
+/*
+ * histogram.h
+ *
+ */
+
+#ifndef _HISTOGRAM_H
+#define _HISTOGRAM_H
+
+/* Each power of two range of values is split into this many buckets, so a
+ * value read back from a histogram is within 1/16 (6.25%) of the truth. */
+#define HISTOGRAM_SUB_BITS 4
+#define HISTOGRAM_SUB_BUCKETS (1 << HISTOGRAM_SUB_BITS)
+
+/* values below 2*HISTOGRAM_SUB_BUCKETS each have their own bucket; above
+ * that, every bit position from 5 to 63 has HISTOGRAM_SUB_BUCKETS */
+#define HISTOGRAM_BUCKETS ((64 - HISTOGRAM_SUB_BITS) * HISTOGRAM_SUB_BUCKETS + HISTOGRAM_SUB_BUCKETS)
+
+typedef struct
+{
+   UINT64 count;
+   UINT64 sum;
+   UINT64 max;
+   UINT64 buckets[HISTOGRAM_BUCKETS];
+} histogram_type;
+
+void HistogramClear(histogram_type *h);
+void HistogramRecord(histogram_type *h,UINT64 value);
+
+/* Returns the value that the given percentage (0 to 100) of recorded
+ * values are at or below, rounded up to the top of its bucket but never
+ * more than the largest value recorded.  Returns 0 if h is empty. */
+UINT64 HistogramPercentile(const histogram_type *h,double percent);
+
+UINT64 HistogramMean(const histogram_type *h);
+
+int HistogramBucketIndex(UINT64 value);
+UINT64 HistogramBucketTop(int index);
+
+#endif
@@ -996,6 +996,7 @@ void InterfaceReloadSystem()
 	ResetResource();
 	ResetTimer();
 	ResetList();
+	ResetArray();
 	ResetObject();
 	ResetMessage();
 	ResetClass();
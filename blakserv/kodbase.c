@@ -14,6 +14,10 @@
  Message and parameter names are held in a special linked list in
  nameid.c.  Class and property names are held in the class, and
  resource names are held in the resource.
+
+ After ReloadBof, the kodbase is loaded again on top of what is there.
+ Classes and resources that already have their names are left alone;
+ the caller must reset the message and parameter names first.
  
  */
 
@@ -22,6 +26,7 @@
 #define MAX_LINE 128
 
 class_node *current_class;
+bool current_class_named; /* true if current class already has its property names */
 
 /* local function prototypes */
 
@@ -154,7 +159,10 @@ void LoadKodbaseClass(char *class_name,int class_id)
       return;
    }
 
-	SetClassName(class_id,class_name);
+   current_class_named = current_class->property_names != NULL;
+
+   if (current_class->class_name == NULL)
+      SetClassName(class_id,class_name);
 }
 
 void LoadKodbaseProperty(char *prop_name,int property_id)
@@ -166,6 +174,9 @@ void LoadKodbaseProperty(char *prop_name,int property_id)
       return;
    }
 
+   if (current_class_named)
+      return;
+
 /*
    dprintf("class id %i has prop %i named %s\n",current_class->class_id,
            new_prop->id,new_prop->name);
@@ -186,6 +197,9 @@ void LoadKodbaseClassVariable(char *classvar_name,int classvar_id)
       return;
    }
 
+   if (current_class_named)
+      return;
+
    new_classvar = (classvar_name_node *)AllocateMemory(MALLOC_ID_KODBASE,
 						       sizeof(classvar_name_node));
    new_classvar->id = classvar_id;
@@ -215,5 +229,11 @@ void LoadKodbaseParameter(char *parm_name,int parm_id)
 
 void LoadKodbaseResource(char *resource_name,int resource_id)
 {
+	resource_node *r;
+
+	r = GetResourceByID(resource_id);
+	if (r != NULL && r->resource_name != NULL)
+		return;
+
 	SetResourceName(resource_id,resource_name);
 }
@@ -0,0 +1,158 @@
+// Meridian 59, Copyright 1994-2012 Andrew Kirmse and Chris Kirmse.
+// All rights reserved.
+//
+// This software is distributed under a license that is described in
+// the LICENSE file that accompanies it.
+//
+// Meridian is a registered trademark.
+/*
+ * latency.c
+ *
+
+  This module keeps histograms of how long the main loop spends in each
+  of its phases, in microseconds.  RunMainLoop marks the start of each
+  pass (a "tick"), the end of each phase and the end of the tick; the
+  time from the end of one tick to the start of the next is the wait.
+  Timer lateness, client input queueing delay and the time of each top
+  level Blakod message are recorded as they happen.
+
+  It is also the stall watchdog.  A tick that runs longer than
+  StallMilliseconds is logged with the time spent in each phase.  Since
+  nearly every stall is Blakod that runs too long, the interpreter calls
+  LatencyCheckStall every STALL_CHECK_INSTRUCTIONS instructions, and the
+  first time in a tick that the limit has passed we log the Blakod
+  stack too, so we know what was running.
+
+*/
+
+#include "blakserv.h"
+
+static histogram_type latency_histograms[NUM_LATENCY];
+static time_t latency_start_time;
+
+static UINT64 tick_start;       /* 0 when not in a tick */
+static UINT64 phase_start;
+static UINT64 tick_phases[NUM_LATENCY];
+
+static UINT64 stall_limit;      /* 0 when the watchdog is off */
+static bool stall_reported;
+static int num_stalls;
+
+static const char *latency_names[NUM_LATENCY] =
+{
+   "wait", "sockets", "sessions", "timers", "tick", "blakod", "timerlate", "input",
+};
+
+void InitLatency(void)
+{
+   int i;
+
+   for (i=0;i<NUM_LATENCY;i++)
+      HistogramClear(&latency_histograms[i]);
+
+   latency_start_time = GetTime();
+   tick_start = 0;
+   phase_start = 0;
+   num_stalls = 0;
+}
+
+void LatencyRecord(int phase,UINT64 microseconds)
+{
+   HistogramRecord(&latency_histograms[phase],microseconds);
+}
+
+void LatencyTickStart(void)
+{
+   UINT64 now;
+   int i;
+
+   now = GetMicroCount();
+   if (phase_start != 0)
+      LatencyRecord(LATENCY_WAIT,now - phase_start);
+
+   tick_start = now;
+   phase_start = now;
+   for (i=0;i<NUM_LATENCY;i++)
+      tick_phases[i] = 0;
+
+   stall_limit = (UINT64) std::max(0,ConfigInt(DEBUG_STALL))*1000;
+   stall_reported = false;
+}
+
+/* the given phase of this tick has just finished */
+void LatencyPhaseEnd(int phase)
+{
+   UINT64 now;
+
+   if (tick_start == 0)
+      return;
+
+   now = GetMicroCount();
+   LatencyRecord(phase,now - phase_start);
+   tick_phases[phase] += now - phase_start;
+   phase_start = now;
+}
+
+void LatencyTickEnd(void)
+{
+   UINT64 now,elapsed;
+
+   if (tick_start == 0)
+      return;
+
+   now = GetMicroCount();
+   elapsed = now - tick_start;
+   LatencyRecord(LATENCY_TICK,elapsed);
+
+   if (stall_limit != 0 && elapsed >= stall_limit)
+   {
+      if (!stall_reported)
+         num_stalls++;
+
+      eprintf("Main loop stalled for %i ms: sockets %i ms, sessions %i ms, timers %i ms\n",
+              (int) (elapsed/1000),(int) (tick_phases[LATENCY_SOCKETS]/1000),
+              (int) (tick_phases[LATENCY_SESSIONS]/1000),(int) (tick_phases[LATENCY_TIMERS]/1000));
+   }
+
+   tick_start = 0;
+   phase_start = now;
+}
+
+/* called by the interpreter every so often while Blakod runs */
+void LatencyCheckStall(void)
+{
+   UINT64 elapsed;
+
+   if (stall_reported || stall_limit == 0 || tick_start == 0)
+      return;
+
+   elapsed = GetMicroCount() - tick_start;
+   if (elapsed < stall_limit)
+      return;
+
+   stall_reported = true;
+   num_stalls++;
+
+   eprintf("Main loop stalled for %i ms so far, in Blakod:\n%s\n",
+           (int) (elapsed/1000),BlakodStackInfo().c_str());
+}
+
+const char * GetLatencyName(int phase)
+{
+   return latency_names[phase];
+}
+
+const histogram_type * GetLatencyHistogram(int phase)
+{
+   return &latency_histograms[phase];
+}
+
+int GetLatencyNumStalls(void)
+{
+   return num_stalls;
+}
+
+time_t GetLatencyStartTime(void)
+{
+   return latency_start_time;
+}
@@ -0,0 +1,44 @@
+// Meridian 59, Copyright 1994-2012 Andrew Kirmse and Chris Kirmse.
+// All rights reserved.
+//
+// This software is distributed under a license that is described in
+// the LICENSE file that accompanies it.
+//
+// Meridian is a registered trademark.
+/*
+ * latency.h
+ *
+ */
+
+#ifndef _LATENCY_H
+#define _LATENCY_H
+
+enum
+{
+   LATENCY_WAIT,                /* waiting for socket events or the next timer */
+   LATENCY_SOCKETS,             /* accepting, reading and writing sockets */
+   LATENCY_SESSIONS,            /* PollSessions */
+   LATENCY_TIMERS,              /* TimerActivate */
+   LATENCY_TICK,                /* one pass of the main loop, less the wait */
+   LATENCY_BLAKOD,              /* each top level message, with its posts */
+   LATENCY_TIMER_LATE,          /* how long after its time each timer went off */
+   LATENCY_INPUT,               /* how long client input waited to be handled */
+   NUM_LATENCY
+};
+
+/* how many instructions the interpreter runs between stall checks */
+#define STALL_CHECK_INSTRUCTIONS 100000
+
+void InitLatency(void);
+void LatencyTickStart(void);
+void LatencyPhaseEnd(int phase);
+void LatencyTickEnd(void);
+void LatencyRecord(int phase,UINT64 microseconds);
+void LatencyCheckStall(void);
+
+const char * GetLatencyName(int phase);
+const histogram_type * GetLatencyHistogram(int phase);
+int GetLatencyNumStalls(void);
+time_t GetLatencyStartTime(void);
+
+#endif
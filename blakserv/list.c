@@ -65,8 +65,10 @@ int AllocateListNode(void)
 	
 	if (num_nodes == max_nodes)
 	{
+		/* grow by half, so that building a big heap doesn't copy it over
+		   and over */
 		old_nodes = max_nodes;
-		max_nodes = max_nodes + ( INIT_LIST_NODES/2) ;
+		max_nodes = max_nodes + max_nodes/2;
 		
 		list_nodes = (list_node *)
 			ResizeMemory(MALLOC_ID_LIST,list_nodes,old_nodes*sizeof(list_node),
@@ -132,9 +134,7 @@ int Cons(val_type source,val_type dest)
 	/*   bprintf("Allocing list node #%i\n",num_nodes); */
 	
 	list_id = AllocateListNode();
-	new_node = GetListNodeByID(list_id);
-	if (!new_node)
-		return NIL;
+	new_node = &list_nodes[list_id];
 	
 	new_node->first.int_val = source.int_val;
 	new_node->rest.int_val = dest.int_val;
@@ -366,9 +366,7 @@ void MoveListNode(int dest_id,int source_id)
 			dest_id);
 		return;
 	}
-	dest->first = source->first;
-	dest->rest = source->rest;
-	dest->garbage_ref = source->garbage_ref;
+	*dest = *source;
 }
 
 void SetNumListNodes(int new_num_nodes)
@@ -15,11 +15,12 @@
 
 #define INIT_LIST_NODES (500000)
 
+/* just the two values, 16 bytes; garbage.c keeps its marks for the nodes
+   apart from them */
 typedef struct
 {
    val_type first;
    val_type rest;
-   int garbage_ref;
 } list_node;
 
 void InitList(void);
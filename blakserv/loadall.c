@@ -104,6 +104,7 @@ bool LoadAllButAccountAtTime(char *time_str)
 		
 		ClearObject();
 		ClearList(); 
+		ClearArray();
 		ClearTimer();
 		ClearUser();
 		SetSystemObjectID(CreateObject(SYSTEM_CLASS,0,NULL));
@@ -14,6 +14,10 @@
   Data lines start with a tag name, either "SYSTEM", "OBJECT", "PROP", "LIST",
   "TIMER", or "USER" which indicates what type of data is being stored on that
   line.
+
+  Saved objects are matched up with the current classes by property name.
+  ReloadBof uses the same table of old property names to move existing
+  objects onto classes whose properties have changed.
   
 */
 
@@ -36,6 +40,9 @@ typedef struct load_game_class_struct
 	
 	int num_props;
 	load_game_prop_node *props; /* array of property names */
+
+	bool layout_checked;  /* for RemapLoadGameObject */
+	bool layout_changed;
 	
 	struct load_game_class_struct *next;
 } load_game_class_node;
@@ -102,6 +109,7 @@ void LoadGameClose(void);
 bool LoadGameSystem(void);
 bool LoadGameObject(int file_version);
 bool LoadGameListNodes(int file_version);
+bool LoadGameArrays(void);
 bool LoadGameTimer(int file_version);
 bool LoadGameUser(void);
 bool LoadGameClass(void);
@@ -121,19 +129,13 @@ void LoadGameTranslateVal(val_type *pval);
 bool LoadGame(char *filename)
 {
 	bool ret_val;
-	load_game_class_node *lgc,*tempc;
-	int i,j;
 	UINT64 start_time;
 	UINT64 end_time;
 	
 	start_time = GetMilliCount();
 	dprintf("LoadGame starting\n");
 
-	load_game_classes_table_size = ConfigInt(MEMORY_SIZE_CLASS_HASH);
-	load_game_classes = (load_game_class_node **)AllocateMemory(MALLOC_ID_LOAD_GAME,
-																	  load_game_classes_table_size*sizeof(load_game_class_node *));
-	for (i=0;i<load_game_classes_table_size;i++)
-		load_game_classes[i] = NULL;
+	InitLoadGameClasses();
 
 	load_game_resources = CreateISHash(ConfigInt(MEMORY_SIZE_RESOURCE_NAME_HASH));
 	current_object_id = INVALID_OBJECT;
@@ -152,6 +154,33 @@ bool LoadGame(char *filename)
 	
 	/* now free load game memory */
 	
+	FreeLoadGameClasses();
+
+	FreeISHash(load_game_resources);
+	load_game_resources = NULL;
+
+	end_time = GetMilliCount();
+	dprintf("LoadGame exiting LoadGame %u seconds\n",(unsigned int)(end_time-start_time)/1000);
+	
+	return ret_val;
+}
+
+void InitLoadGameClasses(void)
+{
+	int i;
+
+	load_game_classes_table_size = ConfigInt(MEMORY_SIZE_CLASS_HASH);
+	load_game_classes = (load_game_class_node **)AllocateMemory(MALLOC_ID_LOAD_GAME,
+																	  load_game_classes_table_size*sizeof(load_game_class_node *));
+	for (i=0;i<load_game_classes_table_size;i++)
+		load_game_classes[i] = NULL;
+}
+
+void FreeLoadGameClasses(void)
+{
+	load_game_class_node *lgc,*tempc;
+	int i,j;
+
 	for (i=0;i<load_game_classes_table_size;i++)
 	{
 		lgc = load_game_classes[i];
@@ -176,14 +205,75 @@ bool LoadGame(char *filename)
 	
 	FreeMemory(MALLOC_ID_LOAD_GAME,load_game_classes,load_game_classes_table_size*sizeof(load_game_class_node *));
 	load_game_classes = NULL;
+}
 
-	FreeISHash(load_game_resources);
-	load_game_resources = NULL;
+/* AddLoadGameClass
+ *
+ * Record the property names of class c as it is now, as if it had been
+ * read from a saved game, so that RemapLoadGameObject can move objects of
+ * the class onto a reloaded version of it.
+ */
+void AddLoadGameClass(class_node *c)
+{
+	load_game_class_node *lgc;
+	const char *prop_name;
+	int i;
 
-	end_time = GetMilliCount();
-	dprintf("LoadGame exiting LoadGame %u seconds\n",(unsigned int)(end_time-start_time)/1000);
-	
-	return ret_val;
+	lgc = CreateLoadGameClass(c->class_id,c->class_name == NULL ? (char *) "" : c->class_name,
+									  c->num_properties);
+
+	for (i=1;i<=c->num_properties;i++)
+	{
+		/* an unnamed property can't be matched up, so its value is dropped */
+		prop_name = GetPropertyNameByID(c,i);
+		LoadAddPropertyName(lgc,i,prop_name == NULL ? (char *) "?" : (char *) prop_name);
+	}
+}
+
+/* RemapLoadGameObject
+ *
+ * If object o's class was recorded with AddLoadGameClass and now has
+ * different properties, give o the new layout, keeping the value of each
+ * property that still exists by name, as LoadGameObject does.
+ */
+void RemapLoadGameObject(object_node *o)
+{
+	load_game_class_node *lgc;
+	class_node *c;
+	prop_type *old_p;
+	int old_num_props,property_id,i;
+
+	lgc = GetLoadGameClassByID(o->class_id);
+	if (lgc == NULL)
+		return;
+
+	c = o->class_ptr;
+	if (!lgc->layout_checked)
+	{
+		lgc->layout_checked = true;
+		lgc->layout_changed = lgc->num_props != c->num_properties;
+		for (i=1;i<=lgc->num_props && !lgc->layout_changed;i++)
+		{
+			const char *prop_name = GetPropertyNameByID(c,i);
+			if (prop_name == NULL || stricmp(prop_name,lgc->props[i-1].prop_name) != 0)
+				lgc->layout_changed = true;
+		}
+	}
+	if (!lgc->layout_changed)
+		return;
+
+	old_p = ReplaceObjectProperties(o,&old_num_props);
+
+	for (i=1;i<old_num_props && i<=lgc->num_props;i++)
+	{
+		property_id = GetPropertyIDByName(c,GetLoadGamePropertyNameByID(lgc,i));
+		/* property just eliminated in new kod */
+		if (property_id == INVALID_PROPERTY || property_id >= o->num_props)
+			continue;
+		o->p[property_id].val = old_p[i].val;
+	}
+
+	FreeObjectProperties(c,old_p,old_num_props);
 }
 
 bool LoadGameOpen(char *fname)
@@ -253,6 +343,10 @@ bool LoadGameParse(char *filename)
 			if (!LoadGameListNodes(file_version))
 				return false;
 			break;
+		case SAVE_GAME_ARRAYS :
+			if (!LoadGameArrays())
+				return false;
+			break;
 		case SAVE_GAME_TIMER :
 			if (!LoadGameTimer(file_version))
 				return false;
@@ -371,6 +465,33 @@ bool LoadGameListNodes(int file_version)
 	return true;
 }
 
+bool LoadGameArrays(void)
+{
+	int num_arrays,length,i,j;
+	array_node *a;
+	
+	LoadGameReadInt(&num_arrays);
+	
+	for (i=0;i<num_arrays;i++)
+	{
+		LoadGameReadInt(&length);
+		if (!LoadArray(i,length))
+		{
+			eprintf("LoadGameArrays can't set array %i\n",i);
+			return false;
+		}
+		
+		a = GetArrayByID(i);
+		for (j=0;j<length;j++)
+		{
+			LoadGameReadInt64(&a->elems[j]);
+			LoadGameTranslateVal(&a->elems[j]);
+		}
+	}
+	
+	return true;
+}
+
 bool LoadGameTimer(int file_version)
 {
 	int timer_id,object_id,milliseconds32;
@@ -468,6 +589,8 @@ load_game_class_node * CreateLoadGameClass(int class_old_id,char *class_name,int
 		strlen(class_name)+1);
 	strcpy(lgc->class_name,class_name);
 	lgc->num_props = num_props;
+	lgc->layout_checked = false;
+	lgc->layout_changed = false;
 	lgc->props = NULL;
 	if (num_props > 0)
 		lgc->props = (load_game_prop_node *)AllocateMemory(MALLOC_ID_LOAD_GAME,
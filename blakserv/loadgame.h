@@ -15,4 +15,9 @@
 
 bool LoadGame(char *filename);
 
+void InitLoadGameClasses(void);
+void FreeLoadGameClasses(void);
+void AddLoadGameClass(class_node *c);
+void RemapLoadGameObject(object_node *o);
+
 #endif
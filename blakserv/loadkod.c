@@ -14,6 +14,13 @@
   file is maintained.  When each .bof file is loaded, the classes and
   message handlers are created by class.c and message.c.  The format of
   the .bof files is in bof.txt.
+
+  ReloadBof loads just the .bof files that have been compiled since the
+  last load, replacing the classes in them while the game is running.
+
+  Every file is checked by VerifyBof as it is read, and isn't loaded if it
+  is malformed, so that the interpreter can run its message handlers
+  without checking their operands as it goes.
   
 */
 
@@ -30,9 +37,16 @@ loaded_bof_node *mem_files;
 
 /* local function prototypes */
 bool LoadBofName(char *fname);
+bool ReadBofFile(char *fname,char **ptr,int *size);
 void AddFileMem(char *fname,char *ptr,int size);
+void AddLoadedBof(loaded_bof_node *lf);
+void AddReloadedClass(class_node *c);
+bool IsClassInBof(char *fmem,int class_id);
+void FindBofInUse(class_node *c);
 void FindClasses(char *fmem,char *fname);
 void FindMessages(char *fmem,int class_id,bof_dispatch *dispatch);
+void CheckVerifiedProperties(class_node *c);
+static bool VerifyBof(char *fname,char *mem,int size);
 
 void InitLoadBof(void)
 {
@@ -80,6 +94,7 @@ void LoadBof(void)
 	}
 	
 	SetClassesSuperPtr();
+	ForEachClass(CheckVerifiedProperties);
 	SetClassVariables();
 	SetMessagesPropagate();
 
@@ -103,7 +118,187 @@ void ResetLoadBof(void)
 	mem_files = NULL;
 }
 
+/* ReloadBof
+ *
+ * Load the .bof files that have been compiled since the last load, without
+ * unloading the game.  Classes in them replace the loaded classes in place;
+ * objects of a class whose properties changed keep the values of the
+ * properties that are still there, matched by name as when loading a saved
+ * game.  Also loads the matching .rsc files and the kodbase.  Returns the
+ * number of changed files loaded (a file the same as the loaded copy is
+ * skipped), or -1 if one couldn't be read, in which case no class has
+ * changed.
+ */
+
+static loaded_bof_node *reload_files;
+static char *bof_in_use_mem;
+static bool bof_in_use;
+
+int ReloadBof(void)
+{
+	char file_load_path[MAX_PATH+FILENAME_MAX];
+	char file_copy_path[MAX_PATH+FILENAME_MAX];
+	loaded_bof_node *lf,*next,*old,**prev;
+	char *ptr;
+	int size,num_files;
+	
+	StringVector files;
+	if (!FindMatchingFiles(ConfigStr(PATH_BOF), BOF_EXTENSION, &files) || files.empty())
+		return 0;
+
+	/* read them all first, so that a bad one leaves the running kod alone */
+	reload_files = NULL;
+	num_files = 0;
+	for (StringVector::iterator it = files.begin(); it != files.end(); ++it)
+	{
+		snprintf(file_load_path, sizeof(file_load_path), "%s%s",ConfigStr(PATH_BOF), it->c_str());
+		snprintf(file_copy_path, sizeof(file_copy_path), "%s%s",ConfigStr(PATH_MEMMAP), it->c_str());
+		if (!ReadBofFile(file_load_path,&ptr,&size))
+		{
+			eprintf("ReloadBof can't load %s, nothing reloaded\n", it->c_str());
+			for (lf = reload_files; lf != NULL; lf = next)
+			{
+				next = lf->next;
+				FreeMemory(MALLOC_ID_LOADBOF,lf->mem,lf->length);
+				FreeMemory(MALLOC_ID_LOADBOF,lf,sizeof(loaded_bof_node));
+			}
+			return -1;
+		}
+
+		/* a build may copy over files that didn't change; leave their classes be */
+		for (old = mem_files; old != NULL; old = old->next)
+			if (stricmp(old->fname,file_copy_path) == 0)
+				break;
+		if (old != NULL && old->length == size && memcmp(old->mem,ptr,size) == 0)
+		{
+			FreeMemory(MALLOC_ID_LOADBOF,ptr,size);
+			BlakMoveFile(file_load_path,file_copy_path);
+			continue;
+		}
+		
+		lf = (loaded_bof_node *)AllocateMemory(MALLOC_ID_LOADBOF,sizeof(loaded_bof_node));
+		strcpy(lf->fname,file_copy_path);
+		lf->mem = ptr;
+		lf->length = size;
+		lf->next = reload_files;
+		reload_files = lf;
+		num_files++;
+	}
+
+	/* strings can change without the code changing */
+	for (StringVector::iterator it = files.begin(); it != files.end(); ++it)
+		ReloadRsc(it->c_str());
+
+	if (num_files == 0)
+		return 0;
+
+	/* remember the property names of the classes being replaced, and
+	   of their subclasses, before they change */
+	InitLoadGameClasses();
+	ForEachClass(AddReloadedClass);
+
+	for (lf = reload_files; lf != NULL; lf = next)
+	{
+		next = lf->next;
+
+		snprintf(file_load_path, sizeof(file_load_path), "%s%s",ConfigStr(PATH_BOF),
+					lf->fname + strlen(ConfigStr(PATH_MEMMAP)));
+		BlakMoveFile(file_load_path,lf->fname);
+
+		/* take the old copy of the file out of the list */
+		old = NULL;
+		for (prev = &mem_files; *prev != NULL; prev = &(*prev)->next)
+			if (stricmp((*prev)->fname,lf->fname) == 0)
+			{
+				old = *prev;
+				*prev = old->next;
+				break;
+			}
+
+		AddLoadedBof(lf);
+
+		if (old != NULL)
+		{
+			/* a class that was taken out of the file still runs the old copy */
+			bof_in_use_mem = old->mem;
+			bof_in_use = false;
+			ForEachClass(FindBofInUse);
+			if (bof_in_use)
+			{
+				old->next = mem_files;
+				mem_files = old;
+			}
+			else
+			{
+				FreeMemory(MALLOC_ID_LOADBOF,old->mem,old->length);
+				FreeMemory(MALLOC_ID_LOADBOF,old,sizeof(loaded_bof_node));
+			}
+		}
+	}
+
+	SetClassesSuperPtr();
+	ForEachClass(CheckVerifiedProperties);
+	SetClassVariables();
+	SetMessagesPropagate();
+
+	/* new messages and parameters may have been added anywhere in the list */
+	ResetNameID();
+	LoadKodbase();
+
+	ForEachObject(RemapLoadGameObject);
+	FreeLoadGameClasses();
+
+	reload_files = NULL;
+	return num_files;
+}
+
+void AddReloadedClass(class_node *c)
+{
+	class_node *ancestor;
+	loaded_bof_node *lf;
+
+	for (ancestor = c; ancestor != NULL; ancestor = ancestor->super_ptr)
+		for (lf = reload_files; lf != NULL; lf = lf->next)
+			if (IsClassInBof(lf->mem,ancestor->class_id))
+			{
+				AddLoadGameClass(c);
+				return;
+			}
+}
+
+bool IsClassInBof(char *fmem,int class_id)
+{
+	bof_list_elem *classes;
+	int i;
+
+	classes = &((bof_file_header *)fmem)->classes;
+	for (i=0;i<((bof_file_header *)fmem)->num_classes;i++)
+		if (classes[i].id == class_id)
+			return true;
+	return false;
+}
+
+void FindBofInUse(class_node *c)
+{
+	if (c->bof_base == bof_in_use_mem)
+		bof_in_use = true;
+}
+
 bool LoadBofName(char *fname)
+{
+	char *ptr;
+	int file_size;
+
+	if (!ReadBofFile(fname,&ptr,&file_size))
+		return false;
+
+	AddFileMem(fname,ptr,file_size);
+	
+	return true;
+}
+
+/* read a .bof file into memory, checking its header */
+bool ReadBofFile(char *fname,char **mem,int *size)
 {
    FILE *f = fopen(fname, "rb");
 	if (f == NULL)
@@ -141,14 +336,21 @@ bool LoadBofName(char *fname)
 	char *ptr = (char *)AllocateMemory(MALLOC_ID_LOADBOF,file_size);
    if (fread(ptr, 1, file_size, f) != file_size)
    {
+      FreeMemory(MALLOC_ID_LOADBOF,ptr,file_size);
       fclose(f);
       return false;
    }
 
    fclose(f);
 
-	AddFileMem(fname,ptr,file_size);
-	
+	if (!VerifyBof(fname,ptr,file_size))
+	{
+		FreeMemory(MALLOC_ID_LOADBOF,ptr,file_size);
+		return false;
+	}
+
+	*mem = ptr;
+	*size = file_size;
 	return true;
 }
 
@@ -162,7 +364,13 @@ void AddFileMem(char *fname,char *ptr,int size)
 	strcpy(lf->fname,fname);
 	lf->mem = ptr;
 	lf->length = size;
-	
+
+	AddLoadedBof(lf);
+}
+
+/* add the classes of a loaded file, and add it to the list */
+void AddLoadedBof(loaded_bof_node *lf)
+{
 	/* we store the fname so the class structures can point to it, but kill the path */
 	
 	if (strrchr(lf->fname,'\\') == NULL)
@@ -225,5 +433,454 @@ void FindMessages(char *fmem,int class_id,bof_dispatch *dispatch)
 	for (i=0;i<dispatch->num_messages;i++)
 		AddMessage(class_id,i,messages[i].id,
                  (char *)(fmem + messages[i].offset),
-                 messages[i].dstr_id);
+                 messages[i].dstr_id,true);
+}
+
+/* Handlers were verified against the properties and class vars of their
+   own class.  One with a subclass that has fewer (from a .bof not rebuilt
+   since its superclass's was) could read or write past the end of that
+   subclass's objects or class vars, so it and those of the classes above
+   it go back to being checked as they run. */
+void CheckVerifiedProperties(class_node *c)
+{
+	class_node *ancestor;
+	int i;
+
+	if (c->super_ptr == NULL ||
+		 (c->num_properties >= c->super_ptr->num_properties &&
+		  c->num_vars >= c->super_ptr->num_vars))
+		return;
+
+	eprintf("CheckVerifiedProperties class %i has fewer properties or class vars than its superclass %i; "
+		"rebuild its .bof\n",c->class_id,c->super_id);
+	for (ancestor = c->super_ptr; ancestor != NULL; ancestor = ancestor->super_ptr)
+		for (i=0;i<ancestor->num_messages;i++)
+			ancestor->messages[i].verified = false;
+}
+
+/* VerifyBof
+ *
+ * Check a .bof file that has just been read, before any of it is used:
+ * every offset in it is inside the file, and each message handler decodes
+ * to whole instructions, from its start to where the next thing in the
+ * file starts.  Instructions may only name locals and parameters the
+ * handler has, properties and class vars its class has, and C functions
+ * that exist, with no more parameters than InterpretCall takes; gotos
+ * must go to the start of an instruction in the same handler, and the
+ * last instruction must return or goto, so the interpreter never runs off
+ * the end.  Returns false, having said why, if the file fails.
+ */
+
+typedef struct
+{
+	char *mem;
+	int pos;                     /* offset of the next byte to decode */
+	int code_start;              /* offset of the handler's first instruction */
+	int end;                     /* offset of the first byte past the handler */
+	int num_locals;              /* locals and parameters */
+	int num_properties;
+	int num_classvars;
+	const char *error;
+} bof_verify_type;
+
+/* whether length bytes at offset are all inside a file of size bytes */
+static bool BofRange(int size,int offset,INT64 length)
+{
+	return offset >= 0 && length >= 0 && offset + length <= size;
+}
+
+static bool VerifyByte(bof_verify_type *v,int *b)
+{
+	if (v->pos + 1 > v->end)
+	{
+		v->error = "instruction runs past the end of the handler";
+		return false;
+	}
+	*b = (unsigned char) v->mem[v->pos++];
+	return true;
+}
+
+static bool VerifyInt(bof_verify_type *v,int *i)
+{
+	if (v->pos + 4 > v->end)
+	{
+		v->error = "instruction runs past the end of the handler";
+		return false;
+	}
+	*i = *(int *)(v->mem + v->pos);
+	v->pos += 4;
+	return true;
+}
+
+/* check that what an operand of the given type names exists */
+static bool VerifyIndex(bof_verify_type *v,int type,blak_int index)
+{
+	switch (type)
+	{
+	case LOCAL_VAR :
+		if (index < 0 || index >= v->num_locals)
+		{
+			v->error = "local variable out of range";
+			return false;
+		}
+		return true;
+
+	case PROPERTY :
+		/* equal to num_properties is ok, because self = prop 0 */
+		if (index < 0 || index > v->num_properties)
+		{
+			v->error = "property out of range";
+			return false;
+		}
+		return true;
+
+	case CONSTANT :
+		return true;
+
+	case CLASS_VAR :
+		if (index < 0 || index >= v->num_classvars)
+		{
+			v->error = "class variable out of range";
+			return false;
+		}
+		return true;
+	}
+
+	v->error = "unknown operand type";
+	return false;
+}
+
+/* a source operand, which the interpreter reads as a Blakod value */
+static bool VerifySource(bof_verify_type *v,int type)
+{
+	int data;
+
+	return VerifyInt(v,&data) && VerifyIndex(v,type,val32to64(data));
+}
+
+/* a destination, which the interpreter reads as a plain index */
+static bool VerifyDest(bof_verify_type *v,int type)
+{
+	int data;
+
+	return VerifyInt(v,&data) && VerifyIndex(v,type,data);
+}
+
+static bool VerifyCall(bof_verify_type *v,opcode_type opcode)
+{
+	int function_id,num_parms,type,name_id,i;
+
+	if (!VerifyByte(v,&function_id))
+		return false;
+	if (!IsCFunction(function_id))
+	{
+		v->error = "unknown C function";
+		return false;
+	}
+
+	switch (opcode.source1)
+	{
+	case CALL_NO_ASSIGN :
+		break;
+	case CALL_ASSIGN_LOCAL_VAR :
+	case CALL_ASSIGN_PROPERTY :
+		if (!VerifyDest(v,opcode.source1))
+			return false;
+		break;
+	default :
+		v->error = "unknown call assignment";
+		return false;
+	}
+
+	if (!VerifyByte(v,&num_parms))
+		return false;
+	if (num_parms > MAX_C_PARMS)
+	{
+		v->error = "too many parameters to C function";
+		return false;
+	}
+	for (i=0;i<num_parms;i++)
+		if (!VerifyByte(v,&type) || !VerifySource(v,type))
+			return false;
+
+	if (!VerifyByte(v,&num_parms))
+		return false;
+	if (num_parms > MAX_NAME_PARMS)
+	{
+		v->error = "too many named parameters to C function";
+		return false;
+	}
+	for (i=0;i<num_parms;i++)
+		if (!VerifyInt(v,&name_id) || !VerifyByte(v,&type) || !VerifySource(v,type))
+			return false;
+
+	return true;
+}
+
+/* decode the instruction at v->pos, adding where it can goto to targets;
+   sets *falls_through to whether the next instruction can run after it */
+static bool VerifyInstruction(bof_verify_type *v,std::vector<int> &targets,bool *falls_through)
+{
+	opcode_type opcode;
+	char opcode_char;
+	int inst_start,info,dest_addr;
+	INT64 target;
+
+	inst_start = v->pos;
+	if (!VerifyByte(v,&info))
+		return false;
+	opcode_char = (char) info;
+	memcpy(&opcode,&opcode_char,1);
+
+	*falls_through = true;
+
+	switch (opcode.command)
+	{
+	case UNARY_ASSIGN :
+		if (!VerifyByte(v,&info))
+			return false;
+		if (info > BITWISE_NOT)
+		{
+			v->error = "unknown unary operation";
+			return false;
+		}
+		return VerifyDest(v,opcode.dest) && VerifySource(v,opcode.source1);
+
+	case BINARY_ASSIGN :
+		if (!VerifyByte(v,&info))
+			return false;
+		if (info > BITWISE_OR)
+		{
+			v->error = "unknown binary operation";
+			return false;
+		}
+		return VerifyDest(v,opcode.dest) && VerifySource(v,opcode.source1) &&
+			VerifySource(v,opcode.source2);
+
+	case GOTO :
+		if (!VerifyInt(v,&dest_addr))
+			return false;
+		/* relative to the start of the goto */
+		target = (INT64) inst_start + dest_addr;
+		if (target < v->code_start || target >= v->end)
+		{
+			v->error = "goto out of the handler";
+			return false;
+		}
+		targets.push_back((int) target);
+
+		if (opcode.source2 == GOTO_UNCONDITIONAL)
+		{
+			*falls_through = false;
+			return true;
+		}
+		return VerifySource(v,opcode.source1);
+
+	case CALL :
+		return VerifyCall(v,opcode);
+
+	case RETURN :
+		*falls_through = false;
+		if (opcode.dest == PROPAGATE)
+			return true;
+		return VerifySource(v,opcode.source1);
+	}
+
+	v->error = "unknown instruction";
+	return false;
+}
+
+static bool VerifyHandler(char *fname,char *mem,int start,int end,int num_properties,
+						  int num_classvars)
+{
+	bof_verify_type v;
+	std::vector<bool> inst_starts;
+	std::vector<int> targets;
+	int num_locals,num_parms,inst_start;
+	bool falls_through;
+	size_t i;
+
+	v.mem = mem;
+	v.pos = start;
+	v.end = end;
+	v.num_properties = num_properties;
+	v.num_classvars = num_classvars;
+	v.error = NULL;
+
+	inst_start = start;
+	if (VerifyByte(&v,&num_locals) && VerifyByte(&v,&num_parms))
+	{
+		v.num_locals = num_locals + num_parms;
+		if (v.num_locals > MAX_LOCALS)
+			v.error = "too many locals and parameters";
+		/* each parameter's id and default value */
+		else if (v.pos + 8*num_parms > end)
+			v.error = "parameters run past the end of the handler";
+	}
+	if (v.error != NULL)
+	{
+		eprintf("VerifyBof %s handler at offset %i: %s\n",fname,start,v.error);
+		return false;
+	}
+
+	v.pos += 8*num_parms;
+	v.code_start = v.pos;
+	inst_starts.assign(end - v.code_start,false);
+
+	falls_through = true;
+	while (v.pos < end)
+	{
+		inst_start = v.pos;
+		inst_starts[inst_start - v.code_start] = true;
+		if (!VerifyInstruction(&v,targets,&falls_through))
+			break;
+	}
+
+	if (v.error == NULL && falls_through)
+		v.error = "no return at the end of the handler";
+
+	for (i=0;i<targets.size() && v.error == NULL;i++)
+		if (!inst_starts[targets[i] - v.code_start])
+		{
+			v.error = "goto into the middle of an instruction";
+			inst_start = targets[i];
+		}
+
+	if (v.error != NULL)
+	{
+		eprintf("VerifyBof %s handler at offset %i: %s at offset %i\n",
+			fname,start,v.error,inst_start);
+		return false;
+	}
+	return true;
+}
+
+static bool VerifyBof(char *fname,char *mem,int size)
+{
+	bof_file_header *header;
+	bof_class_header *class_data;
+	bof_class_props *props;
+	bof_dispatch *dispatch;
+	bof_dstring *dstrs;
+	bof_line_table *line_table;
+	bof_list_elem *classes;
+	bof_dispatch_list_elem *messages;
+	std::vector<int> bounds;
+	int i,j,offset,end;
+
+	header = (bof_file_header *)mem;
+	if (!BofRange(size,0,offsetof(bof_file_header,classes)) ||
+		!BofRange(size,offsetof(bof_file_header,classes),(INT64) header->num_classes*sizeof(bof_list_elem)))
+	{
+		eprintf("VerifyBof %s has a bad class table\n",fname);
+		return false;
+	}
+
+	if (!BofRange(size,header->source_filename,1))
+	{
+		eprintf("VerifyBof %s has a bad source filename offset\n",fname);
+		return false;
+	}
+
+	dstrs = (bof_dstring *)(mem + header->dstring_offset);
+	if (!BofRange(size,header->dstring_offset,sizeof(int)) ||
+		!BofRange(size,header->dstring_offset + sizeof(int),(INT64) dstrs->num_strings*sizeof(int)))
+	{
+		eprintf("VerifyBof %s has a bad string table\n",fname);
+		return false;
+	}
+	for (i=0;i<dstrs->num_strings;i++)
+	{
+		offset = (&dstrs->string_offsets)[i];
+		if (!BofRange(size,offset,1) || memchr(mem + offset,0,size - offset) == NULL)
+		{
+			eprintf("VerifyBof %s has a bad string %i\n",fname,i);
+			return false;
+		}
+	}
+
+	/* 0 means no line number table */
+	if (header->line_table_offset != 0)
+	{
+		line_table = (bof_line_table *)(mem + header->line_table_offset);
+		if (!BofRange(size,header->line_table_offset,sizeof(int)) ||
+			!BofRange(size,header->line_table_offset + sizeof(int),
+					  (INT64) line_table->num_line_entries*sizeof(bof_line_entry)))
+		{
+			eprintf("VerifyBof %s has a bad line number table\n",fname);
+			return false;
+		}
+		bounds.push_back(header->line_table_offset);
+	}
+
+	bounds.push_back(header->source_filename);
+	bounds.push_back(header->dstring_offset);
+	bounds.push_back(size);
+
+	/* check the structure of each class, noting where each part starts,
+	   since a handler goes up to the next thing in the file */
+	classes = &header->classes;
+	for (i=0;i<header->num_classes;i++)
+	{
+		class_data = (bof_class_header *)(mem + classes[i].offset);
+		if (!BofRange(size,classes[i].offset,offsetof(bof_class_header,classvar_values)) ||
+			!BofRange(size,classes[i].offset + offsetof(bof_class_header,classvar_values),
+					  (INT64) class_data->num_default_classvar_vals*sizeof(bof_list_elem)) ||
+			class_data->num_classvars < 0)
+		{
+			eprintf("VerifyBof %s class %i has a bad header\n",fname,classes[i].id);
+			return false;
+		}
+
+		props = (bof_class_props *)(mem + class_data->offset_properties);
+		if (!BofRange(size,class_data->offset_properties,offsetof(bof_class_props,prop_values)) ||
+			!BofRange(size,class_data->offset_properties + offsetof(bof_class_props,prop_values),
+					  (INT64) props->num_default_prop_vals*sizeof(bof_list_elem)) ||
+			props->num_properties < 0)
+		{
+			eprintf("VerifyBof %s class %i has bad properties\n",fname,classes[i].id);
+			return false;
+		}
+
+		dispatch = (bof_dispatch *)(mem + class_data->offset_dispatch);
+		if (!BofRange(size,class_data->offset_dispatch,offsetof(bof_dispatch,messages)) ||
+			!BofRange(size,class_data->offset_dispatch + offsetof(bof_dispatch,messages),
+					  (INT64) dispatch->num_messages*sizeof(bof_dispatch_list_elem)))
+		{
+			eprintf("VerifyBof %s class %i has a bad message table\n",fname,classes[i].id);
+			return false;
+		}
+
+		bounds.push_back(classes[i].offset);
+		bounds.push_back(class_data->offset_properties);
+		bounds.push_back(class_data->offset_dispatch);
+		messages = &dispatch->messages;
+		for (j=0;j<dispatch->num_messages;j++)
+			bounds.push_back(messages[j].offset);
+	}
+	std::sort(bounds.begin(),bounds.end());
+
+	for (i=0;i<header->num_classes;i++)
+	{
+		class_data = (bof_class_header *)(mem + classes[i].offset);
+		props = (bof_class_props *)(mem + class_data->offset_properties);
+		dispatch = (bof_dispatch *)(mem + class_data->offset_dispatch);
+		messages = &dispatch->messages;
+		for (j=0;j<dispatch->num_messages;j++)
+		{
+			offset = messages[j].offset;
+			if (!BofRange(size,offset,2))
+			{
+				eprintf("VerifyBof %s class %i has a bad handler offset %i\n",
+					fname,classes[i].id,offset);
+				return false;
+			}
+			end = *std::upper_bound(bounds.begin(),bounds.end(),offset);
+			if (!VerifyHandler(fname,mem,offset,end,props->num_properties,
+							   class_data->num_classvars))
+				return false;
+		}
+	}
+
+	return true;
 }
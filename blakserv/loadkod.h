@@ -24,6 +24,7 @@ typedef struct loaded_bof_struct
 void InitLoadBof(void);
 void ResetLoadBof(void);
 void LoadBof(void);
+int ReloadBof(void);
 void CloseAllFiles(void);
 
 #endif
@@ -21,6 +21,7 @@
 
 /* local function prototypes */
 bool EachLoadRsc(const char *filename,int resource_num, const char *string);
+bool EachReloadRsc(const char *filename,int resource_num, const char *string);
 bool LoadDynamicRscName(const char *filename);
 
 void LoadRsc(void)
@@ -53,6 +54,42 @@ bool EachLoadRsc(const char *filename,int resource_num,const char *string)
 	return true;
 }
 
+/* ReloadRsc
+ *
+ * Load the .rsc file that goes with a reloaded .bof file.  Resources
+ * that are already loaded get their new strings.
+ */
+void ReloadRsc(const char *bof_fname)
+{
+	char file_load_path[MAX_PATH+FILENAME_MAX];
+	char *ext;
+
+	snprintf(file_load_path, sizeof(file_load_path), "%s%s",ConfigStr(PATH_RSC), bof_fname);
+	ext = strrchr(file_load_path,'.');
+	if (ext == NULL || strlen(ext) != strlen(RSC_EXTENSION))
+		return;
+	strcpy(ext,RSC_EXTENSION);
+
+	/* a class with no resources has no .rsc file */
+	if (access(file_load_path,0) != 0)
+		return;
+
+	if (!RscFileLoad(file_load_path,EachReloadRsc))
+		eprintf("ReloadRsc error loading %s\n",file_load_path);
+}
+
+bool EachReloadRsc(const char *filename,int resource_num,const char *string)
+{
+	resource_node *r;
+
+	r = GetResourceByID(resource_num);
+	if (r == NULL)
+		AddResource(resource_num,string);
+	else if (strcmp(r->resource_val,string) != 0)
+		ChangeDynamicResourceStr(r,string); /* tells clients in the game, too */
+	return true;
+}
+
 
 void LoadDynamicRsc(const char *filename)
 {
@@ -14,6 +14,7 @@
 #define _LOADRSC_H
 
 void LoadRsc(void);
+void ReloadRsc(const char *bof_fname);
 void LoadDynamicRsc(const char *filename);
 
 #endif
@@ -80,6 +80,7 @@ void MainServer()
 	InitMessage();
 	InitObject();
 	InitList();
+	InitArray();
 	InitTimer();
 	InitSession();
 	InitResource();
@@ -93,6 +94,8 @@ void MainServer()
 	InitMotd();
 	InitLoadBof();
 	InitTime();
+	InitLatency();
+	InitMetrics();
 	InitGameLock();
 	InitBkodInterpret();
 	InitBufferPool();
@@ -175,6 +178,7 @@ void MainExitServer()
 	ResetResource();
 	ResetTimer();
 	ResetList();
+	ResetArray();
 	ResetObject();
 	ResetMessage();
 	ResetClass();
@@ -10,6 +10,18 @@
 *
 
   This module keeps track of memory usage by most of the system.
+
+  It also keeps pools of small blocks, for the kinds of memory that are
+  allocated and freed a block at a time all through the game (timers,
+  table entries, strings, and so on).  Each malloc id has a pool for each
+  size class, a multiple of POOL_ALIGN bytes up to POOL_MAX_BLOCK.  A pool
+  cuts its blocks from chunks as they are needed, each twice as big as the
+  one before, from POOL_FIRST_CHUNK up to POOL_MAX_CHUNK bytes, and
+  keeps the blocks freed back to it on a list threaded through the blocks
+  themselves, to give out first.  Chunks are never given back, so a pool
+  stays as big as its peak; show memory gives how much of it is free.
+  Bigger blocks, and all blocks when the memory checker is on, go to
+  AllocateMemory.
   
 */
 
@@ -186,6 +198,22 @@ void *ReallocCHK(int malloc_id, void *p,size_t size, size_t old_size )
 
 memory_statistics memory_stat;
 
+#define POOL_ALIGN 16
+#define POOL_MAX_BLOCK 256
+#define POOL_NUM_CLASSES (POOL_MAX_BLOCK/POOL_ALIGN)
+#define POOL_FIRST_CHUNK (4*1024)
+#define POOL_MAX_CHUNK (64*1024)
+
+typedef struct
+{
+	void *free_blocks;
+	char *next_block; /* the part of the newest chunk not cut up yet */
+	char *end_block;
+	size_t next_chunk; /* size of the next chunk, or 0 before the first */
+} memory_pool;
+
+static memory_pool pools[MALLOC_ID_NUM][POOL_NUM_CLASSES];
+
 const char *memory_stat_names[] = 
 {
 	"Timer", "String", "Kodbase", "Resource", 
@@ -196,12 +224,14 @@ const char *memory_stat_names[] =
 		"List", "Object properties",
 		"Configuration", "Rooms",
 		"Admin constants", "Buffers", "Game loading",
-		"Tables", "Socket blocks",
+		"Tables", "Socket blocks", "Arrays", "Posted messages",
 		
 		NULL
 };
 
 /* local function prototypes */
+static void CountAllocation(int malloc_id,size_t size);
+static void CountFree(int malloc_id,size_t size);
 
 
 void InitMemory(void)
@@ -216,8 +246,8 @@ void InitMemory(void)
 	if (i != MALLOC_ID_NUM)
 		StartupPrintf("InitMemory FATAL there aren't names for every malloc id\n");
 	
-	for (i=0;i<MALLOC_ID_NUM;i++)
-		memory_stat.allocated[i] = 0;
+	memset(&memory_stat,0,sizeof(memory_stat));
+	memset(pools,0,sizeof(pools));
 }
 
 memory_statistics * GetMemoryStats(void)
@@ -258,7 +288,7 @@ void * AllocateMemoryDebug(int malloc_id,size_t size,const char *filename,int li
 	if (malloc_id < 0 || malloc_id >= MALLOC_ID_NUM)
 		eprintf("AllocateMemory allocating memory of unknown type %i\n",malloc_id);
 	else
-		memory_stat.allocated[malloc_id] += size;
+		CountAllocation(malloc_id,size);
 #ifndef NMEMDEBUG
 
 
@@ -298,7 +328,7 @@ void FreeMemoryX(int malloc_id,void **ptr,size_t size)
 	if (malloc_id < 0 || malloc_id >= MALLOC_ID_NUM)
 		eprintf("FreeMemory freeing memory of unknown type %i\n",malloc_id);
 	else
-		memory_stat.allocated[malloc_id] -= size;
+		CountFree(malloc_id,size);
 	
 #ifndef NMEMDEBUG
 	FreeCHK(*ptr);
@@ -319,7 +349,11 @@ void * ResizeMemory(int malloc_id,void *ptr,int old_size,int new_size)
 	if (malloc_id < 0 || malloc_id >= MALLOC_ID_NUM)
 		eprintf("ResizeMemory resizing memory of unknown type %i\n",malloc_id);
 	else
+	{
 		memory_stat.allocated[malloc_id] += new_size-old_size;
+		if (memory_stat.allocated[malloc_id] > memory_stat.peak[malloc_id])
+			memory_stat.peak[malloc_id] = memory_stat.allocated[malloc_id];
+	}
 
 #ifndef NMEMDEBUG
 	return ReallocCHK(malloc_id,ptr,new_size,old_size);
@@ -355,6 +389,101 @@ void AddMemoryCount(int malloc_id, int64_t size)
       else
       {
          memory_stat.allocated[malloc_id] = (size_t) result;
+         if (memory_stat.allocated[malloc_id] > memory_stat.peak[malloc_id])
+            memory_stat.peak[malloc_id] = memory_stat.allocated[malloc_id];
       }
    }
 }
+
+static void CountAllocation(int malloc_id,size_t size)
+{
+	memory_stat.allocated[malloc_id] += size;
+	memory_stat.live[malloc_id]++;
+	if (memory_stat.allocated[malloc_id] > memory_stat.peak[malloc_id])
+		memory_stat.peak[malloc_id] = memory_stat.allocated[malloc_id];
+}
+
+static void CountFree(int malloc_id,size_t size)
+{
+	memory_stat.allocated[malloc_id] -= size;
+	memory_stat.live[malloc_id]--;
+}
+
+void * AllocatePoolMemory(int malloc_id,size_t size)
+{
+	memory_pool *pool;
+	size_t block_size;
+	void *ptr;
+
+#ifndef NMEMDEBUG
+	return AllocateMemory(malloc_id,size);
+#endif
+
+	if (size == 0 || size > POOL_MAX_BLOCK || malloc_id < 0 || malloc_id >= MALLOC_ID_NUM)
+		return AllocateMemory(malloc_id,size);
+
+	block_size = (size + POOL_ALIGN - 1) & ~(size_t) (POOL_ALIGN - 1);
+	pool = &pools[malloc_id][block_size/POOL_ALIGN - 1];
+
+	if (pool->free_blocks != NULL)
+	{
+		ptr = pool->free_blocks;
+		memcpy(&pool->free_blocks,ptr,sizeof(void *));
+	}
+	else
+	{
+		if (pool->next_block == pool->end_block)
+		{
+			/* the tail of the old chunk, if any, is too small for a block and
+			   stays unused */
+			if (pool->next_chunk == 0)
+				pool->next_chunk = POOL_FIRST_CHUNK;
+			pool->next_block = (char *) malloc(pool->next_chunk);
+			if (pool->next_block == NULL)
+			{
+				eprintf("AllocatePoolMemory couldn't allocate %i bytes (id %i)\n",
+						  (int) pool->next_chunk,malloc_id);
+				FatalError("Memory allocation failure");
+			}
+			pool->end_block = pool->next_block + pool->next_chunk/block_size*block_size;
+			memory_stat.pool_reserved[malloc_id] += pool->next_chunk;
+			if (pool->next_chunk < POOL_MAX_CHUNK)
+				pool->next_chunk *= 2;
+		}
+		ptr = pool->next_block;
+		pool->next_block += block_size;
+	}
+
+	memory_stat.pool_used[malloc_id] += block_size;
+	CountAllocation(malloc_id,size);
+	return ptr;
+}
+
+void FreePoolMemoryX(int malloc_id,void **ptr,size_t size)
+{
+	memory_pool *pool;
+	size_t block_size;
+
+#ifndef NMEMDEBUG
+	FreeMemoryX(malloc_id,ptr,size);
+	return;
+#endif
+
+	if (size == 0 || size > POOL_MAX_BLOCK || malloc_id < 0 || malloc_id >= MALLOC_ID_NUM)
+	{
+		FreeMemoryX(malloc_id,ptr,size);
+		return;
+	}
+
+	block_size = (size + POOL_ALIGN - 1) & ~(size_t) (POOL_ALIGN - 1);
+	pool = &pools[malloc_id][block_size/POOL_ALIGN - 1];
+
+	memcpy(*ptr,&pool->free_blocks,sizeof(void *));
+	pool->free_blocks = *ptr;
+
+	memory_stat.pool_used[malloc_id] -= block_size;
+	CountFree(malloc_id,size);
+
+	/* we want to catch any references to this, after the free()  */
+	*ptr = (void*) (int) 0xDEADC0DE;
+}
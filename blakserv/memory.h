@@ -23,7 +23,7 @@ enum
    MALLOC_ID_LIST, MALLOC_ID_OBJECT_PROPERTIES,
    MALLOC_ID_CONFIG, MALLOC_ID_ROOM,
    MALLOC_ID_ADMIN_CONSTANTS, MALLOC_ID_BUFFER, MALLOC_ID_LOAD_GAME,
-   MALLOC_ID_TABLE, MALLOC_ID_BLOCK,
+   MALLOC_ID_TABLE, MALLOC_ID_BLOCK, MALLOC_ID_ARRAY, MALLOC_ID_POST,
    
    MALLOC_ID_NUM
 };
@@ -31,6 +31,10 @@ enum
 typedef struct
 {
   size_t allocated[MALLOC_ID_NUM];
+  size_t peak[MALLOC_ID_NUM];          /* most allocated has been */
+  size_t live[MALLOC_ID_NUM];          /* blocks allocated and not freed */
+  size_t pool_reserved[MALLOC_ID_NUM]; /* bytes of pool chunks */
+  size_t pool_used[MALLOC_ID_NUM];     /* bytes of those handed out */
 } memory_statistics;
 
 #define AllocateMemory(id,size) AllocateMemoryDebug(id,size,__FILE__,__LINE__)
@@ -45,8 +49,14 @@ void FreeMemoryX(int malloc_id,void **ptr,size_t size);
 void * ResizeMemory(int malloc_id,void *ptr,int old_size,int new_size);
 void AddMemoryCount(int malloc_id, int64_t size);
 
+/* for many small blocks of the same few sizes, freed with FreePoolMemory
+   and the same size */
+void * AllocatePoolMemory(int malloc_id,size_t size);
+void FreePoolMemoryX(int malloc_id,void **ptr,size_t size);
+
 /* i want to be able to affect the passed ptr */
 #define FreeMemory(m_id,ptr,size) FreeMemoryX(m_id,(void **) &ptr,size)
+#define FreePoolMemory(m_id,ptr,size) FreePoolMemoryX(m_id,(void **) &ptr,size)
 
 
 #endif
@@ -15,6 +15,9 @@
  The table is in the same order as the table in the .bof file.  Linear
  searches are performed to find messages.
 
+ When a class is reloaded its table is replaced, so the propagate
+ pointers of every class must be set again with SetMessagesPropagate.
+
  */
 
 #include "blakserv.h"
@@ -55,6 +58,9 @@ void SetClassNumMessages(int class_id,int num_messages)
       return;
    }
 
+   /* drop the old table if the class is being reloaded */
+   ResetMessageClass(c);
+
    if (num_messages == 0)
       return;
 
@@ -69,12 +75,13 @@ void SetClassNumMessages(int class_id,int num_messages)
       c->messages[i].dstr_id = INVALID_DSTR;
       c->messages[i].trace_session_id = INVALID_ID;
       c->messages[i].called_count = 0;
+      c->messages[i].verified = false;
       c->messages[i].propagate_message = NULL;
       c->messages[i].propagate_class = NULL;
    }  
 }
 
-void AddMessage(int class_id,int count,int message_id,char *offset,int dstr_id)
+void AddMessage(int class_id,int count,int message_id,char *offset,int dstr_id,bool verified)
 {
    class_node *c;
 
@@ -92,6 +99,7 @@ void AddMessage(int class_id,int count,int message_id,char *offset,int dstr_id)
    c->messages[count].dstr_id = dstr_id;
    c->messages[count].trace_session_id = INVALID_ID;
    c->messages[count].called_count = 0;
+   c->messages[count].verified = verified;
 }
 
 /* SetMessagesPropagate
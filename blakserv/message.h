@@ -20,6 +20,7 @@ typedef struct message_struct
    int dstr_id;
    int trace_session_id;
    int called_count;
+   bool verified;               /* checked by VerifyBof, so runs unchecked */
    struct message_struct *propagate_message;
    struct class_struct *propagate_class;
 } message_node;
@@ -27,7 +28,7 @@ typedef struct message_struct
 void InitMessage(void);
 void ResetMessage(void);
 void SetClassNumMessages(int class_id,int num_messages);
-void AddMessage(int class_id,int count,int message_id,char *offset,int dstr_id);
+void AddMessage(int class_id,int count,int message_id,char *offset,int dstr_id,bool verified);
 void SetMessagesPropagate(void);
 
 /* two more header functions in class.h */
@@ -0,0 +1,301 @@
+// Meridian 59, Copyright 1994-2012 Andrew Kirmse and Chris Kirmse.
+// All rights reserved.
+//
+// This software is distributed under a license that is described in
+// the LICENSE file that accompanies it.
+//
+// Meridian is a registered trademark.
+/*
+ * metrics.c
+ *
+
+  This module writes the server's health figures in the Prometheus text
+  exposition format, for "show metrics" on the maintenance port.
+
+  Nothing here walks the objects, lists or strings: those counts are kept
+  by their modules as they change.  Traffic, buffer pool use, garbage
+  collection and saves are counted in metric_counters by MetricsAdd, a
+  relaxed atomic increment, since the socket code can run on another
+  thread.  Counters only go up, so a collector gets rates and averages
+  from the difference between two scrapes.  For anyone reading by hand,
+  the bytes per second over the last TransmittedPeriod are kept too.
+
+*/
+
+#include "blakserv.h"
+
+std::atomic<UINT64> metric_counters[NUM_METRICS];
+
+static UINT64 rate_time;        /* GetMicroCount() at the last rate update */
+static UINT64 rate_received;    /* counters at the last rate update */
+static UINT64 rate_sent;
+static double received_per_second;
+static double sent_per_second;
+
+static UINT64 garbage_last;     /* microseconds of the most recent one */
+static UINT64 save_last;
+
+static void (*metrics_output)(const char *fmt,...);
+
+static const char *session_state_names[] =
+{
+   "admin", "game", "trysync", "synched", "resync", "maintenance",
+};
+#define NUM_SESSION_STATES (sizeof(session_state_names)/sizeof(session_state_names[0]))
+static int session_state_counts[NUM_SESSION_STATES];
+
+void InitMetrics(void)
+{
+   int i;
+
+   for (i=0;i<NUM_METRICS;i++)
+      metric_counters[i] = 0;
+
+   rate_time = GetMicroCount();
+   rate_received = 0;
+   rate_sent = 0;
+   received_per_second = 0.0;
+   sent_per_second = 0.0;
+   garbage_last = 0;
+   save_last = 0;
+}
+
+/* called every TransmittedPeriod seconds */
+void MetricsUpdateRates(void)
+{
+   UINT64 now,received,sent;
+   double seconds;
+
+   now = GetMicroCount();
+   received = metric_counters[METRIC_BYTES_RECEIVED].load(std::memory_order_relaxed);
+   sent = metric_counters[METRIC_BYTES_SENT].load(std::memory_order_relaxed);
+
+   if (now > rate_time)
+   {
+      seconds = (now - rate_time)/1000000.0;
+      received_per_second = (received - rate_received)/seconds;
+      sent_per_second = (sent - rate_sent)/seconds;
+   }
+
+   rate_time = now;
+   rate_received = received;
+   rate_sent = sent;
+}
+
+void MetricsGarbageCollectDone(UINT64 microseconds)
+{
+   MetricsAdd(METRIC_GARBAGE_COLLECTS,1);
+   MetricsAdd(METRIC_GARBAGE_MICROSECONDS,microseconds);
+   garbage_last = microseconds;
+}
+
+void MetricsSaveDone(UINT64 microseconds)
+{
+   MetricsAdd(METRIC_SAVES,1);
+   MetricsAdd(METRIC_SAVE_MICROSECONDS,microseconds);
+   save_last = microseconds;
+}
+
+static UINT64 GetMetric(int counter)
+{
+   return metric_counters[counter].load(std::memory_order_relaxed);
+}
+
+static void MetricHeader(const char *name,const char *type,const char *help)
+{
+   metrics_output("# HELP %s %s\n",name,help);
+   metrics_output("# TYPE %s %s\n",name,type);
+}
+
+static void MetricInt(const char *name,const char *type,const char *help,UINT64 value)
+{
+   MetricHeader(name,type,help);
+   metrics_output("%s %" PRIu64 "\n",name,value);
+}
+
+static void MetricSeconds(const char *name,const char *type,const char *help,UINT64 microseconds)
+{
+   MetricHeader(name,type,help);
+   metrics_output("%s %.6f\n",name,microseconds/1000000.0);
+}
+
+static void MetricsCountSession(session_node *s)
+{
+   if (s->state >= 0 && s->state < (int) NUM_SESSION_STATES)
+      session_state_counts[s->state]++;
+}
+
+static void WriteSessionMetrics(void)
+{
+   int i;
+
+   for (i=0;i<(int) NUM_SESSION_STATES;i++)
+      session_state_counts[i] = 0;
+   ForEachSession(MetricsCountSession);
+
+   MetricHeader("blakserv_sessions","gauge","Connected sessions by state.");
+   for (i=0;i<(int) NUM_SESSION_STATES;i++)
+      metrics_output("blakserv_sessions{state=\"%s\"} %i\n",session_state_names[i],
+                     session_state_counts[i]);
+
+   MetricInt("blakserv_connections_total","counter","Sessions created.",
+             GetMetric(METRIC_CONNECTIONS));
+   MetricInt("blakserv_connections_rate_limited_total","counter",
+             "Connections closed by the connection rate limits.",
+             GetMetric(METRIC_CONNECTIONS_LIMITED));
+   MetricInt("blakserv_received_bytes_total","counter","Bytes read from clients.",
+             GetMetric(METRIC_BYTES_RECEIVED));
+   MetricInt("blakserv_sent_bytes_total","counter","Bytes written to clients.",
+             GetMetric(METRIC_BYTES_SENT));
+
+   MetricHeader("blakserv_received_bytes_per_second","gauge",
+                "Bytes read per second over the last transmitted period.");
+   metrics_output("blakserv_received_bytes_per_second %.1f\n",received_per_second);
+   MetricHeader("blakserv_sent_bytes_per_second","gauge",
+                "Bytes written per second over the last transmitted period.");
+   metrics_output("blakserv_sent_bytes_per_second %.1f\n",sent_per_second);
+}
+
+static void WriteBufferMetrics(void)
+{
+   UINT64 in_use,pooled;
+
+   in_use = GetMetric(METRIC_BUFFERS_TAKEN) - GetMetric(METRIC_BUFFERS_RETURNED);
+   pooled = GetMetric(METRIC_BUFFERS_CREATED) - GetMetric(METRIC_BUFFERS_FREED) - in_use;
+
+   MetricHeader("blakserv_buffers","gauge","Buffer pool buffers in use and free in the pool.");
+   metrics_output("blakserv_buffers{state=\"in_use\"} %" PRIu64 "\n",in_use);
+   metrics_output("blakserv_buffers{state=\"free\"} %" PRIu64 "\n",pooled);
+   MetricInt("blakserv_buffers_created_total","counter","Buffers allocated by the buffer pool.",
+             GetMetric(METRIC_BUFFERS_CREATED));
+   MetricInt("blakserv_buffer_size_bytes","gauge","Size of each buffer.",BUFFER_SIZE);
+}
+
+static void WriteGameMetrics(void)
+{
+   MetricInt("blakserv_objects","gauge","Objects in use.",GetObjectsUsed());
+   MetricInt("blakserv_list_nodes","gauge","List nodes in use.",GetListNodesUsed());
+   MetricInt("blakserv_arrays","gauge","Arrays in use.",GetArraysUsed());
+   MetricInt("blakserv_strings","gauge","Strings in use.",GetStringsUsed());
+   MetricInt("blakserv_timers","gauge","Active timers.",GetNumActiveTimers());
+
+   MetricInt("blakserv_garbage_collections_total","counter","Garbage collections.",
+             GetMetric(METRIC_GARBAGE_COLLECTS));
+   MetricSeconds("blakserv_garbage_collection_seconds_total","counter",
+                 "Time spent garbage collecting.",GetMetric(METRIC_GARBAGE_MICROSECONDS));
+   MetricSeconds("blakserv_garbage_collection_last_seconds","gauge",
+                 "Time the most recent garbage collection took.",garbage_last);
+   MetricInt("blakserv_saves_total","counter","Game saves.",GetMetric(METRIC_SAVES));
+   MetricSeconds("blakserv_save_seconds_total","counter","Time spent saving the game.",
+                 GetMetric(METRIC_SAVE_MICROSECONDS));
+   MetricSeconds("blakserv_save_last_seconds","gauge","Time the most recent save took.",save_last);
+}
+
+static void WriteKodMetrics(void)
+{
+   kod_statistics *kstat;
+
+   kstat = GetKodStats();
+
+   MetricInt("blakserv_kod_instructions_total","counter","Blakod instructions interpreted.",
+             (UINT64) kstat->billions_interpreted*1000000000 + kstat->num_interpreted);
+   MetricInt("blakserv_kod_messages_total","counter","Blakod messages handled.",
+             (UINT64) kstat->num_messages);
+   MetricInt("blakserv_kod_top_level_messages_total","counter","Top level Blakod messages handled.",
+             (UINT64) kstat->num_top_level_messages);
+   MetricSeconds("blakserv_kod_seconds_total","counter","Time spent in top level Blakod messages.",
+                 (UINT64) kstat->interpreting_time*1000);
+   MetricInt("blakserv_kod_slow_messages_total","counter",
+             "Top level Blakod messages that took over a second.",
+             (UINT64) kstat->interpreting_time_over_second);
+   MetricSeconds("blakserv_kod_longest_message_seconds","gauge",
+                 "Longest time on one top level Blakod message.",
+                 (UINT64) kstat->interpreting_time_highest*1000);
+   MetricInt("blakserv_kod_most_instructions","gauge",
+             "Most instructions on one top level Blakod message.",
+             (UINT64) kstat->num_interpreted_highest);
+   MetricInt("blakserv_kod_deepest_stack","gauge","Deepest Blakod message call stack.",
+             (UINT64) kstat->message_depth_highest);
+   MetricInt("blakserv_kod_post_queue_highest","gauge","Most posted Blakod messages waiting at once.",
+             (UINT64) kstat->post_queue_highest);
+}
+
+static void WriteLatencyMetrics(void)
+{
+   static const double quantiles[] = { 0.5, 0.9, 0.99, 0.999 };
+   const histogram_type *h;
+   int i,j;
+
+   MetricHeader("blakserv_latency_seconds","summary",
+                "Main loop phases, Blakod messages, timer lateness and input delay.");
+   for (i=0;i<NUM_LATENCY;i++)
+   {
+      h = GetLatencyHistogram(i);
+      for (j=0;j<(int) (sizeof(quantiles)/sizeof(quantiles[0]));j++)
+         metrics_output("blakserv_latency_seconds{phase=\"%s\",quantile=\"%g\"} %.6f\n",
+                        GetLatencyName(i),quantiles[j],
+                        HistogramPercentile(h,quantiles[j]*100.0)/1000000.0);
+      metrics_output("blakserv_latency_seconds_sum{phase=\"%s\"} %.6f\n",
+                     GetLatencyName(i),h->sum/1000000.0);
+      metrics_output("blakserv_latency_seconds_count{phase=\"%s\"} %" PRIu64 "\n",
+                     GetLatencyName(i),h->count);
+   }
+   MetricInt("blakserv_stalls_total","counter","Main loop ticks over StallMilliseconds.",
+             (UINT64) GetLatencyNumStalls());
+}
+
+static void WriteMemoryMetrics(void)
+{
+   memory_statistics *mstat;
+   int i;
+
+   mstat = GetMemoryStats();
+
+   MetricHeader("blakserv_memory_bytes","gauge","Memory allocated, by use.");
+   for (i=0;i<GetNumMemoryStats();i++)
+      metrics_output("blakserv_memory_bytes{use=\"%s\"} %" PRIu64 "\n",GetMemoryStatName(i),
+                     (UINT64) mstat->allocated[i]);
+
+   MetricHeader("blakserv_memory_peak_bytes","gauge","Most memory allocated, by use.");
+   for (i=0;i<GetNumMemoryStats();i++)
+      metrics_output("blakserv_memory_peak_bytes{use=\"%s\"} %" PRIu64 "\n",GetMemoryStatName(i),
+                     (UINT64) mstat->peak[i]);
+
+   MetricHeader("blakserv_memory_blocks","gauge","Memory blocks allocated, by use.");
+   for (i=0;i<GetNumMemoryStats();i++)
+      metrics_output("blakserv_memory_blocks{use=\"%s\"} %" PRIu64 "\n",GetMemoryStatName(i),
+                     (UINT64) mstat->live[i]);
+
+   MetricHeader("blakserv_memory_pool_bytes","gauge","Memory taken by small block pools, by use.");
+   for (i=0;i<GetNumMemoryStats();i++)
+      if (mstat->pool_reserved[i] > 0)
+         metrics_output("blakserv_memory_pool_bytes{use=\"%s\",state=\"used\"} %" PRIu64 "\n"
+                        "blakserv_memory_pool_bytes{use=\"%s\",state=\"free\"} %" PRIu64 "\n",
+                        GetMemoryStatName(i),(UINT64) mstat->pool_used[i],
+                        GetMemoryStatName(i),(UINT64) (mstat->pool_reserved[i] - mstat->pool_used[i]));
+}
+
+void WriteMetrics(void (*output_func)(const char *fmt,...))
+{
+   kod_statistics *kstat;
+   channel_stats cstat;
+
+   metrics_output = output_func;
+
+   kstat = GetKodStats();
+   MetricInt("blakserv_start_time_seconds","gauge","When the server started, in seconds since 1970.",
+             (UINT64) kstat->system_start_time);
+
+   WriteSessionMetrics();
+   WriteBufferMetrics();
+   WriteGameMetrics();
+   WriteKodMetrics();
+   WriteLatencyMetrics();
+   WriteMemoryMetrics();
+
+   GetChannelStats(&cstat);
+   MetricHeader("blakserv_channel_messages_total","counter","Channel log messages.");
+   metrics_output("blakserv_channel_messages_total{result=\"written\"} %i\n",cstat.written);
+   metrics_output("blakserv_channel_messages_total{result=\"repeated\"} %i\n",cstat.repeated);
+   metrics_output("blakserv_channel_messages_total{result=\"dropped\"} %i\n",cstat.dropped);
+}
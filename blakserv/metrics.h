@@ -0,0 +1,50 @@
+// Meridian 59, Copyright 1994-2012 Andrew Kirmse and Chris Kirmse.
+// All rights reserved.
+//
+// This software is distributed under a license that is described in
+// the LICENSE file that accompanies it.
+//
+// Meridian is a registered trademark.
+/*
+ * metrics.h
+ *
+ */
+
+#ifndef _METRICS_H
+#define _METRICS_H
+
+#include <atomic>
+
+/* counters that only ever go up, from server start */
+enum
+{
+   METRIC_BYTES_RECEIVED,
+   METRIC_BYTES_SENT,
+   METRIC_CONNECTIONS,          /* sessions created */
+   METRIC_CONNECTIONS_LIMITED,  /* connections closed by the connection rate limits */
+   METRIC_BUFFERS_CREATED,      /* buffers allocated by the buffer pool */
+   METRIC_BUFFERS_FREED,        /* buffers given back to the system by ResetBufferPool */
+   METRIC_BUFFERS_TAKEN,        /* GetBuffer calls */
+   METRIC_BUFFERS_RETURNED,     /* DeleteBuffer calls */
+   METRIC_GARBAGE_COLLECTS,
+   METRIC_GARBAGE_MICROSECONDS,
+   METRIC_SAVES,
+   METRIC_SAVE_MICROSECONDS,
+   NUM_METRICS
+};
+
+extern std::atomic<UINT64> metric_counters[NUM_METRICS];
+
+/* Safe to call from any thread; this is all the cost on the hot path. */
+static __inline void MetricsAdd(int counter,UINT64 amount)
+{
+   metric_counters[counter].fetch_add(amount,std::memory_order_relaxed);
+}
+
+void InitMetrics(void);
+void MetricsUpdateRates(void);
+void MetricsGarbageCollectDone(UINT64 microseconds);
+void MetricsSaveDone(UINT64 microseconds);
+void WriteMetrics(void (*output_func)(const char *fmt,...));
+
+#endif
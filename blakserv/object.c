@@ -12,6 +12,18 @@
  This module maintains a dynamically sized array with the Blakod
  objects. 
 
+ The objects of each class are also kept in a doubly linked list from
+ the class, by object id since the array moves, so that the objects of a
+ class can be found without looking at every object.  Objects are only
+ ever added at the end of the array, so each list is in order of id.
+
+ The property values of the objects of each class come from a slab kept
+ with the class: chunks of blocks of 1 + num_properties values, which
+ grow in size as the class makes more objects.  Blocks of deleted objects
+ go on a free list, threaded through the blocks themselves, for the next
+ object of the class, and the chunks are only given back all together, by
+ ResetObject and ClearObject.
+
  */
 
 #include "blakserv.h"
@@ -19,8 +31,33 @@
 object_node *objects;
 int num_objects,max_objects;
 
+/* blocks in a class's first chunk; each chunk after has twice as many, up
+   to about PROP_SLAB_MAX_CHUNK bytes */
+#define PROP_SLAB_FIRST_BLOCKS 4
+#define PROP_SLAB_MAX_CHUNK (64*1024)
+
+typedef struct prop_chunk_struct
+{
+   struct prop_chunk_struct *next;
+   size_t size; /* in bytes, including this header */
+} prop_chunk;
+
+typedef struct prop_slab_struct
+{
+   int block_props; /* 1 + num_properties of the class */
+   int next_blocks; /* blocks in the next chunk */
+   prop_type *free_blocks;
+   prop_chunk *chunks;
+} prop_slab;
+
 /* local function prototypes */
 void SetObjectProperties(int object_id,class_node *c);
+static prop_type * AllocateObjectProperties(class_node *c);
+static void AddPropertyChunk(prop_slab *s);
+static void FreePropertySlab(class_node *c);
+static void LinkObjectInstance(object_node *o);
+static void UnlinkObjectInstance(object_node *o);
+static void ClearClassInstances(class_node *c);
 
 void InitObject()
 {
@@ -31,24 +68,11 @@ void InitObject()
 
 void ResetObject()
 {
-   int i,old_objects;
-   class_node *c;
+   int old_objects;
+
+   ForEachClass(FreePropertySlab);
+   ForEachClass(ClearClassInstances);
 
-   for (i=0;i<num_objects;i++)
-   {
-      if (!objects[i].deleted)
-      {
-	 c = objects[i].class_ptr;
-	 if (c == NULL)
-	 {
-	    eprintf("ResetObject can't find class id %i\n",objects[i].class_id);
-	    return;
-	 }
-
-	 FreeMemory(MALLOC_ID_OBJECT_PROPERTIES,objects[i].p,
-		    sizeof(prop_type)*(1+c->num_properties));
-      }
-   }
    old_objects = max_objects;
    num_objects = 0;  
    max_objects = INIT_OBJECTS;
@@ -66,6 +90,9 @@ void ClearObject()
 {
    int old_objects;
 
+   ForEachClass(FreePropertySlab);
+   ForEachClass(ClearClassInstances);
+
    old_objects = max_objects;
    num_objects = 0;
    max_objects = INIT_OBJECTS;
@@ -106,15 +133,13 @@ int AllocateObject(int class_id)
    objects[num_objects].class_ptr = c;
    objects[num_objects].deleted = false;
    objects[num_objects].num_props = 1 + c->num_properties;
-   objects[num_objects].p = (prop_type *)AllocateMemory(MALLOC_ID_OBJECT_PROPERTIES,
-							sizeof(prop_type)*(1+c->num_properties));
+   objects[num_objects].p = AllocateObjectProperties(c);
 
    if (ConfigBool(DEBUG_INITPROPERTIES))
    {
       int i;
       prop_type p;
 
-      p.id = 0;
       p.val.v.tag = TAG_INVALID;
       p.val.v.data = 0;
 
@@ -124,9 +149,148 @@ int AllocateObject(int class_id)
       }
    }
 
+   LinkObjectInstance(&objects[num_objects]);
+
    return num_objects++;
 }
 
+static prop_type * AllocateObjectProperties(class_node *c)
+{
+   prop_slab *s;
+   prop_type *p;
+
+   s = c->prop_slab;
+   if (s == NULL)
+   {
+      s = (prop_slab *)AllocateMemory(MALLOC_ID_OBJECT_PROPERTIES,sizeof(prop_slab));
+      s->block_props = 1 + c->num_properties;
+      s->next_blocks = PROP_SLAB_FIRST_BLOCKS;
+      s->free_blocks = NULL;
+      s->chunks = NULL;
+      c->prop_slab = s;
+   }
+   else if (s->block_props != 1 + c->num_properties)
+   {
+      /* the class was reloaded with different properties.  Blocks of the
+         old size stay in their chunks, unused once freed, until reset */
+      s->block_props = 1 + c->num_properties;
+      s->next_blocks = PROP_SLAB_FIRST_BLOCKS;
+      s->free_blocks = NULL;
+   }
+
+   if (s->free_blocks == NULL)
+      AddPropertyChunk(s);
+
+   p = s->free_blocks;
+   memcpy(&s->free_blocks,p,sizeof(prop_type *));
+   return p;
+}
+
+static void AddPropertyChunk(prop_slab *s)
+{
+   prop_chunk *chunk;
+   prop_type *block;
+   size_t block_size;
+   int i;
+
+   block_size = s->block_props*sizeof(prop_type);
+   chunk = (prop_chunk *)AllocateMemory(MALLOC_ID_OBJECT_PROPERTIES,
+					sizeof(prop_chunk) + s->next_blocks*block_size);
+   chunk->size = sizeof(prop_chunk) + s->next_blocks*block_size;
+   chunk->next = s->chunks;
+   s->chunks = chunk;
+
+   /* hand out the blocks in order of address */
+   for (i=s->next_blocks-1;i>=0;i--)
+   {
+      block = (prop_type *)(chunk + 1) + i*s->block_props;
+      memcpy(block,&s->free_blocks,sizeof(prop_type *));
+      s->free_blocks = block;
+   }
+
+   if (2*s->next_blocks*block_size <= PROP_SLAB_MAX_CHUNK)
+      s->next_blocks *= 2;
+}
+
+/* FreeObjectProperties
+ *
+ * Gives back the property array p, of num_props values, of an object of
+ * class c.
+ */
+void FreeObjectProperties(class_node *c,prop_type *p,int num_props)
+{
+   prop_slab *s;
+
+   s = c->prop_slab;
+   if (s == NULL)
+   {
+      eprintf("FreeObjectProperties got properties of CLASS %s, which has none\n",
+	      c->class_name);
+      return;
+   }
+
+   /* from before the class was reloaded, so no use to later objects */
+   if (num_props != s->block_props)
+      return;
+
+   memcpy(p,&s->free_blocks,sizeof(prop_type *));
+   s->free_blocks = p;
+}
+
+static void FreePropertySlab(class_node *c)
+{
+   prop_slab *s;
+   prop_chunk *chunk,*next;
+
+   s = c->prop_slab;
+   if (s == NULL)
+      return;
+
+   for (chunk = s->chunks; chunk != NULL; chunk = next)
+   {
+      next = chunk->next;
+      FreeMemory(MALLOC_ID_OBJECT_PROPERTIES,chunk,chunk->size);
+   }
+   FreeMemory(MALLOC_ID_OBJECT_PROPERTIES,s,sizeof(prop_slab));
+   c->prop_slab = NULL;
+}
+
+/* add an object to the end of its class's list */
+static void LinkObjectInstance(object_node *o)
+{
+   class_node *c;
+
+   c = o->class_ptr;
+   o->next_instance = INVALID_OBJECT;
+   o->prev_instance = c->last_instance;
+   if (c->last_instance == INVALID_OBJECT)
+      c->first_instance = o->object_id;
+   else
+      objects[c->last_instance].next_instance = o->object_id;
+   c->last_instance = o->object_id;
+}
+
+static void UnlinkObjectInstance(object_node *o)
+{
+   class_node *c;
+
+   c = o->class_ptr;
+   if (o->prev_instance == INVALID_OBJECT)
+      c->first_instance = o->next_instance;
+   else
+      objects[o->prev_instance].next_instance = o->next_instance;
+   if (o->next_instance == INVALID_OBJECT)
+      c->last_instance = o->prev_instance;
+   else
+      objects[o->next_instance].prev_instance = o->prev_instance;
+}
+
+static void ClearClassInstances(class_node *c)
+{
+   c->first_instance = INVALID_OBJECT;
+   c->last_instance = INVALID_OBJECT;
+}
+
 /* charlie:  i dont want the error logs spammed by the object search routines */
 
 object_node * GetObjectByIDQuietly(int object_id)
@@ -195,7 +359,6 @@ int CreateObject(int class_id,int num_parms,parm_node parms[])
       return INVALID_OBJECT;
    
    /* set self = prop 0 */
-   objects[new_object_id].p[0].id = 0; 
    objects[new_object_id].p[0].val.v.tag = TAG_OBJECT; 
    objects[new_object_id].p[0].val.v.data = new_object_id;
 
@@ -246,7 +409,6 @@ bool LoadObject(int object_id,char *class_name)
    }
 
    /* set self = prop 0 */
-   objects[object_id].p[0].id = 0;
    objects[object_id].p[0].val.v.tag = TAG_OBJECT; 
    objects[object_id].p[0].val.v.data = object_id;
 
@@ -293,13 +455,6 @@ bool SetObjectPropertyByName(int object_id,char *prop_name,val_type val)
 	      property_id,object_id,c->class_name,c->class_id);
       return false;
    }
-   
-   if (o->p[property_id].id != property_id)
-   {
-      eprintf("SetObjectPropertyByName property index/id mismatch %i %i\n",
-	      property_id,o->p[property_id].id);
-      return false;
-   }
 
    o->p[property_id].val = val;
    return true;
@@ -321,13 +476,40 @@ void SetObjectProperties(int object_id,class_node *c)
       }
       else
       {
-	 objects[object_id].p[c->prop_default[i].id].id = c->prop_default[i].id;
 	 objects[object_id].p[c->prop_default[i].id].val.int_val =
 	    c->prop_default[i].val.int_val;
       }
    }
 }
 
+/* ReplaceObjectProperties
+ *
+ * Called when an object's class has been reloaded with different
+ * properties.  Gives the object a property array for its class as it is
+ * now, set to the class defaults, and returns the old one, with its length
+ * in *old_num_props.  The caller copies what it wants out of the old
+ * array, then frees it with FreeObjectProperties.
+ */
+prop_type * ReplaceObjectProperties(object_node *o,int *old_num_props)
+{
+   prop_type *old_p;
+   class_node *c;
+
+   c = o->class_ptr;
+   old_p = o->p;
+   *old_num_props = o->num_props;
+
+   o->num_props = 1 + c->num_properties;
+   o->p = AllocateObjectProperties(c);
+   memset(o->p,0,sizeof(prop_type)*(1+c->num_properties));
+
+   /* self = prop 0 */
+   o->p[0] = old_p[0];
+   SetObjectProperties(o->object_id,c);
+
+   return old_p;
+}
+
 void DeleteBlakodObject(int object_id)
 {
    class_node *c;
@@ -349,7 +531,8 @@ void DeleteBlakodObject(int object_id)
 
    /* now remove object */
 
-   FreeMemory(MALLOC_ID_OBJECT_PROPERTIES,o->p,sizeof(prop_type)*(1+c->num_properties));
+   FreeObjectProperties(o->class_ptr,o->p,o->num_props);
+   UnlinkObjectInstance(o);
    o->deleted = true;
 }   
 
@@ -362,6 +545,38 @@ void ForEachObject(void (*callback_func)(object_node *o))
 	 callback_func(&objects[i]);
 }
 
+/* ForEachObjectOfClass
+ *
+ * Calls callback_func for each object of class c, and of its subclasses
+ * too if subclasses is set, in order of id as ForEachObject does, looking
+ * at just those objects.  Objects that callback_func creates aren't
+ * included, and ones it deletes are skipped.
+ */
+void ForEachObjectOfClass(class_node *c,bool subclasses,void (*callback_func)(object_node *o))
+{
+   std::vector<int> ids;
+   class_node *sub;
+   int i,id;
+
+   for (id = c->first_instance; id != INVALID_OBJECT; id = objects[id].next_instance)
+      ids.push_back(id);
+
+   if (subclasses && c->class_exit > c->class_enter + 1)
+   {
+      for (i = c->class_enter + 1; i < c->class_exit; i++)
+      {
+	 sub = GetClassByOrder(i);
+	 for (id = sub->first_instance; id != INVALID_OBJECT; id = objects[id].next_instance)
+	    ids.push_back(id);
+      }
+      std::sort(ids.begin(),ids.end());
+   }
+
+   for (i=0;i<(int) ids.size();i++)
+      if (!objects[ids[i]].deleted)
+	 callback_func(&objects[ids[i]]);
+}
+
 /* these functions are for garbage collecting */
 
 void MoveObject(int dest_id,int source_id)
@@ -386,7 +601,8 @@ void MoveObject(int dest_id,int source_id)
       return;
    }
 
-   /* don't change the dest id here--it is set to array index, correctly */
+   /* don't change the dest id here--it is set to array index, correctly.
+      the class lists are put right by SetNumObjects, once all have moved */
    dest->class_id = source->class_id;
    dest->class_ptr = source->class_ptr;
    dest->deleted = source->deleted;
@@ -400,7 +616,14 @@ void MoveObject(int dest_id,int source_id)
 
 void SetNumObjects(int new_num_objects)
 {
+   int i;
+
    num_objects = new_num_objects;
+
+   ForEachClass(ClearClassInstances);
+   for (i=0;i<num_objects;i++)
+      if (!objects[i].deleted)
+	 LinkObjectInstance(&objects[i]);
 }
 
 /*
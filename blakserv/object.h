@@ -15,9 +15,10 @@
 
 #define INIT_OBJECTS 100000
 
+/* an object's properties are an array of these, indexed by property id,
+   with self as property 0 */
 typedef struct
 {
-   int id;
    val_type val;
 } prop_type;
 
@@ -30,6 +31,8 @@ typedef struct
    int garbage_ref;
    int num_props; /* used by garbage collect */
    prop_type *p;
+   int next_instance; /* ids of the objects of the same class either side */
+   int prev_instance;
 } object_node;
 
 void InitObject(void);
@@ -44,8 +47,11 @@ object_node * GetObjectByIDQuietly(int object_id);
 bool IsObjectByID(int object_id);
 object_node * GetObjectByIDEvenDeleted(int object_id);
 bool SetObjectPropertyByName(int object_id,char *prop_name,val_type val);
+prop_type * ReplaceObjectProperties(object_node *o,int *old_num_props);
+void FreeObjectProperties(class_node *c,prop_type *p,int num_props);
 
 void ForEachObject(void (*callback_func)(object_node *o));
+void ForEachObjectOfClass(class_node *c,bool subclasses,void (*callback_func)(object_node *o));
 void MoveObject(int dest_id,int source_id);
 void SetNumObjects(int new_num_objects);
 
@@ -33,6 +33,7 @@ void RunMainLoop(void)
 
 	   // wait up to ms, dispatch any socket events
 	   int val = epoll_wait(fd_epoll, notify_events, num_notify_events, ms);
+	   LatencyTickStart();
 	   if (val == -1)
 	   {
 		   eprintf("RunMainLoop error on epoll_wait %s\n", GetLastErrorStr());
@@ -75,10 +76,15 @@ void RunMainLoop(void)
 		   }
 
 	   }
+	   LatencyPhaseEnd(LATENCY_SOCKETS);
+
 	   EnterServerLock();
 	   PollSessions(); /* really just need to check session timers */
+	   LatencyPhaseEnd(LATENCY_SESSIONS);
 	   TimerActivate();
+	   LatencyPhaseEnd(LATENCY_TIMERS);
 	   LeaveServerLock();
+	   LatencyTickEnd();
    }
 
    close(fd_epoll);
@@ -41,6 +41,7 @@ void RunMainLoop(void)
         // wait up to ms, dispatch any socket events
         int val = kevent(fd_kqueue, NULL, 0, notify_events, num_notify_events, 
                         ms >= 0 ? &timeout : NULL);
+        LatencyTickStart();
         
         if (val == -1)
         {
@@ -89,11 +90,15 @@ void RunMainLoop(void)
                 }
             }
         }
+        LatencyPhaseEnd(LATENCY_SOCKETS);
         
         EnterServerLock();
         PollSessions(); /* really just need to check session timers */
+        LatencyPhaseEnd(LATENCY_SESSIONS);
         TimerActivate();
+        LatencyPhaseEnd(LATENCY_TIMERS);
         LeaveServerLock();
+        LatencyTickEnd();
     }
     close(fd_kqueue);
 }
@@ -37,12 +37,18 @@ void RunMainLoop(void)
 			   switch (msg.message)
 			   {
 			   case WM_BLAK_MAIN_READ :
+				   /* sockets are read by the interface thread, so a tick
+				      here has no sockets phase */
+				   LatencyTickStart();
 				   EnterServerLock();
 	       
 				   PollSession((int) msg.lParam);
+				   LatencyPhaseEnd(LATENCY_SESSIONS);
 				   TimerActivate();
+				   LatencyPhaseEnd(LATENCY_TIMERS);
 	       
 				   LeaveServerLock();
+				   LatencyTickEnd();
 				   break;
 			   case WM_BLAK_MAIN_RECALIBRATE :
 				   /* new soonest timer, so we should recalculate our time left... 
@@ -70,10 +76,14 @@ void RunMainLoop(void)
 	   {
 		   /* a Blakod timer is ready to go */
 	 
+		   LatencyTickStart();
 		   EnterServerLock();
 		   PollSessions(); /* really just need to check session timers */
+		   LatencyPhaseEnd(LATENCY_SESSIONS);
 		   TimerActivate();
+		   LatencyPhaseEnd(LATENCY_TIMERS);
 		   LeaveServerLock();
+		   LatencyTickEnd();
 	   }
    }
 }
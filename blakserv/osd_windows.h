@@ -17,6 +17,7 @@
 #define NOMINMAX
 #include <windows.h>
 #include <winsock2.h>
+#include <ws2tcpip.h>
 #include "resource.h"
 #include <crtdbg.h>
 #include <io.h>
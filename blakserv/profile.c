@@ -0,0 +1,311 @@
+// Meridian 59, Copyright 1994-2012 Andrew Kirmse and Chris Kirmse.
+// All rights reserved.
+//
+// This software is distributed under a license that is described in
+// the LICENSE file that accompanies it.
+//
+// Meridian is a registered trademark.
+/*
+ * profile.c
+ *
+
+  This module profiles the Blakod interpreter.  It does nothing until
+  profiling is started from the admin console with "profile start".
+
+  While profiling, SendBlakodMessage tells us when each message handler
+  starts and finishes, and we total the wall time and the instructions
+  spent in each handler, both inclusive (with everything it called) and
+  exclusive (in the handler itself, including any C calls it made).
+  Propagating to a superclass handler counts as calling it.  A handler that
+  recurses is counted inclusively only for its outermost call, so that its
+  time isn't counted twice.
+
+  Every ProfileSampleInterval instructions the interpreter also passes us
+  its whole message stack, and we count how often each distinct stack is
+  seen.  "profile flamegraph" prints these in the collapsed stack format
+  that flamegraph.pl and speedscope read: one line per stack, handlers
+  from the outermost in separated by semicolons, then the count.  The
+  innermost handler has the kod source line that was running.
+
+*/
+
+#include "blakserv.h"
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+
+/* most distinct stacks kept; any more are all counted as one */
+#define MAX_PROFILE_STACKS 100000
+
+typedef std::chrono::steady_clock profile_clock;
+
+/* one handler call in progress */
+typedef struct
+{
+   profile_node *node;
+   int depth;                   /* its frame # in the interpreter's stack */
+   profile_clock::time_point start_time;
+   UINT64 child_ns;
+   int start_insts;
+   INT64 child_insts;
+} profile_frame;
+
+/* next value of the interpreter's instruction count to take a sample at */
+int profile_next_sample;
+
+static int profile_interval;
+static int profile_num_samples;
+static bool profile_started = false;
+static profile_clock::time_point profile_start_time;
+static profile_clock::time_point profile_stop_time;
+
+/* keyed by class id and message id */
+static std::unordered_map<INT64,profile_node> profile_nodes;
+
+/* keyed by the class and message ids of each frame, then the source line,
+   so that names are only looked up when the stacks are printed */
+static std::unordered_map<std::string,int> profile_stacks;
+
+static profile_frame profile_frames[MAX_DEPTH];
+static int profile_num_frames;
+
+static void DropProfileFrames(int depth);
+
+void StartProfiling(int interval)
+{
+   DropProfileFrames(0);
+   profile_nodes.clear();
+   profile_stacks.clear();
+
+   profile_interval = std::max(1,interval);
+   profile_next_sample = profile_interval;
+   profile_num_samples = 0;
+   profile_started = true;
+   profile_start_time = profile_clock::now();
+
+   kod_stat.profiling = true;
+}
+
+void StopProfiling(void)
+{
+   if (!kod_stat.profiling)
+      return;
+
+   DropProfileFrames(0);
+   profile_stop_time = profile_clock::now();
+   kod_stat.profiling = false;
+}
+
+/* forget calls at or above the given depth without counting them; they
+   were started before profiling was, or never finished */
+static void DropProfileFrames(int depth)
+{
+   while (profile_num_frames > 0 && profile_frames[profile_num_frames-1].depth >= depth)
+   {
+      profile_num_frames--;
+      profile_frames[profile_num_frames].node->active--;
+   }
+}
+
+/* handler m of class c has started running in frame # depth of the stack;
+   insts is the interpreter's instruction count so far */
+void ProfileEnter(class_node *c,message_node *m,int depth,int insts)
+{
+   profile_node *p;
+   profile_frame *f;
+
+   DropProfileFrames(depth);
+   if (profile_num_frames >= MAX_DEPTH)
+      return;
+
+   p = &profile_nodes[((INT64) c->class_id << 32) | (unsigned int) m->message_id];
+   if (p->calls == 0)
+   {
+      p->class_id = c->class_id;
+      p->message_id = m->message_id;
+   }
+   p->calls++;
+   p->active++;
+
+   f = &profile_frames[profile_num_frames++];
+   f->node = p;
+   f->depth = depth;
+   f->start_time = profile_clock::now();
+   f->child_ns = 0;
+   f->start_insts = insts;
+   f->child_insts = 0;
+}
+
+/* the handlers in frame # depth and above have all returned */
+void ProfileLeave(int depth,int insts)
+{
+   profile_clock::time_point now;
+   profile_frame *f;
+   profile_node *p;
+   UINT64 ns;
+   INT64 num;
+
+   now = profile_clock::now();
+   while (profile_num_frames > 0 && profile_frames[profile_num_frames-1].depth >= depth)
+   {
+      f = &profile_frames[--profile_num_frames];
+      ns = (UINT64) std::chrono::duration_cast<std::chrono::nanoseconds>(now - f->start_time).count();
+      num = insts - f->start_insts;
+
+      p = f->node;
+      p->active--;
+      if (p->active == 0)
+      {
+         p->inclusive_ns += ns;
+         p->inclusive_insts += num;
+      }
+      p->exclusive_ns += ns - f->child_ns;
+      p->exclusive_insts += num - f->child_insts;
+
+      if (profile_num_frames > 0)
+      {
+         profile_frames[profile_num_frames-1].child_ns += ns;
+         profile_frames[profile_num_frames-1].child_insts += num;
+      }
+   }
+}
+
+/* the interpreter has reached its sampling limit (see ProfileCheckLimit),
+   running at bkod_ptr with depth frames of stack */
+void ProfileSample(kod_stack_type *stack,int depth,char *bkod_ptr,int insts)
+{
+   std::string key;
+   class_node *c;
+   int i,line;
+
+   /* another call already took this sample, or profiling has stopped */
+   if (!kod_stat.profiling || insts < profile_next_sample)
+      return;
+
+   profile_next_sample = insts + profile_interval;
+   profile_num_samples++;
+
+   key.reserve((2*depth + 1)*sizeof(int));
+   for (i=0;i<depth;i++)
+   {
+      key.append((const char *) &stack[i].class_id,sizeof(int));
+      key.append((const char *) &stack[i].message_id,sizeof(int));
+   }
+
+   line = 0;
+   if (depth > 0)
+   {
+      c = GetClassByID(stack[depth-1].class_id);
+      if (c != NULL)
+         line = GetSourceLine(c,bkod_ptr);
+   }
+   key.append((const char *) &line,sizeof(int));
+
+   if (profile_stacks.size() >= MAX_PROFILE_STACKS && profile_stacks.count(key) == 0)
+      key.clear();
+
+   profile_stacks[key]++;
+}
+
+/* the interpreter's instruction count is about to go from insts back to 0 */
+void ProfileRebase(int insts)
+{
+   profile_next_sample -= insts;
+}
+
+int GetProfileNumSamples(void)
+{
+   return profile_num_samples;
+}
+
+int GetProfileInterval(void)
+{
+   return profile_interval;
+}
+
+UINT64 GetProfileElapsedMilli(void)
+{
+   profile_clock::time_point end;
+
+   if (!profile_started)
+      return 0;
+
+   end = kod_stat.profiling ? profile_clock::now() : profile_stop_time;
+   return (UINT64) std::chrono::duration_cast<std::chrono::milliseconds>(end - profile_start_time).count();
+}
+
+void ForEachProfileNode(void (*callback_func)(profile_node *p))
+{
+   for (auto &entry : profile_nodes)
+      callback_func(&entry.second);
+}
+
+static int GetProfileKeyInt(const std::string &key,int index)
+{
+   int num;
+
+   memcpy(&num,key.data() + index*sizeof(int),sizeof(int));
+   return num;
+}
+
+static void AppendProfileFrame(std::string &s,int class_id,int message_id)
+{
+   class_node *c;
+
+   if (class_id == INVALID_CLASS)
+   {
+      s += "Server";
+      return;
+   }
+
+   c = GetClassByID(class_id);
+   s += (c == NULL || c->class_name == NULL) ? "(unknown)" : c->class_name;
+   s += "::";
+   s += GetNameByID(message_id);
+}
+
+void ForEachProfileStack(void (*callback_func)(const char *stack,int count))
+{
+   std::string s;
+   class_node *c;
+   int i,num_frames,line;
+
+   for (auto &entry : profile_stacks)
+   {
+      if (entry.first.empty())
+      {
+         callback_func("(other stacks)",entry.second);
+         continue;
+      }
+
+      num_frames = (int) (entry.first.size()/sizeof(int) - 1)/2;
+      line = GetProfileKeyInt(entry.first,2*num_frames);
+
+      s.clear();
+      for (i=0;i<num_frames;i++)
+      {
+         if (i > 0)
+            s += ";";
+         AppendProfileFrame(s,GetProfileKeyInt(entry.first,2*i),
+                            GetProfileKeyInt(entry.first,2*i+1));
+      }
+
+      if (num_frames > 0)
+      {
+         c = GetClassByID(GetProfileKeyInt(entry.first,2*(num_frames-1)));
+         if (c != NULL && c->fname != NULL)
+         {
+            s += " (";
+            s += c->fname;
+            s += ":";
+            s += std::to_string(line);
+            s += ")";
+         }
+      }
+      else
+         s = "Server";
+
+      callback_func(s.c_str(),entry.second);
+   }
+}
@@ -0,0 +1,54 @@
+// Meridian 59, Copyright 1994-2012 Andrew Kirmse and Chris Kirmse.
+// All rights reserved.
+//
+// This software is distributed under a license that is described in
+// the LICENSE file that accompanies it.
+//
+// Meridian is a registered trademark.
+/*
+ * profile.h
+ *
+ */
+
+#ifndef _PROFILE_H
+#define _PROFILE_H
+
+/* totals for one message handler, i.e. one (class, message) pair */
+typedef struct
+{
+   int class_id;
+   int message_id;
+   int calls;
+   int active;                  /* # of calls to it currently on the stack */
+   UINT64 inclusive_ns;
+   UINT64 exclusive_ns;
+   INT64 inclusive_insts;
+   INT64 exclusive_insts;
+} profile_node;
+
+void StartProfiling(int interval);
+void StopProfiling(void);
+void ProfileEnter(class_node *c,message_node *m,int depth,int insts);
+void ProfileLeave(int depth,int insts);
+void ProfileSample(kod_stack_type *stack,int depth,char *bkod_ptr,int insts);
+void ProfileRebase(int insts);
+
+int GetProfileNumSamples(void);
+int GetProfileInterval(void);
+UINT64 GetProfileElapsedMilli(void);
+void ForEachProfileNode(void (*callback_func)(profile_node *p));
+void ForEachProfileStack(void (*callback_func)(const char *stack,int count));
+
+extern int profile_next_sample;
+
+/* The interpreter only checks whether to sample when it reaches this many
+   instructions, folded into its infinite loop check, so profiling costs
+   nothing per instruction when it is off. */
+static __inline int ProfileCheckLimit(int max_statements)
+{
+   if (kod_stat.profiling && profile_next_sample < max_statements)
+      return profile_next_sample;
+   return max_statements;
+}
+
+#endif
@@ -14,6 +14,11 @@
  Currently the memory is not kept track of by memory.c because we use
  a common load function for the .roo file with the client.
 
+ Each room also keeps a spatial hash of the objects it holds, bucketed
+ into cells of ROOM_CELL_SIZE squares.  The Blakod tells us when things
+ move or leave, and can then ask for just the objects near a point
+ instead of walking its whole plActive list.
+
  */
 
 #include "blakserv.h"
@@ -87,6 +92,10 @@ blak_int LoadRoomData(int resource_id)
 
    AddMemoryCount(MALLOC_ID_ROOM, (int64_t)room->GetSize());
 
+   room->cell_rows = std::max(1,(room->file_info.rows + ROOM_CELL_SIZE - 1)/ROOM_CELL_SIZE);
+   room->cell_cols = std::max(1,(room->file_info.cols + ROOM_CELL_SIZE - 1)/ROOM_CELL_SIZE);
+   room->cells.resize(room->cell_rows*room->cell_cols);
+
    room->roomdata_id = num_roomdata++;
    room->next = roomdata;
    roomdata = room;
@@ -110,6 +119,169 @@ roomdata_node * GetRoomDataByID(int id)
    return NULL;
 }
 
+void ForEachRoomData(void (*callback_func)(roomdata_node *r))
+{
+   roomdata_node *room;
+
+   room = roomdata;
+   while (room != NULL)
+   {
+      callback_func(room);
+      room = room->next;
+   }
+}
+
+/* GetRoomCell
+ *
+ * Returns the spatial hash cell for a 1-based row and col.  Things just
+ * outside the room (they're on their way out) go in the nearest edge cell.
+ */
+static int GetRoomCell(roomdata_node *r,int row,int col)
+{
+   int cell_row,cell_col;
+
+   cell_row = std::clamp((row-1)/ROOM_CELL_SIZE,0,r->cell_rows-1);
+   cell_col = std::clamp((col-1)/ROOM_CELL_SIZE,0,r->cell_cols-1);
+
+   return cell_row*r->cell_cols + cell_col;
+}
+
+static void RemoveFromRoomCell(roomdata_node *r,int cell,int object_id)
+{
+   std::vector<int> &ids = r->cells[cell];
+
+   for (size_t i=0;i<ids.size();i++)
+   {
+      if (ids[i] == object_id)
+      {
+         /* order within a cell doesn't matter */
+         ids[i] = ids.back();
+         ids.pop_back();
+         return;
+      }
+   }
+   eprintf("RemoveFromRoomCell can't find OBJECT %i in room %i\n",object_id,
+           (int) r->roomdata_id);
+}
+
+void RoomObjectMoved(roomdata_node *r,int object_id,int row,int col)
+{
+   room_object_pos pos;
+
+   pos.row = row;
+   pos.col = col;
+   pos.cell = GetRoomCell(r,row,col);
+
+   auto it = r->object_pos.find(object_id);
+   if (it == r->object_pos.end())
+   {
+      r->object_pos[object_id] = pos;
+      r->cells[pos.cell].push_back(object_id);
+      return;
+   }
+
+   if (it->second.cell != pos.cell)
+   {
+      RemoveFromRoomCell(r,it->second.cell,object_id);
+      r->cells[pos.cell].push_back(object_id);
+   }
+   it->second = pos;
+}
+
+void RoomObjectRemoved(roomdata_node *r,int object_id)
+{
+   auto it = r->object_pos.find(object_id);
+   if (it == r->object_pos.end())
+      return;
+
+   RemoveFromRoomCell(r,it->second.cell,object_id);
+   r->object_pos.erase(it);
+}
+
+void ClearRoomObjects(roomdata_node *r)
+{
+   for (auto &ids : r->cells)
+      ids.clear();
+   r->object_pos.clear();
+}
+
+/* GetRoomObjectsInRange
+ *
+ * Adds to found every object whose square is within distance squares
+ * (inclusive, straight-line) of row,col, in order of object id.  Returns
+ * the number found.
+ */
+int GetRoomObjectsInRange(roomdata_node *r,int row,int col,int distance,std::vector<int> &found)
+{
+   int min_cell_row,max_cell_row,min_cell_col,max_cell_col;
+   int cell_row,cell_col;
+   INT64 distance_squared;
+   int num_found = 0;
+
+   if (distance < 0)
+      return 0;
+
+   distance_squared = (INT64) distance * distance;
+
+   min_cell_row = std::clamp((row-1-distance)/ROOM_CELL_SIZE,0,r->cell_rows-1);
+   max_cell_row = std::clamp((row-1+distance)/ROOM_CELL_SIZE,0,r->cell_rows-1);
+   min_cell_col = std::clamp((col-1-distance)/ROOM_CELL_SIZE,0,r->cell_cols-1);
+   max_cell_col = std::clamp((col-1+distance)/ROOM_CELL_SIZE,0,r->cell_cols-1);
+
+   for (cell_row=min_cell_row;cell_row<=max_cell_row;cell_row++)
+   {
+      for (cell_col=min_cell_col;cell_col<=max_cell_col;cell_col++)
+      {
+         for (int object_id : r->cells[cell_row*r->cell_cols + cell_col])
+         {
+            const room_object_pos &pos = r->object_pos[object_id];
+            INT64 row_diff = pos.row - row;
+            INT64 col_diff = pos.col - col;
+
+            if (row_diff*row_diff + col_diff*col_diff <= distance_squared)
+            {
+               found.push_back(object_id);
+               num_found++;
+            }
+         }
+      }
+   }
+
+   /* cells keep no order, so the Blakod sees the same order every time */
+   std::sort(found.end() - num_found,found.end());
+   return num_found;
+}
+
+/* GetRoomObjectsOfClass
+ *
+ * Adds to found every object in the room that is of class class_id or one
+ * of its subclasses, in order of object id.  Returns the number found.
+ */
+int GetRoomObjectsOfClass(roomdata_node *r,int class_id,std::vector<int> &found)
+{
+   object_node *o;
+   int num_found = 0;
+
+   for (auto &ids : r->cells)
+   {
+      for (int object_id : ids)
+      {
+         o = GetObjectByIDQuietly(object_id);
+         if (o == NULL)
+            continue;
+
+         if (IsClassOrSubclass(o->class_ptr,class_id))
+         {
+            found.push_back(object_id);
+            num_found++;
+         }
+      }
+   }
+
+   std::sort(found.end() - num_found,found.end());
+   return num_found;
+}
+
 bool CanMoveInRoom(roomdata_node *r,int from_row,int from_col,int to_row,int to_col)
 {
    int dir_row,dir_col;
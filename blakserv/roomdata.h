@@ -13,6 +13,17 @@
 #ifndef _ROOMDATA_H
 #define _ROOMDATA_H
 
+/* objects in a room are bucketed into square cells this many grid squares
+   on a side, so proximity queries only look at nearby cells */
+#define ROOM_CELL_SIZE 8
+
+typedef struct
+{
+   int row; /* 1-based, like the Blakod */
+   int col;
+   int cell;
+} room_object_pos;
+
 typedef struct roomdata_struct
 {
    int GetSize(void) const
@@ -33,6 +44,13 @@ typedef struct roomdata_struct
    struct roomdata_struct *next;
    room_type file_info;
    blak_int roomdata_id;
+
+   // Spatial hash of the objects the room holds, kept up to date by the
+   // Blakod with RoomObjectMoved() and RoomObjectRemoved().
+   int cell_rows;
+   int cell_cols;
+   std::vector<std::vector<int>> cells;
+   std::unordered_map<int,room_object_pos> object_pos;
 } roomdata_node;
 
 enum
@@ -46,5 +64,12 @@ bool CanMoveInRoom(roomdata_node *r,int from_row,int from_col,int to_row,int to_
 bool CanMoveInRoomFine(roomdata_node *r,int from_row,int from_col,int to_row,int to_col);
 blak_int LoadRoomData(int resource_id);
 roomdata_node * GetRoomDataByID(int id);
+void ForEachRoomData(void (*callback_func)(roomdata_node *r));
+
+void RoomObjectMoved(roomdata_node *r,int object_id,int row,int col);
+void RoomObjectRemoved(roomdata_node *r,int object_id);
+void ClearRoomObjects(roomdata_node *r);
+int GetRoomObjectsInRange(roomdata_node *r,int row,int col,int distance,std::vector<int> &found);
+int GetRoomObjectsOfClass(roomdata_node *r,int class_id,std::vector<int> &found);
 
 #endif
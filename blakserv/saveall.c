@@ -27,6 +27,7 @@ INT64 SaveAll(void)
    INT64 save_time;
    char save_name[MAX_PATH+FILENAME_MAX];
    char time_str[100];
+   UINT64 start_time;
 
    /* Note:  You must call GarbageCollect() right before SaveAll() */
 
@@ -45,6 +46,7 @@ INT64 SaveAll(void)
       We make our own copy since the time functions use a static
       buffer. */
    save_time = GetTime();
+   start_time = GetMicroCount();
    snprintf(time_str, sizeof(time_str), "%lli",(long long) save_time);
 
    save_ok = true;
@@ -67,6 +69,8 @@ INT64 SaveAll(void)
    if (!SaveDynamicRsc(save_name))
       save_ok = false;
 
+   MetricsSaveDone(GetMicroCount() - start_time);
+
    if (save_ok) {
       SaveControlFile(save_time);
 
@@ -86,6 +86,8 @@ void SaveObjects(void);
 void SaveEachObject(object_node *o);
 void SaveListNodes(void);
 void SaveEachListNode(list_node *l,int list_id);
+void SaveArrays(void);
+void SaveEachArray(array_node *a,int array_id);
 void SaveTimers(void);
 void SaveEachTimer(timer_node *t);
 void SaveUsers(void);
@@ -113,6 +115,7 @@ bool SaveGame(char *filename)
 	SaveSystem();
 	SaveObjects();
 	SaveListNodes();
+	SaveArrays();
 	SaveTimers();
 	SaveUsers();
 
@@ -222,6 +225,27 @@ void SaveEachListNode(list_node *l,int list_id)
 	SaveGameWriteInt64(l->rest.int_val);
 }
 
+/* no section at all when there are no arrays, so servers from before arrays
+   can still load the game */
+void SaveArrays(void)
+{
+	if (GetArraysUsed() == 0)
+		return;
+
+	SaveGameWriteByte(SAVE_GAME_ARRAYS);
+	SaveGameWriteInt(GetArraysUsed());
+	ForEachArray(SaveEachArray);
+}
+
+void SaveEachArray(array_node *a,int array_id)
+{
+	int i;
+
+	SaveGameWriteInt(a->length);
+	for (i=0;i<a->length;i++)
+		SaveGameWriteInt64(a->elems[i].int_val);
+}
+
 void SaveTimers(void)
 {
 	ForEachTimer(SaveEachTimer);
@@ -21,7 +21,8 @@ enum
    SAVE_GAME_OBJECT = 4,
    SAVE_GAME_LIST_NODES = 5,
    SAVE_GAME_TIMER = 6,
-   SAVE_GAME_USER = 7
+   SAVE_GAME_USER = 7,
+   SAVE_GAME_ARRAYS = 8
 };
 
 bool SaveGame(char *filename);
@@ -27,6 +27,7 @@ kod_statistics kod_stat;		/* actual statistics */
 
 char *bkod;
 int num_interpreted = 0; /* number of instructions in this top level call */
+static int stall_next_check = STALL_CHECK_INSTRUCTIONS; /* when to next call LatencyCheckStall */
 
 int trace_session_id = INVALID_ID;
 
@@ -59,13 +60,19 @@ int InterpretAtMessage(int object_id,class_node* c,message_node* m,
 static __inline void StoreValue(int object_id,local_var_type *local_vars,int data_type,int data,
 						 val_type new_data);
 static __inline void StoreValue(object_node *o,local_var_type *local_vars,int data_type,int data,
-						 val_type new_data);
-static __inline void InterpretUnaryAssign(object_node *o,local_var_type *local_vars,opcode_type opcode);
-static __inline void InterpretBinaryAssign(object_node *o,local_var_type *local_vars,opcode_type opcode);
+						 val_type new_data,bool checked);
+static __inline void InterpretUnaryAssign(object_node *o,local_var_type *local_vars,opcode_type opcode,
+					  bool checked);
+static __inline void InterpretBinaryAssign(object_node *o,local_var_type *local_vars,opcode_type opcode,
+					   bool checked);
 static __inline void InterpretGoto(object_node *o,local_var_type *local_vars,
-				   opcode_type opcode,char *inst_start);
-static __inline bool InterpretCall(object_node **o_ptr,int object_id,local_var_type *local_vars,opcode_type opcode);
+				   opcode_type opcode,char *inst_start,bool checked);
+static __inline bool InterpretCall(object_node **o_ptr,int object_id,local_var_type *local_vars,opcode_type opcode,
+				   bool checked);
 #endif
+static void GrowPostQueue(void);
+static parm_node * AllocatePostParms(int num_parms);
+static void ResetPostQueue(void);
 
 void InitProfiling(void)
 {
@@ -90,6 +97,7 @@ void InitProfiling(void)
 	kod_stat.interpreting_class = INVALID_CLASS;
 	kod_stat.debugging = ConfigBool(DEBUG_UNINITIALIZED);
 	kod_stat.debug_initlocals = ConfigBool(DEBUG_INITLOCALS);
+	kod_stat.profiling = false;
 
 	for (i=0;i<MAX_C_FUNCTION;i++)
 		kod_stat.c_count[i] = 0;
@@ -106,8 +114,7 @@ void InitBkodInterpret(void)
 
 	bkod = NULL;
 
-	post_q.next = 0;
-	post_q.last = 0;
+	ResetPostQueue();
 
 	for (i=0;i<MAX_C_FUNCTION;i++)
 		ccall_table[i] = C_Invalid;
@@ -150,6 +157,10 @@ void InitBkodInterpret(void)
 	ccall_table[CANMOVEINROOM] = C_CanMoveInRoom;
 	ccall_table[CANMOVEINROOMFINE] = C_CanMoveInRoomFine;
 	ccall_table[POINTINSECTOR] = C_IsPointInSector;
+	ccall_table[ROOMOBJECTMOVED] = C_RoomObjectMoved;
+	ccall_table[ROOMOBJECTREMOVED] = C_RoomObjectRemoved;
+	ccall_table[ROOMOBJECTSINRANGE] = C_RoomObjectsInRange;
+	ccall_table[ROOMOBJECTSOFCLASS] = C_RoomObjectsOfClass;
 
 	ccall_table[CONS] = C_Cons;
 	ccall_table[FIRST] = C_First;
@@ -164,6 +175,12 @@ void InitBkodInterpret(void)
 	ccall_table[FINDLISTELEM] = C_FindListElem;
 	ccall_table[MOVELISTELEM] = C_MoveListElem;
 
+	ccall_table[CREATEARRAY] = C_CreateArray;
+	ccall_table[GETARRAYELEM] = C_GetArrayElem;
+	ccall_table[SETARRAYELEM] = C_SetArrayElem;
+	ccall_table[ARRAYLENGTH] = C_ArrayLength;
+	ccall_table[ISARRAY] = C_IsArray;
+
 	ccall_table[GETTIME] = C_GetTime;
 
 	ccall_table[CREATETABLE] = C_CreateTable;
@@ -187,6 +204,12 @@ void InitBkodInterpret(void)
 
 	ccall_table[SENDWEBHOOK] = C_SendWebhook;
 }
+
+/* whether Blakod can call a C function with this id */
+bool IsCFunction(int function_id)
+{
+	return function_id >= 0 && function_id < MAX_C_FUNCTION && ccall_table[function_id] != C_Invalid;
+}
 #endif
 
 /* this pointer only makes sense when interpreting (used by bprintf only) */
@@ -224,25 +247,126 @@ void TraceInfo(int session_id,const char *class_name,int message_id,int num_parm
 	SendSessionAdminText(session_id,"\n");
 }
 
-void PostBlakodMessage(int object_id,int message_id,int num_parms,parm_node parms[])
+/* makes room for one more post, first by moving the unsent posts down over
+   the sent ones, if that frees half the queue, then by doubling it */
+static void GrowPostQueue(void)
 {
-	int i,new_next;
+	int old_max;
 
-	new_next = (post_q.next + 1) % MAX_POST_QUEUE;
-	if (new_next == post_q.last)
+	if (post_q.last > 0 && post_q.last >= post_q.max/2)
 	{
-		bprintf("PostBlakodMessage can't post MESSAGE %s (%i) to OBJECT %i; queue filled\n",
-			GetNameByID(message_id),message_id,object_id);
+		memmove(post_q.data,post_q.data + post_q.last,
+			(post_q.next - post_q.last)*sizeof(post_node));
+		post_q.next -= post_q.last;
+		post_q.last = 0;
 		return;
 	}
-	post_q.data[post_q.next].object_id = object_id;
-	post_q.data[post_q.next].message_id = message_id;
-	post_q.data[post_q.next].num_parms = num_parms;
-	for (i=0;i<num_parms;i++)
+
+	old_max = post_q.max;
+	if (old_max == 0)
+	{
+		post_q.max = INIT_POST_QUEUE;
+		post_q.data = (post_node *)AllocateMemory(MALLOC_ID_POST,post_q.max*sizeof(post_node));
+		return;
+	}
+
+	post_q.max = old_max*2;
+	post_q.data = (post_node *)ResizeMemory(MALLOC_ID_POST,post_q.data,
+		old_max*sizeof(post_node),post_q.max*sizeof(post_node));
+	lprintf("PostBlakodMessage resized to %i posts\n",post_q.max);
+}
+
+/* returns room for num_parms parms that stays put until the post is sent */
+static parm_node * AllocatePostParms(int num_parms)
+{
+	post_parm_chunk *chunk;
+	parm_node *parms;
+
+	chunk = post_q.cur_chunk;
+	if (chunk == NULL || chunk->used + num_parms > POST_PARM_CHUNK)
+	{
+		chunk = (post_parm_chunk *)AllocateMemory(MALLOC_ID_POST,sizeof(post_parm_chunk));
+		chunk->next = NULL;
+		chunk->used = 0;
+		if (post_q.cur_chunk == NULL)
+			post_q.chunks = chunk;
+		else
+			post_q.cur_chunk->next = chunk;
+		post_q.cur_chunk = chunk;
+	}
+
+	parms = &chunk->parms[chunk->used];
+	chunk->used += num_parms;
+	return parms;
+}
+
+/* called after the posts of a top level message have been sent.  If they
+   all were, the queue and its parms start over at the beginning.  If some
+   are left over (see SendTopLevelBlakodMessage), the chunks before the one
+   holding the oldest unsent post's parms are freed, so that posts that
+   keep getting left over can't grow the parms without end */
+static void ResetPostQueue(void)
+{
+	post_parm_chunk *chunk,*next_chunk;
+	parm_node *oldest;
+	int i;
+
+	if (post_q.next == post_q.last)
+	{
+		post_q.next = 0;
+		post_q.last = 0;
+	}
+
+	if (post_q.chunks == NULL)
+		return;
+
+	oldest = NULL;
+	for (i=post_q.last;i<post_q.next && oldest == NULL;i++)
+		oldest = post_q.data[i].parms;
+
+	if (oldest == NULL)
+	{
+		for (chunk = post_q.chunks->next;chunk != NULL;chunk = next_chunk)
+		{
+			next_chunk = chunk->next;
+			FreeMemory(MALLOC_ID_POST,chunk,sizeof(post_parm_chunk));
+		}
+		post_q.chunks->next = NULL;
+		post_q.chunks->used = 0;
+		post_q.cur_chunk = post_q.chunks;
+		return;
+	}
+
+	/* parms go into the chunks in the order the posts were made */
+	while (oldest < post_q.chunks->parms || oldest >= post_q.chunks->parms + POST_PARM_CHUNK)
 	{
-		post_q.data[post_q.next].parms[i] = parms[i];
+		chunk = post_q.chunks;
+		post_q.chunks = chunk->next;
+		FreeMemory(MALLOC_ID_POST,chunk,sizeof(post_parm_chunk));
 	}
-	post_q.next = new_next;
+}
+
+void PostBlakodMessage(int object_id,int message_id,int num_parms,parm_node parms[])
+{
+	post_node *post;
+
+	if (post_q.next == post_q.max)
+		GrowPostQueue();
+
+	post = &post_q.data[post_q.next];
+	post->object_id = object_id;
+	post->message_id = message_id;
+	post->num_parms = num_parms;
+	post->parms = NULL;
+	if (num_parms > 0)
+	{
+		post->parms = AllocatePostParms(num_parms);
+		memcpy(post->parms,parms,num_parms*sizeof(parm_node));
+	}
+	post_q.next++;
+
+	if (post_q.next - post_q.last > kod_stat.post_queue_highest)
+		kod_stat.post_queue_highest = post_q.next - post_q.last;
 }
 
 /* returns the return value of the blakod */
@@ -250,6 +374,7 @@ blak_int SendTopLevelBlakodMessage(int object_id,int message_id,int num_parms,pa
 {
 	blak_int ret_val = 0;
 	UINT64 start_time = 0;
+	UINT64 start_micro;
 	int interp_time = 0;
 	int posts = 0;
 	int accumulated_num_interpreted = 0;
@@ -263,18 +388,27 @@ blak_int SendTopLevelBlakodMessage(int object_id,int message_id,int num_parms,pa
 	kod_stat.debug_initlocals = ConfigBool(DEBUG_INITLOCALS);
 
 	start_time = GetMilliCount();
+	start_micro = GetMicroCount();
 	kod_stat.num_top_level_messages++;
 	trace_session_id = INVALID_ID;
+	if (kod_stat.profiling)
+		ProfileRebase(num_interpreted);
 	num_interpreted = 0;
+	stall_next_check = STALL_CHECK_INSTRUCTIONS;
 
 	ret_val = SendBlakodMessage(object_id,message_id,num_parms,parms);
 
 	while (post_q.next != post_q.last)
 	{
+		post_node post;
+
 		posts++;
 
 		accumulated_num_interpreted += num_interpreted;
+		if (kod_stat.profiling)
+			ProfileRebase(num_interpreted);
 		num_interpreted = 0;
+		stall_next_check = STALL_CHECK_INSTRUCTIONS;
 
 		if (accumulated_num_interpreted > 10*ConfigInt(BLAKOD_MAX_STATEMENTS))
 		{
@@ -289,13 +423,18 @@ blak_int SendTopLevelBlakodMessage(int object_id,int message_id,int num_parms,pa
 			break;
 		}
 
-		/* posted messages' return value is ignored */
-		SendBlakodMessage(post_q.data[post_q.last].object_id,post_q.data[post_q.last].message_id,
-			post_q.data[post_q.last].num_parms,post_q.data[post_q.last].parms);
+		/* the queue can move while this one is sent, but its parms don't */
+		post = post_q.data[post_q.last++];
 
-		post_q.last = (post_q.last + 1) % MAX_POST_QUEUE;
+		/* posted messages' return value is ignored */
+		SendBlakodMessage(post.object_id,post.message_id,post.num_parms,post.parms);
 	}
 
+	/* posts left over after the limit above wait for the next top level
+	   message */
+	ResetPostQueue();
+
+	LatencyRecord(LATENCY_BLAKOD,GetMicroCount() - start_micro);
 	interp_time = (int)(GetMilliCount() - start_time);
 	kod_stat.interpreting_time += interp_time;
 	if (interp_time > kod_stat.interpreting_time_highest)
@@ -344,28 +483,37 @@ static int numExecuted;
 
 void SendClassMessage(object_node *object)
 {
-	class_node *c = GetClassByID(object->class_id);
-	do
-	{
-		if (c->class_id == classMsg.class_id)
-		{
-			SendBlakodMessage(object->object_id,classMsg.message_id,classMsg.num_params,classMsg.parm);
-			numExecuted++;
-			return;
-		}
-		c = c->super_ptr;
-	} while (c != NULL);
+	SendBlakodMessage(object->object_id,classMsg.message_id,classMsg.num_params,classMsg.parm);
+	numExecuted++;
 }
 
+/* sends the message to each object of the class and its subclasses that
+   exists when it's called, and returns how many were sent to */
 int SendBlakodClassMessage(int class_id,int message_id,int num_params,parm_node parm[])
 {
+	ClassMessage prev_msg;
+	int prev_executed,ret_val;
+	class_node *c;
+
+	c = GetClassByID(class_id);
+	if (c == NULL)
+		return 0;
+
+	/* a handler can send a class message of its own */
+	prev_msg = classMsg;
+	prev_executed = numExecuted;
+
 	numExecuted = 0;
 	classMsg.class_id = class_id;
 	classMsg.message_id = message_id;
 	classMsg.num_params = num_params;
 	classMsg.parm = parm;
-	ForEachObject(SendClassMessage);
-	return numExecuted;
+	ForEachObjectOfClass(c,true,SendClassMessage);
+	ret_val = numExecuted;
+
+	classMsg = prev_msg;
+	numExecuted = prev_executed;
+	return ret_val;
 }
 
 /* returns the return value of the blakod */
@@ -415,7 +563,7 @@ blak_int SendBlakodMessage(int object_id,int message_id,int num_parms,parm_node
 	stack[message_depth].message_id = m->message_id;
 	stack[message_depth].propagate_depth = 0;
 	stack[message_depth].num_parms = num_parms;
-	memcpy(stack[message_depth].parms,parms,num_parms*sizeof(parm_node));
+	stack[message_depth].parms = parms;
 	stack[message_depth].bkod_ptr = bkod;
 	if (message_depth > 0)
 		stack[message_depth-1].bkod_ptr = prev_bkod;
@@ -435,6 +583,9 @@ blak_int SendBlakodMessage(int object_id,int message_id,int num_parms,parm_node
 		return NIL;
 	}
 
+	if (kod_stat.profiling)
+		ProfileEnter(c,m,message_depth-1,num_interpreted);
+
 	if (m->trace_session_id != INVALID_ID)
 	{
 		trace_session_id = m->trace_session_id;
@@ -461,6 +612,8 @@ blak_int SendBlakodMessage(int object_id,int message_id,int num_parms,parm_node
 			bprintf("SendBlakodMessage can't propagate MESSAGE %s (%i) in CLASS %s (%i)\n",
 				GetNameByID(message_id),message_id,c->class_name,c->class_id);
 			message_depth -= propagate_depth;
+			if (kod_stat.profiling)
+				ProfileLeave(message_depth,num_interpreted);
 			kod_stat.interpreting_class = prev_interpreting_class;
 			bkod = prev_bkod;
 			return NIL;
@@ -471,6 +624,8 @@ blak_int SendBlakodMessage(int object_id,int message_id,int num_parms,parm_node
 			bprintf("SendBlakodMessage can't find class to propagate to, from "
 				"MESSAGE %s (%i) in CLASS %s (%i)\n",GetNameByID(message_id),message_id,c->class_name,c->class_id);
 			message_depth -= propagate_depth;
+			if (kod_stat.profiling)
+				ProfileLeave(message_depth,num_interpreted);
 			kod_stat.interpreting_class = prev_interpreting_class;
 			bkod = prev_bkod;
 			return NIL;
@@ -497,8 +652,10 @@ blak_int SendBlakodMessage(int object_id,int message_id,int num_parms,parm_node
 		stack[message_depth].message_id = m->message_id;
 		stack[message_depth].propagate_depth = propagate_depth;
 		stack[message_depth].num_parms = num_parms;
-		memcpy(stack[message_depth].parms,parms,num_parms*sizeof(parm_node));
+		stack[message_depth].parms = parms;
 		stack[message_depth].bkod_ptr = m->handler;
+		if (kod_stat.profiling)
+			ProfileEnter(c,m,message_depth,num_interpreted);
 		message_depth++;
 		propagate_depth++;
 
@@ -507,6 +664,8 @@ blak_int SendBlakodMessage(int object_id,int message_id,int num_parms,parm_node
 	}
 
 	message_depth -= propagate_depth;
+	if (kod_stat.profiling)
+		ProfileLeave(message_depth,num_interpreted);
 	kod_stat.interpreting_class = prev_interpreting_class;
 	bkod = prev_bkod;
 
@@ -535,6 +694,11 @@ __inline blak_int get_blakint() {
 
 /* returns either RETURN_PROPAGATE or RETURN_NO_PROPAGATE.  If no propagate,
 * then the return value in ret_val is good.
+*
+* A handler that VerifyBof has checked (m->verified) runs without checking
+* the number of its locals, where its instructions store, which class
+* vars they read and how many parameters its calls pass, since it can't
+* get them wrong.
 */
 int InterpretAtMessage(int object_id,class_node* c,message_node* m,
 					   int num_sent_parms,
@@ -549,7 +713,7 @@ int InterpretAtMessage(int object_id,class_node* c,message_node* m,
 
 	int i,j;
 	char *inst_start;
-	bool found_parm;
+	bool found_parm,checked;
 	object_node *o;
 
 	o = GetObjectByID(object_id);
@@ -560,11 +724,13 @@ int InterpretAtMessage(int object_id,class_node* c,message_node* m,
 		return RETURN_NO_PROPAGATE;
 	}
 
+	checked = (m == NULL || !m->verified);
+
 	num_locals = get_byte();
 	num_parms = get_byte();
 
 	local_vars.num_locals = num_locals+num_parms;
-	if (local_vars.num_locals > MAX_LOCALS)
+	if (checked && local_vars.num_locals > MAX_LOCALS)
 	{
 		dprintf("InterpretAtMessage found too many locals and parms for OBJECT %i CLASS %s MESSAGE %s (%s) aborting and returning NIL\n",
             object_id,
@@ -616,34 +782,48 @@ int InterpretAtMessage(int object_id,class_node* c,message_node* m,
 	}
 
 	int max_statements = ConfigInt(BLAKOD_MAX_STATEMENTS);
+	int check_statements = ProfileCheckLimit(std::min(max_statements,stall_next_check));
 
 	for(;;)			/* returns when gets a blakod return */
 	{
 		num_interpreted++;
 
-		/* infinite loop check */
-		if (num_interpreted > max_statements)
+		/* infinite loop check, which is also when we check for a stall and
+			sample if profiling */
+		if (num_interpreted > check_statements)
 		{
-			bprintf("InterpretAtMessage interpreted too many instructions--infinite loop?\n");
+			if (num_interpreted > max_statements)
+			{
+				bprintf("InterpretAtMessage interpreted too many instructions--infinite loop?\n");
 
-			dprintf("Infinite loop at depth %i\n", message_depth);
-			dprintf("  OBJECT %i CLASS %s MESSAGE %s (%s) aborting and returning NIL\n",
-              object_id,
-              c? c->class_name : "(unknown)",
-              m? GetNameByID(m->message_id) : "(unknown)",
-              BlakodDebugInfo().c_str());
+				dprintf("Infinite loop at depth %i\n", message_depth);
+				dprintf("  OBJECT %i CLASS %s MESSAGE %s (%s) aborting and returning NIL\n",
+	              object_id,
+	              c? c->class_name : "(unknown)",
+	              m? GetNameByID(m->message_id) : "(unknown)",
+	              BlakodDebugInfo().c_str());
 
-			dprintf("  Local variables:\n");
-			for (i=0;i<local_vars.num_locals;i++)
+				dprintf("  Local variables:\n");
+				for (i=0;i<local_vars.num_locals;i++)
+				{
+					dprintf("  %3i : %s %5" PRId64 "\n",
+						i,
+						GetTagName(local_vars.locals[i]),
+						local_vars.locals[i].v.data);
+				}
+
+				(*ret_val).int_val = NIL;
+				return RETURN_NO_PROPAGATE;
+			}
+
+			if (num_interpreted > stall_next_check)
 			{
-				dprintf("  %3i : %s %5" PRId64 "\n",
-					i,
-					GetTagName(local_vars.locals[i]),
-					local_vars.locals[i].v.data);
+				LatencyCheckStall();
+				stall_next_check = num_interpreted + STALL_CHECK_INSTRUCTIONS;
 			}
 
-			(*ret_val).int_val = NIL;
-			return RETURN_NO_PROPAGATE;
+			ProfileSample(stack,message_depth,bkod,num_interpreted);
+			check_statements = ProfileCheckLimit(std::min(max_statements,stall_next_check));
 		}
 
 		opcode_char = get_byte();
@@ -660,17 +840,17 @@ int InterpretAtMessage(int object_id,class_node* c,message_node* m,
 		switch (opcode.command)
 		{
 			case UNARY_ASSIGN :
-				InterpretUnaryAssign(o,&local_vars,opcode);
+				InterpretUnaryAssign(o,&local_vars,opcode,checked);
 				continue;
 			case BINARY_ASSIGN :
-				InterpretBinaryAssign(o,&local_vars,opcode);
+				InterpretBinaryAssign(o,&local_vars,opcode,checked);
 				continue;
 			case GOTO :
 				inst_start = bkod - 1; /* we've read one byte of instruction so far */
-				InterpretGoto(o,&local_vars,opcode,inst_start);
+				InterpretGoto(o,&local_vars,opcode,inst_start,checked);
 				continue;
 			case CALL :
-				if (!InterpretCall(&o,object_id,&local_vars,opcode))
+				if (!InterpretCall(&o,object_id,&local_vars,opcode,checked))
 				{
 					(*ret_val).int_val = NIL;
 					return RETURN_NO_PROPAGATE;
@@ -690,7 +870,7 @@ int InterpretAtMessage(int object_id,class_node* c,message_node* m,
 				{
 					blak_int data;
 					data = get_blakint();
-					*ret_val = RetrieveValue(o,&local_vars,opcode.source1,data);
+					*ret_val = RetrieveValue(o,&local_vars,opcode.source1,data,checked);
 					return RETURN_NO_PROPAGATE;
 				}
 				/* can't get here */
@@ -765,7 +945,7 @@ static __inline void StoreValue(int object_id,local_var_type *local_vars,int dat
 }
 
 static __inline void StoreValue(object_node *o,local_var_type *local_vars,int data_type,int data,
-						 val_type new_data)
+						 val_type new_data,bool checked)
 {
 	class_node *class_data;
 
@@ -779,7 +959,7 @@ static __inline void StoreValue(object_node *o,local_var_type *local_vars,int da
 	switch (data_type)
 	{
 	case LOCAL_VAR :
-		if (data < 0 || data >= local_vars->num_locals)
+		if (checked && (data < 0 || data >= local_vars->num_locals))
 		{
 			eprintf("[%s] StoreValue can't write to illegal local var %i\n",
               BlakodDebugInfo().c_str(),data);
@@ -804,7 +984,7 @@ static __inline void StoreValue(object_node *o,local_var_type *local_vars,int da
 			return;
 		}
 		/* equal to num_properties is ok, because self = prop 0 */
-		if (data < 0 || data > class_data->num_properties)
+		if (checked && (data < 0 || data > class_data->num_properties))
 		{
 			eprintf("[%s] StoreValue can't write to illegal property %i (max %i)\n",
               BlakodDebugInfo().c_str(),data,class_data->num_properties);
@@ -820,7 +1000,8 @@ static __inline void StoreValue(object_node *o,local_var_type *local_vars,int da
 	}
 }
 
-static __inline void InterpretUnaryAssign(object_node *o,local_var_type *local_vars,opcode_type opcode)
+static __inline void InterpretUnaryAssign(object_node *o,local_var_type *local_vars,opcode_type opcode,
+					  bool checked)
 {
 	char info;
 	int dest;
@@ -831,7 +1012,7 @@ static __inline void InterpretUnaryAssign(object_node *o,local_var_type *local_v
 	dest = get_int();
 	source = get_blakint();
 
-	source_data = RetrieveValue(o,local_vars,opcode.source1,source);
+	source_data = RetrieveValue(o,local_vars,opcode.source1,source,checked);
 
 	switch (info)
 	{
@@ -870,10 +1051,11 @@ static __inline void InterpretUnaryAssign(object_node *o,local_var_type *local_v
 		break;
 	}
 
-	StoreValue(o,local_vars,opcode.dest,dest,source_data);
+	StoreValue(o,local_vars,opcode.dest,dest,source_data,checked);
 }
 
-static __inline void InterpretBinaryAssign(object_node *o,local_var_type *local_vars,opcode_type opcode)
+static __inline void InterpretBinaryAssign(object_node *o,local_var_type *local_vars,opcode_type opcode,
+					   bool checked)
 {
 	char info;
   int dest;
@@ -885,8 +1067,8 @@ static __inline void InterpretBinaryAssign(object_node *o,local_var_type *local_
 	source1 = get_blakint();
 	source2 = get_blakint();
 
-	source1_data = RetrieveValue(o,local_vars,opcode.source1,source1);
-	source2_data = RetrieveValue(o,local_vars,opcode.source2,source2);
+	source1_data = RetrieveValue(o,local_vars,opcode.source1,source1,checked);
+	source2_data = RetrieveValue(o,local_vars,opcode.source2,source2,checked);
 
 	/*
 	if (source1_data.v.tag != source2_data.v.tag)
@@ -1071,11 +1253,11 @@ static __inline void InterpretBinaryAssign(object_node *o,local_var_type *local_
 		break;
    }
 
-   StoreValue(o,local_vars,opcode.dest,dest,source1_data);
+   StoreValue(o,local_vars,opcode.dest,dest,source1_data,checked);
 }
 
 static __inline void InterpretGoto(object_node *o,local_var_type *local_vars,
-				   opcode_type opcode,char *inst_start)
+				   opcode_type opcode,char *inst_start,bool checked)
 {
 	int dest_addr;
 	blak_int var_check;
@@ -1095,13 +1277,14 @@ static __inline void InterpretGoto(object_node *o,local_var_type *local_vars,
 	}
 
 	var_check = get_blakint();
-	check_data = RetrieveValue(o,local_vars,opcode.source1,var_check);
+	check_data = RetrieveValue(o,local_vars,opcode.source1,var_check,checked);
 	if ((opcode.dest == GOTO_IF_TRUE && check_data.v.data != 0) ||
 		(opcode.dest == GOTO_IF_FALSE && check_data.v.data == 0))
 		bkod = inst_start + dest_addr;
 }
 
-static __inline bool InterpretCall(object_node **o_ptr,int object_id,local_var_type *local_vars,opcode_type opcode)
+static __inline bool InterpretCall(object_node **o_ptr,int object_id,local_var_type *local_vars,opcode_type opcode,
+				   bool checked)
 {
 	parm_node normal_parm_array[MAX_C_PARMS],name_parm_array[MAX_NAME_PARMS];
 	unsigned char info,num_normal_parms,num_name_parms,initial_type;
@@ -1130,7 +1313,7 @@ static __inline bool InterpretCall(object_node **o_ptr,int object_id,local_var_t
 
 	num_normal_parms = get_byte();
 
-	if (num_normal_parms > MAX_C_PARMS)
+	if (checked && num_normal_parms > MAX_C_PARMS)
 	{
 		bprintf("InterpretCall found a call w/ more than %i parms, DEATH\n",
 			MAX_C_PARMS);
@@ -1146,7 +1329,7 @@ static __inline bool InterpretCall(object_node **o_ptr,int object_id,local_var_t
 
 	num_name_parms = get_byte();
 
-	if (num_name_parms > MAX_NAME_PARMS)
+	if (checked && num_name_parms > MAX_NAME_PARMS)
 	{
 		bprintf("InterpretCall found a call w/ more than %i name parms, DEATH\n",
 			MAX_NAME_PARMS);
@@ -1166,7 +1349,7 @@ static __inline bool InterpretCall(object_node **o_ptr,int object_id,local_var_t
 
 		/* maybe only need to do this in call to sendmessage and postmessage? */
 
-		name_val = RetrieveValue(o,local_vars,initial_type,initial_value);
+		name_val = RetrieveValue(o,local_vars,initial_type,initial_value,checked);
 
 		name_parm_array[i].value = name_val.int_val;
 	}
@@ -1189,7 +1372,7 @@ static __inline bool InterpretCall(object_node **o_ptr,int object_id,local_var_t
 		case CALL_ASSIGN_LOCAL_VAR :
 		case CALL_ASSIGN_PROPERTY :
 			/* Use refreshed object pointer to avoid internal GetObjectByID lookup */
-			StoreValue(o,local_vars,opcode.source1,assign_index,call_return);
+			StoreValue(o,local_vars,opcode.source1,assign_index,call_return,checked);
 			break;
 	}
 	return true;
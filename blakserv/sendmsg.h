@@ -32,7 +32,7 @@ typedef struct
 	int message_id;
 	int propagate_depth;
 	int num_parms;
-   parm_node parms[MAX_NAME_PARMS];
+	parm_node *parms;   /* the sender's, which outlive the frame */
 	char *bkod_ptr;
 } kod_stack_type;
 
@@ -52,12 +52,14 @@ typedef struct
    int interpreting_time_object_id;
    int interpreting_time_posts;
    int message_depth_highest;
+   int post_queue_highest;
 
    /* while interpreting stuff, this is valid */
    int interpreting_class;
 
    int debugging;
    int debug_initlocals;
+   int profiling;               /* see profile.c */
 
    /* the number of calls to each C function */
    int c_count[MAX_C_FUNCTION];
@@ -65,25 +67,40 @@ typedef struct
 
 /* stuff for PostMessage queue */
 
-#define MAX_POST_QUEUE 4000
+#define INIT_POST_QUEUE 256
+
+/* parms of posted messages are handed out of chunks of this many; when the
+   queue empties they're all given back but the first */
+#define POST_PARM_CHUNK 1024
 
 typedef struct
 {
    int object_id;
    int message_id;
    int num_parms;
-   parm_node parms[MAX_NAME_PARMS];
+   parm_node *parms;
 } post_node;
 
+typedef struct post_parm_chunk_struct
+{
+   struct post_parm_chunk_struct *next;
+   int used;
+   parm_node parms[POST_PARM_CHUNK];
+} post_parm_chunk;
+
 typedef struct
 {
-   int next;
-   int last;
-   post_node data[MAX_POST_QUEUE];
+   int next;                    /* where the next post goes */
+   int last;                    /* the next post to send */
+   int max;
+   post_node *data;
+   post_parm_chunk *chunks;
+   post_parm_chunk *cur_chunk;
 } post_queue_type;
 
 void InitProfiling(void);
 void InitBkodInterpret(void);
+bool IsCFunction(int function_id);
 
 extern kod_statistics kod_stat;
 __inline kod_statistics * GetKodStats(void) { return &kod_stat; }
@@ -99,9 +116,12 @@ int SendBlakodClassMessage(int class_id,int message_id,int num_params,parm_node
 std::string BlakodDebugInfo(void);
 std::string BlakodStackInfo(void);
 
-/* this function used in sendmsg.c and ccode.c, but called all the time! */
+/* this function used in sendmsg.c and ccode.c, but called all the time!
+ * checked is false when the value comes from a handler VerifyBof has
+ * checked, whose class var indices are known to be in range. */
 
-val_type __inline RetrieveValue(int object_id,local_var_type *local_vars,int data_type,blak_int data)
+val_type __inline RetrieveValue(int object_id,local_var_type *local_vars,int data_type,blak_int data,
+			       bool checked = true)
 {
    object_node *o;
    class_node *c;
@@ -161,7 +181,7 @@ val_type __inline RetrieveValue(int object_id,local_var_type *local_vars,int dat
 	 ret_val.int_val = NIL;
 	 return ret_val;
       }
-      if (data >= c->num_vars || data < 0)
+      if (checked && (data >= c->num_vars || data < 0))
       {
 	 eprintf("[%s] RetrieveValue can't retrieve invalid class var %" PRId64 " in OBJECT %i CLASS %s (%i)\n",
            BlakodDebugInfo().c_str(),data,object_id,c->class_name,c->class_id);
@@ -184,7 +204,8 @@ val_type __inline RetrieveValue(int object_id,local_var_type *local_vars,int dat
    return ret_val;
 }
 
-val_type __inline RetrieveValue(object_node *o,local_var_type *local_vars,int data_type,blak_int data)
+val_type __inline RetrieveValue(object_node *o,local_var_type *local_vars,int data_type,blak_int data,
+			       bool checked = true)
 {
    class_node *c;
    val_type ret_val;
@@ -241,7 +262,7 @@ val_type __inline RetrieveValue(object_node *o,local_var_type *local_vars,int da
 	 ret_val.int_val = NIL;
 	 return ret_val;
       }
-      if (data >= c->num_vars || data < 0)
+      if (checked && (data >= c->num_vars || data < 0))
       {
 	 eprintf("[%s] RetrieveValue can't retrieve invalid class var %" PRId64 " in OBJECT %i CLASS %s (%i)\n",
            BlakodDebugInfo().c_str(),data,o->object_id,c->class_name,c->class_id);
@@ -25,6 +25,10 @@ unsigned char epoch; /* number to send to game clients as 7th byte in message */
 session_node *sessions;
 int num_sessions;
 
+/* ids below num_sessions that aren't connected, as a min-heap, so that new
+   sessions still take the lowest free id and so count as active first */
+static std::vector<int> free_session_ids;
+
 int transmitted_bytes; /* keep a tab on bandwidth use */
 
 Mutex mutex_sessions; /* need to add/remove or search through list of sessions */
@@ -61,6 +65,8 @@ void InitSession()
 		AllocateMemory(MALLOC_ID_SESSION_MODES,ConfigInt(SESSION_MAX_CONNECT)*sizeof(session_node));
 
 	num_sessions = 0;
+	free_session_ids.clear();
+	free_session_ids.reserve(ConfigInt(SESSION_MAX_CONNECT));
 
 	if (sizeof(admin_data) > SESSION_STATE_BYTES)
 		FatalError("sizeof(admin_data) must be <= SESSION_STATE_BYTES");
@@ -118,20 +124,20 @@ session_node *AllocateSession(void)
 {
 	int i;
 
-	for (i=0;i<num_sessions;i++)
+	if (!free_session_ids.empty())
 	{
-		if (sessions[i].connected == false)
-			break;
+		std::pop_heap(free_session_ids.begin(),free_session_ids.end(),std::greater<int>());
+		i = free_session_ids.back();
+		free_session_ids.pop_back();
 	}
-
-	if (i == num_sessions)
+	else
 	{
 	/* if no emptied low number sessions and using every session, can't
 		use them */
 		if (num_sessions == ConfigInt(SESSION_MAX_CONNECT))
 			return NULL;
 
-		num_sessions++;
+		i = num_sessions++;
 	}
 
 	/* we're gonna hang 'em up once synched if too many people on*/
@@ -145,6 +151,8 @@ session_node *AllocateSession(void)
 	sessions[i].exiting_state = false;
 	sessions[i].receive_list = NULL;
 	sessions[i].receive_index = 0;
+	sessions[i].receive_time = 0;
+	sessions[i].input_delay_max = 0;
 	sessions[i].send_list = NULL;
 	sessions[i].version_major = 0;
 	sessions[i].version_minor = 0;
@@ -375,6 +383,8 @@ session_node * CreateSession(connection_node conn)
 
 	/* dprintf("CreateSession making session %i\n",session->session_id); */
 
+	MetricsAdd(METRIC_CONNECTIONS,1);
+
 	InterfaceLogon(session);
 
 	return session;
@@ -463,6 +473,9 @@ void CloseSession(int session_id)
 	s->session_id = -1;
 	s->state = -1;
 
+	free_session_ids.push_back(session_id);
+	std::push_heap(free_session_ids.begin(),free_session_ids.end(),std::greater<int>());
+
 	LeaveSessionLock();
 }
 
@@ -551,7 +564,17 @@ void PollSession(int session_id)
 	*/
 
 	if (s->receive_list != NULL)
+	{
+		if (s->receive_time != 0)
+		{
+			int delay = (int) (GetMicroCount() - s->receive_time);
+			LatencyRecord(LATENCY_INPUT,delay);
+			if (delay > s->input_delay_max)
+				s->input_delay_max = delay;
+			s->receive_time = 0;
+		}
 		ProcessSessionBuffer(s);
+	}
 
 
 	if (!MutexRelease(s->muxReceive))
@@ -853,6 +876,7 @@ void SendBytes(session_node *s,char *buf,int len_buf)
 		else
 		{
 			transmitted_bytes += len_buf;
+			MetricsAdd(METRIC_BYTES_SENT,len_buf);
 		}
 	}
 	else
@@ -1000,6 +1024,7 @@ void SendBufferList(session_node *s,buffer_node *blist)
 			else
 			{
 				transmitted_bytes += blist->len_buf;
+				MetricsAdd(METRIC_BYTES_SENT,blist->len_buf);
 
 				bn = blist->next;
 				DeleteBuffer(blist);
@@ -118,6 +118,8 @@ typedef struct
    /* this protects the list of received data: receive_list, and receive_index */
    buffer_node *receive_list;
    int receive_index; /* index into first buffer of receive_list, of where we are */
+   UINT64 receive_time; /* GetMicroCount() when input arrived that we haven't handled, or 0 */
+   int input_delay_max; /* longest input has waited to be handled, in microseconds */
 
 
    Mutex muxSend;
@@ -13,6 +13,13 @@
  for the Blakod.  It also has a temp string, for things from the
  client like say commands which are not stored by the Blakod.
 
+ When [Memory] InternStrings is on, string data is interned: nodes with
+ the same contents share one reference counted copy, so equal strings
+ also have equal data pointers.  Shared data is never written to; every
+ change to a string node goes through SetString or AdoptString, which
+ drop the node's reference and give it new data.  The temp string is
+ never interned.
+
  */
 
 #include "blakserv.h"
@@ -23,8 +30,14 @@ int num_strings,max_strings;
 /* this is for say commands, which are not saved */
 string_node temp_str;
 
+/* interned string data -> number of string nodes sharing it */
+static std::unordered_map<std::string_view,int> interned_strings;
+static string_intern_stats intern_stats;
+
 /* local function prototypes */
 int AllocateString();
+static void ShareStringData(string_node *snod,const char *buf,int len);
+static void ReleaseStringData(string_node *snod);
 
 void InitString()
 {
@@ -43,7 +56,7 @@ void ResetString()
    int i,old_strings;
 
    for (i=0;i<num_strings;i++)
-      FreeMemory(MALLOC_ID_STRING,strings[i].data,strings[i].len_data);
+      ReleaseStringData(&strings[i]);
 
    old_strings = max_strings;
    num_strings = 0;  
@@ -74,6 +87,8 @@ int AllocateString()
 
    strings[num_strings].data = NULL;
    strings[num_strings].len_data = 0;
+   strings[num_strings].interned = false;
+   strings[num_strings].fuzzy_valid = false;
    
    return num_strings++;
 }
@@ -110,10 +125,7 @@ int CreateStringWithLen(const char *buf,int len)
    string_id = AllocateString();
    snod = GetStringByID(string_id);
 
-   snod->data = (char *)AllocateMemory(MALLOC_ID_STRING,len+1);
-   memcpy(snod->data,buf,len);
-   snod->len_data = len;
-   snod->data[snod->len_data] = '\0';
+   ShareStringData(snod,buf,len);
    
    return string_id;
 }
@@ -132,17 +144,20 @@ bool LoadBlakodString(FILE *f,int len_str,int string_id)
 
    if (len_str != 0)
    {
-      snod->data = (char *)AllocateMemory(MALLOC_ID_STRING,len_str+1);
-      if (!fread(snod->data, 1, len_str, f))
+      char *buf = (char *)AllocatePoolMemory(MALLOC_ID_STRING,len_str+1);
+      if (!fread(buf, 1, len_str, f))
+      {
+         FreePoolMemory(MALLOC_ID_STRING,buf,len_str+1);
          return false;
-      snod->data[len_str] = '\0';
+      }
+      buf[len_str] = '\0';
+      AdoptString(snod,buf,len_str);
    }
    else
    {
       snod->data = NULL;
+      snod->len_data = 0;
    }
-
-   snod->len_data = len_str;
    
    return true;
 }
@@ -166,18 +181,8 @@ void FreeString(int string_id) /* for garbage collection */
       return;
    }
 
-   if (snod->data != NULL)
-   {
-      FreeMemory(MALLOC_ID_STRING,snod->data,snod->len_data+1);
-   }
-   else
-   {
-      /* happens when blank string saved, loaded, then garbage collected */
-      /* eprintf("FreeString can't free NULL string %i\n",string_id); */
-   }
-
-   snod->data = NULL;
-   snod->len_data = 0;
+   /* data is NULL when blank string saved, loaded, then garbage collected */
+   ReleaseStringData(snod);
 }
 
 void MoveStringNode(int dest_id,int source_id) /* for garbage collection */
@@ -209,14 +214,18 @@ void MoveStringNode(int dest_id,int source_id) /* for garbage collection */
    if (dest_id == source_id)
       return;
 
-   if (dest->data != NULL)
-      FreeMemory(MALLOC_ID_STRING,dest->data,dest->len_data+1);
+   ReleaseStringData(dest);
 
    dest->data = source->data;
    dest->len_data = source->len_data;
+   dest->interned = source->interned;
+   dest->fuzzy_valid = source->fuzzy_valid;
+   dest->fuzzy_hash = source->fuzzy_hash;
 
    source->data = NULL;
    source->len_data = 0;
+   source->interned = false;
+   source->fuzzy_valid = false;
 }
 
 void SetNumStrings(int new_num_strings) /* for garbage collecting */
@@ -231,16 +240,143 @@ int GetNumStrings() /* for saving */
 
 void SetString(string_node *snod,char *buf,int len)
 {
+   string_node old;
+
    if (snod == &temp_str)
    {
       SetTempString(buf,len);
       return;
    }
-   FreeMemory(MALLOC_ID_STRING,snod->data,snod->len_data+1);
-   snod->data = (char *)AllocateMemory(MALLOC_ID_STRING,len+1);
-   memcpy(snod->data,buf,len);
+
+   /* buf may be snod's own data, so let go of that only after copying */
+   old = *snod;
+   ShareStringData(snod,buf,len);
+   ReleaseStringData(&old);
+}
+
+/* give snod buf, which the caller got from AllocatePoolMemory with len+1
+ * bytes under MALLOC_ID_STRING and zero-terminated, in place of its
+ * current data */
+void AdoptString(string_node *snod,char *buf,int len)
+{
+   std::string_view key(buf,len);
+
+   ReleaseStringData(snod);
+
+   if (snod != &temp_str && ConfigBool(MEMORY_INTERN_STRINGS))
+   {
+      auto it = interned_strings.find(key);
+      if (it != interned_strings.end())
+      {
+         FreePoolMemory(MALLOC_ID_STRING,buf,len+1);
+         it->second++;
+         intern_stats.references++;
+         intern_stats.bytes_referenced += len;
+         snod->data = (char *) it->first.data();
+         snod->len_data = len;
+         snod->interned = true;
+         return;
+      }
+
+      interned_strings.emplace(key,1);
+      intern_stats.unique++;
+      intern_stats.references++;
+      intern_stats.bytes += len;
+      intern_stats.bytes_referenced += len;
+      snod->interned = true;
+   }
+
+   snod->data = buf;
    snod->len_data = len;
-   snod->data[snod->len_data] = '\0';
+}
+
+/* point snod at a copy of buf, shared with any equal interned string */
+static void ShareStringData(string_node *snod,const char *buf,int len)
+{
+   char *data;
+
+   if (ConfigBool(MEMORY_INTERN_STRINGS))
+   {
+      auto it = interned_strings.find(std::string_view(buf,len));
+      if (it != interned_strings.end())
+      {
+         it->second++;
+         intern_stats.references++;
+         intern_stats.bytes_referenced += len;
+         snod->data = (char *) it->first.data();
+         snod->len_data = len;
+         snod->interned = true;
+         snod->fuzzy_valid = false;
+         return;
+      }
+   }
+
+   data = (char *)AllocatePoolMemory(MALLOC_ID_STRING,len+1);
+   memcpy(data,buf,len);
+   data[len] = '\0';
+
+   snod->data = NULL;
+   snod->len_data = 0;
+   snod->interned = false;
+   AdoptString(snod,data,len);
+}
+
+static void ReleaseStringData(string_node *snod)
+{
+   if (snod->interned)
+   {
+      auto it = interned_strings.find(std::string_view(snod->data,snod->len_data));
+      if (it == interned_strings.end())
+         eprintf("ReleaseStringData can't find interned string %.20s\n",snod->data);
+      else
+      {
+         intern_stats.references--;
+         intern_stats.bytes_referenced -= snod->len_data;
+         if (--it->second == 0)
+         {
+            interned_strings.erase(it);
+            intern_stats.unique--;
+            intern_stats.bytes -= snod->len_data;
+            FreePoolMemory(MALLOC_ID_STRING,snod->data,snod->len_data+1);
+         }
+      }
+   }
+   else if (snod->data != NULL)
+      FreePoolMemory(MALLOC_ID_STRING,snod->data,snod->len_data+1);
+
+   snod->data = NULL;
+   snod->len_data = 0;
+   snod->interned = false;
+   snod->fuzzy_valid = false;
+}
+
+const string_intern_stats * GetStringInternStats(void)
+{
+   return &intern_stats;
+}
+
+/* must be called by anything that changes a string's data in place */
+void InvalidateStringCache(string_node *snod)
+{
+   snod->fuzzy_valid = false;
+}
+
+/* the fuzzy hash of a Blakod string is asked for on every table lookup
+ * keyed by it, so remember it until the string changes */
+unsigned int GetStringFuzzyHash(string_node *snod)
+{
+   const char *s;
+   int len;
+
+   if (!snod->fuzzy_valid)
+   {
+      s = snod->data;
+      len = snod->len_data;
+      FuzzyTrimBuffer(&s,&len);
+      snod->fuzzy_hash = GetBufferHash(s,len);
+      snod->fuzzy_valid = true;
+   }
+   return snod->fuzzy_hash;
 }
 
 void SetTempString(char *buf,int len)
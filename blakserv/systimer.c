@@ -160,6 +160,7 @@ void ProcessOneSysTimer(systimer_node *st)
 
 
       ResetTransmittedBytes();
+      MetricsUpdateRates();
       break;
 
    case SYST_RESET_POOL :
@@ -167,8 +168,7 @@ void ProcessOneSysTimer(systimer_node *st)
       break;
 
    case SYST_REOPEN_CHANNELS :
-      CloseDefaultChannels();
-      OpenDefaultChannels();
+      ReopenDefaultChannels();
       break;
 
    }
@@ -21,8 +21,6 @@
 table_node *tables;
 int next_table_id;
 
-static char buf0[LEN_MAX_CLIENT_MSG+1];
-
 /* local function prototypes */
 
 void FreeTable(table_node *tn);
@@ -129,7 +127,7 @@ void FreeTable(table_node *tn)
       while (hn != NULL)
       {
 	 temp = hn->next;
-	 FreeMemory(MALLOC_ID_TABLE,hn,sizeof(hash_node));
+	 FreePoolMemory(MALLOC_ID_TABLE,hn,sizeof(hash_node));
 	 hn = temp;
       }
    }
@@ -184,7 +182,7 @@ hash_node * AllocateTableEntry(val_type key_val,val_type data_val)
 {
    hash_node *hn;
    
-   hn = (hash_node *)AllocateMemory(MALLOC_ID_TABLE,sizeof(hash_node));
+   hn = (hash_node *)AllocatePoolMemory(MALLOC_ID_TABLE,sizeof(hash_node));
 
    hn->key_val = key_val;
    hn->data_val = data_val;
@@ -268,7 +266,7 @@ void DeleteTableEntry(int table_id,val_type key_val)
    if (EqualTableEntry(tn->table[index]->key_val,key_val))
    {
       hn = tn->table[index]->next;
-      FreeMemory(MALLOC_ID_TABLE,tn->table[index],sizeof(hash_node));
+      FreePoolMemory(MALLOC_ID_TABLE,tn->table[index],sizeof(hash_node));
       tn->table[index] = hn;
       return;
    }
@@ -281,7 +279,7 @@ void DeleteTableEntry(int table_id,val_type key_val)
       {
 	 temp = hn->next;
 	 hn->next = hn->next->next;
-	 FreeMemory(MALLOC_ID_TABLE,temp,sizeof(hash_node));
+	 FreePoolMemory(MALLOC_ID_TABLE,temp,sizeof(hash_node));
 	 return;
       }
       hn = hn->next;
@@ -386,7 +384,7 @@ unsigned int GetTableHash(val_type val)
 {
    resource_node *r;
    string_node *snod;
-   char* s = NULL;
+   const char* s = NULL;
    int len = 0;
 
    switch (val.v.tag)
@@ -411,9 +409,7 @@ unsigned int GetTableHash(val_type val)
 	 eprintf("%s\n",BlakodStackInfo().c_str());
 	 return 0;
       }
-      s = snod->data;
-      len = snod->len_data;
-      break;
+      return GetStringFuzzyHash(snod);
 
    case TAG_TEMP_STRING :
       snod = GetTempString();
@@ -433,9 +429,9 @@ unsigned int GetTableHash(val_type val)
    if (!s || len <= 0)
       return 0;
 
-   FuzzyCollapseString(buf0,s,len);
+   FuzzyTrimBuffer(&s,&len);
 
-   return GetBufferHash(buf0, strlen(buf0));
+   return GetBufferHash(s,len);
 }
 
 unsigned int GetBufferHash(const char *buf, size_t len_buf)
@@ -85,6 +85,7 @@ const char * GetTagName(val_type val)
    case TAG_CLASS : return "CLASS";
    case TAG_MESSAGE : return "MESSAGE";
    case TAG_OVERRIDE : return "OVERRIDE";
+   case TAG_ARRAY : return "ARRAY";
    case TAG_INVALID : return "INVALID";
    default :
       eprintf("GetTagName warning, can't identify tag %i\n",val.v.tag);
@@ -162,6 +163,8 @@ int GetTagNum(const char *tag_str)
       return TAG_TIMER;
    if (ch == 'Q')
       return TAG_TEMP_STRING;
+   if (ch == 'A')
+      return TAG_ARRAY;
 
    if (0 == stricmp(tag_str,"INVALID"))
       return TAG_INVALID;
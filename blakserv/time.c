@@ -146,3 +146,32 @@ UINT64 GetMilliCount()
 #endif
 }
 
+/* Microseconds from an arbitrary start, for timing short intervals.  Unlike
+   GetMilliCount() this never goes backwards when the clock is set. */
+UINT64 GetMicroCount()
+{
+#ifdef BLAK_PLATFORM_WINDOWS
+
+	static LARGE_INTEGER frequency;
+	LARGE_INTEGER now;
+
+	if (frequency.QuadPart == 0)
+		QueryPerformanceFrequency(&frequency);
+
+	if (frequency.QuadPart == 0)
+		return 0;
+
+	QueryPerformanceCounter(&now);
+	return (now.QuadPart/frequency.QuadPart)*1000000 +
+		((now.QuadPart % frequency.QuadPart)*1000000)/frequency.QuadPart;
+
+#else
+
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+
+   return (UINT64) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+
+#endif
+}
+
@@ -59,7 +59,7 @@ void ClearTimer(void)
    {
       temp = t;
       t = t->next;
-      FreeMemory(MALLOC_ID_TIMER,temp,sizeof(timer_node));
+      FreePoolMemory(MALLOC_ID_TIMER,temp,sizeof(timer_node));
    }
    timers = NULL;
    next_timer_num = 0;
@@ -70,7 +70,7 @@ void ClearTimer(void)
    {
       temp = t;
       t = t->next;
-      FreeMemory(MALLOC_ID_TIMER,temp,sizeof(timer_node));
+      FreePoolMemory(MALLOC_ID_TIMER,temp,sizeof(timer_node));
    }
    deleted_timers = NULL;
 }
@@ -157,7 +157,7 @@ int CreateTimer(int object_id,int message_id,int milliseconds)
    timer_node *t;
 
    if (deleted_timers == NULL)
-      t = (timer_node *)AllocateMemory(MALLOC_ID_TIMER,sizeof(timer_node));
+      t = (timer_node *)AllocatePoolMemory(MALLOC_ID_TIMER,sizeof(timer_node));
    else
    {
       /* dprintf("recovering former timer id %i\n",deleted_timers->timer_id); */
@@ -196,7 +196,7 @@ bool LoadTimer(int timer_id,int object_id,char *message_name,INT64 milliseconds)
       return false;
    }
 
-   t = (timer_node *)AllocateMemory(MALLOC_ID_TIMER,sizeof(timer_node));
+   t = (timer_node *)AllocatePoolMemory(MALLOC_ID_TIMER,sizeof(timer_node));
    t->timer_id = timer_id;
    t->object_id = object_id;
    t->message_id = m->message_id;
@@ -293,6 +293,8 @@ void TimerActivate()
 	       (now-timers->time)/1000,(now-timers->time)%1000);
 	*/
 
+      LatencyRecord(LATENCY_TIMER_LATE,(now - timers->time)*1000);
+
       object_id = timers->object_id;
       message_id = timers->message_id;
       
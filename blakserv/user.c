@@ -15,12 +15,24 @@
  Since the objects can change number when garbage collected, there is
  a function the garbage collector calls to change the object number.
 
+ The users are also indexed by object number, and by account number
+ to the account's users in the order they were made, so that looking
+ one up doesn't walk every user ever created.  The list itself is
+ newest first, and is what's saved.
+
  */
 
 #include "blakserv.h"
 
 user_node *users;
 
+static std::unordered_map<int,user_node *> users_by_object;
+static std::unordered_map<int,std::vector<user_node *>> users_by_account;
+
+/* local function prototypes */
+static void InsertUser(user_node *u);
+static void RemoveUser(user_node *u);
+
 void InitUser(void)
 {
    users = NULL;
@@ -43,6 +55,49 @@ void ClearUser(void)
       FreeMemory(MALLOC_ID_USER,temp,sizeof(user_node));
    }
    users = NULL;
+
+   users_by_object.clear();
+   users_by_account.clear();
+}
+
+/* puts u, with its account_id and object_id set, at the front of the list
+   and in the indexes */
+static void InsertUser(user_node *u)
+{
+   u->prev = NULL;
+   u->next = users;
+   if (users != NULL)
+      users->prev = u;
+   users = u;
+
+   users_by_object[u->object_id] = u;
+   users_by_account[u->account_id].push_back(u);
+}
+
+/* takes u out of the list and the indexes, and frees it */
+static void RemoveUser(user_node *u)
+{
+   std::unordered_map<int,std::vector<user_node *>>::iterator it;
+
+   if (u->prev == NULL)
+      users = u->next;
+   else
+      u->prev->next = u->next;
+   if (u->next != NULL)
+      u->next->prev = u->prev;
+
+   users_by_object.erase(u->object_id);
+
+   it = users_by_account.find(u->account_id);
+   if (it != users_by_account.end())
+   {
+      std::vector<user_node *> &account_users = it->second;
+      account_users.erase(std::find(account_users.begin(),account_users.end(),u));
+      if (account_users.empty())
+         users_by_account.erase(it);
+   }
+
+   FreeMemory(MALLOC_ID_USER,u,sizeof(user_node));
 }
 
 user_node * CreateNewUser(int account_id,int class_id)
@@ -75,8 +130,7 @@ user_node * CreateNewUser(int account_id,int class_id)
    
    u->object_id = CreateObject(class_id,2,p);
 
-   u->next = users;
-   users = u;
+   InsertUser(u);
 
    return u;
 }
@@ -109,8 +163,7 @@ user_node * CreateNewUserByName(int account_id,int class_id,char*buf)
    
    u->object_id = CreateObject(class_id,2,p);
 
-   u->next = users;
-   users = u;
+   InsertUser(u);
 
    return u;
 }
@@ -119,20 +172,14 @@ bool AssociateUser(int account_id,int object_id)
 {
    user_node *u;
 
-   u = users;
-   while (u != NULL)
-   {
-      if (u->object_id == object_id)
-        return false;
-      u = u->next;
-   }
+   if (GetUserByObjectID(object_id) != NULL)
+      return false;
 
    u = (user_node *)AllocateMemory(MALLOC_ID_USER,sizeof(user_node));
    u->account_id = account_id;
    u->object_id = object_id;
 
-   u->next = users;
-   users = u;
+   InsertUser(u);
 
    return true;
 }
@@ -142,119 +189,85 @@ void LoadUser(int account_id,int object_id)
    AssociateUser(account_id,object_id);
 }
 
-void ChangeUserObjectID(int new_id,int prev_id)
+/* refuses to give a user another user's object, which would leave that
+   one in the list but not findable by object */
+bool ChangeUserObjectID(int new_id,int prev_id)
 {
-   user_node *u;
+   user_node *u,*owner;
 
-   u = users;
-   while (u != NULL)
+   u = GetUserByObjectID(prev_id);
+   if (u == NULL)
+      return false;
+
+   owner = GetUserByObjectID(new_id);
+   if (owner != NULL && owner != u)
    {
-      if (u->object_id == prev_id)
-	 u->object_id = new_id;
-      u = u->next;
+      eprintf("ChangeUserObjectID can't move account %i's user from OBJECT %i to OBJECT %i, "
+              "which is account %i's\n",u->account_id,prev_id,new_id,owner->account_id);
+      return false;
    }
+
+   users_by_object.erase(prev_id);
+   u->object_id = new_id;
+   users_by_object[new_id] = u;
+   return true;
+}
+
+/* the garbage collector changes every user's object_id at once, then calls
+   this to index them by their new ones */
+void ReindexUserObjectIDs(void)
+{
+   user_node *u;
+
+   users_by_object.clear();
+   for (u = users;u != NULL;u = u->next)
+      users_by_object[u->object_id] = u;
 }
 
 int DeleteUserByAccountID(int account_id)
 {
-   user_node *u,*temp;
+   std::unordered_map<int,std::vector<user_node *>>::iterator it;
    int count;
 
    count = 0;
-   u = users;
-
-   if (u == NULL)
-      return 0;
-
-   /* delete from front of list */
-   while (u->account_id == account_id)
+   while ((it = users_by_account.find(account_id)) != users_by_account.end())
    {
+      RemoveUser(it->second.back());
       count++;
-      temp = u->next;
-      FreeMemory(MALLOC_ID_USER,u,sizeof(user_node));
-      u = temp;
-      users = u;
-   }
-   
-   while (u != NULL)
-   {
-      temp = u->next;
-      if (temp != NULL && temp->account_id == account_id)
-      {
-	 count++;
-	 u->next = temp->next;
-	 FreeMemory(MALLOC_ID_USER,temp,sizeof(user_node));
-      }
-      else
-	 u = u->next;
    }
    return count;
 }
 
 int DeleteUserByObjectID(int object_id)
 {
-   user_node *u,*temp;
-   int count;
-
-   count = 0;
-   u = users;
+   user_node *u;
 
+   u = GetUserByObjectID(object_id);
    if (u == NULL)
       return 0;
 
-   /* delete from front of list */
-   if (u->object_id == object_id)
-   {
-      count++;
-      temp = u->next;
-      FreeMemory(MALLOC_ID_USER,u,sizeof(user_node));
-      u = temp;
-      users = u;
-   }
-   
-   while (u != NULL)
-   {
-      temp = u->next;
-      if (temp != NULL && temp->object_id == object_id)
-      {
-	 count++;
-	 u->next = temp->next;
-	 FreeMemory(MALLOC_ID_USER,temp,sizeof(user_node));
-      }
-      else
-	 u = u->next;
-   }
-   return count;
+   RemoveUser(u);
+   return 1;
 }
 
 int CountUserByAccountID(int account_id)
 {
-   user_node *u;
-   int count;
+   std::unordered_map<int,std::vector<user_node *>>::iterator it;
 
-   count = 0;
-   u = users;
-   while (u != NULL)
-   {
-      if (u->account_id == account_id)
-	 count++;
-      u = u->next;
-   }
-   return count;
+   it = users_by_account.find(account_id);
+   if (it == users_by_account.end())
+      return 0;
+   return (int) it->second.size();
 }
 
 user_node * GetUserByObjectID(int object_id)
 {
-   user_node *u;
+   std::unordered_map<int,user_node *>::iterator it;
 
-   u = users;
-   while (u != NULL)
-   {
-      if (u->object_id == object_id)
-	 return u;
-      u = u->next;
-   }
-   return NULL;
+   it = users_by_object.find(object_id);
+   if (it == users_by_object.end())
+      return NULL;
+   return it->second;
 }
 
 void ForEachUser(void (*callback_func)(user_node *u))
@@ -269,31 +282,38 @@ void ForEachUser(void (*callback_func)(user_node *u))
    }
 }
 
+/* newest first, like the list.  The callbacks send Blakod messages, which
+   can make or delete users, so this goes by object ids taken beforehand. */
 void ForEachUserByAccountID(void (*callback_func)(user_node *u),int account_id)
 {
+   std::unordered_map<int,std::vector<user_node *>>::iterator it;
+   std::vector<int> object_ids;
    user_node *u;
+   int i;
 
-   u = users;
-   while (u != NULL)
+   it = users_by_account.find(account_id);
+   if (it == users_by_account.end())
+      return;
+
+   for (i=(int)it->second.size()-1;i>=0;i--)
+      object_ids.push_back(it->second[i]->object_id);
+
+   for (i=0;i<(int)object_ids.size();i++)
    {
-      if (u->account_id == account_id)
-	 callback_func(u);
-      u = u->next;
+      u = GetUserByObjectID(object_ids[i]);
+      if (u != NULL && u->account_id == account_id)
+         callback_func(u);
    }
 }
 
 user_node * GetFirstUserByAccountID(int account_id)
 {
-   user_node *u;
+   std::unordered_map<int,std::vector<user_node *>>::iterator it;
 
-   u = users;
-   while (u != NULL)
-   {
-      if (u->account_id == account_id)
-	 return u;
-      u = u->next;
-   }
-   return NULL;
+   it = users_by_account.find(account_id);
+   if (it == users_by_account.end())
+      return NULL;
+   return it->second.back();
 }
 
 user_node * GetUserByName(char *username)
@@ -17,6 +17,7 @@ typedef struct user_struct
 {
    int account_id;
    int object_id;
+   struct user_struct *prev;
    struct user_struct *next;
 } user_node;
 
@@ -26,7 +27,8 @@ void ClearUser(void);
 user_node * CreateNewUser(int account_id,int class_id);
 bool AssociateUser(int account_id,int object_id);
 void LoadUser(int account_id,int object_id);
-void ChangeUserObjectID(int new_id,int prev_id);
+bool ChangeUserObjectID(int new_id,int prev_id);
+void ReindexUserObjectIDs(void);
 int DeleteUserByAccountID(int account_id);
 int DeleteUserByObjectID(int object_id);
 int CountUserByAccountID(int account_id);
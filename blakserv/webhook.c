@@ -12,43 +12,86 @@
   Cross-platform webhook message delivery via named pipes (Windows) or FIFOs (Linux/macOS).
   Keeps pipes open for performance instead of opening/closing on every message.
 
+  The game thread only appends messages to a bounded queue.  A writer thread builds
+  the JSON payloads, packs as many as fit in one pipe write, and sends them round-robin
+  across the pipes.  If every pipe is full the batch is kept and retried; if the queue
+  fills up meanwhile the oldest messages are dropped and counted.  A pipe that can't
+  be opened is retried with exponential backoff.
+
 */
 
 #include "blakserv.h"
 #include "json_utils.h"
 #include "webhook_message.h"
 
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
 // Configuration constants
-static const int MAX_WEBHOOK_PIPES = 10;
+static const int WEBHOOK_QUEUE_SIZE = 1000;
+// A FIFO write of up to PIPE_BUF (at least 4096) bytes is atomic, so a batch is never split
+static const size_t WEBHOOK_BATCH_BYTES = 4096;
+static const int WEBHOOK_RETRY_MS = 100;
+static const int WEBHOOK_BACKOFF_MIN_MS = 250;
+static const int WEBHOOK_BACKOFF_MAX_MS = 30000;
+
+typedef std::chrono::steady_clock webhook_clock;
 
-// Global state for persistent pipe connections
+typedef struct
+{
+    std::string message;
+    time_t timestamp;
+    bool trusted_structured_json;
+} webhook_entry;
+
+// Global state for persistent pipe connections, owned by the writer thread
 static bool webhook_initialized = false;
 static char pipe_prefix[64] = "";
 static int last_pipe_index = 0;
 static HANDLE pipe_handles[MAX_WEBHOOK_PIPES];
 static bool pipe_connected[MAX_WEBHOOK_PIPES];
+static webhook_clock::time_point pipe_retry_time[MAX_WEBHOOK_PIPES];
+static int pipe_backoff_ms[MAX_WEBHOOK_PIPES];
+
+// Shared between the game thread and the writer thread, protected by webhook_mutex
+static std::mutex webhook_mutex;
+static std::condition_variable webhook_wakeup;
+static std::deque<webhook_entry> webhook_queue;
+static bool webhook_stopping = false;
+static webhook_stats stats;
+
+static std::thread webhook_thread;
+static bool exit_hook_registered = false;
 
 // Helper functions
 static void generate_pipe_name(int pipe_index, char *buffer, size_t buffer_size);
-static void format_json_message(const char *message, int len, char *output, size_t output_size);
 static HANDLE open_webhook_pipe(const char *pipe_name);
 static bool write_webhook_pipe(HANDLE handle, const char *data, int len, bool *is_permanent_error);
+static void WebhookWriterThread(void);
+static void ShutdownWebhooksAtExit(void);
 
 bool InitWebhooks(void)
 {
-    if (webhook_initialized) {
-        return true;
-    }
-
     // Check if webhooks are enabled in config
     if (!ConfigBool(WEBHOOK_ENABLED)) {
         return true; // Webhooks are disabled, nothing to initialize
     }
 
-    // Store pipe prefix from config
-    const char* config_prefix = ConfigStr(WEBHOOK_PREFIX);
-    if (config_prefix && *config_prefix) {
-        snprintf(pipe_prefix, sizeof(pipe_prefix), "%s_", config_prefix);
+    return StartWebhooks(ConfigStr(WEBHOOK_PREFIX));
+}
+
+bool StartWebhooks(const char *prefix)
+{
+    if (webhook_initialized) {
+        return true;
+    }
+
+    // Store pipe prefix
+    if (prefix && *prefix) {
+        snprintf(pipe_prefix, sizeof(pipe_prefix), "%s_", prefix);
     } else {
         pipe_prefix[0] = '\0';
     }
@@ -57,18 +100,50 @@ bool InitWebhooks(void)
     for (int i = 0; i < MAX_WEBHOOK_PIPES; i++) {
         pipe_handles[i] = INVALID_HANDLE_VALUE;
         pipe_connected[i] = false;
+        pipe_retry_time[i] = webhook_clock::time_point();
+        pipe_backoff_ms[i] = WEBHOOK_BACKOFF_MIN_MS;
+    }
+
+    webhook_queue.clear();
+    webhook_stopping = false;
+    stats = webhook_stats();
+    webhook_thread = std::thread(WebhookWriterThread);
+
+    if (!exit_hook_registered) {
+        atexit(ShutdownWebhooksAtExit);
+        exit_hook_registered = true;
     }
 
     webhook_initialized = true;
     return true;
 }
 
+// exit() with the writer still running, as FatalErrorShow does, would destroy a
+// joinable std::thread and abort; give the queue its last try and stop it instead
+static void ShutdownWebhooksAtExit(void)
+{
+    if (webhook_thread.joinable() && std::this_thread::get_id() == webhook_thread.get_id()) {
+        webhook_thread.detach();
+        return;
+    }
+
+    ShutdownWebhooks();
+}
+
 void ShutdownWebhooks(void)
 {
     if (!IsWebhookEnabled()) {
         return;
     }
 
+    // The writer makes one last attempt at whatever is queued, then exits
+    {
+        std::lock_guard<std::mutex> lock(webhook_mutex);
+        webhook_stopping = true;
+    }
+    webhook_wakeup.notify_one();
+    webhook_thread.join();
+
     // Close all pipe handles
     for (int i = 0; i < MAX_WEBHOOK_PIPES; i++) {
         if (pipe_connected[i] && pipe_handles[i] != INVALID_HANDLE_VALUE) {
@@ -86,59 +161,175 @@ bool IsWebhookEnabled(void)
     return webhook_initialized;
 }
 
+void GetWebhookStats(webhook_stats *ws)
+{
+    std::lock_guard<std::mutex> lock(webhook_mutex);
+    *ws = stats;
+    ws->queued = (int)webhook_queue.size();
+}
+
 static bool SendWebhookMessageInternal(const char* message, int len, bool trusted_structured_json)
 {
     if (!IsWebhookEnabled() || !message || len <= 0) {
         return false;
     }
 
-    // Construct the payload using helper function.
-    std::string input_message(message, len);
-    std::string message_to_send = ConstructWebhookPayload(input_message, time(NULL), trusted_structured_json);
+    webhook_entry entry;
+    entry.message.assign(message, len);
+    entry.timestamp = time(NULL);
+    entry.trusted_structured_json = trusted_structured_json;
+
+    {
+        std::lock_guard<std::mutex> lock(webhook_mutex);
+
+        // Overflow policy: the newest events are the most interesting, so drop the oldest
+        if ((int)webhook_queue.size() >= WEBHOOK_QUEUE_SIZE) {
+            webhook_queue.pop_front();
+            stats.dropped++;
+        }
+        webhook_queue.push_back(std::move(entry));
+        stats.posted++;
+        stats.queued_max = std::max(stats.queued_max, (int)webhook_queue.size());
+    }
+    webhook_wakeup.notify_one();
+
+    return true;
+}
+
+bool SendWebhookMessage(const char* message, int len)
+{
+    return SendWebhookMessageInternal(message, len, false);
+}
+
+bool SendWebhookStructuredMessage(const char* message, int len)
+{
+    return SendWebhookMessageInternal(message, len, true);
+}
+
+/*
+ * WriteWebhookBatch:  Writes one batch to the first pipe in round-robin order that
+ *    takes all of it, connecting pipes whose backoff has expired on the way.
+ *    Returns the pipe index used, or -1 if no pipe could take it.
+ */
+static int WriteWebhookBatch(const std::string &batch)
+{
+    webhook_clock::time_point now = webhook_clock::now();
 
-    // Try to send using round-robin across all pipes
     for (int i = 0; i < MAX_WEBHOOK_PIPES; i++) {
         int pipe_index = (last_pipe_index + i) % MAX_WEBHOOK_PIPES;
-        
-        // Try to connect if not already connected
+
+        // Try to connect if not already connected and not backing off
         if (!pipe_connected[pipe_index]) {
+            if (now < pipe_retry_time[pipe_index]) {
+                continue;
+            }
+
             char pipe_name[128];
             generate_pipe_name(pipe_index + 1, pipe_name, sizeof(pipe_name));
             pipe_handles[pipe_index] = open_webhook_pipe(pipe_name);
-            
-            if (pipe_handles[pipe_index] != INVALID_HANDLE_VALUE) {
-                pipe_connected[pipe_index] = true;
+
+            if (pipe_handles[pipe_index] == INVALID_HANDLE_VALUE) {
+                pipe_retry_time[pipe_index] = now + std::chrono::milliseconds(pipe_backoff_ms[pipe_index]);
+                pipe_backoff_ms[pipe_index] = std::min(pipe_backoff_ms[pipe_index] * 2, WEBHOOK_BACKOFF_MAX_MS);
+                continue;
             }
+
+            pipe_connected[pipe_index] = true;
+            pipe_backoff_ms[pipe_index] = WEBHOOK_BACKOFF_MIN_MS;
+            std::lock_guard<std::mutex> lock(webhook_mutex);
+            stats.pipes[pipe_index].connected = true;
+            stats.pipes[pipe_index].connects++;
         }
-        
-        // Try to send message
-        if (pipe_connected[pipe_index]) {
-            bool is_permanent_error = false;
-            if (write_webhook_pipe(pipe_handles[pipe_index], message_to_send.c_str(), (int)message_to_send.length(), &is_permanent_error)) {
-                last_pipe_index = (pipe_index + 1) % MAX_WEBHOOK_PIPES;
-                return true;
-            }
-            
-            // Write failed - only close pipe if it's a real error (not just buffer full)
-            if (is_permanent_error) {
-                CloseHandle(pipe_handles[pipe_index]);
-                pipe_handles[pipe_index] = INVALID_HANDLE_VALUE;
-                pipe_connected[pipe_index] = false;
-            }
+
+        // Try to send the batch
+        bool is_permanent_error = false;
+        if (write_webhook_pipe(pipe_handles[pipe_index], batch.c_str(), (int)batch.length(), &is_permanent_error)) {
+            last_pipe_index = (pipe_index + 1) % MAX_WEBHOOK_PIPES;
+            return pipe_index;
+        }
+
+        std::lock_guard<std::mutex> lock(webhook_mutex);
+
+        // Write failed - only close pipe if it's a real error (not just buffer full)
+        if (is_permanent_error) {
+            CloseHandle(pipe_handles[pipe_index]);
+            pipe_handles[pipe_index] = INVALID_HANDLE_VALUE;
+            pipe_connected[pipe_index] = false;
+            pipe_retry_time[pipe_index] = now;
+            stats.pipes[pipe_index].connected = false;
+            stats.pipes[pipe_index].disconnects++;
+        } else {
+            stats.pipes[pipe_index].full++;
         }
     }
 
-    return false;
+    return -1;
 }
 
-bool SendWebhookMessage(const char* message, int len)
+static void WebhookWriterThread(void)
 {
-    return SendWebhookMessageInternal(message, len, false);
-}
+    std::deque<webhook_entry> pending;
+    std::string batch;
+    size_t batch_count = 0;
 
-bool SendWebhookStructuredMessage(const char* message, int len)
-{
-    return SendWebhookMessageInternal(message, len, true);
+    std::unique_lock<std::mutex> lock(webhook_mutex);
+    for (;;) {
+        // Take everything queued; the game thread only ever waits for this swap
+        if (pending.empty()) {
+            if (webhook_queue.empty()) {
+                if (webhook_stopping) {
+                    break;
+                }
+                webhook_wakeup.wait(lock);
+                continue;
+            }
+            pending.swap(webhook_queue);
+        }
+        bool stopping = webhook_stopping;
+        lock.unlock();
+
+        // Pack messages into one write, newline terminated so the listener can split them
+        if (batch.empty()) {
+            batch_count = 0;
+            while (batch_count < pending.size()) {
+                const webhook_entry &entry = pending[batch_count];
+                std::string payload = ConstructWebhookPayload(entry.message, entry.timestamp,
+                                                              entry.trusted_structured_json);
+                if (batch_count > 0 && batch.length() + payload.length() + 1 > WEBHOOK_BATCH_BYTES) {
+                    break;
+                }
+                batch += payload;
+                batch += '\n';
+                batch_count++;
+            }
+        }
+
+        int pipe_index = WriteWebhookBatch(batch);
+
+        lock.lock();
+        if (pipe_index >= 0 || stopping) {
+            if (pipe_index >= 0) {
+                stats.pipes[pipe_index].messages += (int)batch_count;
+                stats.pipes[pipe_index].writes++;
+                stats.pipes[pipe_index].bytes += batch.length();
+            } else {
+                stats.undelivered += (int)batch_count;
+            }
+            pending.erase(pending.begin(), pending.begin() + batch_count);
+            batch.clear();
+
+            // Anything taken but not yet written still counts against the queue size
+            while ((int)(pending.size() + webhook_queue.size()) > WEBHOOK_QUEUE_SIZE) {
+                pending.pop_front();
+                stats.dropped++;
+            }
+            continue;
+        }
+
+        // Every pipe is full or unavailable; keep the batch and try again shortly
+        webhook_wakeup.wait_for(lock, std::chrono::milliseconds(WEBHOOK_RETRY_MS),
+                                [] { return webhook_stopping; });
+    }
 }
 
 static void generate_pipe_name(int pipe_index, char *buffer, size_t buffer_size)
@@ -154,7 +345,7 @@ static HANDLE open_webhook_pipe(const char *pipe_name)
 {
 #ifdef BLAK_PLATFORM_WINDOWS
     HANDLE handle = CreateFileA(pipe_name, GENERIC_WRITE, 0, NULL, OPEN_EXISTING, 0, NULL);
-    
+
     if (handle != INVALID_HANDLE_VALUE) {
         // Set pipe to non-blocking mode
         DWORD mode = PIPE_NOWAIT;
@@ -163,7 +354,7 @@ static HANDLE open_webhook_pipe(const char *pipe_name)
             return INVALID_HANDLE_VALUE;
         }
     }
-    
+
     return handle;
 #else
     return open(pipe_name, O_WRONLY | O_NONBLOCK);
@@ -172,8 +363,8 @@ static HANDLE open_webhook_pipe(const char *pipe_name)
 
 /*
  * write_webhook_pipe:  Write data to webhook pipe. Distinguishes temporary errors
- *    (buffer full, partial write) from permanent errors (broken pipe) via 
- *    is_permanent_error output parameter. 
+ *    (buffer full, partial write) from permanent errors (broken pipe) via
+ *    is_permanent_error output parameter.
  *    Returns true if full message sent, false otherwise.
  */
 static bool write_webhook_pipe(HANDLE handle, const char *data, int len, bool *is_permanent_error)
@@ -181,11 +372,11 @@ static bool write_webhook_pipe(HANDLE handle, const char *data, int len, bool *i
 #ifdef BLAK_PLATFORM_WINDOWS
     DWORD bytes_written;
     BOOL success = WriteFile(handle, data, (DWORD)len, &bytes_written, NULL);
-    
+
     if (success && bytes_written == (DWORD)len) {
         return true;
     }
-    
+
     // Check if pipe buffer is full (temporary) vs broken (permanent)
     if (!success) {
         DWORD error = GetLastError();
@@ -198,11 +389,11 @@ static bool write_webhook_pipe(HANDLE handle, const char *data, int len, bool *i
     return false;
 #else
     ssize_t bytes_written = write(handle, data, len);
-    
+
     if (bytes_written == len) {
         return true;
     }
-    
+
     // Check if pipe buffer is full (temporary) vs broken (permanent)
     if (bytes_written == -1) {
         // EAGAIN/EWOULDBLOCK means pipe buffer is full but pipe is still valid
@@ -24,8 +24,12 @@
   - No configuration needed - automatic pipe distribution
 
   PERFORMANCE:
-  - Pipes are connected on-demand and kept open for performance
-  - Non-blocking operations prevent game server blocking
+  - Sending only appends to a bounded in-process queue; the game thread never touches a pipe
+  - A writer thread formats the JSON and packs several messages into each pipe write,
+    one payload per line
+  - Pipes are connected on-demand, kept open, and reconnected with exponential backoff
+  - If the listener falls behind and the queue fills, the oldest messages are dropped
+    and counted ("show webhooks" in the admin console)
 
   PLATFORM SUPPORT:
   - Windows: Named pipes (e.g., \\\\.\\pipe\\m59apiwebhook1)
@@ -36,6 +40,29 @@
 #ifndef _WEBHOOK_H
 #define _WEBHOOK_H
 
+#define MAX_WEBHOOK_PIPES 10
+
+typedef struct
+{
+    bool connected;
+    int connects;        // successful opens, including reconnects
+    int disconnects;     // pipes closed after a broken or partial write
+    int full;            // writes refused because the pipe buffer was full
+    int writes;          // batches written
+    int messages;        // messages delivered
+    INT64 bytes;         // payload bytes delivered
+} webhook_pipe_stats;
+
+typedef struct
+{
+    int queued;          // messages waiting for the writer thread
+    int queued_max;      // high water mark of the queue
+    int posted;          // messages accepted from the game thread
+    int dropped;         // oldest messages discarded because the queue was full
+    int undelivered;     // messages still unsent at shutdown
+    webhook_pipe_stats pipes[MAX_WEBHOOK_PIPES];
+} webhook_stats;
+
 /**
  * Initialize the webhook system.
  * Prepares internal state for message delivery. Pipes are connected lazily on first use.
@@ -47,23 +74,33 @@
  */
 bool InitWebhooks(void);
 
+/**
+ * Start the webhook writer thread without consulting the configuration.
+ * InitWebhooks calls this when [Webhook] Enabled is set.
+ *
+ * @param prefix Pipe name prefix, or NULL/empty for none
+ * @return True if the webhook system is running
+ */
+bool StartWebhooks(const char *prefix);
+
 /**
  * Shutdown the webhook system.
- * Closes all open pipes and cleans up resources.
+ * Makes one last attempt to deliver queued messages, stops the writer thread,
+ * and closes all open pipes.
  * Should be called during server shutdown.
  */
 void ShutdownWebhooks(void);
 
 /**
- * Send a message via webhook pipes.
+ * Queue a message for delivery via webhook pipes.
  * Messages sent through this API are treated as untrusted input and wrapped
  * in JSON with timestamp.
- * Uses round-robin across pipes for load distribution.
- * Non-blocking operation - returns false if no pipes are connected.
+ * The writer thread uses round-robin across pipes for load distribution.
+ * Never blocks on pipe I/O; if the queue is full the oldest message is dropped.
  * 
  * @param message The message content to send (untrusted/plain text)
  * @param len Length of the message
- * @return True if message was sent successfully, false otherwise
+ * @return True if message was queued, false if webhooks are disabled
  */
 bool SendWebhookMessage(const char* message, int len);
 
@@ -73,10 +110,15 @@ bool SendWebhookMessage(const char* message, int len);
  *
  * @param message The structured event JSON payload to send
  * @param len Length of the message
- * @return True if message was sent successfully, false otherwise
+ * @return True if message was queued, false if webhooks are disabled
  */
 bool SendWebhookStructuredMessage(const char* message, int len);
 
 bool IsWebhookEnabled(void);
 
+/**
+ * Copy the current queue and per-pipe delivery counters into ws.
+ */
+void GetWebhookStats(webhook_stats *ws);
+
 #endif /* _WEBHOOK_H */
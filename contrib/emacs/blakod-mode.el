@@ -30,7 +30,7 @@
 (defconst blakod-font-lock-keywords-1
   (list
    '("\\<\\(return\\|include\\|constants\\|resources\\|classvars\\|properties\\|messages\\|propagate\\|if\\|else\\|local\\|and\\|or\\|mod\\|not\\|AND\\|OR\\|MOD\\|NOT\\|while\\|for\\|in\\|break\\|continue\\|is\\)\\>" . font-lock-keyword-face)
-   '("\\<\\(Send\\|Create\\|Cons\\|First\\|Rest\\|Length\\|List\\|Nth\\|SetFirst\\|SetNth\\|DelListElem\\|FindListElem\\|Random\\|AddPacket\\|SendPacket\\|SendCopyPacket\\|ClearPacket\\|Debug\\|GetInactiveTime\\|DumpStack\\|StringEqual\\|StringContain\\|StringSubstitute\\|StringLength\\|StringConsistsOf\\|CreateTimer\\|DeleteTimer\\|IsList\\|IsClass\\|RoomData\\|LoadRoom\\|GetClass\\|GetTime\\|CanMoveInRoom\\|CanMoveInRoomFine\\|SetResource\\|Post\\|Abs\\|Sqrt\\|ParseString\\|CreateTable\\|AddTableEntry\\|GetTableEntry\\|DeleteTableEntry\\|DeleteTable\\|Bound\\|GetTimeRemaining\\|SetString\\|AppendTempString\\|ClearTempString\\|GetTempString\\|CreateString\\|IsObject\\|RecycleUser\\|MinigameNumberToString\\|MinigameStringToNumber\\)\\>" . font-lock-builtin-face)
+   '("\\<\\(Send\\|Create\\|Cons\\|First\\|Rest\\|Length\\|List\\|Nth\\|SetFirst\\|SetNth\\|DelListElem\\|FindListElem\\|Random\\|AddPacket\\|SendPacket\\|SendCopyPacket\\|ClearPacket\\|Debug\\|GetInactiveTime\\|DumpStack\\|StringEqual\\|StringContain\\|StringSubstitute\\|StringLength\\|StringConsistsOf\\|CreateTimer\\|DeleteTimer\\|IsList\\|CreateArray\\|GetArrayElem\\|SetArrayElem\\|ArrayLength\\|IsArray\\|IsClass\\|RoomData\\|LoadRoom\\|GetClass\\|GetTime\\|CanMoveInRoom\\|CanMoveInRoomFine\\|RoomObjectMoved\\|RoomObjectRemoved\\|RoomObjectsInRange\\|RoomObjectsOfClass\\|SetResource\\|Post\\|Abs\\|Sqrt\\|ParseString\\|CreateTable\\|AddTableEntry\\|GetTableEntry\\|DeleteTableEntry\\|DeleteTable\\|Bound\\|GetTimeRemaining\\|SetString\\|AppendTempString\\|ClearTempString\\|GetTempString\\|CreateString\\|IsObject\\|RecycleUser\\|MinigameNumberToString\\|MinigameStringToNumber\\)\\>" . font-lock-builtin-face)
    '("\\<\\(\\$\\|-?[0-9]+\\|0x[0-9a-fA-f]+\\)\\>" . font-lock-constant-face)
    '("\\('\\w*'\\)" . font-lock-variable-name-face))
   "Minimal highlighting expressions for Blakod mode")
@@ -145,6 +145,10 @@ enum
    CANMOVEINROOM = 64,
    CANMOVEINROOMFINE = 65,
    POINTINSECTOR = 66,
+   ROOMOBJECTMOVED = 67,
+   ROOMOBJECTREMOVED = 68,
+   ROOMOBJECTSINRANGE = 69,
+   ROOMOBJECTSOFCLASS = 70,
 
    MINIGAMENUMBERTOSTRING = 71,
    MINIGAMESTRINGTONUMBER = 72,
@@ -162,6 +166,12 @@ enum
    FINDLISTELEM = 111,
    MOVELISTELEM = 112,
 
+   CREATEARRAY = 113,
+   GETARRAYELEM = 114,
+   SETARRAYELEM = 115,
+   ARRAYLENGTH = 116,
+   ISARRAY = 117,
+
    GETTIME = 120,
 
    ABS = 131,
@@ -199,7 +209,7 @@ enum
    TAG_MESSAGE = 11,
    TAG_DEBUGSTR = 12,
    TAG_OVERRIDE = 13,     // For overriding a class variable with a property
-   TAG_RESERVED = 14,     // Reserved for future expansion
+   TAG_ARRAY = 14,
    TAG_INVALID = 15,
 };
 
@@ -0,0 +1,636 @@
+// Blakod micro-benchmarks.
+//
+// Runs the real interpreter, object, list, array, table, string, room,
+// garbage collection, memory pool, user and block list code, built
+// optimized and with no sockets, on the classes in bench/bench.kod, and
+// writes a JSON report of how long each workload took.
+// The workloads are deterministic: each reports the number of Blakod
+// instructions it ran and a checksum of its results, which must be the
+// same from run to run and only change when the workload or the
+// interpreter's behavior does.  Compare reports from two commits to see
+// what a change did to speed.
+//
+// Usage: bench_blakod [-d kod_dir] [-r rooms_dir] [-o report] [-n reps]
+//                     [-g heap_nodes] [workload ...]
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "../blakserv/blakserv.h"
+
+// config.c uses this to load blakserv.cfg, but doesn't export it; the
+// benchmark sets its paths the same way, before the defaults go in.
+const char *AddConfig(int config_id, const char *config_data, int config_type, int is_dynamic);
+
+// The server's main.c isn't linked in; these stand in for what it defines.
+DWORD main_thread_id;
+bool InMainLoop(void) { return false; }
+void MainExitServer(void) { }
+
+typedef std::chrono::steady_clock bench_clock;
+
+// Nodes added to the heap by each BuildHeap send, to stay well under
+// BLAKOD_MAX_STATEMENTS.
+#define BENCH_HEAP_CHUNK 200000
+
+// Blocks live at once in the alloc_pool and alloc_malloc workloads.
+#define BENCH_ALLOC_BLOCKS 2000000
+
+// Users registered for the user_lookup workload, which looks up this many
+// of them, and the ids they're given.
+#define BENCH_USERS 200000
+#define BENCH_USER_LOOKUPS 20000
+#define BENCH_USER_ACCOUNT 1000000
+#define BENCH_USER_OBJECT 10000000
+
+// Addresses banned for the block_check workload, and how many it checks.
+#define BENCH_BLOCKS 50000
+#define BENCH_BLOCK_CHECKS 200000
+
+typedef struct
+{
+    const char *name;
+    const char *message;   // sent to the system object with #count
+    int count;             // units of work per send
+    int sends;             // sends per repetition
+} bench_workload;
+
+static const bench_workload workloads[] =
+{
+    { "send_storm",      "SendStorm",      100000, 10 },
+    { "post_storm",      "PostStorm",       20000, 10 },
+    { "propagate_chain", "PropagateChain",  20000, 10 },
+    { "is_class",        "IsClassWork",    100000, 10 },
+    { "create_object",   "CreateWork",      20000, 10 },
+    { "list",            "ListWork",        20000, 20 },
+    { "array",           "ArrayWork",       20000, 20 },
+    { "table",           "TableWork",       20000, 10 },
+    { "string",          "StringWork",      20000, 10 },
+    { "can_move_sweep",  "MoveSweep",       50000, 10 },
+};
+#define NUM_WORKLOADS (int)(sizeof(workloads) / sizeof(workloads[0]))
+
+typedef struct
+{
+    std::string name;
+    INT64 ops;
+    INT64 instructions;
+    INT64 checksum;
+    std::vector<double> seconds;  // one per repetition
+} bench_result;
+
+static int system_id;
+static int count_id;
+static INT64 user_choice_sum;
+
+static INT64 GetInstructionCount(void)
+{
+    return (INT64) kod_stat.billions_interpreted * 1000000000 + kod_stat.num_interpreted;
+}
+
+static bool SetPath(int config_id, const char *path)
+{
+    const char *error = AddConfig(config_id, path, CONFIG_PATH, false);
+
+    if (error != NULL)
+    {
+        fprintf(stderr, "bench_blakod: %s: %s\n", path, error);
+        return false;
+    }
+    return true;
+}
+
+// Sends message to the system object with #count=count and returns the
+// integer it answers.
+static INT64 SendBench(int message_id, int count)
+{
+    parm_node parm;
+    val_type val;
+
+    val.v.tag = TAG_INT;
+    val.v.data = count;
+    parm.type = CONSTANT;
+    parm.value = val.int_val;
+    parm.name_id = count_id;
+
+    val.int_val = SendTopLevelBlakodMessage(system_id, message_id, count > 0 ? 1 : 0, &parm);
+    return val.v.tag == TAG_INT ? val.v.data : 0;
+}
+
+static int GetMessageID(const char *name)
+{
+    int id = GetIDByName(name);
+
+    if (id == INVALID_ID)
+        fprintf(stderr, "bench_blakod: no message %s in the kodbase\n", name);
+    return id;
+}
+
+static bool RunWorkload(const bench_workload *w, int reps, bench_result *r)
+{
+    int message_id, rep, i;
+    INT64 checksum, start_insts;
+    bench_clock::time_point start;
+
+    message_id = GetMessageID(w->message);
+    if (message_id == INVALID_ID)
+        return false;
+
+    r->name = w->name;
+    r->ops = (INT64) w->count * w->sends;
+
+    // The first repetition warms the caches and isn't timed
+    for (rep = -1; rep < reps; rep++)
+    {
+        checksum = 0;
+        start_insts = GetInstructionCount();
+        start = bench_clock::now();
+        for (i = 0; i < w->sends; i++)
+            checksum += SendBench(message_id, w->count);
+        if (rep >= 0)
+            r->seconds.push_back(std::chrono::duration<double>(bench_clock::now() - start).count());
+
+        if (rep > -1 && (checksum != r->checksum ||
+                         GetInstructionCount() - start_insts != r->instructions))
+        {
+            fprintf(stderr, "bench_blakod: %s gave different results on repetition %d\n",
+                    w->name, rep + 1);
+            return false;
+        }
+        r->checksum = checksum;
+        r->instructions = GetInstructionCount() - start_insts;
+    }
+    return true;
+}
+
+// Times GarbageCollect on a heap of about heap_nodes list nodes, half of
+// them reachable from the system object.
+static bool RunGarbageCollect(int heap_nodes, int reps, bench_result *r)
+{
+    int build_id, clear_id, rep, built;
+    INT64 live;
+    bench_clock::time_point start;
+
+    build_id = GetMessageID("BuildHeap");
+    clear_id = GetMessageID("ClearHeap");
+    if (build_id == INVALID_ID || clear_id == INVALID_ID)
+        return false;
+
+    r->name = "garbage_collect";
+    r->instructions = 0;
+
+    for (rep = -1; rep < reps; rep++)
+    {
+        SendBench(clear_id, 0);
+        GarbageCollect();
+
+        for (built = 0; built < heap_nodes; built += BENCH_HEAP_CHUNK)
+            SendBench(build_id, std::min(BENCH_HEAP_CHUNK, heap_nodes - built));
+        r->ops = GetListNodesUsed();
+
+        start = bench_clock::now();
+        GarbageCollect();
+        if (rep >= 0)
+            r->seconds.push_back(std::chrono::duration<double>(bench_clock::now() - start).count());
+
+        live = GetListNodesUsed();
+        if (rep > -1 && live != r->checksum)
+        {
+            fprintf(stderr, "bench_blakod: garbage_collect kept %lld nodes, not %lld\n",
+                    (long long) live, (long long) r->checksum);
+            return false;
+        }
+        r->checksum = live;
+    }
+
+    SendBench(clear_id, 0);
+    GarbageCollect();
+    return true;
+}
+
+// Blocks of the sizes the server gets from its pools: timers, table
+// entries, buffer nodes and string data of a few lengths.
+static const struct
+{
+    int malloc_id;
+    size_t size;
+} alloc_blocks[] =
+{
+    { MALLOC_ID_TIMER, sizeof(timer_node) },
+    { MALLOC_ID_TABLE, sizeof(hash_node) },
+    { MALLOC_ID_STRING, 9 },
+    { MALLOC_ID_TABLE, sizeof(hash_node) },
+    { MALLOC_ID_STRING, 25 },
+    { MALLOC_ID_BUFFER, sizeof(buffer_node) },
+    { MALLOC_ID_STRING, 60 },
+    { MALLOC_ID_STRING, 130 },
+};
+#define NUM_ALLOC_BLOCKS (int)(sizeof(alloc_blocks) / sizeof(alloc_blocks[0]))
+
+// Allocates count blocks, frees every other one and allocates it again,
+// then frees them all, through AllocatePoolMemory or, to compare, plain
+// AllocateMemory.  Run one of these alone under a tool that reports peak
+// RSS to compare memory use too.
+static bool RunAllocate(const char *name, bool pooled, int count, int reps, bench_result *r)
+{
+    std::vector<void *> blocks(count);
+    bench_clock::time_point start;
+    INT64 checksum;
+    int rep, i, b;
+
+    r->name = name;
+    r->ops = (INT64) count * 4;
+    r->instructions = 0;
+
+    for (rep = -1; rep < reps; rep++)
+    {
+        checksum = 0;
+        start = bench_clock::now();
+        for (i = 0; i < count; i++)
+        {
+            b = i % NUM_ALLOC_BLOCKS;
+            blocks[i] = pooled ? AllocatePoolMemory(alloc_blocks[b].malloc_id, alloc_blocks[b].size)
+                : AllocateMemory(alloc_blocks[b].malloc_id, alloc_blocks[b].size);
+            checksum += alloc_blocks[b].size;
+        }
+        for (i = 0; i < count; i += 2)
+        {
+            b = i % NUM_ALLOC_BLOCKS;
+            if (pooled)
+            {
+                FreePoolMemory(alloc_blocks[b].malloc_id, blocks[i], alloc_blocks[b].size);
+                blocks[i] = AllocatePoolMemory(alloc_blocks[b].malloc_id, alloc_blocks[b].size);
+            }
+            else
+            {
+                FreeMemory(alloc_blocks[b].malloc_id, blocks[i], alloc_blocks[b].size);
+                blocks[i] = AllocateMemory(alloc_blocks[b].malloc_id, alloc_blocks[b].size);
+            }
+        }
+        for (i = 0; i < count; i++)
+        {
+            b = i % NUM_ALLOC_BLOCKS;
+            if (pooled)
+                FreePoolMemory(alloc_blocks[b].malloc_id, blocks[i], alloc_blocks[b].size);
+            else
+                FreeMemory(alloc_blocks[b].malloc_id, blocks[i], alloc_blocks[b].size);
+        }
+        if (rep >= 0)
+            r->seconds.push_back(std::chrono::duration<double>(bench_clock::now() - start).count());
+        r->checksum = checksum;
+    }
+    return true;
+}
+
+static void CountUserChoice(user_node *u)
+{
+    user_choice_sum += u->object_id;
+}
+
+// Registers BENCH_USERS users, four to an account, then does count of
+// what logging in and picking a character looks them up with: the
+// account's user count, its users, and one user by object.
+static bool RunUserLookup(int count, int reps, bench_result *r)
+{
+    bench_clock::time_point start;
+    user_node *u;
+    int rep, i, account_id;
+
+    r->name = "user_lookup";
+    r->ops = count;
+    r->instructions = 0;
+
+    for (i = 0; i < BENCH_USERS; i++)
+        AssociateUser(BENCH_USER_ACCOUNT + i / 4, BENCH_USER_OBJECT + i);
+
+    for (rep = -1; rep < reps; rep++)
+    {
+        user_choice_sum = 0;
+        start = bench_clock::now();
+        for (i = 0; i < count; i++)
+        {
+            account_id = BENCH_USER_ACCOUNT + (int) ((i * 7919LL) % (BENCH_USERS / 4));
+            user_choice_sum += CountUserByAccountID(account_id);
+            ForEachUserByAccountID(CountUserChoice, account_id);
+            u = GetUserByObjectID(BENCH_USER_OBJECT + (account_id - BENCH_USER_ACCOUNT) * 4 + i % 4);
+            if (u == NULL || u->account_id != account_id)
+            {
+                fprintf(stderr, "bench_blakod: user_lookup found the wrong user\n");
+                return false;
+            }
+        }
+        if (rep >= 0)
+            r->seconds.push_back(std::chrono::duration<double>(bench_clock::now() - start).count());
+        r->checksum = user_choice_sum;
+    }
+
+    ClearUser();
+    return true;
+}
+
+// Bans BENCH_BLOCKS addresses, half of them for an hour as a hangup does
+// and half for good as banned.txt does, then checks count addresses the
+// way each accepted connection is, one in eight of them banned.
+static bool RunBlockCheck(int count, int reps, bench_result *r)
+{
+    bench_clock::time_point start;
+    struct in_addr addr;
+    INT64 blocked;
+    int rep, i;
+
+    r->name = "block_check";
+    r->ops = count;
+    r->instructions = 0;
+
+    for (i = 0; i < BENCH_BLOCKS; i++)
+    {
+        addr.s_addr = htonl(0x0a000000 + (unsigned int) i * 8 * 2654435761u % 0x01000000);
+        AddBlock(i % 2 == 0 ? 3600 : -1, &addr);
+    }
+
+    for (rep = -1; rep < reps; rep++)
+    {
+        blocked = 0;
+        start = bench_clock::now();
+        for (i = 0; i < count; i++)
+        {
+            addr.s_addr = htonl(0x0a000000 + (unsigned int) (i % BENCH_BLOCKS) * 2654435761u % 0x01000000);
+            if (!CheckBlockList(&addr))
+                blocked++;
+        }
+        if (rep >= 0)
+            r->seconds.push_back(std::chrono::duration<double>(bench_clock::now() - start).count());
+        r->checksum = blocked;
+    }
+
+    DeleteAllBlocks();
+    return true;
+}
+
+static double Median(std::vector<double> v)
+{
+    std::sort(v.begin(), v.end());
+    if (v.empty())
+        return 0.0;
+    if (v.size() % 2 == 1)
+        return v[v.size() / 2];
+    return (v[v.size() / 2 - 1] + v[v.size() / 2]) / 2.0;
+}
+
+// Keys are always written in the same order, one result per line, so that
+// reports diff cleanly.
+static void WriteReport(FILE *f, const std::vector<bench_result> &results, int reps)
+{
+    size_t i;
+
+    fprintf(f, "{\n");
+    fprintf(f, "  \"benchmark\": \"blakod\",\n");
+    fprintf(f, "  \"version\": 1,\n");
+    fprintf(f, "  \"repetitions\": %d,\n", reps);
+    fprintf(f, "  \"results\": [\n");
+    for (i = 0; i < results.size(); i++)
+    {
+        const bench_result &r = results[i];
+        double median = Median(r.seconds);
+        double best = *std::min_element(r.seconds.begin(), r.seconds.end());
+
+        fprintf(f, "    {\"name\": \"%s\", \"ops\": %lld, \"instructions\": %lld, "
+                "\"checksum\": %lld, \"median_ns_per_op\": %.2f, \"min_ns_per_op\": %.2f, "
+                "\"median_seconds\": %.6f}%s\n",
+                r.name.c_str(), (long long) r.ops, (long long) r.instructions,
+                (long long) r.checksum, median * 1e9 / r.ops, best * 1e9 / r.ops,
+                median, i + 1 < results.size() ? "," : "");
+    }
+    fprintf(f, "  ]\n");
+    fprintf(f, "}\n");
+}
+
+static bool Wanted(const char *name, int argc, char **argv, int first)
+{
+    int i;
+
+    if (first >= argc)
+        return true;
+    for (i = first; i < argc; i++)
+        if (!strcmp(argv[i], name))
+            return true;
+    return false;
+}
+
+static const char *other_workloads[] =
+{
+    "garbage_collect", "alloc_pool", "alloc_malloc", "user_lookup", "block_check",
+};
+#define NUM_OTHER_WORKLOADS (int)(sizeof(other_workloads) / sizeof(other_workloads[0]))
+
+static bool IsWorkload(const char *name)
+{
+    int i;
+
+    for (i = 0; i < NUM_WORKLOADS; i++)
+        if (!strcmp(workloads[i].name, name))
+            return true;
+    for (i = 0; i < NUM_OTHER_WORKLOADS; i++)
+        if (!strcmp(other_workloads[i], name))
+            return true;
+    return false;
+}
+
+static void Usage(void)
+{
+    int i;
+
+    fprintf(stderr, "Usage: bench_blakod [-d kod_dir] [-r rooms_dir] [-o report] [-n reps]\n"
+            "                    [-g heap_nodes] [workload ...]\n");
+    fprintf(stderr, "Workloads:");
+    for (i = 0; i < NUM_OTHER_WORKLOADS; i++)
+        fprintf(stderr, " %s", other_workloads[i]);
+    for (i = 0; i < NUM_WORKLOADS; i++)
+        fprintf(stderr, " %s", workloads[i].name);
+    fprintf(stderr, "\n");
+    exit(1);
+}
+
+// Everything between opening the channels and closing them; returns the
+// exit code, so that main closes them whatever happens.
+static int RunBenchmarks(const char *kod_dir, const char *rooms_dir, const char *report,
+                         int reps, int heap_nodes, int argc, char **argv, int first)
+{
+    std::vector<bench_result> results;
+    FILE *f;
+    int i;
+
+    InitClass();
+    InitMessage();
+    InitObject();
+    InitList();
+    InitArray();
+    InitTimer();
+    InitSession();
+    InitResource();
+    InitRoomData();
+    InitString();
+    InitUser();
+    InitAccount();
+    InitNameID();
+    InitLoadBof();
+    InitTime();
+    InitLatency();
+    InitMetrics();
+    InitBkodInterpret();
+    InitBufferPool();
+    InitTable();
+
+    LoadBof();
+    LoadRsc();
+    LoadKodbase();
+
+    if (GetClassByID(SYSTEM_CLASS) == NULL)
+    {
+        fprintf(stderr, "bench_blakod: no system class in %s; build it with make bench\n", kod_dir);
+        return 1;
+    }
+
+    count_id = GetIDByName("count");
+    system_id = CreateObject(SYSTEM_CLASS, 0, NULL);
+    SetSystemObjectID(system_id);
+
+    for (i = 0; i < NUM_WORKLOADS; i++)
+    {
+        bench_result r;
+
+        if (!Wanted(workloads[i].name, argc, argv, first))
+            continue;
+        if (!strcmp(workloads[i].message, "MoveSweep") &&
+            SendBench(GetMessageID("HasRoom"), 0) == 0)
+        {
+            fprintf(stderr, "bench_blakod: skipping %s; no room file in %s\n",
+                    workloads[i].name, rooms_dir);
+            continue;
+        }
+        if (!RunWorkload(&workloads[i], reps, &r))
+            return 1;
+        results.push_back(r);
+        printf("%-16s %10.2f ns/op  %12lld instructions\n", r.name.c_str(),
+               Median(r.seconds) * 1e9 / r.ops, (long long) r.instructions);
+    }
+
+    if (Wanted("garbage_collect", argc, argv, first))
+    {
+        bench_result r;
+
+        if (!RunGarbageCollect(heap_nodes, reps, &r))
+            return 1;
+        results.push_back(r);
+        printf("%-16s %10.2f ns/node  %lld nodes\n", r.name.c_str(),
+               Median(r.seconds) * 1e9 / r.ops, (long long) r.ops);
+    }
+
+    for (i = 0; i < 2; i++)
+    {
+        const char *name = i == 0 ? "alloc_pool" : "alloc_malloc";
+        bench_result r;
+
+        if (!Wanted(name, argc, argv, first))
+            continue;
+        RunAllocate(name, i == 0, BENCH_ALLOC_BLOCKS, reps, &r);
+        results.push_back(r);
+        printf("%-16s %10.2f ns/op\n", r.name.c_str(), Median(r.seconds) * 1e9 / r.ops);
+    }
+
+    if (Wanted("user_lookup", argc, argv, first))
+    {
+        bench_result r;
+
+        if (!RunUserLookup(BENCH_USER_LOOKUPS, reps, &r))
+            return 1;
+        results.push_back(r);
+        printf("%-16s %10.2f ns/op\n", r.name.c_str(), Median(r.seconds) * 1e9 / r.ops);
+    }
+
+    if (Wanted("block_check", argc, argv, first))
+    {
+        bench_result r;
+
+        RunBlockCheck(BENCH_BLOCK_CHECKS, reps, &r);
+        results.push_back(r);
+        printf("%-16s %10.2f ns/op\n", r.name.c_str(), Median(r.seconds) * 1e9 / r.ops);
+    }
+
+    // Only the skipped room workload can leave this empty
+    if (results.empty())
+    {
+        fprintf(stderr, "bench_blakod: no workloads ran\n");
+        return 1;
+    }
+
+    if ((f = fopen(report, "w")) == NULL)
+    {
+        fprintf(stderr, "bench_blakod: can't write %s\n", report);
+        return 1;
+    }
+    WriteReport(f, results, reps);
+    fclose(f);
+    printf("Wrote %s\n", report);
+
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    const char *kod_dir = "bench_build";
+    const char *rooms_dir = "../resource/rooms";
+    const char *report = "bench_blakod.json";
+    int reps = 5, heap_nodes = 2000000;
+    int i, first, rc;
+
+    for (first = 1; first < argc && argv[first][0] == '-'; first += 2)
+    {
+        if (first + 1 >= argc)
+            Usage();
+        switch (argv[first][1])
+        {
+        case 'd': kod_dir = argv[first + 1]; break;
+        case 'r': rooms_dir = argv[first + 1]; break;
+        case 'o': report = argv[first + 1]; break;
+        case 'n': reps = atoi(argv[first + 1]); break;
+        case 'g': heap_nodes = atoi(argv[first + 1]); break;
+        default: Usage();
+        }
+    }
+    if (reps < 1 || heap_nodes < 1)
+        Usage();
+    for (i = first; i < argc; i++)
+    {
+        if (!IsWorkload(argv[i]))
+        {
+            fprintf(stderr, "bench_blakod: no workload %s\n", argv[i]);
+            Usage();
+        }
+    }
+
+    // The same start up as MainServer, less the parts that talk to the
+    // outside world.  LoadBof moves new .bof files from PATH_BOF to
+    // PATH_MEMMAP, so with both the same it just loads them.  The channel
+    // buffer comes first: once InitMemory has zeroed the counts, static
+    // objects' destructors complain through eprintf if we return early.
+    InitChannelBuffer();
+    InitMemory();
+    InitConfig();
+    if (!SetPath(PATH_BOF, kod_dir) || !SetPath(PATH_MEMMAP, kod_dir) ||
+        !SetPath(PATH_RSC, kod_dir) || !SetPath(PATH_KODBASE, kod_dir) ||
+        !SetPath(PATH_ROOMS, rooms_dir) || !SetPath(PATH_CHANNEL, kod_dir))
+        return 1;
+    LoadConfig();
+
+    // Blakod errors go to the usual channel files, in kod_dir
+    OpenDefaultChannels();
+
+    rc = RunBenchmarks(kod_dir, rooms_dir, report, reps, heap_nodes, argc, argv, first);
+
+    CloseDefaultChannels();
+
+    return rc;
+}
@@ -0,0 +1,287 @@
+#include <set>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "test_framework.h"
+#include "../blakserv/blakserv.h"
+
+static val_type MakeVal(int tag, int data)
+{
+    val_type val;
+
+    val.int_val = NIL;
+    val.v.tag = tag;
+    val.v.data = data;
+    return val;
+}
+
+static val_type NilVal(void)
+{
+    val_type val;
+
+    val.int_val = NIL;
+    return val;
+}
+
+// The system object's plHeap, which the tests hang what they keep from
+static val_type *GetHeap(void)
+{
+    object_node *o = GetObjectByID(GetSystemObjectID());
+
+    return &o->p[GetPropertyIDByName(o->class_ptr, "plHeap")].val;
+}
+
+static int CreateTarget(int hits)
+{
+    int object_id = CreateObject(GetClassByName("BenchTarget")->class_id, 0, NULL);
+    object_node *o = GetObjectByID(object_id);
+
+    o->p[GetPropertyIDByName(o->class_ptr, "piHits")].val = MakeVal(TAG_INT, hits);
+    return object_id;
+}
+
+// What val holds, written out without any of the ids that garbage
+// collection or loading can change.  An array that holds itself, through
+// however many others, is written "up" the second time.
+static std::string Describe(val_type val, std::set<int> &open)
+{
+    std::string s;
+    object_node *o;
+    array_node *a;
+    int prop_id;
+
+    switch (val.v.tag)
+    {
+    case TAG_NIL:
+        return "$";
+    case TAG_INT:
+        return std::to_string(val.v.data);
+    case TAG_OBJECT:
+        o = GetObjectByID(val.v.data);
+        if (o == NULL)
+            return "no object";
+        s = o->class_ptr->class_name;
+        prop_id = GetPropertyIDByName(o->class_ptr, "piHits");
+        if (prop_id != INVALID_PROPERTY)
+        {
+            s += ":";
+            s += Describe(o->p[prop_id].val, open);
+        }
+        return s;
+    case TAG_LIST:
+        s += '(';
+        while (val.v.tag == TAG_LIST)
+        {
+            list_node *l = GetListNodeByID(val.v.data);
+            if (l == NULL)
+                return "no list";
+            s += Describe(l->first, open) + " ";
+            val = l->rest;
+        }
+        return s + ")";
+    case TAG_ARRAY:
+        a = GetArrayByID(val.v.data);
+        if (a == NULL || a->elems == NULL)
+            return "no array";
+        if (!open.insert(val.v.data).second)
+            return "up";
+        s += '[';
+        for (int i = 0; i < a->length; i++)
+            s += Describe(a->elems[i], open) + " ";
+        open.erase(val.v.data);
+        return s + "]";
+    default:
+        return "tag " + std::to_string(val.v.tag);
+    }
+}
+
+static std::string Describe(val_type val)
+{
+    std::set<int> open;
+
+    return Describe(val, open);
+}
+
+// The ids of the arrays val holds, however deep
+static void CollectArrays(val_type val, std::set<int> &ids)
+{
+    if (val.v.tag == TAG_LIST)
+    {
+        for (; val.v.tag == TAG_LIST; val = GetListNodeByID(val.v.data)->rest)
+            CollectArrays(GetListNodeByID(val.v.data)->first, ids);
+    }
+    else if (val.v.tag == TAG_ARRAY && ids.insert(val.v.data).second)
+    {
+        array_node *a = GetArrayByID(val.v.data);
+        for (int i = 0; i < a->length; i++)
+            CollectArrays(a->elems[i], ids);
+    }
+}
+
+// Makes count arrays of one to five elements, a third of them kept, holding
+// numbers, objects, lists, arrays of their own that lead back to them and
+// one array they all share.  The rest are garbage that hold objects, lists and arrays too.
+// Returns the heap, a list of an array of the kept arrays and the shared
+// one, which it also puts in plHeap.
+static val_type BuildArrayHeap(int count)
+{
+    std::vector<int> kept;
+    int shared, i, n, array_id, inner, list_id;
+
+    shared = CreateArray(2);
+    SetArrayElem(shared, 1, MakeVal(TAG_INT, -7));
+    SetArrayElem(shared, 2, MakeVal(TAG_OBJECT, CreateTarget(-7)));
+
+    for (i = 0; i < count; i++)
+    {
+        array_id = CreateArray(1 + i % 5);
+        list_id = Cons(MakeVal(TAG_INT, i), MakeVal(TAG_ARRAY, shared));
+        inner = CreateArray(1);
+        SetArrayElem(inner, 1, MakeVal(TAG_LIST, Cons(MakeVal(TAG_ARRAY, array_id), NilVal())));
+
+        for (n = 1; n <= 1 + i % 5; n++)
+        {
+            switch (n)
+            {
+            case 1: SetArrayElem(array_id, n, MakeVal(TAG_INT, i)); break;
+            case 2: SetArrayElem(array_id, n, MakeVal(TAG_OBJECT, CreateTarget(i))); break;
+            case 3: SetArrayElem(array_id, n, MakeVal(TAG_LIST, list_id)); break;
+            case 4: SetArrayElem(array_id, n, MakeVal(TAG_ARRAY, inner)); break;
+            case 5: SetArrayElem(array_id, n, MakeVal(TAG_ARRAY, shared)); break;
+            }
+        }
+        if (i % 3 == 0)
+            kept.push_back(array_id);
+    }
+
+    array_id = CreateArray((int) kept.size());
+    for (i = 0; i < (int) kept.size(); i++)
+        SetArrayElem(array_id, i + 1, MakeVal(TAG_ARRAY, kept[i]));
+
+    *GetHeap() = MakeVal(TAG_LIST, Cons(MakeVal(TAG_ARRAY, array_id),
+                                        MakeVal(TAG_LIST, Cons(MakeVal(TAG_ARRAY, shared), NilVal()))));
+    return *GetHeap();
+}
+
+// Every reference to the shared array, after whatever happened to the
+// ids, is still to the one array
+static bool SharedArrayStaysShared(void)
+{
+    list_node *l = GetListNodeByID(GetHeap()->v.data);
+    array_node *top = GetArrayByID(l->first.v.data);
+    int shared = GetListNodeByID(l->rest.v.data)->first.v.data;
+
+    for (int i = 0; i < top->length; i++)
+    {
+        array_node *a = GetArrayByID(top->elems[i].v.data);
+        if (a->length == 5 && a->elems[4].v.data != shared)
+            return false;
+        if (a->length >= 3 && GetListNodeByID(a->elems[2].v.data)->rest.v.data != shared)
+            return false;
+    }
+    return true;
+}
+
+static int test_array_gc_compacts_and_renumbers(void)
+{
+    std::set<int> ids;
+    std::string before;
+    int objects_used, arrays_made, i;
+
+    *GetHeap() = NilVal();
+    GarbageCollect();
+    ASSERT_TRUE(GetArraysUsed() == 0);
+    objects_used = GetObjectsUsed();
+
+    BuildArrayHeap(90);
+    before = Describe(*GetHeap());
+    arrays_made = GetArraysUsed();
+    ASSERT_TRUE(before.find("no ") == std::string::npos);
+
+    for (i = 0; i < 2; i++)
+    {
+        GarbageCollect();
+        ASSERT_TRUE(Describe(*GetHeap()) == before);
+        ASSERT_TRUE(SharedArrayStaysShared());
+
+        // the arrays left are exactly the ones still held, numbered from 0
+        ids.clear();
+        CollectArrays(*GetHeap(), ids);
+        ASSERT_TRUE((int) ids.size() == GetArraysUsed());
+        ASSERT_TRUE(GetArraysUsed() < arrays_made);
+        ASSERT_TRUE(*ids.begin() == 0 && *ids.rbegin() == GetArraysUsed() - 1);
+
+        // and only objects held by them kept: the shared array's one and
+        // one for each kept array of two or more elements (i % 5 >= 1)
+        ASSERT_TRUE(GetObjectsUsed() == objects_used + 1 + 24);
+    }
+
+    *GetHeap() = NilVal();
+    GarbageCollect();
+    ASSERT_TRUE(GetArraysUsed() == 0);
+    ASSERT_TRUE(GetObjectsUsed() == objects_used);
+    return 0;
+}
+
+static bool SaveAndLoadGame(void)
+{
+    std::string game_file = std::string(ConfigStr(PATH_LOADSAVE)) + "array_test_game";
+    std::string string_file = std::string(ConfigStr(PATH_LOADSAVE)) + "array_test_string";
+    bool loaded;
+
+    if (!SaveGame((char *) game_file.c_str()) || !SaveStrings((char *) string_file.c_str()))
+        return false;
+
+    // the same as LoadAllButAccount after a failed load
+    ClearObject();
+    ClearList();
+    ClearArray();
+    ClearTimer();
+    ClearUser();
+    ResetString();
+    if (GetArraysUsed() != 0)
+        return false;
+
+    loaded = LoadBlakodStrings((char *) string_file.c_str()) &&
+        LoadGame((char *) game_file.c_str());
+    unlink(game_file.c_str());
+    unlink(string_file.c_str());
+    return loaded;
+}
+
+static int test_array_save_load_round_trip(void)
+{
+    std::string before;
+    int arrays_used, objects_used;
+
+    BuildArrayHeap(40);
+    GarbageCollect();
+    before = Describe(*GetHeap());
+    arrays_used = GetArraysUsed();
+    objects_used = GetObjectsUsed();
+
+    ASSERT_TRUE(SaveAndLoadGame());
+    ASSERT_TRUE(GetArraysUsed() == arrays_used);
+    ASSERT_TRUE(GetObjectsUsed() == objects_used);
+    ASSERT_TRUE(Describe(*GetHeap()) == before);
+    ASSERT_TRUE(SharedArrayStaysShared());
+
+    // and what was loaded collects the same as what was made
+    GarbageCollect();
+    ASSERT_TRUE(GetArraysUsed() == arrays_used);
+    ASSERT_TRUE(Describe(*GetHeap()) == before);
+
+    // a game with no arrays has no array section, and loads with none
+    *GetHeap() = NilVal();
+    GarbageCollect();
+    ASSERT_TRUE(SaveAndLoadGame());
+    ASSERT_TRUE(GetArraysUsed() == 0);
+    ASSERT_TRUE(GetHeap()->v.tag == TAG_NIL);
+    return 0;
+}
+
+void run_array_tests(int *tests_run, int *failures)
+{
+    *failures += run_test("test_array_gc_compacts_and_renumbers", test_array_gc_compacts_and_renumbers, tests_run);
+    *failures += run_test("test_array_save_load_round_trip", test_array_save_load_round_trip, tests_run);
+}
@@ -0,0 +1,213 @@
+#include <random>
+#include <vector>
+#include "test_framework.h"
+#include "../blakserv/blakserv.h"
+
+// The block list's tree nodes come from AllocateMemory, which memory.c
+// provides in the server
+void *AllocateMemoryDebug(int malloc_id, size_t size, const char *filename, int linenumber)
+{
+    (void)malloc_id; (void)filename; (void)linenumber;
+    return malloc(size);
+}
+
+void FreeMemoryX(int malloc_id, void **ptr, size_t size)
+{
+    (void)malloc_id; (void)size;
+    free(*ptr);
+    *ptr = NULL;
+}
+
+static bool PrefixHolds(const ip_key &prefix, int prefix_len, const ip_key &addr)
+{
+    for (int i = 0; i < prefix_len; i++)
+    {
+        int mask = 0x80 >> (i & 7);
+        if ((prefix.bytes[i >> 3] & mask) != (addr.bytes[i >> 3] & mask))
+            return false;
+    }
+    return true;
+}
+
+static int test_block_parse_prefixes(void)
+{
+    ip_key key;
+    int prefix_len;
+
+    ASSERT_TRUE(ParseIPPrefix("10.1.2.3", &key, &prefix_len));
+    ASSERT_TRUE(prefix_len == IP_KEY_BITS);
+    ASSERT_TRUE(key.bytes[10] == 0xff && key.bytes[11] == 0xff && key.bytes[12] == 10 && key.bytes[15] == 3);
+    ASSERT_TRUE(IPPrefixStr(&key, prefix_len) == "10.1.2.3");
+
+    ASSERT_TRUE(ParseIPPrefix(" 10.1.2.3/16\r\n", &key, &prefix_len));
+    ASSERT_TRUE(prefix_len == IP_KEY_IPV4_BITS + 16);
+    ASSERT_TRUE(key.bytes[14] == 0 && key.bytes[15] == 0);
+    ASSERT_TRUE(IPPrefixStr(&key, prefix_len) == "10.1.0.0/16");
+
+    ASSERT_TRUE(ParseIPPrefix("2001:db8::1/32", &key, &prefix_len));
+    ASSERT_TRUE(prefix_len == 32);
+    ASSERT_TRUE(IPPrefixStr(&key, prefix_len) == "2001:db8::/32");
+
+    ASSERT_TRUE(!ParseIPPrefix("", &key, &prefix_len));
+    ASSERT_TRUE(!ParseIPPrefix("10.1.2", &key, &prefix_len));
+    ASSERT_TRUE(!ParseIPPrefix("10.1.2.3/33", &key, &prefix_len));
+    ASSERT_TRUE(!ParseIPPrefix("10.1.2.3/", &key, &prefix_len));
+    ASSERT_TRUE(!ParseIPPrefix("::1/129", &key, &prefix_len));
+    return 0;
+}
+
+// Random IPv4 prefixes, all in a few /8s so that they overlap, checked
+// against a plain scan of them while they're added and removed
+static int test_ip_tree_matches_scan(void)
+{
+    std::mt19937 rng(49);
+    std::vector<ip_key> keys;
+    std::vector<int> lens;
+    ip_tree tree = { NULL, 0 };
+    struct in_addr addr;
+    ip_key key;
+    int i, j, round;
+
+    for (round = 0; round < 2; round++)
+    {
+        if (round == 0)
+        {
+            for (i = 0; i < 3000; i++)
+            {
+                addr.s_addr = htonl(((10 + rng() % 3) << 24) | (rng() & 0xffffff));
+                IPKeyFromInAddr(&addr, &key);
+                int len = IP_KEY_IPV4_BITS + 8 + rng() % 25;
+                ip_tree_node *node = IPTreeAdd(&tree, &key, len);
+                ASSERT_TRUE(node->prefix_len == len);
+                keys.push_back(node->key);
+                lens.push_back(len);
+            }
+        }
+        else
+        {
+            // take out every other one; a prefix added twice stays for its
+            // second copy
+            for (i = 0; i < (int) keys.size(); i += 2)
+                IPTreeRemove(&tree, &keys[i], lens[i]);
+            for (i = 1; i < (int) keys.size(); i += 2)
+                IPTreeAdd(&tree, &keys[i], lens[i]);
+            for (i = 0; i < (int) keys.size(); i += 2)
+            {
+                keys[i].bytes[0] = 1;   // never matches an IPv4 address
+                lens[i] = IP_KEY_BITS;
+            }
+        }
+
+        for (i = 0; i < 20000; i++)
+        {
+            bool expected = false;
+
+            addr.s_addr = htonl(((9 + rng() % 5) << 24) | (rng() & 0xffffff));
+            IPKeyFromInAddr(&addr, &key);
+            for (j = 0; j < (int) keys.size() && !expected; j++)
+                expected = PrefixHolds(keys[j], lens[j], key);
+            ASSERT_TRUE((IPTreeMatch(&tree, &key, 0) != NULL) == expected);
+        }
+    }
+
+    IPTreeClear(&tree);
+    ASSERT_TRUE(tree.root == NULL && tree.num_prefixes == 0);
+    return 0;
+}
+
+static int test_block_list_expiry(void)
+{
+    struct in_addr addr, other;
+    ip_key key;
+    int prefix_len;
+
+    DeleteAllBlocks();
+    addr.s_addr = inet_addr("192.168.5.20");
+    other.s_addr = inet_addr("192.168.6.20");
+
+    ASSERT_TRUE(CheckBlockList(&addr));
+
+    // ran out as soon as it was added, and goes at the next check
+    AddBlock(0, &addr);
+    ASSERT_TRUE(GetNumBlocks() == 1);
+    ASSERT_TRUE(CheckBlockList(&addr));
+    ASSERT_TRUE(GetNumBlocks() == 0);
+
+    AddBlock(1000, &addr);
+    ASSERT_TRUE(!CheckBlockList(&addr));
+    ASSERT_TRUE(CheckBlockList(&other));
+
+    // made permanent, its old time doesn't take it away
+    AddBlock(-1, &addr);
+    AddBlock(0, &addr);
+    ASSERT_TRUE(!CheckBlockList(&addr));
+
+    ASSERT_TRUE(ParseIPPrefix("192.168.0.0/16", &key, &prefix_len));
+    AddBlockPrefix(1000, &key, prefix_len);
+    ASSERT_TRUE(!CheckBlockList(&other));
+    ASSERT_TRUE(FindBlock(&key, prefix_len));
+    DeleteBlock(&key, prefix_len);
+    ASSERT_TRUE(CheckBlockList(&other));
+    ASSERT_TRUE(!CheckBlockList(&addr));
+
+    DeleteAllBlocks();
+    ASSERT_TRUE(CheckBlockList(&addr));
+    ASSERT_TRUE(GetNumBlocks() == 0);
+    return 0;
+}
+
+// Burst of 3 and 60 a minute for one address, 5 a second in all
+static int test_connect_rate(void)
+{
+    struct in_addr a, b, c;
+    UINT64 now = 1000000;
+    int i, allowed;
+
+    a.s_addr = inet_addr("10.0.0.1");
+    b.s_addr = inet_addr("10.0.0.2");
+    c.s_addr = inet_addr("10.0.0.3");
+    SetConnectRateLimits(3, 60, 5);
+
+    for (i = 0; i < 3; i++)
+        ASSERT_TRUE(CheckConnectRate(&a, now));
+    ASSERT_TRUE(!CheckConnectRate(&a, now));
+
+    // the refused connection wasn't taken from the global bucket
+    ASSERT_TRUE(CheckConnectRate(&b, now));
+    ASSERT_TRUE(CheckConnectRate(&b, now));
+    ASSERT_TRUE(!CheckConnectRate(&c, now));
+
+    // a second later the address has one more, and everyone five more
+    now += 1000;
+    ASSERT_TRUE(CheckConnectRate(&a, now));
+    ASSERT_TRUE(!CheckConnectRate(&a, now));
+    allowed = 0;
+    for (i = 0; i < 10; i++)
+    {
+        struct in_addr d;
+        d.s_addr = htonl(0x0b000000 + i);
+        if (CheckConnectRate(&d, now))
+            allowed++;
+    }
+    ASSERT_TRUE(allowed == 4);
+
+    // buckets that have filled again go when the minute's sweep comes
+    ASSERT_TRUE(GetNumConnectRateAddresses() > 0);
+    now += 5 * 60 * 1000;
+    ASSERT_TRUE(CheckConnectRate(&a, now));
+    ASSERT_TRUE(GetNumConnectRateAddresses() == 1);
+
+    // 0 turns the limits off
+    SetConnectRateLimits(0, 0, 0);
+    for (i = 0; i < 100; i++)
+        ASSERT_TRUE(CheckConnectRate(&a, now));
+    return 0;
+}
+
+void run_block_tests(int *tests_run, int *failures)
+{
+    *failures += run_test("test_block_parse_prefixes", test_block_parse_prefixes, tests_run);
+    *failures += run_test("test_ip_tree_matches_scan", test_ip_tree_matches_scan, tests_run);
+    *failures += run_test("test_block_list_expiry", test_block_list_expiry, tests_run);
+    *failures += run_test("test_connect_rate", test_connect_rate, tests_run);
+}
@@ -2,6 +2,8 @@
 #include <cstring>
 #include <string>
 #include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
 
 #include "test_framework.h"
 #include "test_channel.h"
@@ -10,6 +12,9 @@
 // Capture buffer
 static std::string last_channel_msg;
 static int last_channel_id = -1;
+static std::vector<std::string> channel_msgs;
+// When set, messages also go here, for a forked child to report them
+static int channel_msgs_fd = -1;
 
 // Stubs
 void WriteChannelBuffer(int channel_id, char *s) {
@@ -19,6 +24,9 @@ void WriteChannelBuffer(int channel_id, char *s) {
     } else {
         last_channel_msg.clear();
     }
+    channel_msgs.push_back(last_channel_msg);
+    if (channel_msgs_fd >= 0 && s)
+        (void)!write(channel_msgs_fd, s, strlen(s));
 }
 
 bool ConfigBool(int config_id) {
@@ -119,11 +127,93 @@ static int test_lprintf_basic(void) {
     return 0;
 }
 
+static int test_channel_writer_delivers_in_order(void) {
+    channel_msgs.clear();
+
+    OpenDefaultChannels();
+    lprintf("first");
+    eprintf("second\n");
+    lprintf("third");
+    FlushDefaultChannels();
+    CloseDefaultChannels();
+
+    ASSERT_TRUE(channel_msgs.size() == 3);
+    ASSERT_TRUE(channel_msgs[0].find(" | first\r\n") != std::string::npos);
+    ASSERT_TRUE(channel_msgs[1].find(" | second\r\n") != std::string::npos);
+    ASSERT_TRUE(channel_msgs[2].find(" | third\r\n") != std::string::npos);
+    ASSERT_TRUE(last_channel_id == CHANNEL_L);
+    return 0;
+}
+
+static int test_channel_writer_folds_repeats(void) {
+    channel_stats before, after;
+
+    channel_msgs.clear();
+    GetChannelStats(&before);
+
+    OpenDefaultChannels();
+    for (int i = 0; i < 5; i++)
+        dprintf("same %d", 7);
+    dprintf("different");
+    CloseDefaultChannels();
+
+    GetChannelStats(&after);
+    ASSERT_TRUE(channel_msgs.size() == 3);
+    ASSERT_TRUE(channel_msgs[0].find("|same 7") != std::string::npos);
+    ASSERT_TRUE(channel_msgs[1].find("Previous message repeated 4 more times") != std::string::npos);
+    ASSERT_TRUE(channel_msgs[2].find("|different") != std::string::npos);
+    ASSERT_TRUE(after.repeated - before.repeated == 4);
+    ASSERT_TRUE(after.written - before.written == 2);
+    return 0;
+}
+
+// A fatal error exits with the writer running; that has to write out the
+// ring and stop the writer rather than abort on its std::thread
+static int test_channel_writer_stops_at_exit(void) {
+    int fds[2];
+    int status;
+    char buf[4096];
+    ssize_t len;
+    std::string output;
+
+    ASSERT_TRUE(pipe(fds) == 0);
+    fflush(stdout);
+
+    pid_t pid = fork();
+    ASSERT_TRUE(pid >= 0);
+    if (pid == 0) {
+        close(fds[0]);
+        channel_msgs_fd = fds[1];
+        freopen("/dev/null", "w", stderr);
+        OpenDefaultChannels();
+        for (int i = 0; i < 100; i++)
+            lprintf("line %d", i);
+        lprintf("last words");
+        FatalErrorShow(__FILE__, __LINE__, "test");
+        _exit(2);   // not reached
+    }
+
+    close(fds[1]);
+    while ((len = read(fds[0], buf, sizeof(buf))) > 0)
+        output.append(buf, len);
+    close(fds[0]);
+
+    ASSERT_TRUE(waitpid(pid, &status, 0) == pid);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_TRUE(WEXITSTATUS(status) == 1);
+    ASSERT_TRUE(output.find("line 99") != std::string::npos);
+    ASSERT_TRUE(output.find("last words") != std::string::npos);
+    return 0;
+}
+
 int run_channel_tests(int *tests_run, int *failures) {
     int local_failures = 0;
     local_failures += run_test("test_dprintf_overflow_with_newlines", test_dprintf_overflow_with_newlines, tests_run);
     local_failures += run_test("test_lprintf_basic", test_lprintf_basic, tests_run);
     local_failures += run_test("test_bprintf_long_debug_info", test_bprintf_long_debug_info, tests_run);
+    local_failures += run_test("test_channel_writer_delivers_in_order", test_channel_writer_delivers_in_order, tests_run);
+    local_failures += run_test("test_channel_writer_folds_repeats", test_channel_writer_folds_repeats, tests_run);
+    local_failures += run_test("test_channel_writer_stops_at_exit", test_channel_writer_stops_at_exit, tests_run);
     *failures += local_failures;
     return local_failures;
 }
@@ -0,0 +1,60 @@
+#include <vector>
+#include "test_framework.h"
+#include "../blakserv/blakserv.h"
+
+static std::vector<class_node *> all_classes;
+
+static void CollectClass(class_node *c)
+{
+    all_classes.push_back(c);
+}
+
+// whether c is class_id or inherits from it, by walking its superclasses
+static bool ScanIsClass(class_node *c, int class_id)
+{
+    for (; c != NULL; c = c->super_ptr)
+        if (c->class_id == class_id)
+            return true;
+    return false;
+}
+
+// GetClassByID finds every class through the id table, and
+// IsClassOrSubclass answers as a walk up the superclasses would for every
+// pair of classes, and for ids no class has
+static int test_class_is_class_matches_scan(void)
+{
+    int max_id = 0;
+
+    all_classes.clear();
+    ForEachClass(CollectClass);
+    ASSERT_TRUE(GetClassByName("BenchLink8") != NULL);
+
+    for (class_node *c : all_classes)
+    {
+        ASSERT_TRUE(GetClassByID(c->class_id) == c);
+        if (c->class_id > max_id)
+            max_id = c->class_id;
+    }
+
+    for (class_node *c : all_classes)
+    {
+        for (class_node *ancestor : all_classes)
+            ASSERT_TRUE(IsClassOrSubclass(c, ancestor->class_id) == ScanIsClass(c, ancestor->class_id));
+
+        ASSERT_TRUE(!IsClassOrSubclass(c, -1));
+        ASSERT_TRUE(!IsClassOrSubclass(c, max_id + 1));
+    }
+    ASSERT_TRUE(!IsClassOrSubclass(NULL, SYSTEM_CLASS));
+    ASSERT_TRUE(GetClassByID(max_id + 1) == NULL);
+
+    ASSERT_TRUE(IsClassOrSubclass(GetClassByName("BenchLink8"), GetClassByName("BenchTarget")->class_id));
+    ASSERT_TRUE(!IsClassOrSubclass(GetClassByName("BenchTarget"), GetClassByName("BenchLink8")->class_id));
+
+    all_classes.clear();
+    return 0;
+}
+
+void run_class_tests(int *tests_run, int *failures)
+{
+    *failures += run_test("test_class_is_class_matches_scan", test_class_is_class_matches_scan, tests_run);
+}
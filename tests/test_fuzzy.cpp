@@ -0,0 +1,192 @@
+#include <cctype>
+#include <cstring>
+#include <random>
+#include <string>
+#include "test_framework.h"
+#include "../blakserv/fuzzy.h"
+
+// The fuzzy string routines used to work on uppercased scratch copies.  These
+// are those original implementations, kept here as the reference that the
+// in-place versions must agree with byte for byte.
+
+#define iswhite(c) ((c)==' ' || (c)=='\t' || (c)=='\n' || (c)=='\r')
+
+static void RefCollapseString(char *pTarget, const char *pSource, int len)
+{
+    if (!pTarget || !pSource || len <= 0)
+    {
+        *pTarget = '\0';
+        return;
+    }
+
+    while (len && iswhite(*pSource)) { pSource++; len--; }
+    while (len && iswhite(pSource[len-1])) { len--; }
+
+    while (len)
+    {
+        *pTarget++ = toupper(*pSource++);
+        len--;
+    }
+
+    *pTarget = '\0';
+}
+
+static bool RefBufferContain(const char *s1, int len1, const char *s2, int len2)
+{
+    static char buf0[256], buf1[256];
+
+    if (!s1 || !s2 || len1 <= 0 || len2 <= 0)
+        return false;
+
+    RefCollapseString(buf0, s1, len1);
+    RefCollapseString(buf1, s2, len2);
+
+    return strstr(buf0, buf1) != NULL;
+}
+
+static bool RefBufferEqual(const char *s1, int len1, const char *s2, int len2)
+{
+    if (!s1 || !s2 || len1 <= 0 || len2 <= 0)
+        return false;
+
+    while (len1 && iswhite(*s1)) { s1++; len1--; }
+    while (len2 && iswhite(*s2)) { s2++; len2--; }
+    while (len1 && iswhite(s1[len1-1])) { len1--; }
+    while (len2 && iswhite(s2[len2-1])) { len2--; }
+
+    if (!len1 || !len2)
+        return false;
+
+    while (len1 && len2 && toupper(*s1) == toupper(*s2))
+    {
+        s1++;
+        s2++;
+        len1--;
+        len2--;
+    }
+
+    return (len1 == 0 && len2 == 0);
+}
+
+static const char *RefStristr(const char *pSource, const char *pSearch)
+{
+    if (!pSource || !pSearch || !*pSearch)
+        return NULL;
+
+    size_t nSearch = strlen(pSearch);
+    const char *pEnd = pSource + strlen(pSource) - nSearch;
+    while (pSource <= pEnd)
+    {
+        if (0 == strncasecmp(pSource, pSearch, nSearch))
+            return pSource;
+        pSource++;
+    }
+
+    return NULL;
+}
+
+// Random strings from a small alphabet so that matches, near misses, case
+// differences, whitespace runs, embedded zeros and high bytes all turn up.
+static std::string RandomFuzzyString(std::mt19937 &rng, int max_len)
+{
+    static const char alphabet[] = "aAbBzZ[{@` \t\r\n\0\x80\xe9";
+    std::uniform_int_distribution<int> len_dist(0, max_len);
+    std::uniform_int_distribution<int> char_dist(0, (int) sizeof(alphabet) - 2);
+    std::string s;
+    int len = len_dist(rng);
+
+    for (int i = 0; i < len; i++)
+        s.push_back(alphabet[char_dist(rng)]);
+    return s;
+}
+
+static int test_fuzzy_contain_examples(void)
+{
+    ASSERT_TRUE(FuzzyBufferContain("   orc teeth", 12, "ORC", 3));
+    ASSERT_TRUE(FuzzyBufferContain("orc teeth  ", 11, " teeth ", 7));
+    ASSERT_TRUE(FuzzyBufferContain("orc teeth", 9, "   ", 3));
+    ASSERT_TRUE(!FuzzyBufferContain("orc teeth", 9, "orcteeth", 8));
+    ASSERT_TRUE(!FuzzyBufferContain("orc", 3, "orc teeth", 9));
+    ASSERT_TRUE(!FuzzyBufferContain("orc", 0, "orc", 3));
+    ASSERT_TRUE(!FuzzyBufferContain("orc", 3, NULL, 3));
+    return 0;
+}
+
+static int test_fuzzy_trim_matches_collapse(void)
+{
+    std::mt19937 rng(59);
+    char ref[256];
+
+    for (int n = 0; n < 20000; n++)
+    {
+        std::string s = RandomFuzzyString(rng, 40);
+        const char *p = s.data();
+        int len = (int) s.size();
+
+        RefCollapseString(ref, p, len);
+        FuzzyTrimBuffer(&p, &len);
+
+        ASSERT_TRUE(len == (int) strlen(ref));
+        for (int i = 0; i < len; i++)
+            ASSERT_TRUE((char) toupper(p[i]) == ref[i]);
+    }
+    return 0;
+}
+
+static int test_fuzzy_contain_differential(void)
+{
+    std::mt19937 rng(1994);
+
+    for (int n = 0; n < 50000; n++)
+    {
+        std::string s1 = RandomFuzzyString(rng, 64);
+        std::string s2 = RandomFuzzyString(rng, 6);
+
+        ASSERT_TRUE(FuzzyBufferContain(s1.data(), (int) s1.size(), s2.data(), (int) s2.size()) ==
+                    RefBufferContain(s1.data(), (int) s1.size(), s2.data(), (int) s2.size()));
+    }
+    return 0;
+}
+
+static int test_fuzzy_equal_differential(void)
+{
+    std::mt19937 rng(2012);
+
+    for (int n = 0; n < 50000; n++)
+    {
+        std::string s1 = RandomFuzzyString(rng, 8);
+        std::string s2 = RandomFuzzyString(rng, 8);
+
+        ASSERT_TRUE(FuzzyBufferEqual(s1.data(), (int) s1.size(), s2.data(), (int) s2.size()) ==
+                    RefBufferEqual(s1.data(), (int) s1.size(), s2.data(), (int) s2.size()));
+    }
+    return 0;
+}
+
+static int test_fuzzy_find_matches_stristr(void)
+{
+    std::mt19937 rng(6000);
+
+    for (int n = 0; n < 50000; n++)
+    {
+        std::string s0 = RandomFuzzyString(rng, 64);
+        std::string s1 = RandomFuzzyString(rng, 4);
+        int len0 = (int) strnlen(s0.c_str(), s0.size());
+        int len1 = (int) strnlen(s1.c_str(), s1.size());
+
+        const char *expected = RefStristr(s0.c_str(), s1.c_str());
+        const char *found = FuzzyFindBuffer(s0.c_str(), len0, s1.c_str(), len1);
+
+        ASSERT_TRUE(found == expected);
+    }
+    return 0;
+}
+
+void run_fuzzy_tests(int *tests_run, int *failures)
+{
+    *failures += run_test("test_fuzzy_contain_examples", test_fuzzy_contain_examples, tests_run);
+    *failures += run_test("test_fuzzy_trim_matches_collapse", test_fuzzy_trim_matches_collapse, tests_run);
+    *failures += run_test("test_fuzzy_contain_differential", test_fuzzy_contain_differential, tests_run);
+    *failures += run_test("test_fuzzy_equal_differential", test_fuzzy_equal_differential, tests_run);
+    *failures += run_test("test_fuzzy_find_matches_stristr", test_fuzzy_find_matches_stristr, tests_run);
+}
@@ -0,0 +1,94 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "test_framework.h"
+#include "../blakserv/osd_linux.h"
+#include "../blakserv/histogram.h"
+
+// Bucket tops must be strictly increasing, and every value must land in the
+// bucket whose range holds it.
+static int test_histogram_buckets_cover_values(void)
+{
+    for (int i = 1; i < HISTOGRAM_BUCKETS; i++)
+        ASSERT_TRUE(HistogramBucketTop(i) > HistogramBucketTop(i - 1));
+    ASSERT_TRUE(HistogramBucketTop(HISTOGRAM_BUCKETS - 1) == ~(UINT64) 0);
+
+    std::mt19937_64 rng(36);
+    for (int n = 0; n < 100000; n++)
+    {
+        UINT64 value = rng() >> (rng() % 64);
+        int index = HistogramBucketIndex(value);
+
+        ASSERT_TRUE(index >= 0 && index < HISTOGRAM_BUCKETS);
+        ASSERT_TRUE(value <= HistogramBucketTop(index));
+        ASSERT_TRUE(index == 0 || value > HistogramBucketTop(index - 1));
+    }
+    return 0;
+}
+
+static int test_histogram_small_values_exact(void)
+{
+    static histogram_type h;
+
+    HistogramClear(&h);
+    for (UINT64 v = 1; v <= 20; v++)
+        HistogramRecord(&h, v);
+
+    ASSERT_TRUE(h.count == 20);
+    ASSERT_TRUE(h.max == 20);
+    ASSERT_TRUE(HistogramMean(&h) == 10);
+    ASSERT_TRUE(HistogramPercentile(&h, 50.0) == 10);
+    ASSERT_TRUE(HistogramPercentile(&h, 100.0) == 20);
+    ASSERT_TRUE(HistogramPercentile(&h, 0.0) == 1);
+    return 0;
+}
+
+static int test_histogram_empty(void)
+{
+    static histogram_type h;
+
+    HistogramClear(&h);
+    ASSERT_TRUE(HistogramPercentile(&h, 99.0) == 0);
+    ASSERT_TRUE(HistogramMean(&h) == 0);
+    return 0;
+}
+
+// Percentiles of random latencies must be within the bucket resolution of
+// the exact answer from sorting them.
+static int test_histogram_percentiles_match_sorted(void)
+{
+    static histogram_type h;
+    std::vector<UINT64> values;
+    std::mt19937_64 rng(1036);
+    std::lognormal_distribution<double> latency(7.0, 1.5);
+    const double percents[] = { 50.0, 90.0, 99.0, 99.9 };
+
+    HistogramClear(&h);
+    for (int n = 0; n < 50000; n++)
+    {
+        UINT64 value = (UINT64) latency(rng);
+        values.push_back(value);
+        HistogramRecord(&h, value);
+    }
+    std::sort(values.begin(), values.end());
+
+    for (double percent : percents)
+    {
+        UINT64 rank = (UINT64) (percent / 100.0 * values.size() + 0.5);
+        UINT64 exact = values[rank - 1];
+        UINT64 estimate = HistogramPercentile(&h, percent);
+
+        ASSERT_TRUE(estimate >= exact);
+        ASSERT_TRUE(estimate - exact <= exact / HISTOGRAM_SUB_BUCKETS);
+    }
+    ASSERT_TRUE(HistogramPercentile(&h, 100.0) == values.back());
+    return 0;
+}
+
+void run_histogram_tests(int *tests_run, int *failures)
+{
+    *failures += run_test("test_histogram_buckets_cover_values", test_histogram_buckets_cover_values, tests_run);
+    *failures += run_test("test_histogram_small_values_exact", test_histogram_small_values_exact, tests_run);
+    *failures += run_test("test_histogram_empty", test_histogram_empty, tests_run);
+    *failures += run_test("test_histogram_percentiles_match_sorted", test_histogram_percentiles_match_sorted, tests_run);
+}
@@ -39,6 +39,22 @@ void bprintf(const char *format, ...) { (void)format; }
 void dprintf(const char *format, ...) { (void)format; }
 void SendSessionAdminText(int session_id, const char *format, ...) { (void)session_id; (void)format; }
 
+// Mocks for memory, which the post queue takes its room from
+void *AllocateMemoryDebug(int malloc_id, size_t size, const char *filename, int linenumber) {
+    (void)malloc_id; (void)filename; (void)linenumber;
+    return malloc(size);
+}
+void *ResizeMemory(int malloc_id, void *ptr, int old_size, int new_size) {
+    (void)malloc_id; (void)old_size;
+    return realloc(ptr, new_size);
+}
+void FreeMemoryX(int malloc_id, void **ptr, size_t size) {
+    (void)malloc_id; (void)size;
+    free(*ptr);
+    *ptr = NULL;
+}
+void lprintf(const char *format, ...) { (void)format; }
+
 static bool g_flush_called = false;
 void FlushDefaultChannels(void) { g_flush_called = true; }
 
@@ -98,6 +114,24 @@ int GetSourceLine(class_node *c, char *bkod_ptr) {
     return 1;
 }
 
+// Mocks for the profiler: count samples, taking one every 100 instructions
+int profile_next_sample;
+static int g_num_samples = 0;
+void ProfileSample(kod_stack_type *stack, int depth, char *bkod_ptr, int insts) {
+    (void)stack; (void)depth; (void)bkod_ptr;
+    if (insts < profile_next_sample)
+        return;
+    g_num_samples++;
+    profile_next_sample = insts + 100;
+}
+void ProfileRebase(int insts) { (void)insts; }
+
+// Mocks for latency: count how often the interpreter checks for a stall
+UINT64 GetMicroCount(void) { return 1000000; }
+void LatencyRecord(int phase, UINT64 microseconds) { (void)phase; (void)microseconds; }
+static int g_num_stall_checks = 0;
+void LatencyCheckStall(void) { g_num_stall_checks++; }
+
 // Include source file
 #include "../blakserv/sendmsg.c"
 
@@ -182,7 +216,7 @@ static int test_InterpretCall_Valid(void) {
     local_var_type locals;
 
     // Execute
-    bool result = InterpretCall(&o_ptr, 1, &locals, opcode);
+    bool result = InterpretCall(&o_ptr, 1, &locals, opcode, true);
 
     ASSERT_TRUE(result);
     ASSERT_TRUE(!g_flush_called);
@@ -215,7 +249,7 @@ static int test_InterpretCall_Overflow_Normal(void) {
     local_var_type locals;
 
     // Execute
-    bool result = InterpretCall(&o_ptr, 1, &locals, opcode);
+    bool result = InterpretCall(&o_ptr, 1, &locals, opcode, true);
 
     ASSERT_TRUE(!result); // Should return false
     ASSERT_TRUE(g_flush_called); // Should flush
@@ -249,7 +283,7 @@ static int test_InterpretCall_Overflow_Name(void) {
     local_var_type locals;
 
     // Execute
-    bool result = InterpretCall(&o_ptr, 1, &locals, opcode);
+    bool result = InterpretCall(&o_ptr, 1, &locals, opcode, true);
 
     ASSERT_TRUE(!result); // Should return false
     ASSERT_TRUE(g_flush_called); // Should flush
@@ -257,6 +291,149 @@ static int test_InterpretCall_Overflow_Name(void) {
     return 0;
 }
 
+// Runs a handler that is one unconditional goto to itself, until it hits
+// the instruction limit (1000, from the ConfigInt mock)
+static void RunEndlessHandler(void) {
+    std::vector<char> bytecode;
+
+    append_byte(bytecode, 0); // num_locals
+    append_byte(bytecode, 0); // num_parms
+
+    opcode_type opcode;
+    unsigned char opcode_char = 0;
+    memset(&opcode, 0, sizeof(opcode));
+    opcode.command = GOTO;
+    opcode.source2 = GOTO_UNCONDITIONAL;
+    memcpy(&opcode_char, &opcode, 1);
+    append_byte(bytecode, opcode_char);
+    append_int(bytecode, 0); // back to the goto itself
+
+    test_bkod = bytecode.data();
+    test_num_interpreted = 0;
+    test_kod_stat.interpreting_class = INVALID_CLASS; // for the loop error message
+
+    val_type ret_val;
+    InterpretAtMessage(1, GetClassByID(1), nullptr, 0, nullptr, &ret_val);
+}
+
+static int test_Profile_NoSamplesWhenOff(void) {
+    test_kod_stat.profiling = false;
+    profile_next_sample = 100;
+    g_num_samples = 0;
+
+    RunEndlessHandler();
+
+    ASSERT_TRUE(g_num_samples == 0);
+    ASSERT_TRUE(test_num_interpreted == 1001);
+    return 0;
+}
+
+static int test_Profile_SamplesAtInterval(void) {
+    test_kod_stat.profiling = true;
+    profile_next_sample = 100;
+    g_num_samples = 0;
+
+    RunEndlessHandler();
+    test_kod_stat.profiling = false;
+
+    // At instructions 101, 201, ... 901; the limit still stops the loop
+    ASSERT_TRUE(g_num_samples == 9);
+    ASSERT_TRUE(test_num_interpreted == 1001);
+    return 0;
+}
+
+static int test_Stall_CheckedAtInterval(void) {
+    test_kod_stat.profiling = false;
+    profile_next_sample = 1000000;
+    g_num_stall_checks = 0;
+    stall_next_check = 250;
+
+    RunEndlessHandler();
+
+    // Once at instruction 251; the next is STALL_CHECK_INSTRUCTIONS later
+    ASSERT_TRUE(g_num_stall_checks == 1);
+    ASSERT_TRUE(stall_next_check == 251 + STALL_CHECK_INSTRUCTIONS);
+    ASSERT_TRUE(test_num_interpreted == 1001);
+    return 0;
+}
+
+// A handler with one local that returns 5 + 2
+static std::vector<char> AddHandler(int num_locals) {
+    std::vector<char> bytecode;
+    opcode_type opcode;
+    unsigned char opcode_char;
+
+    append_byte(bytecode, num_locals);
+    append_byte(bytecode, 0); // num_parms
+
+    memset(&opcode, 0, sizeof(opcode));
+    opcode.command = BINARY_ASSIGN;
+    opcode.dest = LOCAL_VAR;
+    opcode.source1 = CONSTANT;
+    opcode.source2 = CONSTANT;
+    memcpy(&opcode_char, &opcode, 1);
+    append_byte(bytecode, opcode_char);
+    append_byte(bytecode, ADD);
+    append_int(bytecode, 0);
+    append_int(bytecode, (TAG_INT << 28) | 5);
+    append_int(bytecode, (TAG_INT << 28) | 2);
+
+    memset(&opcode, 0, sizeof(opcode));
+    opcode.command = RETURN;
+    opcode.dest = NO_PROPAGATE;
+    opcode.source1 = LOCAL_VAR;
+    memcpy(&opcode_char, &opcode, 1);
+    append_byte(bytecode, opcode_char);
+    append_int(bytecode, 0);
+
+    return bytecode;
+}
+
+static val_type RunHandler(std::vector<char> &bytecode, message_node *m) {
+    val_type ret_val;
+
+    test_bkod = bytecode.data();
+    test_num_interpreted = 0;
+    test_kod_stat.profiling = false;
+    profile_next_sample = 1000000;
+    stall_next_check = 1000000;
+
+    ret_val.int_val = NIL;
+    InterpretAtMessage(1, GetClassByID(1), m, 0, nullptr, &ret_val);
+    return ret_val;
+}
+
+static int test_Verified_RunsUnchecked(void) {
+    message_node m;
+    memset(&m, 0, sizeof(m));
+    m.verified = true;
+
+    std::vector<char> bytecode = AddHandler(1);
+    val_type ret_val = RunHandler(bytecode, &m);
+
+    ASSERT_TRUE(ret_val.v.tag == TAG_INT);
+    ASSERT_TRUE(ret_val.v.data == 7);
+    return 0;
+}
+
+static int test_Unverified_ChecksLocals(void) {
+    message_node m;
+    memset(&m, 0, sizeof(m));
+    m.verified = false;
+
+    std::vector<char> bytecode = AddHandler(1);
+    val_type ret_val = RunHandler(bytecode, &m);
+    ASSERT_TRUE(ret_val.v.tag == TAG_INT);
+    ASSERT_TRUE(ret_val.v.data == 7);
+
+    // Too many locals: aborted before running anything
+    bytecode = AddHandler(MAX_LOCALS + 1);
+    ret_val = RunHandler(bytecode, &m);
+    ASSERT_TRUE(ret_val.int_val == NIL);
+    ASSERT_TRUE(test_num_interpreted == 0);
+    return 0;
+}
+
 int main(void)
 {
     int tests_run = 0;
@@ -265,6 +442,11 @@ int main(void)
     failures += run_test("test_InterpretCall_Valid", test_InterpretCall_Valid, &tests_run);
     failures += run_test("test_InterpretCall_Overflow_Normal", test_InterpretCall_Overflow_Normal, &tests_run);
     failures += run_test("test_InterpretCall_Overflow_Name", test_InterpretCall_Overflow_Name, &tests_run);
+    failures += run_test("test_Profile_NoSamplesWhenOff", test_Profile_NoSamplesWhenOff, &tests_run);
+    failures += run_test("test_Profile_SamplesAtInterval", test_Profile_SamplesAtInterval, &tests_run);
+    failures += run_test("test_Stall_CheckedAtInterval", test_Stall_CheckedAtInterval, &tests_run);
+    failures += run_test("test_Verified_RunsUnchecked", test_Verified_RunsUnchecked, &tests_run);
+    failures += run_test("test_Unverified_ChecksLocals", test_Unverified_ChecksLocals, &tests_run);
 
     if (failures != 0)
     {
@@ -236,6 +236,15 @@ static int test_get_milli_count_monotonic(void)
     return 0;
 }
 
+static int test_get_micro_count_monotonic(void)
+{
+    UINT64 first = GetMicroCount();
+    UINT64 second = GetMicroCount();
+
+    ASSERT_TRUE(second >= first);
+    return 0;
+}
+
 static int test_rscload_reads_resources(void)
 {
     std::vector<char> path_buffer;
@@ -321,6 +330,7 @@ int main(void)
     failures += run_test("test_relative_time_format", test_relative_time_format, &tests_run);
     failures += run_test("test_relative_time_with_days", test_relative_time_with_days, &tests_run);
     failures += run_test("test_get_milli_count_monotonic", test_get_milli_count_monotonic, &tests_run);
+    failures += run_test("test_get_micro_count_monotonic", test_get_micro_count_monotonic, &tests_run);
     failures += run_test("test_rscload_reads_resources", test_rscload_reads_resources, &tests_run);
     failures += run_test("test_rscload_rejects_bad_magic", test_rscload_rejects_bad_magic, &tests_run);
     failures += run_test("test_json_escape", test_json_escape, &tests_run);
@@ -349,6 +359,22 @@ int main(void)
     extern void run_webhook_message_tests(int *tests_run, int *failures);
     run_webhook_message_tests(&tests_run, &failures);
 
+    // Run fuzzy.c tests
+    extern void run_fuzzy_tests(int *tests_run, int *failures);
+    run_fuzzy_tests(&tests_run, &failures);
+
+    // Run histogram.c tests
+    extern void run_histogram_tests(int *tests_run, int *failures);
+    run_histogram_tests(&tests_run, &failures);
+
+    // Run webhook.c tests
+    extern void run_webhook_tests(int *tests_run, int *failures);
+    run_webhook_tests(&tests_run, &failures);
+
+    // Run block.c tests
+    extern void run_block_tests(int *tests_run, int *failures);
+    run_block_tests(&tests_run, &failures);
+
     if (failures != 0)
     {
         fprintf(stderr, "%d test(s) failed.\n", failures);
@@ -86,7 +86,6 @@ static int test_retrieve_property_via_id(void)
     // It does NOT check class_ptr for PROPERTY type.
 
     obj.p = props;
-    props[0].id = 0;
     props[0].val.v.tag = TAG_STRING; // 2
     props[0].val.v.data = 12345;
 
@@ -110,7 +109,6 @@ static int test_retrieve_property_via_pointer(void)
 
     obj.object_id = 200;
     obj.p = props;
-    props[0].id = 0;
     props[0].val.v.tag = TAG_OBJECT; // 3
     props[0].val.v.data = 999;
 
@@ -158,6 +156,42 @@ static int test_retrieve_class_var_via_pointer(void)
     return 0;
 }
 
+// A verified handler's class var indices were checked at load, so
+// RetrieveValue only bounds checks them when asked to
+static int test_retrieve_class_var_unchecked(void)
+{
+    object_node obj;
+    class_node cls;
+    var_default_type vars[2];
+
+    kod_stat.debugging = 0;
+
+    obj.object_id = 400;
+    obj.class_id = 40;
+    obj.class_ptr = &cls;
+
+    vars[0].val.v.tag = TAG_INT;
+    vars[0].val.v.data = 1;
+    vars[1].val.v.tag = TAG_INT;
+    vars[1].val.v.data = 2;
+
+    // vars has room for two, but the class says it has one
+    cls.class_id = 40;
+    cls.class_name = (char*)"TestClass";
+    cls.num_vars = 1;
+    cls.vars = vars;
+
+    local_var_type locals;
+    val_type result = RetrieveValue(&obj, &locals, CLASS_VAR, 1);
+    ASSERT_TRUE(result.int_val == NIL);
+
+    result = RetrieveValue(&obj, &locals, CLASS_VAR, 1, false);
+    ASSERT_TRUE(result.v.tag == TAG_INT);
+    ASSERT_TRUE(result.v.data == 2);
+
+    return 0;
+}
+
 int run_retrieve_value_tests(int *tests_run, int *failures)
 {
     int local_failures = 0;
@@ -165,6 +199,7 @@ int run_retrieve_value_tests(int *tests_run, int *failures)
     local_failures += run_test("test_retrieve_property_via_id", test_retrieve_property_via_id, tests_run);
     local_failures += run_test("test_retrieve_property_via_pointer", test_retrieve_property_via_pointer, tests_run);
     local_failures += run_test("test_retrieve_class_var_via_pointer", test_retrieve_class_var_via_pointer, tests_run);
+    local_failures += run_test("test_retrieve_class_var_unchecked", test_retrieve_class_var_unchecked, tests_run);
     *failures += local_failures;
     return local_failures;
 }
@@ -0,0 +1,243 @@
+#include <map>
+#include <random>
+#include <vector>
+#include "test_framework.h"
+#include "../blakserv/blakserv.h"
+
+typedef std::map<int, std::pair<int, int>> room_positions;
+
+// A room of rows by cols squares with its spatial hash set up the way
+// LoadRoomData does it, without a room file
+static roomdata_node *CreateTestRoom(int rows, int cols)
+{
+    roomdata_node *r = new roomdata_node();
+
+    r->file_info.rows = rows;
+    r->file_info.cols = cols;
+    r->cell_rows = std::max(1, (rows + ROOM_CELL_SIZE - 1) / ROOM_CELL_SIZE);
+    r->cell_cols = std::max(1, (cols + ROOM_CELL_SIZE - 1) / ROOM_CELL_SIZE);
+    r->cells.resize(r->cell_rows * r->cell_cols);
+    return r;
+}
+
+static std::vector<int> ScanInRange(const room_positions &where, int row, int col, int distance)
+{
+    std::vector<int> found;
+
+    for (auto &entry : where)
+    {
+        INT64 row_diff = entry.second.first - row;
+        INT64 col_diff = entry.second.second - col;
+
+        if (row_diff * row_diff + col_diff * col_diff <= (INT64) distance * distance)
+            found.push_back(entry.first);
+    }
+    return found;
+}
+
+static std::vector<int> ScanOfClass(const room_positions &where, int class_id)
+{
+    std::vector<int> found;
+
+    for (auto &entry : where)
+    {
+        for (class_node *c = GetObjectByID(entry.first)->class_ptr; c != NULL; c = c->super_ptr)
+        {
+            if (c->class_id == class_id)
+            {
+                found.push_back(entry.first);
+                break;
+            }
+        }
+    }
+    return found;
+}
+
+static bool InRangeMatchesScan(roomdata_node *r, const room_positions &where,
+                               int row, int col, int distance)
+{
+    std::vector<int> found;
+
+    // found is added to, not replaced, and what's added is in id order
+    // like the scan
+    found.push_back(-1);
+    if (GetRoomObjectsInRange(r, row, col, distance, found) != (int) found.size() - 1)
+        return false;
+    if (found[0] != -1)
+        return false;
+    found.erase(found.begin());
+    return found == ScanInRange(where, row, col, distance);
+}
+
+static bool OfClassMatchesScan(roomdata_node *r, const room_positions &where, int class_id)
+{
+    std::vector<int> found;
+
+    if (GetRoomObjectsOfClass(r, class_id, found) != (int) found.size())
+        return false;
+    return found == ScanOfClass(where, class_id);
+}
+
+// An object crossing a cell edge, standing just outside the room and
+// leaving it
+static int test_room_objects_move_between_cells(void)
+{
+    roomdata_node *r = CreateTestRoom(20, 20);
+    std::vector<int> found;
+
+    RoomObjectMoved(r, 1, ROOM_CELL_SIZE, ROOM_CELL_SIZE);
+    RoomObjectMoved(r, 2, 1, 1);
+    ASSERT_TRUE(GetRoomObjectsInRange(r, ROOM_CELL_SIZE + 1, ROOM_CELL_SIZE + 1, 1, found) == 0);
+    ASSERT_TRUE(GetRoomObjectsInRange(r, ROOM_CELL_SIZE + 1, ROOM_CELL_SIZE + 1, 2, found) == 1);
+    ASSERT_TRUE(found.size() == 1 && found[0] == 1);
+
+    // into the next cell over, and then within it
+    RoomObjectMoved(r, 1, ROOM_CELL_SIZE + 1, ROOM_CELL_SIZE + 1);
+    RoomObjectMoved(r, 1, ROOM_CELL_SIZE + 2, ROOM_CELL_SIZE + 1);
+    found.clear();
+    ASSERT_TRUE(GetRoomObjectsInRange(r, ROOM_CELL_SIZE, ROOM_CELL_SIZE, 2, found) == 0);
+    ASSERT_TRUE(GetRoomObjectsInRange(r, ROOM_CELL_SIZE + 2, ROOM_CELL_SIZE + 1, 0, found) == 1);
+    ASSERT_TRUE(r->cells[0].size() == 1 && r->cells[0][0] == 2);
+    ASSERT_TRUE(r->cells[r->cell_cols + 1].size() == 1);
+
+    // off the edge goes in the edge cell, and is still found by distance
+    RoomObjectMoved(r, 2, -3, 25);
+    found.clear();
+    ASSERT_TRUE(GetRoomObjectsInRange(r, 1, 20, 7, found) == 1);
+    ASSERT_TRUE(found[0] == 2);
+    ASSERT_TRUE(r->cells[r->cell_cols - 1].size() == 1 && r->cells[0].empty());
+
+    // leaving, twice, and a stranger leaving
+    RoomObjectRemoved(r, 1);
+    RoomObjectRemoved(r, 1);
+    RoomObjectRemoved(r, 3);
+    found.clear();
+    ASSERT_TRUE(GetRoomObjectsInRange(r, 10, 10, 100, found) == 1);
+    ASSERT_TRUE(found[0] == 2 && r->object_pos.size() == 1);
+
+    ClearRoomObjects(r);
+    ASSERT_TRUE(GetRoomObjectsInRange(r, 10, 10, 100, found) == 0);
+    for (auto &ids : r->cells)
+        ASSERT_TRUE(ids.empty());
+
+    delete r;
+    return 0;
+}
+
+// Random comings, goings and moves, some of them just past the walls,
+// with every few checked against a scan of where everything is
+static int test_room_objects_in_range_matches_scan(void)
+{
+    std::mt19937 rng(26);
+    roomdata_node *r = CreateTestRoom(50, 71);
+    room_positions where;
+    std::vector<int> found;
+    int i, object_id, row, col;
+
+    for (i = 0; i < 20000; i++)
+    {
+        object_id = 1 + rng() % 300;
+        if (rng() % 5 == 0)
+        {
+            RoomObjectRemoved(r, object_id);
+            where.erase(object_id);
+        }
+        else
+        {
+            // mostly short steps, the way things walk
+            auto it = where.find(object_id);
+            if (it != where.end() && rng() % 4 != 0)
+            {
+                row = it->second.first + (int) (rng() % 7) - 3;
+                col = it->second.second + (int) (rng() % 7) - 3;
+            }
+            else
+            {
+                row = (int) (rng() % 58) - 3;
+                col = (int) (rng() % 79) - 3;
+            }
+            RoomObjectMoved(r, object_id, row, col);
+            where[object_id] = std::make_pair(row, col);
+        }
+
+        if (i % 10 == 0)
+        {
+            row = (int) (rng() % 60) - 5;
+            col = (int) (rng() % 81) - 5;
+            ASSERT_TRUE(InRangeMatchesScan(r, where, row, col, rng() % 25));
+        }
+    }
+
+    ASSERT_TRUE(r->object_pos.size() == where.size());
+    ASSERT_TRUE(InRangeMatchesScan(r, where, 25, 35, 100));
+    ASSERT_TRUE(GetRoomObjectsInRange(r, 25, 35, -1, found) == 0 && found.empty());
+
+    delete r;
+    return 0;
+}
+
+// Objects of the BenchLink classes, each a subclass of the one before and
+// all of BenchTarget, asked about by each of their classes
+static int test_room_objects_of_class_matches_scan(void)
+{
+    static const char *class_names[] =
+    {
+        "BenchTarget", "BenchLink1", "BenchLink2", "BenchLink4", "BenchLink8", "System",
+    };
+    std::mt19937 rng(260);
+    roomdata_node *r = CreateTestRoom(30, 30);
+    std::vector<int> objects;
+    room_positions where;
+    class_node *c;
+    int i, j, object_id;
+
+    for (i = 0; i < 60; i++)
+    {
+        c = GetClassByName(class_names[i % 5]);
+        ASSERT_TRUE(c != NULL);
+        objects.push_back(CreateObject(c->class_id, 0, NULL));
+    }
+
+    for (i = 0; i < 3000; i++)
+    {
+        object_id = objects[rng() % objects.size()];
+        if (rng() % 4 == 0)
+        {
+            RoomObjectRemoved(r, object_id);
+            where.erase(object_id);
+        }
+        else
+        {
+            where[object_id] = std::make_pair(1 + (int) (rng() % 30), 1 + (int) (rng() % 30));
+            RoomObjectMoved(r, object_id, where[object_id].first, where[object_id].second);
+        }
+
+        if (i % 50 == 0)
+        {
+            for (j = 0; j < (int) (sizeof(class_names) / sizeof(class_names[0])); j++)
+            {
+                c = GetClassByName(class_names[j]);
+                ASSERT_TRUE(c != NULL);
+                ASSERT_TRUE(OfClassMatchesScan(r, where, c->class_id));
+            }
+        }
+    }
+
+    // everyone gone
+    for (int id : objects)
+        RoomObjectRemoved(r, id);
+    where.clear();
+    ASSERT_TRUE(OfClassMatchesScan(r, where, GetClassByName("BenchTarget")->class_id));
+    for (auto &ids : r->cells)
+        ASSERT_TRUE(ids.empty());
+
+    delete r;
+    return 0;
+}
+
+void run_roomdata_tests(int *tests_run, int *failures)
+{
+    *failures += run_test("test_room_objects_move_between_cells", test_room_objects_move_between_cells, tests_run);
+    *failures += run_test("test_room_objects_in_range_matches_scan", test_room_objects_in_range_matches_scan, tests_run);
+    *failures += run_test("test_room_objects_of_class_matches_scan", test_room_objects_of_class_matches_scan, tests_run);
+}
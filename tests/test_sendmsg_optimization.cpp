@@ -54,6 +54,22 @@ void eprintf(const char *format, ...) { (void)format; }
 void bprintf(const char *format, ...) { (void)format; }
 void dprintf(const char *format, ...) { (void)format; }
 void SendSessionAdminText(int session_id, const char *format, ...) { (void)session_id; (void)format; }
+
+// Mocks for memory, which the post queue takes its room from
+void *AllocateMemoryDebug(int malloc_id, size_t size, const char *filename, int linenumber) {
+    (void)malloc_id; (void)filename; (void)linenumber;
+    return malloc(size);
+}
+void *ResizeMemory(int malloc_id, void *ptr, int old_size, int new_size) {
+    (void)malloc_id; (void)old_size;
+    return realloc(ptr, new_size);
+}
+void FreeMemoryX(int malloc_id, void **ptr, size_t size) {
+    (void)malloc_id; (void)size;
+    free(*ptr);
+    *ptr = NULL;
+}
+void lprintf(const char *format, ...) { (void)format; }
 void FlushDefaultChannels(void) {}
 
 const char *GetNameByID(int id) { (void)id; return "MockName"; }
@@ -82,16 +98,42 @@ message_node *GetMessageByID(int class_id, int message_id, class_node **c_ret) {
     return nullptr;
 }
 
-// Stub for SendBlakodMessage which is called by SendTopLevelBlakodMessage
-blak_int SendBlakodMessage(int object_id,int message_id,int num_parms,parm_node parms[]) {
-    // We don't need to implement logic, just return something
-    (void)object_id; (void)message_id; (void)num_parms; (void)parms;
-    return 0;
-}
+// Stub for the profiler, which is off in these tests
+void ProfileRebase(int insts) { (void)insts; }
+
+// Stubs for latency tracking
+UINT64 GetMicroCount(void) { return g_mock_milli_count * 1000; }
+void LatencyRecord(int phase, UINT64 microseconds) { (void)phase; (void)microseconds; }
+void LatencyCheckStall(void) {}
+
+// Stub for SendBlakodMessage which is called by SendTopLevelBlakodMessage.
+// It records what posted messages arrive with, and can post more of them.
+static std::vector<int> g_sent_values;
+static int g_posts_per_send = 0;
+static int g_instructions_per_send = 0;
+
+blak_int SendBlakodMessage(int object_id,int message_id,int num_parms,parm_node parms[]);
 
 // Include sendmsg.c to test InitProfiling and SendTopLevelBlakodMessage
 #include "../blakserv/sendmsg.c"
 
+blak_int SendBlakodMessage(int object_id,int message_id,int num_parms,parm_node parms[]) {
+    (void)object_id; (void)message_id;
+    num_interpreted += g_instructions_per_send;
+    if (num_parms > 0)
+    {
+        g_sent_values.push_back((int) parms[num_parms-1].value);
+        if (g_posts_per_send > 0 && parms[0].value > 0)
+        {
+            parm_node p[2];
+            p[0].value = parms[0].value - 1;
+            p[1].value = parms[num_parms-1].value + 1;
+            PostBlakodMessage(object_id, message_id, 2, p);
+        }
+    }
+    return 0;
+}
+
 // Test functions
 
 static int test_init_profiling_sets_debug_initlocals(void)
@@ -139,6 +181,120 @@ static int test_send_top_level_refresh(void)
     return 0;
 }
 
+// More posts than the queue used to hold all arrive, in order, with the
+// parms they were posted with
+static int test_post_queue_grows(void)
+{
+    const int num_posts = 10000;
+    parm_node parms[MAX_NAME_PARMS];
+    int i;
+
+    g_sent_values.clear();
+    g_posts_per_send = 0;
+    for (i = 0; i < num_posts; i++)
+    {
+        int num_parms = 1 + i % MAX_NAME_PARMS;
+        for (int j = 0; j < num_parms; j++)
+        {
+            parms[j].name_id = j;
+            parms[j].value = 0;
+        }
+        parms[num_parms-1].value = i;
+        PostBlakodMessage(1, 1, num_parms, parms);
+    }
+    ASSERT_TRUE(test_kod_stat.post_queue_highest >= num_posts);
+
+    SendTopLevelBlakodMessage(1, 1, 0, parms);
+
+    // the top level message itself has no parms, so isn't recorded
+    ASSERT_TRUE((int) g_sent_values.size() == num_posts);
+    for (i = 0; i < num_posts; i++)
+        ASSERT_TRUE(g_sent_values[i] == i);
+    ASSERT_TRUE(test_post_q.next == 0);
+    ASSERT_TRUE(test_post_q.last == 0);
+
+    return 0;
+}
+
+// Posts made while posts are being sent are sent too, though the queue
+// moves under them
+static int test_post_while_sending_posts(void)
+{
+    parm_node parms[2];
+    int i;
+
+    g_sent_values.clear();
+    g_posts_per_send = 1;
+    for (i = 0; i < 600; i++)
+    {
+        parms[0].value = 20;
+        parms[1].value = i*1000;
+        PostBlakodMessage(1, 1, 2, parms);
+    }
+
+    SendTopLevelBlakodMessage(1, 1, 0, parms);
+
+    // each of the 600 posts makes a chain of 20 more
+    ASSERT_TRUE((int) g_sent_values.size() == 600*21);
+    ASSERT_TRUE(g_sent_values[0] == 0);
+    ASSERT_TRUE(g_sent_values[600] == 1);
+    ASSERT_TRUE(g_sent_values[600*21-1] == 599*1000 + 20);
+    ASSERT_TRUE(test_post_q.next == 0);
+
+    g_posts_per_send = 0;
+    return 0;
+}
+
+static int CountPostParmChunks(void)
+{
+    int count = 0;
+
+    for (post_parm_chunk *chunk = test_post_q.chunks; chunk != NULL; chunk = chunk->next)
+        count++;
+    return count;
+}
+
+// Posts that keep being left over by the followup limit don't keep the
+// parms of the ones already sent
+static int test_post_parms_freed_when_left_over(void)
+{
+    parm_node parms[2];
+    int i;
+
+    g_sent_values.clear();
+    g_posts_per_send = 1;
+    g_instructions_per_send = 100;
+    for (i = 0; i < 50; i++)
+    {
+        parms[0].value = 1000000;
+        parms[1].value = i;
+        PostBlakodMessage(1, 1, 2, parms);
+    }
+
+    // each top level message sends about 100 posts, which post 100 more
+    for (i = 0; i < 500; i++)
+    {
+        SendTopLevelBlakodMessage(1, 1, 0, parms);
+        ASSERT_TRUE(test_post_q.next - test_post_q.last == 50);
+        ASSERT_TRUE(CountPostParmChunks() <= 2);
+    }
+    ASSERT_TRUE((int) g_sent_values.size() > 500*50);
+
+    // the chains still arrive in order
+    for (i = 50; i < (int) g_sent_values.size(); i++)
+        ASSERT_TRUE(g_sent_values[i] == g_sent_values[i-50] + 1);
+
+    // and once they stop, the queue empties and starts over
+    g_posts_per_send = 0;
+    g_instructions_per_send = 0;
+    SendTopLevelBlakodMessage(1, 1, 0, parms);
+    ASSERT_TRUE(test_post_q.next == 0);
+    ASSERT_TRUE(CountPostParmChunks() == 1);
+    ASSERT_TRUE(test_post_q.chunks->used == 0);
+
+    return 0;
+}
+
 int main(void)
 {
     int tests_run = 0;
@@ -146,6 +302,9 @@ int main(void)
 
     failures += run_test("test_init_profiling_sets_debug_initlocals", test_init_profiling_sets_debug_initlocals, &tests_run);
     failures += run_test("test_send_top_level_refresh", test_send_top_level_refresh, &tests_run);
+    failures += run_test("test_post_queue_grows", test_post_queue_grows, &tests_run);
+    failures += run_test("test_post_while_sending_posts", test_post_while_sending_posts, &tests_run);
+    failures += run_test("test_post_parms_freed_when_left_over", test_post_parms_freed_when_left_over, &tests_run);
 
     if (failures != 0)
     {
@@ -0,0 +1,112 @@
+// Tests that need the server itself: the whole server but main.c, built
+// the same as bench_blakod and started the same way, on the classes in
+// bench/bench.kod.
+//
+// Usage: server_tests [kod_dir]
+
+#include "test_framework.h"
+#include "../blakserv/blakserv.h"
+
+// config.c uses this to load blakserv.cfg, but doesn't export it
+const char *AddConfig(int config_id, const char *config_data, int config_type, int is_dynamic);
+
+// The server's main.c isn't linked in; these stand in for what it defines.
+DWORD main_thread_id;
+bool InMainLoop(void) { return false; }
+void MainExitServer(void) { }
+
+extern void run_roomdata_tests(int *tests_run, int *failures);
+extern void run_array_tests(int *tests_run, int *failures);
+extern void run_user_tests(int *tests_run, int *failures);
+extern void run_string_tests(int *tests_run, int *failures);
+extern void run_class_tests(int *tests_run, int *failures);
+
+static bool SetPath(int config_id, const char *path)
+{
+    const char *error = AddConfig(config_id, path, CONFIG_PATH, false);
+
+    if (error != NULL)
+    {
+        fprintf(stderr, "server_tests: %s: %s\n", path, error);
+        return false;
+    }
+    return true;
+}
+
+// Everything between opening the channels and closing them
+static int RunServerTests(const char *kod_dir)
+{
+    int tests_run = 0;
+    int failures = 0;
+
+    InitClass();
+    InitMessage();
+    InitObject();
+    InitList();
+    InitArray();
+    InitTimer();
+    InitSession();
+    InitResource();
+    InitRoomData();
+    InitString();
+    InitUser();
+    InitAccount();
+    InitNameID();
+    InitLoadBof();
+    InitTime();
+    InitLatency();
+    InitMetrics();
+    InitBkodInterpret();
+    InitBufferPool();
+    InitTable();
+
+    LoadBof();
+    LoadRsc();
+    LoadKodbase();
+
+    if (GetClassByID(SYSTEM_CLASS) == NULL)
+    {
+        fprintf(stderr, "server_tests: no system class in %s; build it with make test\n", kod_dir);
+        return 1;
+    }
+
+    SetSystemObjectID(CreateObject(SYSTEM_CLASS, 0, NULL));
+
+    run_roomdata_tests(&tests_run, &failures);
+    run_array_tests(&tests_run, &failures);
+    run_user_tests(&tests_run, &failures);
+    run_string_tests(&tests_run, &failures);
+    run_class_tests(&tests_run, &failures);
+
+    if (failures != 0)
+    {
+        fprintf(stderr, "%d test(s) failed.\n", failures);
+        return 1;
+    }
+
+    printf("All %d tests passed.\n", tests_run);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    const char *kod_dir = argc > 1 ? argv[1] : "bench_build";
+    int rc;
+
+    // The same start up as bench_blakod; see there
+    InitChannelBuffer();
+    InitMemory();
+    InitConfig();
+    if (!SetPath(PATH_BOF, kod_dir) || !SetPath(PATH_MEMMAP, kod_dir) ||
+        !SetPath(PATH_RSC, kod_dir) || !SetPath(PATH_KODBASE, kod_dir) ||
+        !SetPath(PATH_CHANNEL, kod_dir) || !SetPath(PATH_LOADSAVE, kod_dir))
+        return 1;
+    LoadConfig();
+    OpenDefaultChannels();
+
+    rc = RunServerTests(kod_dir);
+
+    CloseDefaultChannels();
+
+    return rc;
+}
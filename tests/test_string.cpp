@@ -0,0 +1,107 @@
+#include <string>
+#include "test_framework.h"
+#include "../blakserv/blakserv.h"
+
+static parm_node MakeParm(int tag, int data)
+{
+    parm_node parm;
+    val_type val;
+
+    val.int_val = NIL;
+    val.v.tag = tag;
+    val.v.data = data;
+    parm.type = CONSTANT;
+    parm.value = val.int_val;
+    parm.name_id = 0;
+    return parm;
+}
+
+static parm_node TempStringParm(void)
+{
+    return MakeParm(TAG_TEMP_STRING, 0);
+}
+
+// StringSubstitute(s0, s1, s2) as Blakod calls it; returns what it does
+static int Substitute(parm_node s0, parm_node s1, parm_node s2)
+{
+    parm_node parms[3] = { s0, s1, s2 };
+    val_type ret_val;
+
+    ret_val.int_val = C_StringSubstitute(0, NULL, 3, parms, 0, NULL);
+    return (int) ret_val.v.data;
+}
+
+static std::string TempString(void)
+{
+    string_node *snod = GetTempString();
+
+    return std::string(snod->data, snod->len_data);
+}
+
+static void SetTemp(const char *s)
+{
+    SetTempString((char *) s, (int) strlen(s));
+}
+
+// The temp string substituted into itself is copied out before the
+// rest of it is shifted over
+static int test_string_substitute_temp_into_itself(void)
+{
+    int b = CreateString("b");
+    int abc = CreateString("abc");
+
+    SetTemp("abc");
+    ASSERT_TRUE(Substitute(TempStringParm(), MakeParm(TAG_STRING, b), TempStringParm()) == 1);
+    ASSERT_TRUE(TempString() == "aabcc");
+    ASSERT_TRUE(GetTempString()->data[5] == '\0');
+
+    // the whole of it, for itself
+    SetTemp("abc");
+    ASSERT_TRUE(Substitute(TempStringParm(), TempStringParm(), TempStringParm()) == 1);
+    ASSERT_TRUE(TempString() == "abc");
+
+    // into the front, where the shift moves everything
+    SetTemp("bxyz");
+    ASSERT_TRUE(Substitute(TempStringParm(), MakeParm(TAG_STRING, b), TempStringParm()) == 1);
+    ASSERT_TRUE(TempString() == "bxyzxyz");
+
+    // not found, left alone
+    SetTemp("xyz");
+    ASSERT_TRUE(Substitute(TempStringParm(), MakeParm(TAG_STRING, abc), TempStringParm()) == 0);
+    ASSERT_TRUE(TempString() == "xyz");
+
+    FreeString(b);
+    FreeString(abc);
+    return 0;
+}
+
+// A string substituted into itself builds beside the old data
+static int test_string_substitute_string_into_itself(void)
+{
+    int xyz = CreateString("xyz");
+    int y = CreateString("y");
+    string_node *snod;
+
+    ASSERT_TRUE(Substitute(MakeParm(TAG_STRING, xyz), MakeParm(TAG_STRING, y),
+                           MakeParm(TAG_STRING, xyz)) == 1);
+    snod = GetStringByID(xyz);
+    ASSERT_TRUE(std::string(snod->data, snod->len_data) == "xxyzz");
+
+    // and the temp string into a string, and a string into the temp string
+    SetTemp("12");
+    ASSERT_TRUE(Substitute(MakeParm(TAG_STRING, xyz), MakeParm(TAG_STRING, y), TempStringParm()) == 1);
+    snod = GetStringByID(xyz);
+    ASSERT_TRUE(std::string(snod->data, snod->len_data) == "xx12zz");
+    ASSERT_TRUE(Substitute(TempStringParm(), TempStringParm(), MakeParm(TAG_STRING, xyz)) == 1);
+    ASSERT_TRUE(TempString() == "xx12zz");
+
+    FreeString(xyz);
+    FreeString(y);
+    return 0;
+}
+
+void run_string_tests(int *tests_run, int *failures)
+{
+    *failures += run_test("test_string_substitute_temp_into_itself", test_string_substitute_temp_into_itself, tests_run);
+    *failures += run_test("test_string_substitute_string_into_itself", test_string_substitute_string_into_itself, tests_run);
+}
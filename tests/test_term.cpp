@@ -56,32 +56,37 @@ static int test_GetTagName_Basic(void) {
     name = GetTagName(v);
     ASSERT_TRUE(strcmp(name, "$") == 0);
 
+    v.v.tag = TAG_ARRAY;
+    name = GetTagName(v);
+    ASSERT_TRUE(strcmp(name, "ARRAY") == 0);
+    ASSERT_TRUE(GetTagNum(name) == TAG_ARRAY);
+
     return 0;
 }
 
 static int test_GetTagName_Custom(void) {
     val_type v;
-    // Use TAG_RESERVED (14) which is not handled in the switch case in term.c
+    // Use TAG_DEBUGSTR (12) which is not handled in the switch case in term.c
     // This triggers the static buffer usage.
-    v.v.tag = TAG_RESERVED;
+    v.v.tag = TAG_DEBUGSTR;
     const char* name = GetTagName(v);
 
     // snprintf(s, sizeof(s), "%i",(int) val.v.tag);
-    // So it should return "14".
-    ASSERT_TRUE(strcmp(name, "14") == 0);
+    // So it should return "12".
+    ASSERT_TRUE(strcmp(name, "12") == 0);
     return 0;
 }
 
 static int test_GetTagName_Threading(void) {
     // This test attempts to detect race conditions in GetTagName.
     // We need to use tags that trigger the static buffer usage.
-    // However, we only have one such tag (TAG_RESERVED = 14) accessible via the enum constant.
+    // However, we only have one such tag (TAG_DEBUGSTR = 12) accessible via the enum constant.
     // But since tag is a 4-bit field, we are limited to 0-15.
-    // 0-13 and 15 are handled. 14 is the only one hitting default.
+    // 0-11 and 13-15 are handled. 12 is the only one hitting default.
 
-    // Wait, if we only have one value (14) that hits the buffer,
-    // both threads will write "14" to their buffer.
-    // If they share the buffer, they overwrite "14" with "14". No race condition visible!
+    // Wait, if we only have one value (12) that hits the buffer,
+    // both threads will write "12" to their buffer.
+    // If they share the buffer, they overwrite "12" with "12". No race condition visible!
 
     // We need at least TWO different values that hit the buffer to detect a race.
     // But we don't have them in the 4-bit space!
@@ -101,7 +106,7 @@ static int test_GetTagName_Threading(void) {
 
     // So GetDataName is the better candidate for threading test.
 
-    // I will verify GetTagName behavior for 14, but rely on GetDataName for the race test.
+    // I will verify GetTagName behavior for 12, but rely on GetDataName for the race test.
 
     return 0;
 }
@@ -0,0 +1,205 @@
+#include <map>
+#include <vector>
+#include "test_framework.h"
+#include "../blakserv/blakserv.h"
+
+#define TEST_USER_ACCOUNT 5000
+
+static std::vector<user_node *> visited;
+
+static void VisitUser(user_node *u)
+{
+    visited.push_back(u);
+}
+
+static std::vector<user_node *> UsersOfAccount(int account_id)
+{
+    visited.clear();
+    ForEachUserByAccountID(VisitUser, account_id);
+    return visited;
+}
+
+static std::vector<user_node *> AllUsers(void)
+{
+    visited.clear();
+    ForEachUser(VisitUser);
+    return visited;
+}
+
+static int CreateTarget(void)
+{
+    return CreateObject(GetClassByName("BenchTarget")->class_id, 0, NULL);
+}
+
+// What each account's lookups answer, to compare before and after
+typedef struct
+{
+    int count;
+    user_node *first;
+    std::vector<user_node *> users;
+} account_users;
+
+static std::map<int, account_users> LookUpAccounts(int num_accounts)
+{
+    std::map<int, account_users> accounts;
+
+    for (int account_id = TEST_USER_ACCOUNT; account_id < TEST_USER_ACCOUNT + num_accounts; account_id++)
+    {
+        account_users &a = accounts[account_id];
+        a.count = CountUserByAccountID(account_id);
+        a.first = GetFirstUserByAccountID(account_id);
+        a.users = UsersOfAccount(account_id);
+    }
+    return accounts;
+}
+
+// Every user is found by its object, and only by it
+static bool ObjectIndexMatchesList(void)
+{
+    for (user_node *u : AllUsers())
+    {
+        if (GetUserByObjectID(u->object_id) != u)
+            return false;
+    }
+    return true;
+}
+
+// Users of several accounts, made in turn with garbage in between so that
+// collection renumbers every one of their objects
+static int test_user_lookups_survive_gc(void)
+{
+    std::map<int, account_users> before, after;
+    std::vector<int> old_ids;
+    int i, account_id;
+
+    ClearUser();
+    for (i = 0; i < 40; i++)
+    {
+        CreateTarget();
+        account_id = TEST_USER_ACCOUNT + (i * 7) % 11;
+        ASSERT_TRUE(AssociateUser(account_id, CreateTarget()));
+    }
+    ASSERT_TRUE(!AssociateUser(TEST_USER_ACCOUNT, GetFirstUserByAccountID(TEST_USER_ACCOUNT + 1)->object_id));
+
+    before = LookUpAccounts(12);
+    for (user_node *u : AllUsers())
+        old_ids.push_back(u->object_id);
+    ASSERT_TRUE(before[TEST_USER_ACCOUNT].count == 4 && before[TEST_USER_ACCOUNT + 11].count == 0);
+    ASSERT_TRUE(before[TEST_USER_ACCOUNT].first == before[TEST_USER_ACCOUNT].users[0]);
+
+    GarbageCollect();
+
+    after = LookUpAccounts(12);
+    for (account_id = TEST_USER_ACCOUNT; account_id < TEST_USER_ACCOUNT + 12; account_id++)
+    {
+        ASSERT_TRUE(after[account_id].count == before[account_id].count);
+        ASSERT_TRUE(after[account_id].first == before[account_id].first);
+        ASSERT_TRUE(after[account_id].users == before[account_id].users);
+    }
+
+    // each user has a new object and is found by it, and the objects
+    // they had are gone or someone else's
+    i = 0;
+    for (user_node *u : AllUsers())
+    {
+        ASSERT_TRUE(u->object_id != old_ids[i]);
+        ASSERT_TRUE(GetObjectByID(u->object_id) != NULL);
+        i++;
+    }
+    ASSERT_TRUE(i == 40);
+    ASSERT_TRUE(ObjectIndexMatchesList());
+    for (int old_id : old_ids)
+    {
+        user_node *u = GetUserByObjectID(old_id);
+        ASSERT_TRUE(u == NULL || u->object_id == old_id);
+    }
+
+    ClearUser();
+    GarbageCollect();
+    return 0;
+}
+
+static int test_user_change_object_id(void)
+{
+    user_node *a, *b;
+
+    ClearUser();
+    ASSERT_TRUE(AssociateUser(TEST_USER_ACCOUNT, 100));
+    ASSERT_TRUE(AssociateUser(TEST_USER_ACCOUNT + 1, 200));
+    a = GetUserByObjectID(100);
+    b = GetUserByObjectID(200);
+
+    ASSERT_TRUE(ChangeUserObjectID(150, 100));
+    ASSERT_TRUE(GetUserByObjectID(150) == a && GetUserByObjectID(100) == NULL);
+    ASSERT_TRUE(a->object_id == 150);
+
+    // another user's object is refused, and nothing moves
+    ASSERT_TRUE(!ChangeUserObjectID(200, 150));
+    ASSERT_TRUE(GetUserByObjectID(150) == a && GetUserByObjectID(200) == b);
+    ASSERT_TRUE(a->object_id == 150 && b->object_id == 200);
+
+    ASSERT_TRUE(ChangeUserObjectID(150, 150));
+    ASSERT_TRUE(!ChangeUserObjectID(300, 100));
+    ASSERT_TRUE(ObjectIndexMatchesList());
+
+    ClearUser();
+    return 0;
+}
+
+// After deleting, the object and account are free to be used again as if
+// they never had been
+static int test_user_delete_leaves_no_stale_entries(void)
+{
+    std::vector<user_node *> users;
+    int i;
+
+    ClearUser();
+    for (i = 0; i < 5; i++)
+        ASSERT_TRUE(AssociateUser(TEST_USER_ACCOUNT, 100 + i));
+    ASSERT_TRUE(AssociateUser(TEST_USER_ACCOUNT + 1, 200));
+    users = UsersOfAccount(TEST_USER_ACCOUNT);
+
+    // from the middle, the newest and the oldest; the rest keep their order
+    ASSERT_TRUE(DeleteUserByObjectID(102) == 1);
+    ASSERT_TRUE(DeleteUserByObjectID(102) == 0);
+    ASSERT_TRUE(DeleteUserByObjectID(104) == 1);
+    ASSERT_TRUE(DeleteUserByObjectID(100) == 1);
+    ASSERT_TRUE(GetUserByObjectID(100) == NULL && GetUserByObjectID(102) == NULL &&
+                GetUserByObjectID(104) == NULL);
+    ASSERT_TRUE(CountUserByAccountID(TEST_USER_ACCOUNT) == 2);
+    ASSERT_TRUE(GetFirstUserByAccountID(TEST_USER_ACCOUNT) == users[1]);
+    ASSERT_TRUE(UsersOfAccount(TEST_USER_ACCOUNT) == std::vector<user_node *>({ users[1], users[3] }));
+    ASSERT_TRUE(AllUsers().size() == 3);
+
+    // an object that was a user's can be someone else's
+    ASSERT_TRUE(AssociateUser(TEST_USER_ACCOUNT + 2, 102));
+    ASSERT_TRUE(GetUserByObjectID(102)->account_id == TEST_USER_ACCOUNT + 2);
+
+    ASSERT_TRUE(DeleteUserByAccountID(TEST_USER_ACCOUNT) == 2);
+    ASSERT_TRUE(DeleteUserByAccountID(TEST_USER_ACCOUNT) == 0);
+    ASSERT_TRUE(CountUserByAccountID(TEST_USER_ACCOUNT) == 0);
+    ASSERT_TRUE(GetFirstUserByAccountID(TEST_USER_ACCOUNT) == NULL);
+    ASSERT_TRUE(UsersOfAccount(TEST_USER_ACCOUNT).empty());
+    for (i = 0; i < 5; i++)
+        ASSERT_TRUE(i == 2 || GetUserByObjectID(100 + i) == NULL);
+    ASSERT_TRUE(AllUsers().size() == 2);
+    ASSERT_TRUE(ObjectIndexMatchesList());
+
+    // and an account whose users are all gone starts over
+    ASSERT_TRUE(AssociateUser(TEST_USER_ACCOUNT, 101));
+    ASSERT_TRUE(CountUserByAccountID(TEST_USER_ACCOUNT) == 1);
+    ASSERT_TRUE(GetFirstUserByAccountID(TEST_USER_ACCOUNT)->object_id == 101);
+    ASSERT_TRUE(CountUserByAccountID(TEST_USER_ACCOUNT + 1) == 1);
+
+    ClearUser();
+    ASSERT_TRUE(AllUsers().empty() && GetUserByObjectID(101) == NULL);
+    ASSERT_TRUE(CountUserByAccountID(TEST_USER_ACCOUNT + 1) == 0);
+    return 0;
+}
+
+void run_user_tests(int *tests_run, int *failures)
+{
+    *failures += run_test("test_user_lookups_survive_gc", test_user_lookups_survive_gc, tests_run);
+    *failures += run_test("test_user_change_object_id", test_user_change_object_id, tests_run);
+    *failures += run_test("test_user_delete_leaves_no_stale_entries", test_user_delete_leaves_no_stale_entries, tests_run);
+}
@@ -0,0 +1,160 @@
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "test_framework.h"
+#include "../blakserv/blakserv.h"
+
+// A FIFO opened for reading here stands in for the webhook listener.
+
+static void WebhookTestPrefix(char *prefix, size_t size)
+{
+    snprintf(prefix, size, "whtest%d", (int) getpid());
+}
+
+static int OpenWebhookReader(const char *prefix)
+{
+    char path[128];
+
+    snprintf(path, sizeof(path), "/tmp/%s_m59apiwebhook1", prefix);
+    unlink(path);
+    if (mkfifo(path, 0600) != 0)
+        return -1;
+    return open(path, O_RDONLY | O_NONBLOCK);
+}
+
+static void CloseWebhookReader(const char *prefix, int fd)
+{
+    char path[128];
+
+    close(fd);
+    snprintf(path, sizeof(path), "/tmp/%s_m59apiwebhook1", prefix);
+    unlink(path);
+}
+
+// Read from fd until lines newlines have arrived or about two seconds pass
+static std::string ReadWebhookLines(int fd, int lines)
+{
+    std::string text;
+    char buf[4096];
+
+    for (int tries = 0; tries < 200; tries++)
+    {
+        ssize_t n;
+        while ((n = read(fd, buf, sizeof(buf))) > 0)
+            text.append(buf, n);
+
+        int found = 0;
+        for (char c : text)
+            found += (c == '\n');
+        if (found >= lines)
+            break;
+        usleep(10000);
+    }
+    return text;
+}
+
+static int test_webhook_delivers_batched_lines(void)
+{
+    char prefix[32];
+    webhook_stats ws;
+
+    WebhookTestPrefix(prefix, sizeof(prefix));
+    int fd = OpenWebhookReader(prefix);
+    ASSERT_TRUE(fd >= 0);
+
+    ASSERT_TRUE(StartWebhooks(prefix));
+    ASSERT_TRUE(SendWebhookMessage("first", 5));
+    ASSERT_TRUE(SendWebhookMessage("second", 6));
+    const char *event = "{\"event\":\"Third\",\"params\":{\"param1\":\"x\"}}";
+    ASSERT_TRUE(SendWebhookStructuredMessage(event, (int) strlen(event)));
+
+    std::string text = ReadWebhookLines(fd, 3);
+    ShutdownWebhooks();
+    GetWebhookStats(&ws);
+    CloseWebhookReader(prefix, fd);
+
+    size_t first = text.find("\"message\":\"first\"}\n");
+    size_t second = text.find("\"message\":\"second\"}\n");
+    size_t third = text.find(std::string(event) + "\n");
+    ASSERT_TRUE(first != std::string::npos);
+    ASSERT_TRUE(second != std::string::npos && second > first);
+    ASSERT_TRUE(third != std::string::npos && third > second);
+    ASSERT_TRUE(text.back() == '\n');
+
+    ASSERT_TRUE(ws.posted == 3);
+    ASSERT_TRUE(ws.dropped == 0);
+    ASSERT_TRUE(ws.undelivered == 0);
+    ASSERT_TRUE(ws.pipes[0].messages == 3);
+    ASSERT_TRUE(ws.pipes[0].writes >= 1 && ws.pipes[0].writes <= 3);
+    ASSERT_TRUE(ws.pipes[0].bytes == (INT64) text.size());
+    ASSERT_TRUE(ws.pipes[0].connects == 1);
+    return 0;
+}
+
+static int test_webhook_drops_oldest_without_listener(void)
+{
+    char prefix[32];
+    webhook_stats ws;
+
+    // No FIFO exists, so nothing can be delivered and the queue must overflow
+    WebhookTestPrefix(prefix, sizeof(prefix));
+    ASSERT_TRUE(StartWebhooks(prefix));
+    for (int i = 0; i < 2500; i++)
+        ASSERT_TRUE(SendWebhookMessage("lost", 4));
+
+    GetWebhookStats(&ws);
+    ASSERT_TRUE(ws.posted == 2500);
+    ASSERT_TRUE(ws.queued <= 1000);
+    ASSERT_TRUE(ws.dropped >= 500);
+
+    ShutdownWebhooks();
+    GetWebhookStats(&ws);
+    ASSERT_TRUE(ws.dropped + ws.undelivered == 2500);
+    ASSERT_TRUE(ws.pipes[0].connects == 0);
+    ASSERT_TRUE(!SendWebhookMessage("late", 4));
+    return 0;
+}
+
+// A fatal error exits with the writer running; the queue gets its last try
+// and the writer is stopped, rather than the process aborting on its std::thread
+static int test_webhook_stops_at_exit(void)
+{
+    char prefix[32];
+    int status;
+
+    WebhookTestPrefix(prefix, sizeof(prefix));
+    int fd = OpenWebhookReader(prefix);
+    ASSERT_TRUE(fd >= 0);
+
+    fflush(stdout);
+    pid_t pid = fork();
+    ASSERT_TRUE(pid >= 0);
+    if (pid == 0) {
+        freopen("/dev/null", "w", stderr);
+        if (!StartWebhooks(prefix) || !SendWebhookMessage("goodbye", 7))
+            _exit(2);
+        FatalErrorShow(__FILE__, __LINE__, "test");
+        _exit(2);   // not reached
+    }
+
+    ASSERT_TRUE(waitpid(pid, &status, 0) == pid);
+    std::string text = ReadWebhookLines(fd, 1);
+    CloseWebhookReader(prefix, fd);
+
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_TRUE(WEXITSTATUS(status) == 1);
+    ASSERT_TRUE(text.find("\"message\":\"goodbye\"}\n") != std::string::npos);
+    return 0;
+}
+
+void run_webhook_tests(int *tests_run, int *failures)
+{
+    *failures += run_test("test_webhook_delivers_batched_lines", test_webhook_delivers_batched_lines, tests_run);
+    *failures += run_test("test_webhook_drops_oldest_without_listener", test_webhook_drops_oldest_without_listener, tests_run);
+    *failures += run_test("test_webhook_stops_at_exit", test_webhook_stops_at_exit, tests_run);
+}
@@ -0,0 +1,1182 @@
+/*
+ * loadgen.c:  Drive a running server with simulated players, for
+ *   benchmarking.  Each bot logs in through the same protocol as the real
+ *   client, enters the game with the first character on its account, and
+ *   then walks, talks and attacks at the given rates until time is up.
+ *
+ *   Reported are the messages sent and received per second, the server's
+ *   CPU use (when it runs on this machine), and how long a move takes to
+ *   reach the other players: the time from a bot sending BP_REQ_MOVE to the
+ *   first BP_MOVE for its object arriving at any bot.
+ *
+ *   Linux only.  Bots need accounts with a character; -c creates them
+ *   through the maintenance port first, named <prefix>1, <prefix>2, ...
+ *
+ *   All bots come from one address, so the server's ConnectBurst and
+ *   ConnectPerMinute ([Socket] in blakserv.cfg) need to be 0 or big enough
+ *   for them, or it will close most of their connections.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <netdb.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#include <unordered_map>
+
+#include "osd_linux.h"
+#include "histogram.h"
+#include "proto.h"
+#include "crc.h"
+#include "md5.h"
+
+#define MAJOR_REV 7                /* Client version we claim to be */
+#define MINOR_REV 36
+#define P_CATCH 3                  /* See clientd3d/client.h */
+
+#define LENBYTES 2
+#define CRCBYTES 2
+#define HEADERBYTES 7              /* length, CRC, length again, epoch */
+#define SEED_COUNT 5               /* # of security streams; see GameRandomStreamsStep */
+
+#define READ_BUF_SIZE 65536
+#define WRITE_BUF_SIZE 65536
+#define MAX_MSG_SIZE 4096
+
+#define KOD_FINENESS 64            /* Kod has 64 units per grid square */
+#define WALK_RANGE KOD_FINENESS    /* How far bots wander from where they started */
+#define WALK_SPEED 18              /* USER_WALKING_SPEED in user.kod */
+
+#define PING_INTERVAL 10000        /* Milliseconds between BP_PINGs, like the client */
+#define POLL_MILLISECONDS 5
+
+/* Text of system_success_rsc, the server's default RedbookRsc */
+#define DEFAULT_REDBOOK "Success."
+
+enum { BOT_IDLE, BOT_CONNECTING, BOT_LOGIN, BOT_MENU, BOT_ENTERING, BOT_PLAYING, BOT_DEAD };
+
+typedef struct
+{
+   int index;
+   int sock;
+   int state;
+   char name[64];
+
+   unsigned char in[READ_BUF_SIZE];
+   int in_len;
+   unsigned char out[WRITE_BUF_SIZE];
+   int out_len;
+
+   unsigned int seeds[SEED_COUNT]; /* Security streams, from AP_GETCHOICE */
+   unsigned char epoch;            /* From the last game message we got */
+   unsigned int secure_token;      /* Mangles the type byte of server messages */
+   const char *sliding_token;
+
+   int object_id;
+   int room_id;
+   int start_row, start_col;       /* Kod coordinates, in fine units */
+   int row, col;
+   bool have_position;
+
+   UINT64 next_move, next_say, next_attack, next_ping;
+   UINT64 move_time;               /* When our last unanswered move went out, or 0 */
+} bot_type;
+
+static const char *host = "127.0.0.1";
+static int port = 5959;
+static int maintenance_port = 9998;
+static int num_bots = 10;
+static int seconds = 60;
+static int report_interval = 10;
+static int ramp_rate = 20;         /* Bots started per second */
+static int move_interval = 1000;   /* Milliseconds between actions of each kind, or 0 */
+static int say_interval = 15000;
+static int attack_interval = 5000;
+static const char *prefix = "bot";
+static const char *password = "bot";
+static const char *redbook = DEFAULT_REDBOOK;
+static bool create_accounts = false;
+static int server_pid = 0;
+static bool verbose = false;
+
+static struct sockaddr_in server_addr;
+static bot_type *bots;
+static std::unordered_map<int,bot_type *> bots_by_object;
+
+/* Totals for the whole run, and since the last report */
+typedef struct
+{
+   UINT64 msgs_sent, msgs_received;
+   UINT64 bytes_sent, bytes_received;
+   UINT64 moves, says, attacks;
+   histogram_type move_latency;    /* Microseconds */
+} loadgen_stats;
+
+static loadgen_stats total, interval;
+static int num_playing, num_failed;
+
+/************************************************************************/
+void Usage(void)
+{
+   printf("Usage: loadgen [options]\n");
+   printf("  -h <host>      server to connect to (default %s)\n", host);
+   printf("  -p <port>      game port (default %d)\n", port);
+   printf("  -n <bots>      number of bots (default %d)\n", num_bots);
+   printf("  -t <seconds>   how long to run once all bots have started (default %d)\n", seconds);
+   printf("  -i <seconds>   seconds between progress reports (default %d)\n", report_interval);
+   printf("  -r <bots>      bots started per second (default %d)\n", ramp_rate);
+   printf("  -M <ms>        milliseconds between each bot's moves, 0 for none (default %d)\n",
+          move_interval);
+   printf("  -S <ms>        milliseconds between each bot's says, 0 for none (default %d)\n",
+          say_interval);
+   printf("  -A <ms>        milliseconds between each bot's attacks, 0 for none (default %d)\n",
+          attack_interval);
+   printf("  -a <prefix>    account names are <prefix>1, <prefix>2, ... (default %s)\n", prefix);
+   printf("  -w <password>  password of every bot account (default %s)\n", password);
+   printf("  -c             create the accounts first, through the maintenance port\n");
+   printf("  -m <port>      maintenance port, for -c (default %d)\n", maintenance_port);
+   printf("  -P <pid>       server process to measure CPU use of (default: find blakserv)\n");
+   printf("  -R <string>    text of the server's security redbook resource (default \"%s\")\n",
+          redbook);
+   printf("  -v             print every message type received\n");
+   exit(1);
+}
+/************************************************************************/
+static UINT64 GetMicroTime(void)
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (UINT64) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+/************************************************************************/
+/*
+ * Jitter:  Return a time between 0.5 and 1.5 times interval milliseconds
+ *   from now, in microseconds, so that bots don't all act in step.
+ */
+static UINT64 Jitter(UINT64 now, int interval)
+{
+   return now + (UINT64) interval * (500 + rand() % 1000);
+}
+/************************************************************************/
+static void BotError(bot_type *b, const char *fmt, ...)
+{
+   va_list marker;
+
+   printf("%s: ", b->name);
+   va_start(marker, fmt);
+   vprintf(fmt, marker);
+   va_end(marker);
+   printf("\n");
+}
+/************************************************************************/
+/*
+ * BotClose:  Hang up bot b; it takes no further part in the run.
+ */
+static void BotClose(bot_type *b)
+{
+   if (b->sock >= 0)
+      close(b->sock);
+   b->sock = -1;
+
+   if (b->state == BOT_PLAYING)
+      num_playing--;
+   if (b->object_id != 0)
+      bots_by_object.erase(b->object_id);
+
+   b->state = BOT_DEAD;
+   num_failed++;
+}
+/************************************************************************/
+/*
+ * BotFlush:  Write as much of b's output buffer as the socket will take.
+ */
+static void BotFlush(bot_type *b)
+{
+   int written;
+
+   if (b->out_len == 0 || b->sock < 0)
+      return;
+
+   written = (int) send(b->sock, b->out, b->out_len, MSG_NOSIGNAL);
+   if (written < 0)
+   {
+      if (errno != EAGAIN && errno != EWOULDBLOCK)
+      {
+         BotError(b, "write error %s", strerror(errno));
+         BotClose(b);
+      }
+      return;
+   }
+
+   memmove(b->out, b->out + written, b->out_len - written);
+   b->out_len -= written;
+}
+/************************************************************************/
+/*
+ * RandomStreamsStep:  Step b's security streams, as the server does for
+ *   each game message it gets, and return one.
+ */
+static unsigned int RandomStreamsStep(bot_type *b)
+{
+   int i, stream;
+
+   for (i=0; i < SEED_COUNT; i++)
+      b->seeds[i] = (b->seeds[i] * 9301 + 49297) % 233280;
+
+   stream = b->seeds[SEED_COUNT - 1] % (SEED_COUNT - 1);
+   return b->seeds[stream];
+}
+/************************************************************************/
+/*
+ * BotSend:  Queue the message msg of len bytes to the server, with the
+ *   header for b's current state.
+ */
+static void BotSend(bot_type *b, const char *msg, int len)
+{
+   unsigned short length = (unsigned short) len, security = 0;
+   unsigned char *ptr;
+
+   if (b->sock < 0)
+      return;
+
+   if (b->out_len + HEADERBYTES + len > WRITE_BUF_SIZE)
+   {
+      BotError(b, "server isn't reading; output buffer full");
+      BotClose(b);
+      return;
+   }
+
+   /* In the game, the CRC field carries the security stream */
+   if (b->state >= BOT_ENTERING)
+   {
+      security = (unsigned short) RandomStreamsStep(b);
+      security ^= length;
+      security ^= ((unsigned int) (unsigned char) msg[0] << 4);
+      security ^= (unsigned short) CRC32(msg, len);
+   }
+   else security = (unsigned short) CRC32(msg, len);
+
+   ptr = b->out + b->out_len;
+   memcpy(ptr, &length, LENBYTES);
+   memcpy(ptr + LENBYTES, &security, CRCBYTES);
+   memcpy(ptr + LENBYTES + CRCBYTES, &length, LENBYTES);
+   ptr[LENBYTES * 2 + CRCBYTES] = b->state >= BOT_ENTERING ? b->epoch : 0;
+   memcpy(ptr + HEADERBYTES, msg, len);
+   b->out_len += HEADERBYTES + len;
+
+   total.msgs_sent++;
+   interval.msgs_sent++;
+   total.bytes_sent += HEADERBYTES + len;
+   interval.bytes_sent += HEADERBYTES + len;
+
+   BotFlush(b);
+}
+/************************************************************************/
+/* Helpers for building messages */
+static char *AddByte(char *ptr, int byte1)
+{
+   *ptr = (char) byte1;
+   return ptr + 1;
+}
+static char *AddShort(char *ptr, int byte2)
+{
+   short s = (short) byte2;
+   memcpy(ptr, &s, 2);
+   return ptr + 2;
+}
+static char *AddInt(char *ptr, int byte4)
+{
+   memcpy(ptr, &byte4, 4);
+   return ptr + 4;
+}
+static char *AddString(char *ptr, const char *str, int len)
+{
+   ptr = AddShort(ptr, len);
+   memcpy(ptr, str, len);
+   return ptr + len;
+}
+/************************************************************************/
+static void SendLogin(bot_type *b)
+{
+   char msg[MAX_MSG_SIZE], *ptr = msg;
+   unsigned char digest[ENCRYPT_LEN + 1];
+
+   MDString(password, digest);
+   digest[ENCRYPT_LEN] = 0;
+
+   ptr = AddByte(ptr, AP_LOGIN);
+   ptr = AddByte(ptr, MAJOR_REV);
+   ptr = AddByte(ptr, MINOR_REV);
+   ptr = AddInt(ptr, 0);           /* OS type and version */
+   ptr = AddInt(ptr, 0);
+   ptr = AddInt(ptr, 0);
+   ptr = AddInt(ptr, 0);           /* RAM */
+   ptr = AddInt(ptr, 0);           /* CPU */
+   ptr = AddShort(ptr, 1024);      /* Screen size */
+   ptr = AddShort(ptr, 768);
+   ptr = AddInt(ptr, 0);           /* Displays possible */
+   ptr = AddInt(ptr, 0);           /* Bandwidth */
+   ptr = AddInt(ptr, 32);          /* Color depth and partner */
+   ptr = AddString(ptr, b->name, (int) strlen(b->name));
+   ptr = AddString(ptr, (const char *) digest, ENCRYPT_LEN);
+   BotSend(b, msg, (int) (ptr - msg));
+}
+/************************************************************************/
+static void SendRequestGame(bot_type *b)
+{
+   char msg[MAX_MSG_SIZE], *ptr = msg;
+
+   ptr = AddByte(ptr, AP_REQ_GAME);
+   ptr = AddInt(ptr, 0x7fffffff);  /* Last download time; we want no files */
+   ptr = AddInt(ptr, ((MAJOR_REV * 100) + MINOR_REV) * P_CATCH + P_CATCH);
+   ptr = AddString(ptr, host, (int) strlen(host));
+   BotSend(b, msg, (int) (ptr - msg));
+}
+/************************************************************************/
+static void SendSimple(bot_type *b, int type)
+{
+   char msg = (char) type;
+   BotSend(b, &msg, 1);
+}
+/************************************************************************/
+static void SendUseCharacter(bot_type *b, int object_id)
+{
+   char msg[MAX_MSG_SIZE], *ptr = msg;
+
+   ptr = AddByte(ptr, BP_USE_CHARACTER);
+   ptr = AddInt(ptr, object_id);
+   BotSend(b, msg, (int) (ptr - msg));
+}
+/************************************************************************/
+static void SendMove(bot_type *b, UINT64 now)
+{
+   char msg[MAX_MSG_SIZE], *ptr = msg;
+
+   /* Wander within a square of where we started */
+   b->row = b->start_row + rand() % (2 * WALK_RANGE + 1) - WALK_RANGE;
+   b->col = b->start_col + rand() % (2 * WALK_RANGE + 1) - WALK_RANGE;
+
+   ptr = AddByte(ptr, BP_REQ_MOVE);
+   ptr = AddShort(ptr, b->row);
+   ptr = AddShort(ptr, b->col);
+   ptr = AddByte(ptr, WALK_SPEED);
+   ptr = AddInt(ptr, b->room_id);
+   BotSend(b, msg, (int) (ptr - msg));
+
+   b->move_time = now;
+   total.moves++;
+   interval.moves++;
+}
+/************************************************************************/
+static void SendSay(bot_type *b)
+{
+   char msg[MAX_MSG_SIZE], *ptr = msg;
+   char text[100];
+
+   snprintf(text, sizeof(text), "%s says hello %d", b->name, rand() % 1000);
+
+   ptr = AddByte(ptr, BP_SAY_TO);
+   ptr = AddByte(ptr, SAY_NORMAL);
+   ptr = AddString(ptr, text, (int) strlen(text));
+   BotSend(b, msg, (int) (ptr - msg));
+
+   total.says++;
+   interval.says++;
+}
+/************************************************************************/
+static void SendAttack(bot_type *b)
+{
+   char msg[MAX_MSG_SIZE], *ptr = msg;
+   bot_type *target;
+   int i;
+
+   /* Pick another bot that's in the game */
+   for (i=0; i < 10; i++)
+   {
+      target = &bots[rand() % num_bots];
+      if (target != b && target->state == BOT_PLAYING)
+         break;
+   }
+   if (i == 10)
+      return;
+
+   ptr = AddByte(ptr, BP_REQ_ATTACK);
+   ptr = AddByte(ptr, ATTACK_NORMAL);
+   ptr = AddInt(ptr, target->object_id);
+   BotSend(b, msg, (int) (ptr - msg));
+
+   total.attacks++;
+   interval.attacks++;
+}
+/************************************************************************/
+/*
+ * Parser:  Reads fields from a received message, failing (and staying
+ *   failed) if the message is too short.
+ */
+typedef struct
+{
+   const unsigned char *ptr, *end;
+   bool ok;
+} parser_type;
+
+static void ParseBytes(parser_type *p, void *result, int len)
+{
+   if (!p->ok || p->end - p->ptr < len)
+   {
+      p->ok = false;
+      if (result != NULL)
+         memset(result, 0, len);
+      return;
+   }
+   if (result != NULL)
+      memcpy(result, p->ptr, len);
+   p->ptr += len;
+}
+static int ParseByte(parser_type *p)
+{
+   unsigned char byte1;
+   ParseBytes(p, &byte1, 1);
+   return byte1;
+}
+static int ParseShort(parser_type *p)
+{
+   unsigned short byte2;
+   ParseBytes(p, &byte2, 2);
+   return byte2;
+}
+static int ParseInt(parser_type *p)
+{
+   int byte4;
+   ParseBytes(p, &byte4, 4);
+   return byte4;
+}
+static void ParseSkipString(parser_type *p)
+{
+   ParseBytes(p, NULL, ParseShort(p));
+}
+/************************************************************************/
+/* The following skip over the parts of an object in BP_ROOM_CONTENTS;
+   see ExtractNewRoomObject in the client */
+static void ParsePaletteTranslation(parser_type *p)
+{
+   int type;
+
+   if (!p->ok || p->ptr >= p->end)
+      return;
+
+   type = *p->ptr;
+   if (type == ANIMATE_TRANSLATION || type == ANIMATE_EFFECT)
+      ParseBytes(p, NULL, 2);
+}
+static void ParseAnimation(parser_type *p)
+{
+   switch (ParseByte(p))
+   {
+   case ANIMATE_NONE:
+      ParseBytes(p, NULL, SIZE_ANIMATE_GROUP);
+      break;
+   case ANIMATE_CYCLE:
+      ParseBytes(p, NULL, 4 + 2 * SIZE_ANIMATE_GROUP);
+      break;
+   case ANIMATE_ONCE:
+      ParseBytes(p, NULL, 4 + 3 * SIZE_ANIMATE_GROUP);
+      break;
+   }
+}
+static void ParseOverlays(parser_type *p)
+{
+   int i, num;
+
+   num = ParseByte(p);
+   for (i=0; i < num && p->ok; i++)
+   {
+      ParseBytes(p, NULL, SIZE_ID + SIZE_HOTSPOT);
+      ParsePaletteTranslation(p);
+      ParseAnimation(p);
+   }
+}
+/************************************************************************/
+/*
+ * ParseRoomObject:  Skip over one object of BP_ROOM_CONTENTS, returning
+ *   its id and setting its position.
+ */
+static int ParseRoomObject(parser_type *p, int *row, int *col)
+{
+   int id;
+
+   id = ParseInt(p);
+   if (((unsigned int) id >> 28) == CLIENT_TAG_NUMBER)
+      ParseBytes(p, NULL, SIZE_AMOUNT);
+   ParseBytes(p, NULL, 3 * SIZE_ID + 4);   /* Icon, name, rarity, flags */
+   if (ParseShort(p) != LIGHT_FLAG_NONE)
+      ParseBytes(p, NULL, 3);
+   ParsePaletteTranslation(p);
+   ParseAnimation(p);
+   ParseOverlays(p);
+
+   *row = ParseShort(p);
+   *col = ParseShort(p);
+   ParseBytes(p, NULL, SIZE_ANGLE);
+   ParsePaletteTranslation(p);
+   ParseAnimation(p);
+   ParseOverlays(p);
+
+   return id;
+}
+/************************************************************************/
+static void StartPlaying(bot_type *b, UINT64 now)
+{
+   if (b->state == BOT_PLAYING)
+      return;
+
+   b->state = BOT_PLAYING;
+   num_playing++;
+   bots_by_object[b->object_id] = b;
+
+   b->next_move = move_interval ? Jitter(now, move_interval) : 0;
+   b->next_say = say_interval ? Jitter(now, say_interval) : 0;
+   b->next_attack = attack_interval ? Jitter(now, attack_interval) : 0;
+   b->next_ping = Jitter(now, PING_INTERVAL);
+}
+/************************************************************************/
+/*
+ * HandleLoginMessage:  Handle a message to b before it's in the game.
+ */
+static void HandleLoginMessage(bot_type *b, parser_type *p, int type)
+{
+   int i;
+
+   switch (type)
+   {
+   case AP_GETLOGIN:
+      SendLogin(b);
+      break;
+
+   case AP_LOGINOK:
+      b->state = BOT_MENU;
+      break;
+
+   case AP_GETCHOICE:
+      for (i=0; i < SEED_COUNT; i++)
+         b->seeds[i] = (unsigned int) ParseInt(p);
+      SendRequestGame(b);
+      break;
+
+   case AP_GAME:
+      b->state = BOT_ENTERING;
+      break;
+
+   case AP_LOGINFAILED:
+      BotError(b, "login failed; does the account exist (see -c)?");
+      BotClose(b);
+      break;
+
+   case AP_NOCHARACTERS:
+      BotError(b, "account has no characters");
+      BotClose(b);
+      break;
+
+   case AP_DOWNLOAD:
+      BotError(b, "server wants the client to download files");
+      BotClose(b);
+      break;
+
+   case AP_ACCOUNTUSED:
+   case AP_TOOMANYLOGINS:
+   case AP_TIMEOUT:
+   case AP_MESSAGE:
+      BotError(b, "login refused (message %d)", type);
+      BotClose(b);
+      break;
+   }
+}
+/************************************************************************/
+/*
+ * HandleGameMessage:  Handle a message to b once it's in the game.
+ */
+static void HandleGameMessage(bot_type *b, parser_type *p, int type, UINT64 now)
+{
+   std::unordered_map<int,bot_type *>::iterator it;
+   bot_type *mover;
+   int i, num, id, row, col;
+
+   switch (type)
+   {
+   case BP_ECHO_PING:
+      b->secure_token = (unsigned int) (ParseByte(p) ^ 0xED);
+      b->sliding_token = redbook;
+      break;
+
+   case BP_CHARACTERS:
+      /* Play the first character on the account */
+      if (ParseShort(p) == 0)
+      {
+         BotError(b, "account has no characters");
+         BotClose(b);
+         break;
+      }
+      id = ParseInt(p);
+      SendUseCharacter(b, id);
+      break;
+
+   case BP_PLAYER:
+      b->object_id = ParseInt(p);
+      ParseBytes(p, NULL, 2 * SIZE_ID);
+      b->room_id = ParseInt(p);
+      b->have_position = false;
+      break;
+
+   case BP_ROOM_CONTENTS:
+      ParseInt(p);
+      num = ParseShort(p);
+      for (i=0; i < num && p->ok; i++)
+      {
+         id = ParseRoomObject(p, &row, &col);
+         if (p->ok && id == b->object_id)
+         {
+            b->start_row = b->row = row;
+            b->start_col = b->col = col;
+            b->have_position = true;
+         }
+      }
+      if (b->have_position && b->object_id != 0)
+         StartPlaying(b, now);
+      break;
+
+   case BP_MOVE:
+      id = ParseInt(p);
+      if (!p->ok)
+         break;
+
+      /* The first bot to hear of a move gives its broadcast latency */
+      it = bots_by_object.find(id);
+      if (it == bots_by_object.end())
+         break;
+      mover = it->second;
+      if (mover->move_time != 0 && mover != b)
+      {
+         HistogramRecord(&total.move_latency, now - mover->move_time);
+         HistogramRecord(&interval.move_latency, now - mover->move_time);
+         mover->move_time = 0;
+      }
+      break;
+
+   case BP_RESYNC:
+      BotError(b, "server lost sync with us");
+      BotClose(b);
+      break;
+
+   case BP_QUIT:
+      BotError(b, "server sent us back to the login menu");
+      BotClose(b);
+      break;
+   }
+}
+/************************************************************************/
+/*
+ * BotHandleMessage:  Handle the message of len bytes at msg, received by b
+ *   with the given epoch.
+ */
+static void BotHandleMessage(bot_type *b, unsigned char *msg, int len, int epoch, UINT64 now)
+{
+   parser_type p;
+   int type;
+
+   if (len <= 0)
+      return;
+
+   total.msgs_received++;
+   interval.msgs_received++;
+
+   /* The type byte is mangled by a token that changes with every message;
+      see SecurePacketBufferList */
+   msg[0] ^= (unsigned char) (b->secure_token & 0xFF);
+   if (b->sliding_token != NULL)
+   {
+      b->secure_token += (*b->sliding_token) & 0x7F;
+      b->sliding_token++;
+      if (*b->sliding_token == '\0')
+         b->sliding_token = redbook;
+   }
+
+   type = msg[0];
+   if (verbose)
+      printf("%s: got message %d, %d bytes\n", b->name, type, len);
+
+   p.ptr = msg + 1;
+   p.end = msg + len;
+   p.ok = true;
+
+   if (b->state >= BOT_ENTERING && epoch != 0)
+   {
+      b->epoch = (unsigned char) epoch;
+
+      /* Ask for our characters once we know the epoch to send with it */
+      if (b->state == BOT_ENTERING && b->object_id == 0 && b->room_id == 0)
+      {
+         b->room_id = -1;
+         SendSimple(b, BP_SEND_CHARACTERS);
+      }
+      HandleGameMessage(b, &p, type, now);
+   }
+   else HandleLoginMessage(b, &p, type);
+}
+/************************************************************************/
+/*
+ * BotRead:  Read what's waiting on b's socket, and handle each complete
+ *   message.
+ */
+static void BotRead(bot_type *b, UINT64 now)
+{
+   unsigned short len, len_verify;
+   int bytes, pos;
+
+   bytes = (int) recv(b->sock, b->in + b->in_len, READ_BUF_SIZE - b->in_len, 0);
+   if (bytes == 0)
+   {
+      BotError(b, "server closed the connection");
+      BotClose(b);
+      return;
+   }
+   if (bytes < 0)
+   {
+      if (errno != EAGAIN && errno != EWOULDBLOCK)
+      {
+         BotError(b, "read error %s", strerror(errno));
+         BotClose(b);
+      }
+      return;
+   }
+
+   b->in_len += bytes;
+   total.bytes_received += bytes;
+   interval.bytes_received += bytes;
+
+   pos = 0;
+   while (b->in_len - pos >= HEADERBYTES && b->state != BOT_DEAD)
+   {
+      memcpy(&len, b->in + pos, LENBYTES);
+      memcpy(&len_verify, b->in + pos + LENBYTES + CRCBYTES, LENBYTES);
+      if (len != len_verify || len > READ_BUF_SIZE - HEADERBYTES)
+      {
+         BotError(b, "garbled message header");
+         BotClose(b);
+         return;
+      }
+      if (b->in_len - pos < HEADERBYTES + len)
+         break;
+
+      BotHandleMessage(b, b->in + pos + HEADERBYTES, len,
+                       b->in[pos + LENBYTES * 2 + CRCBYTES], now);
+      pos += HEADERBYTES + len;
+   }
+
+   if (b->state == BOT_DEAD)
+      return;
+
+   memmove(b->in, b->in + pos, b->in_len - pos);
+   b->in_len -= pos;
+}
+/************************************************************************/
+static void BotConnect(bot_type *b)
+{
+   int one = 1;
+
+   b->sock = socket(AF_INET, SOCK_STREAM, 0);
+   if (b->sock < 0)
+   {
+      BotError(b, "can't create socket: %s", strerror(errno));
+      BotClose(b);
+      return;
+   }
+   fcntl(b->sock, F_SETFL, O_NONBLOCK);
+   setsockopt(b->sock, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+   if (connect(b->sock, (struct sockaddr *) &server_addr, sizeof(server_addr)) < 0 &&
+       errno != EINPROGRESS)
+   {
+      BotError(b, "can't connect: %s", strerror(errno));
+      BotClose(b);
+      return;
+   }
+   b->state = BOT_CONNECTING;
+}
+/************************************************************************/
+/*
+ * BotAct:  Send whatever b is due to send by now.
+ */
+static void BotAct(bot_type *b, UINT64 now)
+{
+   if (b->state != BOT_PLAYING)
+      return;
+
+   if (b->next_move != 0 && now >= b->next_move)
+   {
+      SendMove(b, now);
+      b->next_move = Jitter(now, move_interval);
+   }
+   if (b->next_say != 0 && now >= b->next_say)
+   {
+      SendSay(b);
+      b->next_say = Jitter(now, say_interval);
+   }
+   if (b->next_attack != 0 && now >= b->next_attack)
+   {
+      SendAttack(b);
+      b->next_attack = Jitter(now, attack_interval);
+   }
+   if (now >= b->next_ping)
+   {
+      SendSimple(b, BP_PING);
+      b->next_ping = Jitter(now, PING_INTERVAL);
+   }
+}
+/************************************************************************/
+/*
+ * FindServerPid:  Return the process id of the only process named
+ *   blakserv, or 0 if there's not exactly one.
+ */
+static int FindServerPid(void)
+{
+   DIR *dir;
+   struct dirent *entry;
+   char path[300], comm[64];
+   FILE *f;
+   int pid = 0, found = 0;
+
+   if ((dir = opendir("/proc")) == NULL)
+      return 0;
+
+   while ((entry = readdir(dir)) != NULL)
+   {
+      if (atoi(entry->d_name) <= 0)
+         continue;
+      snprintf(path, sizeof(path), "/proc/%s/comm", entry->d_name);
+      if ((f = fopen(path, "r")) == NULL)
+         continue;
+      if (fgets(comm, sizeof(comm), f) != NULL && !strcmp(comm, "blakserv\n"))
+      {
+         pid = atoi(entry->d_name);
+         found++;
+      }
+      fclose(f);
+   }
+   closedir(dir);
+
+   return found == 1 ? pid : 0;
+}
+/************************************************************************/
+/*
+ * GetProcessCpuMicro:  Return the CPU time used so far by the given
+ *   process, in microseconds, or 0 if it can't be read.
+ */
+static UINT64 GetProcessCpuMicro(int pid)
+{
+   char path[64], buf[1024], *ptr;
+   unsigned long long utime, stime;
+   FILE *f;
+
+   if (pid == 0)
+      return 0;
+
+   snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+   if ((f = fopen(path, "r")) == NULL)
+      return 0;
+   ptr = fgets(buf, sizeof(buf), f);
+   fclose(f);
+   if (ptr == NULL)
+      return 0;
+
+   /* Fields 14 and 15, after the command name in parentheses */
+   ptr = strrchr(buf, ')');
+   if (ptr == NULL ||
+       sscanf(ptr + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %llu %llu",
+              &utime, &stime) != 2)
+      return 0;
+
+   return (UINT64) (utime + stime) * 1000000 / sysconf(_SC_CLK_TCK);
+}
+/************************************************************************/
+/*
+ * CreateAccounts:  Create an account with one character for each bot,
+ *   through the maintenance port.  Returns false if it can't connect.
+ */
+static bool CreateAccounts(void)
+{
+   struct sockaddr_in addr;
+   struct pollfd pfd;
+   char cmd[200], buf[4096];
+   int sock, i;
+
+   addr = server_addr;
+   addr.sin_port = htons(maintenance_port);
+
+   sock = socket(AF_INET, SOCK_STREAM, 0);
+   if (sock < 0 || connect(sock, (struct sockaddr *) &addr, sizeof(addr)) < 0)
+   {
+      printf("Can't connect to maintenance port %d: %s\n", maintenance_port, strerror(errno));
+      if (sock >= 0)
+         close(sock);
+      return false;
+   }
+
+   for (i=0; i < num_bots; i++)
+   {
+      snprintf(cmd, sizeof(cmd), "create automated %s %s\r\n", bots[i].name, password);
+      if (send(sock, cmd, strlen(cmd), MSG_NOSIGNAL) < 0)
+         break;
+
+      /* Wait for the reply, so that we don't flood the server */
+      pfd.fd = sock;
+      pfd.events = POLLIN;
+      while (poll(&pfd, 1, 200) > 0)
+         if (recv(sock, buf, sizeof(buf), 0) <= 0)
+            break;
+   }
+   close(sock);
+
+   printf("Created accounts %s1 through %s%d (existing ones are left alone)\n",
+          prefix, prefix, num_bots);
+   return true;
+}
+/************************************************************************/
+static void ReportLatency(const histogram_type *h)
+{
+   if (h->count == 0)
+   {
+      printf("no moves seen");
+      return;
+   }
+   printf("p50 %.1fms p90 %.1fms p99 %.1fms p99.9 %.1fms max %.1fms",
+          HistogramPercentile(h, 50.0) / 1000.0, HistogramPercentile(h, 90.0) / 1000.0,
+          HistogramPercentile(h, 99.0) / 1000.0, HistogramPercentile(h, 99.9) / 1000.0,
+          h->max / 1000.0);
+}
+/************************************************************************/
+static void ReportInterval(UINT64 elapsed, UINT64 span, UINT64 cpu_span)
+{
+   double secs = span / 1000000.0;
+
+   printf("%4ds  playing %d/%d  sent %.0f/s  received %.0f/s  move ",
+          (int) (elapsed / 1000000), num_playing, num_bots,
+          interval.msgs_sent / secs, interval.msgs_received / secs);
+   ReportLatency(&interval.move_latency);
+   if (server_pid != 0)
+      printf("  server cpu %.0f%%", 100.0 * cpu_span / span);
+   printf("\n");
+   fflush(stdout);
+}
+/************************************************************************/
+int main(int argc, char **argv)
+{
+   struct pollfd *pfds;
+   struct hostent *he;
+   UINT64 now, start_time, run_start, end_time, next_start, next_report;
+   UINT64 last_report, cpu_start, cpu_last, cpu_now;
+   double secs;
+   int i, c, num_started, num_fds;
+
+   while ((c = getopt(argc, argv, "h:p:n:t:i:r:M:S:A:a:w:cm:P:R:v")) != -1)
+   {
+      switch (c)
+      {
+      case 'h': host = optarg; break;
+      case 'p': port = atoi(optarg); break;
+      case 'n': num_bots = atoi(optarg); break;
+      case 't': seconds = atoi(optarg); break;
+      case 'i': report_interval = atoi(optarg); break;
+      case 'r': ramp_rate = atoi(optarg); break;
+      case 'M': move_interval = atoi(optarg); break;
+      case 'S': say_interval = atoi(optarg); break;
+      case 'A': attack_interval = atoi(optarg); break;
+      case 'a': prefix = optarg; break;
+      case 'w': password = optarg; break;
+      case 'c': create_accounts = true; break;
+      case 'm': maintenance_port = atoi(optarg); break;
+      case 'P': server_pid = atoi(optarg); break;
+      case 'R': redbook = optarg; break;
+      case 'v': verbose = true; break;
+      default: Usage();
+      }
+   }
+   if (optind < argc || num_bots <= 0 || seconds <= 0 || ramp_rate <= 0 || report_interval <= 0)
+      Usage();
+
+   memset(&server_addr, 0, sizeof(server_addr));
+   server_addr.sin_family = AF_INET;
+   server_addr.sin_port = htons(port);
+   if (inet_pton(AF_INET, host, &server_addr.sin_addr) != 1)
+   {
+      if ((he = gethostbyname(host)) == NULL)
+      {
+         printf("Can't find host %s\n", host);
+         return 1;
+      }
+      memcpy(&server_addr.sin_addr, he->h_addr, he->h_length);
+   }
+
+   bots = (bot_type *) calloc(num_bots, sizeof(bot_type));
+   pfds = (struct pollfd *) calloc(num_bots, sizeof(struct pollfd));
+   if (bots == NULL || pfds == NULL)
+   {
+      printf("Out of memory\n");
+      return 1;
+   }
+   for (i=0; i < num_bots; i++)
+   {
+      bots[i].index = i;
+      bots[i].sock = -1;
+      bots[i].state = BOT_IDLE;
+      snprintf(bots[i].name, sizeof(bots[i].name), "%s%d", prefix, i + 1);
+   }
+
+   if (create_accounts && !CreateAccounts())
+      return 1;
+
+   if (server_pid == 0)
+      server_pid = FindServerPid();
+
+   srand((unsigned int) time(NULL));
+   HistogramClear(&total.move_latency);
+   HistogramClear(&interval.move_latency);
+
+   start_time = GetMicroTime();
+   next_start = start_time;
+   run_start = 0;
+   end_time = 0;
+   num_started = 0;
+   cpu_start = cpu_last = GetProcessCpuMicro(server_pid);
+   last_report = start_time;
+   next_report = start_time + (UINT64) report_interval * 1000000;
+
+   printf("Starting %d bots against %s:%d\n", num_bots, host, port);
+
+   for (;;)
+   {
+      now = GetMicroTime();
+
+      /* Start bots at the ramp rate */
+      while (num_started < num_bots && now >= next_start)
+      {
+         BotConnect(&bots[num_started++]);
+         next_start += 1000000 / ramp_rate;
+      }
+
+      if (num_failed == num_bots)
+      {
+         printf("Every bot failed\n");
+         return 1;
+      }
+
+      /* The timed run starts once every bot is in, or has given up */
+      if (run_start == 0 && num_started == num_bots && num_playing + num_failed == num_bots)
+      {
+         run_start = now;
+         end_time = now + (UINT64) seconds * 1000000;
+         total.msgs_sent = total.msgs_received = 0;
+         total.bytes_sent = total.bytes_received = 0;
+         total.moves = total.says = total.attacks = 0;
+         HistogramClear(&total.move_latency);
+         cpu_start = GetProcessCpuMicro(server_pid);
+         printf("%d bots playing; running for %d seconds\n", num_playing, seconds);
+      }
+      if (end_time != 0 && now >= end_time)
+         break;
+
+      for (i=0; i < num_bots; i++)
+         BotAct(&bots[i], now);
+
+      num_fds = 0;
+      for (i=0; i < num_bots; i++)
+      {
+         pfds[i].fd = bots[i].sock;
+         pfds[i].events = 0;
+         pfds[i].revents = 0;
+         if (bots[i].sock < 0)
+            continue;
+         pfds[i].events = POLLIN;
+         if (bots[i].state == BOT_CONNECTING || bots[i].out_len > 0)
+            pfds[i].events |= POLLOUT;
+         num_fds++;
+      }
+
+      if (num_fds == 0)
+         usleep(POLL_MILLISECONDS * 1000);
+      else if (poll(pfds, num_bots, POLL_MILLISECONDS) < 0 && errno != EINTR)
+      {
+         printf("poll failed: %s\n", strerror(errno));
+         return 1;
+      }
+
+      now = GetMicroTime();
+      for (i=0; i < num_bots; i++)
+      {
+         if (bots[i].sock < 0 || pfds[i].revents == 0)
+            continue;
+
+         if (bots[i].state == BOT_CONNECTING)
+         {
+            if (pfds[i].revents & (POLLERR | POLLHUP))
+            {
+               BotError(&bots[i], "can't connect");
+               BotClose(&bots[i]);
+               continue;
+            }
+            bots[i].state = BOT_LOGIN;
+         }
+         if (pfds[i].revents & POLLOUT)
+            BotFlush(&bots[i]);
+         if (bots[i].sock >= 0 && (pfds[i].revents & (POLLIN | POLLHUP | POLLERR)))
+            BotRead(&bots[i], now);
+      }
+
+      if (now >= next_report)
+      {
+         cpu_now = GetProcessCpuMicro(server_pid);
+         ReportInterval(now - start_time, now - last_report, cpu_now - cpu_last);
+         cpu_last = cpu_now;
+         last_report = now;
+         next_report = now + (UINT64) report_interval * 1000000;
+         interval.msgs_sent = interval.msgs_received = 0;
+         interval.bytes_sent = interval.bytes_received = 0;
+         interval.moves = interval.says = interval.attacks = 0;
+         HistogramClear(&interval.move_latency);
+      }
+   }
+
+   cpu_now = GetProcessCpuMicro(server_pid);
+   secs = (now - run_start) / 1000000.0;
+
+   printf("\nResults over %.0f seconds with %d bots playing (%d failed):\n",
+          secs, num_playing, num_failed);
+   printf("  sent      %.0f messages/s, %.0f bytes/s (%.0f moves/s, %.0f says/s, %.0f attacks/s)\n",
+          total.msgs_sent / secs, total.bytes_sent / secs,
+          total.moves / secs, total.says / secs, total.attacks / secs);
+   printf("  received  %.0f messages/s, %.0f bytes/s\n",
+          total.msgs_received / secs, total.bytes_received / secs);
+   printf("  move broadcast latency ");
+   ReportLatency(&total.move_latency);
+   printf(" (%llu moves seen)\n", (unsigned long long) total.move_latency.count);
+   if (server_pid != 0)
+      printf("  server cpu %.1f%% of one core (pid %d)\n",
+             100.0 * (cpu_now - cpu_start) / (now - run_start), server_pid);
+   else printf("  server cpu not measured (use -P)\n");
+
+   for (i=0; i < num_bots; i++)
+      if (bots[i].sock >= 0)
+         close(bots[i].sock);
+
+   return 0;
+}